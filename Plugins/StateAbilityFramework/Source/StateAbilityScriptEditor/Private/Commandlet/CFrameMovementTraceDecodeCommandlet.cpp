@@ -0,0 +1,67 @@
+
+#include "Commandlet/CFrameMovementTraceDecodeCommandlet.h"
+
+#include "Component/Mover/CFrameMovementTrace.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCFrameMovementTraceDecode, Log, All)
+
+UCFrameMovementTraceDecodeCommandlet::UCFrameMovementTraceDecodeCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UCFrameMovementTraceDecodeCommandlet::Main(const FString& Params)
+{
+	FString InputPath;
+	if (!FParse::Value(*Params, TEXT("Input="), InputPath))
+	{
+		UE_LOG(LogCFrameMovementTraceDecode, Error, TEXT("Usage: -run=CFrameMovementTraceDecode -Input=<Trace.cfmtrace> [-Output=<Trace.csv>]"));
+		return 1;
+	}
+
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FPaths::ChangeExtension(InputPath, TEXT("csv"));
+	}
+
+	TArray<FCFrameMovementTraceEvent> Events;
+	TArray<FName> ModeNames;
+	if (!FCFrameMovementTrace::LoadFromFile(InputPath, Events, ModeNames))
+	{
+		return 1;
+	}
+
+	TArray<FString> Lines;
+	Lines.Reserve(Events.Num() + 1);
+	Lines.Add(TEXT("Frame,Entity,Mode,Type,Side,PosX,PosY,PosZ,VelX,VelY,VelZ"));
+
+	for (const FCFrameMovementTraceEvent& Event : Events)
+	{
+		const FName ModeName = ModeNames.IsValidIndex(Event.ModeId) ? ModeNames[Event.ModeId] : NAME_None;
+
+		Lines.Add(FString::Printf(TEXT("%u,%u,%s,%s,%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f"),
+			Event.Frame,
+			Event.EntityIndex,
+			*ModeName.ToString(),
+			Event.Type == ECFrameMovementTraceType::Replay ? TEXT("Replay") : TEXT("Tick"),
+			Event.bClient ? TEXT("Client") : TEXT("Server"),
+			Event.Position.X, Event.Position.Y, Event.Position.Z,
+			Event.Velocity.X, Event.Velocity.Y, Event.Velocity.Z));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(LogCFrameMovementTraceDecode, Error, TEXT("Failed to write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogCFrameMovementTraceDecode, Display, TEXT("Decoded %d events to %s"), Events.Num(), *OutputPath);
+	return 0;
+}
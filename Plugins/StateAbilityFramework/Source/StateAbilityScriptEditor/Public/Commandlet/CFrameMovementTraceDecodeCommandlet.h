@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CFrameMovementTraceDecodeCommandlet.generated.h"
+
+/**
+ * 将 CFrame.Mover.TraceDump 写出的二进制移动记录解码为 CSV
+ * UnrealEditor-Cmd.exe <Project> -run=CFrameMovementTraceDecode -Input=<Trace.cfmtrace> [-Output=<Trace.csv>]
+ */
+UCLASS()
+class UCFrameMovementTraceDecodeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UCFrameMovementTraceDecodeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
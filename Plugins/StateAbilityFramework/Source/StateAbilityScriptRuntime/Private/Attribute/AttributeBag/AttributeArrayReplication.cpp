@@ -0,0 +1,404 @@
+#include "Attribute/AttributeBag/AttributeArrayReplication.h"
+
+#include "Serialization/BitReader.h"
+
+#include "Attribute/AttributeBag/AttributeBagLayout.h"
+#include "Attribute/AttributeBag/AttributeNetGuidReferences.h"
+
+#include <atomic>
+
+namespace
+{
+	// 所有数组共用，避免状态重新创建后的 ReplicationKey 与连接中记录的旧值相同
+	std::atomic<int32> NextReplicationKey{ 0 };
+}
+
+FAttributeArrayReplicationState::FAttributeArrayReplicationState(const FArrayProperty* InArrayProperty)
+	: ArrayProperty(InArrayProperty)
+{
+	check(ArrayProperty);
+}
+
+FAttributeArrayReplicationState::~FAttributeArrayReplicationState()
+{
+	if (ShadowValue)
+	{
+		ArrayProperty->DestroyValue(ShadowValue);
+		FMemory::Free(ShadowValue);
+	}
+}
+
+uint32 FAttributeArrayReplicationState::HashElement(const void* Element) const
+{
+	// 不支持哈希的类型全部落在同一个桶中，退化为逐个比较
+	const FProperty* Inner = ArrayProperty->Inner;
+	return Inner->HasAnyPropertyFlags(CPF_HasGetValueTypeHash) ? Inner->GetValueTypeHash(Element) : 0;
+}
+
+void FAttributeArrayReplicationState::UpdateDelta(const void* ArrayValue, uint32 ReplicationFrame)
+{
+	if (bHasDelta && DeltaFrame == ReplicationFrame)
+	{
+		return;
+	}
+
+	// 第一次同步时客户端的数组可能还是默认值，需要先清空
+	bReset = !bHasDelta;
+	bHasDelta = true;
+	DeltaFrame = ReplicationFrame;
+
+	if (!ShadowValue)
+	{
+		ShadowValue = FMemory::Malloc(ArrayProperty->GetSize(), ArrayProperty->GetMinAlignment());
+		ArrayProperty->InitializeValue(ShadowValue);
+	}
+
+	const FProperty* Inner = ArrayProperty->Inner;
+	FScriptArrayHelper Current(ArrayProperty, ArrayValue);
+	FScriptArrayHelper Shadow(ArrayProperty, ShadowValue);
+
+	const int32 Num = Current.Num();
+	const int32 PrevNum = Shadow.Num();
+	check(PrevNum == ReplicationIDs.Num());
+
+	TArray<uint32> Keys;
+	Keys.SetNumUninitialized(Num);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Keys[Index] = HashElement(Current.GetRawPtr(Index));
+	}
+
+	TArray<int32> NewIDs;
+	NewIDs.Init(INDEX_NONE, Num);
+	// 当前元素对应的旧元素序号
+	TArray<int32> PrevIndices;
+	PrevIndices.Init(INDEX_NONE, Num);
+	TBitArray<> PrevMatched(false, PrevNum);
+
+	// 1. 原位置未变化的元素
+	const int32 CommonNum = FMath::Min(Num, PrevNum);
+	for (int32 Index = 0; Index < CommonNum; ++Index)
+	{
+		if (Keys[Index] == ReplicationKeys[Index] && Inner->Identical(Current.GetRawPtr(Index), Shadow.GetRawPtr(Index)))
+		{
+			NewIDs[Index] = ReplicationIDs[Index];
+			PrevIndices[Index] = Index;
+			PrevMatched[Index] = true;
+		}
+	}
+
+	// 2. 移动了位置的元素，在剩余的旧元素中按哈希查找
+	TMultiMap<uint32, int32> UnmatchedPrev;
+	for (int32 PrevIndex = 0; PrevIndex < PrevNum; ++PrevIndex)
+	{
+		if (!PrevMatched[PrevIndex])
+		{
+			UnmatchedPrev.Add(ReplicationKeys[PrevIndex], PrevIndex);
+		}
+	}
+
+	if (UnmatchedPrev.Num() > 0)
+	{
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			if (NewIDs[Index] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			for (auto It = UnmatchedPrev.CreateKeyIterator(Keys[Index]); It; ++It)
+			{
+				const int32 PrevIndex = It.Value();
+				if (Inner->Identical(Current.GetRawPtr(Index), Shadow.GetRawPtr(PrevIndex)))
+				{
+					NewIDs[Index] = ReplicationIDs[PrevIndex];
+					PrevIndices[Index] = PrevIndex;
+					PrevMatched[PrevIndex] = true;
+					It.RemoveCurrent();
+					break;
+				}
+			}
+		}
+	}
+
+	// 3. 仍未匹配的元素：前一个元素对应的旧元素之后如果有未匹配的旧元素，视为修改并沿用其ID，否则为新增
+	const int32 PrevIDCounter = IDCounter;
+	ChangedIndices.Reset();
+	int32 AnchorPrevIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (NewIDs[Index] == INDEX_NONE)
+		{
+			int32 PrevIndex = AnchorPrevIndex + 1;
+			while (PrevIndex < PrevNum && PrevMatched[PrevIndex])
+			{
+				++PrevIndex;
+			}
+
+			if (PrevIndex < PrevNum)
+			{
+				NewIDs[Index] = ReplicationIDs[PrevIndex];
+				PrevIndices[Index] = PrevIndex;
+				PrevMatched[PrevIndex] = true;
+			}
+			else
+			{
+				NewIDs[Index] = ++IDCounter;
+			}
+			ChangedIndices.Add(Index);
+		}
+
+		if (PrevIndices[Index] != INDEX_NONE)
+		{
+			AnchorPrevIndex = PrevIndices[Index];
+		}
+	}
+
+	// 4. 剩余的旧元素被删除
+	RemovedIDs.Reset();
+	TArray<int32> ExpectedIDs;
+	ExpectedIDs.Reserve(Num);
+	for (int32 PrevIndex = 0; PrevIndex < PrevNum; ++PrevIndex)
+	{
+		if (PrevMatched[PrevIndex])
+		{
+			ExpectedIDs.Add(ReplicationIDs[PrevIndex]);
+		}
+		else
+		{
+			RemovedIDs.Add(ReplicationIDs[PrevIndex]);
+		}
+	}
+
+	// 5. 客户端应用删除后，新增的元素追加在末尾，与实际顺序不同时才发送完整的ID顺序
+	for (const int32 Index : ChangedIndices)
+	{
+		if (NewIDs[Index] > PrevIDCounter)
+		{
+			ExpectedIDs.Add(NewIDs[Index]);
+		}
+	}
+	bOrderChanged = ExpectedIDs != NewIDs;
+
+	DeltaBaseKey = ReplicationKey;
+	if (bReset || bOrderChanged || RemovedIDs.Num() > 0 || ChangedIndices.Num() > 0)
+	{
+		ReplicationKey = ++NextReplicationKey;
+	}
+
+	ReplicationIDs = MoveTemp(NewIDs);
+	ReplicationKeys = MoveTemp(Keys);
+	ArrayProperty->CopyCompleteValue(ShadowValue, ArrayValue);
+}
+
+void FAttributeArrayReplicationState::WriteDelta(FArchive& Ar, UPackageMap* Map, void* ArrayValue, int32 BaseKey) const
+{
+	check(bHasDelta);
+
+	if (BaseKey != DeltaBaseKey && BaseKey != ReplicationKey)
+	{
+		// 连接的基准不是本帧差量的基准：首次同步，或者中间的差量没有送达
+		WriteFullState(Ar, Map, ArrayValue);
+		return;
+	}
+
+	// 连接已经收到了当前的数组，例如同一帧内重复写入
+	const bool bUpToDate = BaseKey == ReplicationKey && BaseKey != DeltaBaseKey;
+
+	const FProperty* Inner = ArrayProperty->Inner;
+	const FAttributeBagLayout::FNetSerializeFunc NetSerialize = FAttributeBagLayout::GetNetSerializeFunc(Inner);
+	FScriptArrayHelper Current(ArrayProperty, ArrayValue);
+
+	bool bWriteReset = bReset && !bUpToDate;
+	Ar.SerializeBits(&bWriteReset, 1);
+
+	uint32 RemovedNum = bUpToDate ? 0 : RemovedIDs.Num();
+	Ar.SerializeIntPacked(RemovedNum);
+	for (uint32 Count = 0; Count < RemovedNum; ++Count)
+	{
+		uint32 PackedID = RemovedIDs[Count];
+		Ar.SerializeIntPacked(PackedID);
+	}
+
+	uint32 ChangedNum = bUpToDate ? 0 : ChangedIndices.Num();
+	Ar.SerializeIntPacked(ChangedNum);
+	for (uint32 Count = 0; Count < ChangedNum; ++Count)
+	{
+		const int32 Index = ChangedIndices[Count];
+		uint32 PackedID = ReplicationIDs[Index];
+		Ar.SerializeIntPacked(PackedID);
+		NetSerialize(Inner, Ar, Map, Current.GetRawPtr(Index));
+	}
+
+	bool bWriteOrder = bOrderChanged && !bUpToDate;
+	Ar.SerializeBits(&bWriteOrder, 1);
+	if (bWriteOrder)
+	{
+		uint32 Num = ReplicationIDs.Num();
+		Ar.SerializeIntPacked(Num);
+		for (int32 ReplicationID : ReplicationIDs)
+		{
+			uint32 PackedID = ReplicationID;
+			Ar.SerializeIntPacked(PackedID);
+		}
+	}
+}
+
+void FAttributeArrayReplicationState::WriteFullState(FArchive& Ar, UPackageMap* Map, void* ArrayValue) const
+{
+	const FProperty* Inner = ArrayProperty->Inner;
+	const FAttributeBagLayout::FNetSerializeFunc NetSerialize = FAttributeBagLayout::GetNetSerializeFunc(Inner);
+	FScriptArrayHelper Current(ArrayProperty, ArrayValue);
+
+	// 客户端清空后按当前顺序追加所有元素，不需要删除与顺序
+	bool bWriteReset = true;
+	Ar.SerializeBits(&bWriteReset, 1);
+
+	uint32 RemovedNum = 0;
+	Ar.SerializeIntPacked(RemovedNum);
+
+	uint32 ChangedNum = ReplicationIDs.Num();
+	Ar.SerializeIntPacked(ChangedNum);
+	for (int32 Index = 0; Index < ReplicationIDs.Num(); ++Index)
+	{
+		uint32 PackedID = ReplicationIDs[Index];
+		Ar.SerializeIntPacked(PackedID);
+		NetSerialize(Inner, Ar, Map, Current.GetRawPtr(Index));
+	}
+
+	bool bWriteOrder = false;
+	Ar.SerializeBits(&bWriteOrder, 1);
+}
+
+bool FAttributeArrayReplicationState::ReadDelta(FBitReader& Ar, UPackageMap* Map, void* ArrayValue, FAttributeNetGuidReferences* GuidReferences, uint16 PropIndex)
+{
+	const FProperty* Inner = ArrayProperty->Inner;
+	const FAttributeBagLayout::FNetSerializeFunc NetSerialize = FAttributeBagLayout::GetNetSerializeFunc(Inner);
+	FScriptArrayHelper Current(ArrayProperty, ArrayValue);
+
+	bool bReadReset = false;
+	Ar.SerializeBits(&bReadReset, 1);
+	if (bReadReset)
+	{
+		if (GuidReferences)
+		{
+			GuidReferences->RemoveProperty(PropIndex);
+		}
+		Current.EmptyValues();
+		ReplicationIDs.Reset();
+	}
+
+	// 删除
+	uint32 RemovedNum = 0;
+	Ar.SerializeIntPacked(RemovedNum);
+	if (RemovedNum > (uint32)MaxNetElementNum)
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	TArray<int32, TInlineAllocator<16>> RemovedIndices;
+	for (uint32 Count = 0; Count < RemovedNum; ++Count)
+	{
+		uint32 ReplicationID = 0;
+		Ar.SerializeIntPacked(ReplicationID);
+
+		const int32 Index = FindIndexByID(ReplicationID);
+		if (Index != INDEX_NONE)
+		{
+			RemovedIndices.Add(Index);
+		}
+		if (GuidReferences)
+		{
+			GuidReferences->Remove(PropIndex, ReplicationID);
+		}
+	}
+
+	RemovedIndices.Sort(TGreater<int32>());
+	for (const int32 Index : RemovedIndices)
+	{
+		Current.RemoveValues(Index);
+		ReplicationIDs.RemoveAt(Index, 1, EAllowShrinking::No);
+	}
+
+	// 新增或修改，未知的ID追加在末尾
+	uint32 ChangedNum = 0;
+	Ar.SerializeIntPacked(ChangedNum);
+	if (ChangedNum > (uint32)MaxNetElementNum)
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	for (uint32 Count = 0; Count < ChangedNum; ++Count)
+	{
+		uint32 ReplicationID = 0;
+		Ar.SerializeIntPacked(ReplicationID);
+
+		int32 Index = FindIndexByID(ReplicationID);
+		if (Index == INDEX_NONE)
+		{
+			Index = Current.AddValue();
+			ReplicationIDs.Add(ReplicationID);
+		}
+
+		{
+			// 只为本次收到的元素重新生成 GUID 引用
+			FAttributeNetGuidTrackingScope TrackingScope(GuidReferences, Map, Ar, PropIndex, ReplicationID);
+			NetSerialize(Inner, Ar, Map, Current.GetRawPtr(Index));
+		}
+
+		if (Ar.IsError())
+		{
+			return false;
+		}
+	}
+
+	// 顺序
+	bool bReadOrder = false;
+	Ar.SerializeBits(&bReadOrder, 1);
+	if (bReadOrder)
+	{
+		uint32 Num = 0;
+		Ar.SerializeIntPacked(Num);
+		if (Num != (uint32)ReplicationIDs.Num())
+		{
+			Ar.SetError();
+			return false;
+		}
+
+		TMap<int32, int32> IndexByID;
+		IndexByID.Reserve(Num);
+		for (int32 Index = 0; Index < ReplicationIDs.Num(); ++Index)
+		{
+			IndexByID.Add(ReplicationIDs[Index], Index);
+		}
+
+		for (int32 Index = 0; Index < (int32)Num; ++Index)
+		{
+			uint32 ReplicationID = 0;
+			Ar.SerializeIntPacked(ReplicationID);
+
+			const int32* FromIndex = IndexByID.Find(ReplicationID);
+			if (!FromIndex || *FromIndex < Index)
+			{
+				Ar.SetError();
+				return false;
+			}
+
+			if (*FromIndex != Index)
+			{
+				const int32 From = *FromIndex;
+				const int32 DisplacedID = ReplicationIDs[Index];
+
+				Current.SwapValues(Index, From);
+				ReplicationIDs.Swap(Index, From);
+
+				IndexByID[DisplacedID] = From;
+				IndexByID[ReplicationID] = Index;
+			}
+		}
+	}
+
+	return !Ar.IsError();
+}
@@ -1453,6 +1453,9 @@ UAttributeBagStruct* UAttributeBagStruct::GetOrCreateFromDescs(const TConstArray
 	NewBag->Bind();
 	NewBag->StaticLink(/*RelinkExistingProperties*/true);
 
+	// 属性偏移在 StaticLink 之后才确定
+	NewBag->Layout = FAttributeBagLayout(NewBag->PropertyDescs);
+
 	return NewBag;
 }
 
@@ -1596,5 +1599,6 @@ const FAttributeBagPropertyDesc* UAttributeBagStruct::FindPropertyDescByIndex(co
 
 const FAttributeBagPropertyDesc* UAttributeBagStruct::FindPropertyDescByName(const FName Name) const
 {
-	return PropertyDescs.FindByPredicate([&Name](const FAttributeBagPropertyDesc& Desc) { return Desc.Name == Name; });
+	const int32 Index = Layout.FindIndex(Name);
+	return Index != INDEX_NONE ? &PropertyDescs[Index] : nullptr;
 }
\ No newline at end of file
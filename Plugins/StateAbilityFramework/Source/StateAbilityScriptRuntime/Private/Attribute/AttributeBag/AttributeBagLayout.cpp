@@ -0,0 +1,288 @@
+#include "Attribute/AttributeBag/AttributeBagLayout.h"
+
+#include <atomic>
+
+#include "Misc/ScopeRWLock.h"
+#include "Serialization/StructuredArchive.h"
+#include "UObject/UObjectGlobals.h"
+
+#include "Attribute/AttributeBag/AttributeBag.h"
+
+namespace AttributeBagLayout
+{
+	// 每个桶尝试的种子数
+	constexpr uint32 MaxSeedAttempts = 4096;
+	// 平均每个桶的名字数
+	constexpr int32 NamesPerBucket = 2;
+
+	// 普通 UScriptStruct 的布局，原生结构体的生命周期与模块相同
+	struct FRegistry
+	{
+		FRWLock Lock;
+		TMap<const UScriptStruct*, TUniquePtr<FAttributeBagLayout>> Layouts;
+		// 被移除的布局，已经取得的引用在移除后仍然有效
+		TArray<TUniquePtr<FAttributeBagLayout>> RetiredLayouts;
+		std::atomic<uint32> Generation = 0;
+
+#if WITH_EDITOR
+		FRegistry()
+		{
+			// UserDefinedStruct 重新编译时可能原地修改属性，非原生结构体的布局全部重新构建
+			FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda([this](const TMap<UObject*, UObject*>& ReplacementMap)
+			{
+				TArray<const UScriptStruct*> InvalidStructs;
+				{
+					FReadScopeLock ReadLock(Lock);
+					for (const auto& LayoutPair : Layouts)
+					{
+						if (!(LayoutPair.Key->StructFlags & STRUCT_Native) || ReplacementMap.Contains(const_cast<UScriptStruct*>(LayoutPair.Key)))
+						{
+							InvalidStructs.Add(LayoutPair.Key);
+						}
+					}
+				}
+
+				for (const UScriptStruct* ScriptStruct : InvalidStructs)
+				{
+					FAttributeBagLayout::Invalidate(ScriptStruct);
+				}
+			});
+		}
+#endif
+	};
+
+	FRegistry& GetRegistry()
+	{
+		static FRegistry Registry;
+		return Registry;
+	}
+
+	bool NetSerializeNative(const FProperty* Property, FArchive& Ar, UPackageMap* Map, void* Data)
+	{
+		return Property->NetSerializeItem(Ar, Map, Data);
+	}
+
+	// 这里之所以可以用SerializeItem，是因为Ar本身就不是普通的FArchive，而是支持Rep的NetWriter/NetReader.
+	bool NetSerializeBySerializeItem(const FProperty* Property, FArchive& Ar, UPackageMap* Map, void* Data)
+	{
+		Property->SerializeItem(FStructuredArchiveFromArchive(Ar).GetSlot(), Data, nullptr);
+		return true;
+	}
+
+	FAttributeBagLayout::FPropertyLayout MakePropertyLayout(const FProperty* Property, const FName Name)
+	{
+		FAttributeBagLayout::FPropertyLayout Layout;
+		Layout.Name = Name;
+		Layout.Property = Property;
+		if (Property)
+		{
+			Layout.Offset = Property->GetOffset_ForInternal();
+			Layout.Size = Property->GetSize();
+			Layout.bPOD = Property->HasAnyPropertyFlags(CPF_IsPlainOldData);
+			Layout.NetSerialize = FAttributeBagLayout::GetNetSerializeFunc(Property);
+			Layout.ArrayProperty = CastField<FArrayProperty>(Property);
+		}
+		return Layout;
+	}
+}
+
+FAttributeBagLayout::FAttributeBagLayout(const UScriptStruct* ScriptStruct)
+{
+	if (ScriptStruct)
+	{
+		for (TFieldIterator<FProperty> It(ScriptStruct); It; ++It)
+		{
+			Properties.Add(AttributeBagLayout::MakePropertyLayout(*It, It->GetFName()));
+		}
+	}
+
+	BuildHash();
+}
+
+FAttributeBagLayout::FAttributeBagLayout(TConstArrayView<FAttributeBagPropertyDesc> PropertyDescs)
+{
+	Properties.Reserve(PropertyDescs.Num());
+	for (const FAttributeBagPropertyDesc& Desc : PropertyDescs)
+	{
+		check(Desc.Index == Properties.Num());
+		Properties.Add(AttributeBagLayout::MakePropertyLayout(Desc.CachedProperty, Desc.Name));
+	}
+
+	BuildHash();
+}
+
+const FAttributeBagLayout& FAttributeBagLayout::Get(const UScriptStruct* ScriptStruct)
+{
+	if (const UAttributeBagStruct* BagStruct = Cast<UAttributeBagStruct>(ScriptStruct))
+	{
+		return BagStruct->GetLayout();
+	}
+
+	static const FAttributeBagLayout EmptyLayout;
+	if (!ScriptStruct)
+	{
+		return EmptyLayout;
+	}
+
+	AttributeBagLayout::FRegistry& Registry = AttributeBagLayout::GetRegistry();
+	{
+		FReadScopeLock ReadLock(Registry.Lock);
+		if (const TUniquePtr<FAttributeBagLayout>* Layout = Registry.Layouts.Find(ScriptStruct))
+		{
+			return **Layout;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Registry.Lock);
+	TUniquePtr<FAttributeBagLayout>& Layout = Registry.Layouts.FindOrAdd(ScriptStruct);
+	if (!Layout)
+	{
+		Layout = MakeUnique<FAttributeBagLayout>(ScriptStruct);
+	}
+	return *Layout;
+}
+
+void FAttributeBagLayout::Invalidate(const UScriptStruct* ScriptStruct)
+{
+	AttributeBagLayout::FRegistry& Registry = AttributeBagLayout::GetRegistry();
+
+	FWriteScopeLock WriteLock(Registry.Lock);
+	TUniquePtr<FAttributeBagLayout> Layout;
+	if (Registry.Layouts.RemoveAndCopyValue(ScriptStruct, Layout))
+	{
+		Registry.RetiredLayouts.Add(MoveTemp(Layout));
+		++Registry.Generation;
+	}
+}
+
+uint32 FAttributeBagLayout::GetGeneration()
+{
+	return AttributeBagLayout::GetRegistry().Generation.load(std::memory_order_relaxed);
+}
+
+FAttributeBagLayout::FNetSerializeFunc FAttributeBagLayout::GetNetSerializeFunc(const FProperty* Property)
+{
+	if (const FStructProperty* StructProp = CastField<FStructProperty>(Property))
+	{
+		return (StructProp->Struct->StructFlags & STRUCT_NetSerializeNative) ? &AttributeBagLayout::NetSerializeNative : &AttributeBagLayout::NetSerializeBySerializeItem;
+	}
+	if (Property->IsA<FMapProperty>() || Property->IsA<FArrayProperty>())
+	{
+		// 完整序列化整个容器。FAttributeEntityBag 的脏标记同步对 TArray 另有按元素的差量路径
+		return &AttributeBagLayout::NetSerializeBySerializeItem;
+	}
+	return &AttributeBagLayout::NetSerializeNative;
+}
+
+bool FAttributeBagLayout::BuildPerfectHash(int32 SlotNum)
+{
+	const int32 BucketNum = (int32)FMath::RoundUpToPowerOfTwo(FMath::Max(FMath::DivideAndRoundUp(Properties.Num(), AttributeBagLayout::NamesPerBucket), 1));
+	BucketMask = BucketNum - 1;
+	BucketSeeds.Init(0, BucketNum);
+	HashMask = SlotNum - 1;
+	HashSlots.Init(INDEX_NONE, SlotNum);
+
+	TArray<TArray<int32, TInlineAllocator<4>>> Buckets;
+	Buckets.SetNum(BucketNum);
+	for (int32 Index = 0; Index < Properties.Num(); ++Index)
+	{
+		TArray<int32, TInlineAllocator<4>>& Bucket = Buckets[BucketHash(GetTypeHash(Properties[Index].Name)) & BucketMask];
+
+		// 同名的属性只保留第一个
+		if (!Bucket.ContainsByPredicate([this, Index](int32 Other) { return Properties[Other].Name == Properties[Index].Name; }))
+		{
+			Bucket.Add(Index);
+		}
+	}
+
+	TArray<int32> BucketOrder;
+	BucketOrder.Reserve(BucketNum);
+	for (int32 BucketIndex = 0; BucketIndex < BucketNum; ++BucketIndex)
+	{
+		if (Buckets[BucketIndex].Num() > 0)
+		{
+			BucketOrder.Add(BucketIndex);
+		}
+	}
+	BucketOrder.StableSort([&Buckets](int32 A, int32 B) { return Buckets[A].Num() > Buckets[B].Num(); });
+
+	TArray<uint32, TInlineAllocator<4>> Slots;
+	for (const int32 BucketIndex : BucketOrder)
+	{
+		const TArray<int32, TInlineAllocator<4>>& Bucket = Buckets[BucketIndex];
+
+		bool bPlaced = false;
+		for (uint32 Seed = 0; Seed < AttributeBagLayout::MaxSeedAttempts && !bPlaced; ++Seed)
+		{
+			Slots.Reset();
+			bPlaced = true;
+			for (const int32 Index : Bucket)
+			{
+				const uint32 Slot = SlotHash(GetTypeHash(Properties[Index].Name), Seed) & HashMask;
+				if (HashSlots[Slot] != INDEX_NONE || Slots.Contains(Slot))
+				{
+					bPlaced = false;
+					break;
+				}
+				Slots.Add(Slot);
+			}
+
+			if (bPlaced)
+			{
+				BucketSeeds[BucketIndex] = Seed;
+				for (int32 Position = 0; Position < Bucket.Num(); ++Position)
+				{
+					HashSlots[Slots[Position]] = Bucket[Position];
+				}
+			}
+		}
+
+		// 同一个桶中有哈希值完全相同的不同名字时不存在可用的种子
+		if (!bPlaced)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FAttributeBagLayout::BuildHash()
+{
+	const int32 SlotNum = (int32)FMath::RoundUpToPowerOfTwo(FMath::Max(Properties.Num() * 2, 1));
+
+	for (int32 Scale = 1; Scale <= 2; ++Scale)
+	{
+		if (BuildPerfectHash(SlotNum * Scale))
+		{
+			bPerfectHash = true;
+			return;
+		}
+	}
+
+	// 退化为线性探测
+	bPerfectHash = false;
+	BucketSeeds.Init(0, 1);
+	BucketMask = 0;
+	HashMask = SlotNum * 2 - 1;
+	HashSlots.Init(INDEX_NONE, SlotNum * 2);
+
+	for (int32 Index = 0; Index < Properties.Num(); ++Index)
+	{
+		uint32 Slot = SlotHash(GetTypeHash(Properties[Index].Name), 0) & HashMask;
+		for (;;)
+		{
+			const int32 ExistingIndex = HashSlots[Slot];
+			if (ExistingIndex == INDEX_NONE)
+			{
+				HashSlots[Slot] = Index;
+				break;
+			}
+			// 同名的属性只保留第一个
+			if (Properties[ExistingIndex].Name == Properties[Index].Name)
+			{
+				break;
+			}
+			Slot = (Slot + 1) & HashMask;
+		}
+	}
+}
@@ -12,6 +12,26 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogAttributeBag, Log, All);
 
+namespace
+{
+	/**
+	 * FAttributeEntityBag 按连接保存的同步基准：各 TArray 属性已发送的 ReplicationKey。
+	 * 由引擎按连接保存，丢包时回退到最近一次被确认的状态，与 FFastArraySerializer 的基准相同。
+	 */
+	class FAttributeEntityBagDeltaState : public INetDeltaBaseState
+	{
+	public:
+		virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+		{
+			const FAttributeEntityBagDeltaState* Other = static_cast<const FAttributeEntityBagDeltaState*>(OtherState);
+			return Other && ArrayReplicationKeys.OrderIndependentCompareEqual(Other->ArrayReplicationKeys);
+		}
+
+		// 属性序号 -> ReplicationKey
+		TMap<int32, int32> ArrayReplicationKeys;
+	};
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FAttributeBag
 FAttributeBag::FAttributeBag()
@@ -90,6 +110,7 @@ FAttributeEntityBag& FAttributeEntityBag::operator=(const FAttributeEntityBag& I
 {
 	DataStruct = const_cast<UScriptStruct*>(InOther.DataStruct);
 	AttributeEntity = InOther.AttributeEntity;
+	ArrayReplicationStates.Reset();
 	return *this;
 }
 
@@ -104,14 +125,10 @@ void FAttributeEntityBag::MarkDirty(const FName Name, bool bValueChanged)
 
 	if (IsDataValid())
 	{
-		int32 index = 0;
-		for (TFieldIterator<FProperty> It(DataStruct); It; ++It, ++index)
+		const int32 Index = GetLayout().FindIndex(Name);
+		if (Index != INDEX_NONE)
 		{
-			FProperty* Property = *It;
-			if (Property && Property->GetFName() == Name)
-			{
-				MarkDirty(index, bValueChanged);
-			}
+			MarkDirty(Index, bValueChanged);
 		}
 	}
 }
@@ -203,10 +220,31 @@ bool FAttributeEntityBag::SerializeWrite(FNetDeltaSerializeInfo& deltaParms)
 
 	UpdatePropertiesCompare(ReplicationFrame);
 	{
+		// 在上一次的基准上记录本次发送的 ReplicationKey
+		TSharedPtr<FAttributeEntityBagDeltaState> NewState = MakeShared<FAttributeEntityBagDeltaState>();
+		if (deltaParms.OldState)
+		{
+			NewState->ArrayReplicationKeys = static_cast<FAttributeEntityBagDeltaState*>(deltaParms.OldState)->ArrayReplicationKeys;
+		}
+		if (deltaParms.NewState)
+		{
+			*deltaParms.NewState = NewState;
+		}
+
 		FNetBitArray changes(GetPropertyNum());
 
 		changes |= DirtyMark;
 
+		// 本帧未修改、但该连接还没有收到最新值的 TArray 属性
+		for (const TPair<int32, TUniquePtr<FAttributeArrayReplicationState>>& Pair : ArrayReplicationStates)
+		{
+			const int32* BaseKey = NewState->ArrayReplicationKeys.Find(Pair.Key);
+			if (Pair.Value && (!BaseKey || *BaseKey != Pair.Value->GetReplicationKey()))
+			{
+				changes.Add(Pair.Key);
+			}
+		}
+
 
 		bool bChangesIsEmpty = changes.IsEmpty();
 
@@ -218,7 +256,7 @@ bool FAttributeEntityBag::SerializeWrite(FNetDeltaSerializeInfo& deltaParms)
 
 			uint8* data = GetMutableMemory();
 
-			if (!(this->NetSerializeDirtyItem(Ar, PackageMapClient, changes)))
+			if (!(this->NetSerializeDirtyItem(Ar, PackageMapClient, changes, &NewState->ArrayReplicationKeys)))
 			{
 				return false;
 			}
@@ -235,15 +273,7 @@ bool FAttributeEntityBag::NetDeltaSerialize(FNetDeltaSerializeInfo& deltaParms)
 	{
 		// 当前处于 GatherGuidReferences 阶段
 
-		FAttributeNetFragment& NetFragment = GetNetFragment();
-
-		for (const auto& GuidReferencePair : NetFragment.GuidReferencesMap)
-		{
-			const auto& GuidReference = GuidReferencePair.Value;
-
-			deltaParms.GatherGuidReferences->Append(GuidReference.UnmappedGUIDs);
-			deltaParms.GatherGuidReferences->Append(GuidReference.MappedDynamicGUIDs);
-		}
+		GetNetFragment().GuidReferences.Gather(*deltaParms.GatherGuidReferences);
 		return true;
 	}
 
@@ -251,26 +281,8 @@ bool FAttributeEntityBag::NetDeltaSerialize(FNetDeltaSerializeInfo& deltaParms)
 	{
 		// 当前处于 MoveGuidToUnmapped 阶段
 
-		FAttributeNetFragment& NetFragment = GetNetFragment();
-
-		bool bFound = false;
-
-		const FNetworkGUID GUID = *deltaParms.MoveGuidToUnmapped;
-
 		// 如果这个GUID是此处关心的，则确保它现在被移交到未映射列表中
-		for (auto& GuidReferencePair : NetFragment.GuidReferencesMap)
-		{
-			auto& GuidReference = GuidReferencePair.Value;
-
-			if (GuidReference.MappedDynamicGUIDs.Contains(GUID))
-			{
-				GuidReference.MappedDynamicGUIDs.Remove(GUID);
-				GuidReference.UnmappedGUIDs.Add(GUID);
-				bFound = true;
-			}
-		}
-
-		return bFound;
+		return GetNetFragment().GuidReferences.MoveToUnmapped(*deltaParms.MoveGuidToUnmapped);
 	}
 
 	if (deltaParms.bUpdateUnmappedObjects)
@@ -278,97 +290,56 @@ bool FAttributeEntityBag::NetDeltaSerialize(FNetDeltaSerializeInfo& deltaParms)
 		// 当前处于 UpdateUnmappedObjects 阶段
 
 		FAttributeNetFragment& NetFragment = GetNetFragment();
-		FAttributeNetSharedFragment& NetSharedFragment = GetNetSharedFragment();
+		const FAttributeBagLayout& Layout = GetLayout();
 
-		const TArray<FProperty*>& PropArray = NetSharedFragment.ReplicatedProps.FindOrAdd(DataStruct);
 		TArray<FAttributeNetFragment::FRepPropIndex> changes;
 
-		// 循环遍历每个 GuidReference，检查是否有unmapped objects
-		for (auto It = NetFragment.GuidReferencesMap.CreateIterator(); It; ++It)
+		// 检查是否映射了任何guids。如果这样做了，可以再次序列化该属性（TArray 属性只有对应的元素），这一次将加载它
+		NetFragment.GuidReferences.UpdateUnmapped(deltaParms.Map, [this, &deltaParms, &Layout, &changes](const FAttributeNetGuidBuffer& GuidBuffer)
 		{
-			// Get the element id
-			const auto index = It.Key();
-
-			if (index < 0)
+			const int32 index = GuidBuffer.PropIndex;
+			if (index >= Layout.Num())
 			{
-				continue;
+				return;
 			}
 
-			// Get a reference to the unmapped item itself
-			auto& GuidReference = It.Value();
+			const FAttributeBagLayout::FPropertyLayout& Property = Layout.GetProperty(index);
+			const FProperty* prop = Property.Property;
+			void* propData = GetMutableMemory() + Property.Offset;
 
-			if ((GuidReference.UnmappedGUIDs.Num() == 0 && GuidReference.MappedDynamicGUIDs.Num() == 0))
+			if (GuidBuffer.ElementID != INDEX_NONE)
 			{
-				// 如果由于某种原因导致当前的属性的GuidReference完成了(或者所有跟踪的guids都被移除了)，我们不再需要跟踪这个属性的guids了
-				It.RemoveCurrent();
-				continue;
-			}
-
-			// 循环遍历所有的guids，并检查它们是否已经加载
-			bool bMappedSomeGUIDs = false;
-
-			for (auto unmappedIt = GuidReference.UnmappedGUIDs.CreateIterator(); unmappedIt; ++unmappedIt)
-			{
-				const FNetworkGUID& GUID = *unmappedIt;
-
-				if (deltaParms.Map->IsGUIDBroken(GUID, false))
+				const TUniquePtr<FAttributeArrayReplicationState>* ArrayState = ArrayReplicationStates.Find(index);
+				const int32 ElementIndex = (ArrayState && Property.ArrayProperty) ? (*ArrayState)->FindIndexByID(GuidBuffer.ElementID) : INDEX_NONE;
+				if (ElementIndex == INDEX_NONE)
 				{
-					// 停止加载损坏的guids
-					UE_LOG(LogAttributeBag, Warning, TEXT("AttributeBagNetSerialization: Broken GUID. NetGuid: %s"), *GUID.ToString());
-					unmappedIt.RemoveCurrent();
-					continue;
+					return;
 				}
 
-				{
-					UObject* mapObject = deltaParms.Map->GetObjectFromNetGUID(GUID, false);
-
-					if (mapObject != nullptr)
-					{
-						// This guid loaded!
-						if (GUID.IsDynamic())
-						{
-							// Move back to mapped list
-							GuidReference.MappedDynamicGUIDs.Add(GUID);
-						}
-						unmappedIt.RemoveCurrent();
-						bMappedSomeGUIDs = true;
-					}
-				}
+				FScriptArrayHelper ArrayHelper(Property.ArrayProperty, propData);
+				prop = Property.ArrayProperty->Inner;
+				propData = ArrayHelper.GetRawPtr(ElementIndex);
 			}
 
-			// 检查是否映射了任何guids。如果这样做了，可以再次序列化该元素，这一次将加载它
-			if (bMappedSomeGUIDs)
-			{
-				deltaParms.bOutSomeObjectsWereMapped = true;
-
-				if (!deltaParms.bCalledPreNetReceive)
-				{
-					// Call PreNetReceive if we are going to change a value (some game code will need to think this is an actual replicated value)
-					deltaParms.Object->PreNetReceive();
-					deltaParms.bCalledPreNetReceive = true;
-				}
-				if (PropArray.IsValidIndex(index))
-				{
-					// Initialize the reader with the stored buffer that we need to read from
-					FNetBitReader reader(deltaParms.Map, GuidReference.Buffer.GetData(), GuidReference.NumBufferBits);
-					const FProperty* prop = PropArray[index];
-					int32 propOffset = prop->GetOffset_ForInternal();
-					NetSerializeItem(prop, reader, deltaParms.Map, GetMutableMemory() + propOffset);
-					MarkDirty(index, true);
-
-					changes.Add(index);
-				}
-			}
+			deltaParms.bOutSomeObjectsWereMapped = true;
 
-			// 如果没有其他guids需要追踪就可以正常的移除了
-			if (GuidReference.UnmappedGUIDs.Num() == 0 && GuidReference.MappedDynamicGUIDs.Num() == 0)
+			if (!deltaParms.bCalledPreNetReceive)
 			{
-				It.RemoveCurrent();
+				// Call PreNetReceive if we are going to change a value (some game code will need to think this is an actual replicated value)
+				deltaParms.Object->PreNetReceive();
+				deltaParms.bCalledPreNetReceive = true;
 			}
-		}
+
+			// Initialize the reader with the stored buffer that we need to read from
+			FNetBitReader reader(deltaParms.Map, const_cast<uint8*>(GuidBuffer.Buffer.GetData()), GuidBuffer.NumBufferBits);
+			NetSerializeItem(prop, reader, deltaParms.Map, propData);
+			MarkDirty(index, true);
+
+			changes.AddUnique(index);
+		});
 
 		//如果我们仍然有未映射的属性，将其传递给外部
-		if (NetFragment.GuidReferencesMap.Num() > 0)
+		if (!NetFragment.GuidReferences.IsEmpty())
 		{
 			deltaParms.bOutHasMoreUnmapped = true;
 		}
@@ -392,22 +363,53 @@ bool FAttributeEntityBag::NetDeltaSerialize(FNetDeltaSerializeInfo& deltaParms)
 	return false;
 }
 
-bool FAttributeEntityBag::NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map, const FNetBitArray& Changes)
+bool FAttributeEntityBag::NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map, const FNetBitArray& Changes, TMap<int32, int32>* ArrayReplicationKeys)
 {
-	uint8* data = GetMutableMemory();
+	uint8* Data = GetMutableMemory();
+	const FAttributeBagLayout& Layout = GetLayout();
+	const int32 PropNum = Layout.Num();
 
-	TFieldIterator<FProperty> PropertyIter(GetScriptStruct());
-	FNetBitArray::FFullIterator It(Changes);
+	// 读取时追踪对象引用，此时 Ar 即 SerializeRead 中的 FBitReader
+	FAttributeNetGuidReferences* GuidReferences = nullptr;
+	if (Ar.IsLoading())
+	{
+		FStructView NetFragmentView = AttributeEntity.Get(FAttributeNetFragment::StaticStruct());
+		GuidReferences = NetFragmentView.IsValid() ? &NetFragmentView.Get<FAttributeNetFragment>().GuidReferences : nullptr;
+	}
 
-	for (; It; ++It, ++PropertyIter)
+	// 只遍历置位的bit，按序号直接取预先生成的处理函数
+	for (FNetBitArray::FIterator It(Changes); It; ++It)
 	{
-		FProperty* Prop = *PropertyIter;
+		const int32 Index = *It;
+		if (Index >= PropNum)
+		{
+			break;
+		}
+
+		const FAttributeBagLayout::FPropertyLayout& Property = Layout.GetProperty(Index);
+		if (!Property.NetSerialize)
+		{
+			return false;
+		}
 
-		if (It.IsMarked())
+		if (Property.ArrayProperty)
+		{
+			if (!NetSerializeArrayItem(Index, Property.ArrayProperty, Ar, Map, Data + Property.Offset, GuidReferences, ArrayReplicationKeys))
+			{
+				return false;
+			}
+		}
+		else if (GuidReferences)
+		{
+			FAttributeNetGuidTrackingScope TrackingScope(GuidReferences, Map, static_cast<FBitReader&>(Ar), (FAttributeNetFragment::FRepPropIndex)Index);
+			Property.NetSerialize(Property.Property, Ar, Map, Data + Property.Offset);
+		}
+		else
 		{
-			NetSerializeItem(Prop, Ar, Map, data);
-			MarkDirty(*It, true);
+			// 返回值只表示对象引用是否已映射
+			Property.NetSerialize(Property.Property, Ar, Map, Data + Property.Offset);
 		}
+		MarkDirty(Index, true);
 
 		if (Ar.IsError())
 		{
@@ -420,44 +422,43 @@ bool FAttributeEntityBag::NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map,
 
 bool FAttributeEntityBag::NetSerializeItem(const FProperty* Prop, FArchive& Ar, UPackageMap* Map, void* Data)
 {
-	if (auto StructProp = CastField<FStructProperty>(Prop))
-	{
-		if (StructProp->Struct->StructFlags & STRUCT_NetSerializeNative)
-		{
-			return StructProp->NetSerializeItem(Ar, Map, Data);
-		}
-		else
-		{
-			// 这里之所以可以用SerializeItem，是因为Ar本身就不是普通的FArchive，而是支持Rep的NetWriter/NetReader.
-			StructProp->SerializeItem(FStructuredArchiveFromArchive(Ar).GetSlot(), Data, nullptr);
-			return true;
-		}
-	}
-	else if (auto MapProp = CastField<FMapProperty>(Prop))
+	return FAttributeBagLayout::GetNetSerializeFunc(Prop)(Prop, Ar, Map, Data);
+}
+
+bool FAttributeEntityBag::NetSerializeArrayItem(int32 Index, const FArrayProperty* ArrayProp, FArchive& Ar, UPackageMap* Map, void* Data, FAttributeNetGuidReferences* GuidReferences, TMap<int32, int32>* ArrayReplicationKeys)
+{
+	TUniquePtr<FAttributeArrayReplicationState>& State = ArrayReplicationStates.FindOrAdd(Index);
+	if (!State || State->GetArrayProperty() != ArrayProp)
 	{
-		MapProp->SerializeItem(FStructuredArchiveFromArchive(Ar).GetSlot(), Data, nullptr);
-		return true;
+		State = MakeUnique<FAttributeArrayReplicationState>(ArrayProp);
 	}
-	else if (auto ArrayProp = CastField<FArrayProperty>(Prop))
+
+	if (Ar.IsSaving())
 	{
-		// @TODO: FastArray？
-		ArrayProp->SerializeItem(FStructuredArchiveFromArchive(Ar).GetSlot(), Data, nullptr);
-		return true;
+		// 差量相对上一个 ReplicationFrame，每帧只计算一次；连接的基准不是差量的基准时发送完整数组
+		State->UpdateDelta(Data, LastReplicationFrame);
+
+		const int32* BaseKey = ArrayReplicationKeys ? ArrayReplicationKeys->Find(Index) : nullptr;
+		State->WriteDelta(Ar, Map, Data, BaseKey ? *BaseKey : INDEX_NONE);
+		if (ArrayReplicationKeys)
+		{
+			ArrayReplicationKeys->Add(Index, State->GetReplicationKey());
+		}
+		return !Ar.IsError();
 	}
 
-	return Prop->NetSerializeItem(Ar, Map, Data);
+	// 读取时 Ar 即 SerializeRead 中的 FBitReader
+	return State->ReadDelta(static_cast<FBitReader&>(Ar), Map, Data, GuidReferences, (FAttributeNetFragment::FRepPropIndex)Index);
 }
 
 int32 FAttributeEntityBag::GetPropertyNum() const
 {
-	int32 Num = 0;
-
-	for (TFieldIterator<FProperty> It(DataStruct); It; ++It)
-	{
-		++Num;
-	}
+	return GetLayout().Num();
+}
 
-	return Num;
+const FAttributeBagLayout& FAttributeEntityBag::GetLayout() const
+{
+	return LayoutCache.Get(DataStruct);
 }
 
 const uint8* FAttributeEntityBag::GetMemory() const
@@ -545,7 +546,11 @@ void FAttributeDynamicBag::MarkDirty(const FName Name, bool bValueChanged)
 
 	if (const UAttributeBagStruct* BagStruct = GetAttributeBagStruct())
 	{
-		MarkDirty(BagStruct->FindPropertyDescByName(Name)->Index, bValueChanged);
+		const int32 Index = BagStruct->GetLayout().FindIndex(Name);
+		if (Index != INDEX_NONE)
+		{
+			MarkDirty(Index, bValueChanged);
+		}
 	}
 }
 
@@ -565,6 +570,7 @@ void FAttributeDynamicBag::ResetDataStruct(const UAttributeBagStruct* NewBagStru
 		UID = FGuid::NewGuid();
 	}
 	DataStruct = const_cast<UAttributeBagStruct*>(NewBagStruct);
+	ArrayReplicationStates.Reset();
 }
 
 const UAttributeBagStruct* FAttributeDynamicBag::GetAttributeBagStruct() const
@@ -670,33 +676,6 @@ bool FAttributeDynamicBag::NetDeltaSerialize(FNetDeltaSerializeInfo& deltaParms)
 	return Super::NetDeltaSerialize(deltaParms);
 }
 
-bool FAttributeDynamicBag::NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map, const FNetBitArray& Changes)
-{
-	uint8* data = GetMutableMemory();
-	int32 PropNum = GetPropertyNum();
-
-	for (FNetBitArray::FIterator It(Changes); It; ++It)
-	{
-		int32 index = *It;
-
-		if (index >= PropNum)
-		{
-			break;
-		}
-
-		const FAttributeBagPropertyDesc* PropertyDesc = FindPropertyDescByIndex(index);
-		NetSerializeItem(PropertyDesc->CachedProperty, Ar, Map, data + PropertyDesc->CachedProperty->GetOffset_ForInternal());
-		MarkDirty(index, true);
-
-		if (Ar.IsError())
-		{
-			return false;
-		}
-	}
-
-	return true;
-}
-
 const void* FAttributeDynamicBag::GetValueAddress(const FAttributeBagPropertyDesc* Desc) const
 {
 	if (Desc == nullptr || !IsDataValid())
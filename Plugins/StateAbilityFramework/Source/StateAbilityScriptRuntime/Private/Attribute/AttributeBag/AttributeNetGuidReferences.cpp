@@ -0,0 +1,250 @@
+#include "Attribute/AttributeBag/AttributeNetGuidReferences.h"
+
+#include "Algo/BinarySearch.h"
+#include "Engine/PackageMapClient.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAttributeBag, Log, All);
+
+namespace AttributeNetGuid
+{
+	FORCEINLINE uint64 MakeKey(uint16 PropIndex, int32 ElementID)
+	{
+		return ((uint64)PropIndex << 32) | (uint32)ElementID;
+	}
+
+	template<typename ArrayType>
+	FORCEINLINE int32 LowerBound(const ArrayType& Array, uint64 Key)
+	{
+		return Algo::LowerBoundBy(Array, Key, [](const auto& Item) { return Item.GetKey(); });
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FAttributeNetGuidReferences
+void FAttributeNetGuidReferences::Set(uint16 PropIndex, int32 ElementID, const TSet<FNetworkGUID>& UnmappedGUIDs, const TSet<FNetworkGUID>& MappedDynamicGUIDs, TArray<uint8>&& Buffer, int32 NumBufferBits)
+{
+	Remove(PropIndex, ElementID);
+
+	const int32 GUIDNum = UnmappedGUIDs.Num() + MappedDynamicGUIDs.Num();
+	if (GUIDNum == 0)
+	{
+		return;
+	}
+
+	const uint64 Key = AttributeNetGuid::MakeKey(PropIndex, ElementID);
+
+	int32 Index = AttributeNetGuid::LowerBound(References, Key);
+	References.InsertDefaulted(Index, GUIDNum);
+	for (const FNetworkGUID& GUID : UnmappedGUIDs)
+	{
+		References[Index++] = { PropIndex, ElementID, GUID, false };
+	}
+	for (const FNetworkGUID& GUID : MappedDynamicGUIDs)
+	{
+		References[Index++] = { PropIndex, ElementID, GUID, true };
+	}
+
+	const int32 BufferIndex = AttributeNetGuid::LowerBound(Buffers, Key);
+	FAttributeNetGuidBuffer& NewBuffer = Buffers.InsertDefaulted_GetRef(BufferIndex);
+	NewBuffer.PropIndex = PropIndex;
+	NewBuffer.ElementID = ElementID;
+	NewBuffer.Buffer = MoveTemp(Buffer);
+	NewBuffer.NumBufferBits = NumBufferBits;
+}
+
+void FAttributeNetGuidReferences::Remove(uint16 PropIndex, int32 ElementID)
+{
+	const uint64 Key = AttributeNetGuid::MakeKey(PropIndex, ElementID);
+
+	const int32 First = AttributeNetGuid::LowerBound(References, Key);
+	int32 Last = First;
+	while (Last < References.Num() && References[Last].GetKey() == Key)
+	{
+		++Last;
+	}
+	if (Last > First)
+	{
+		References.RemoveAt(First, Last - First, EAllowShrinking::No);
+	}
+
+	const int32 BufferIndex = AttributeNetGuid::LowerBound(Buffers, Key);
+	if (Buffers.IsValidIndex(BufferIndex) && Buffers[BufferIndex].GetKey() == Key)
+	{
+		Buffers.RemoveAt(BufferIndex, 1, EAllowShrinking::No);
+	}
+}
+
+void FAttributeNetGuidReferences::RemoveProperty(uint16 PropIndex)
+{
+	const uint64 FirstKey = AttributeNetGuid::MakeKey(PropIndex, 0);
+	const uint64 EndKey = AttributeNetGuid::MakeKey(PropIndex, 0) + (uint64(1) << 32);
+
+	const int32 First = AttributeNetGuid::LowerBound(References, FirstKey);
+	const int32 Last = AttributeNetGuid::LowerBound(References, EndKey);
+	if (Last > First)
+	{
+		References.RemoveAt(First, Last - First, EAllowShrinking::No);
+	}
+
+	const int32 FirstBuffer = AttributeNetGuid::LowerBound(Buffers, FirstKey);
+	const int32 LastBuffer = AttributeNetGuid::LowerBound(Buffers, EndKey);
+	if (LastBuffer > FirstBuffer)
+	{
+		Buffers.RemoveAt(FirstBuffer, LastBuffer - FirstBuffer, EAllowShrinking::No);
+	}
+}
+
+void FAttributeNetGuidReferences::Reset()
+{
+	References.Reset();
+	Buffers.Reset();
+}
+
+const FAttributeNetGuidBuffer* FAttributeNetGuidReferences::FindBuffer(uint16 PropIndex, int32 ElementID) const
+{
+	const uint64 Key = AttributeNetGuid::MakeKey(PropIndex, ElementID);
+	const int32 Index = AttributeNetGuid::LowerBound(Buffers, Key);
+	return Buffers.IsValidIndex(Index) && Buffers[Index].GetKey() == Key ? &Buffers[Index] : nullptr;
+}
+
+void FAttributeNetGuidReferences::Gather(TSet<FNetworkGUID>& OutGUIDs) const
+{
+	for (const FAttributeNetGuidRef& Reference : References)
+	{
+		OutGUIDs.Add(Reference.NetGUID);
+	}
+}
+
+bool FAttributeNetGuidReferences::MoveToUnmapped(const FNetworkGUID& GUID)
+{
+	bool bFound = false;
+	for (FAttributeNetGuidRef& Reference : References)
+	{
+		if (Reference.bMapped && Reference.NetGUID == GUID)
+		{
+			Reference.bMapped = false;
+			bFound = true;
+		}
+	}
+	return bFound;
+}
+
+void FAttributeNetGuidReferences::UpdateUnmapped(UPackageMap* Map, TFunctionRef<void(const FAttributeNetGuidBuffer& Buffer)> OnMapped)
+{
+	// 映射了新 guid 的 Key，References 有序，相同的 Key 连续出现
+	TArray<uint64, TInlineAllocator<16>> MappedKeys;
+
+	int32 WriteIndex = 0;
+	for (int32 ReadIndex = 0; ReadIndex < References.Num(); ++ReadIndex)
+	{
+		FAttributeNetGuidRef& Reference = References[ReadIndex];
+		bool bKeep = true;
+
+		if (!Reference.bMapped)
+		{
+			if (Map->IsGUIDBroken(Reference.NetGUID, false))
+			{
+				// 停止加载损坏的guids
+				UE_LOG(LogAttributeBag, Warning, TEXT("AttributeBagNetSerialization: Broken GUID. NetGuid: %s"), *Reference.NetGUID.ToString());
+				bKeep = false;
+			}
+			else if (Map->GetObjectFromNetGUID(Reference.NetGUID, false) != nullptr)
+			{
+				// 动态对象继续追踪，以便对象销毁后重新变为未映射
+				bKeep = Reference.NetGUID.IsDynamic();
+				Reference.bMapped = true;
+
+				const uint64 Key = Reference.GetKey();
+				if (MappedKeys.Num() == 0 || MappedKeys.Last() != Key)
+				{
+					MappedKeys.Add(Key);
+				}
+			}
+		}
+
+		if (bKeep)
+		{
+			if (WriteIndex != ReadIndex)
+			{
+				References[WriteIndex] = MoveTemp(Reference);
+			}
+			++WriteIndex;
+		}
+	}
+	References.SetNum(WriteIndex, EAllowShrinking::No);
+
+	// 检查是否映射了任何guids。如果这样做了，可以再次序列化该元素，这一次将加载它
+	for (const uint64 Key : MappedKeys)
+	{
+		const int32 BufferIndex = AttributeNetGuid::LowerBound(Buffers, Key);
+		if (Buffers.IsValidIndex(BufferIndex) && Buffers[BufferIndex].GetKey() == Key)
+		{
+			OnMapped(Buffers[BufferIndex]);
+		}
+	}
+
+	// 没有引用的 Key 不再需要重新读取，两个数组都有序，一次合并遍历即可
+	int32 ReferenceIndex = 0;
+	WriteIndex = 0;
+	for (int32 ReadIndex = 0; ReadIndex < Buffers.Num(); ++ReadIndex)
+	{
+		const uint64 Key = Buffers[ReadIndex].GetKey();
+		while (ReferenceIndex < References.Num() && References[ReferenceIndex].GetKey() < Key)
+		{
+			++ReferenceIndex;
+		}
+
+		if (ReferenceIndex < References.Num() && References[ReferenceIndex].GetKey() == Key)
+		{
+			if (WriteIndex != ReadIndex)
+			{
+				Buffers[WriteIndex] = MoveTemp(Buffers[ReadIndex]);
+			}
+			++WriteIndex;
+		}
+	}
+	Buffers.SetNum(WriteIndex, EAllowShrinking::No);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FAttributeNetGuidTrackingScope
+FAttributeNetGuidTrackingScope::FAttributeNetGuidTrackingScope(FAttributeNetGuidReferences* InReferences, UPackageMap* Map, FBitReader& InReader, uint16 InPropIndex, int32 InElementID)
+	: References(InReferences)
+	, MapClient(InReferences ? Cast<UPackageMapClient>(Map) : nullptr)
+	, Reader(InReader)
+	, Mark(InReader)
+	, PropIndex(InPropIndex)
+	, ElementID(InElementID)
+{
+	if (MapClient)
+	{
+		MapClient->ResetTrackedGuids(true);
+	}
+}
+
+FAttributeNetGuidTrackingScope::~FAttributeNetGuidTrackingScope()
+{
+	if (!MapClient)
+	{
+		return;
+	}
+
+	if (!Reader.IsError())
+	{
+		const TSet<FNetworkGUID>& TrackedUnmappedGUIDs = MapClient->GetTrackedUnmappedGuids();
+		const TSet<FNetworkGUID>& TrackedDynamicGUIDs = MapClient->GetTrackedDynamicMappedGuids();
+		if (TrackedUnmappedGUIDs.Num() > 0 || TrackedDynamicGUIDs.Num() > 0)
+		{
+			TArray<uint8> Buffer;
+			const int32 NumBufferBits = (int32)(Reader.GetPosBits() - Mark.GetPos());
+			Mark.Copy(Reader, Buffer);
+			References->Set(PropIndex, ElementID, TrackedUnmappedGUIDs, TrackedDynamicGUIDs, MoveTemp(Buffer), NumBufferBits);
+		}
+		else
+		{
+			References->Remove(PropIndex, ElementID);
+		}
+	}
+
+	MapClient->ResetTrackedGuids(false);
+}
@@ -8,6 +8,13 @@ const FBindEntryHandle FBindEntry::InValidHandle;
 TSet<const FAttributeBindTracker*> FAttributeBindEffect::GlobalActiveTracker;
 TArray<FAttributeBindEffect::FEffectInfo> FAttributeBindEffect::GlobalActiveEffectStack;
 
+int32 FAttributeBindBatch::BatchDepth = 0;
+bool FAttributeBindBatch::bFlushing = false;
+int32 FAttributeBindBatch::FlushingHeight = INDEX_NONE;
+uint32 FAttributeBindBatch::PendingOrder = 0;
+TMap<FAttributeBindBatch::FPendingKey, uint16> FAttributeBindBatch::PendingHeights;
+TArray<FAttributeBindBatch::FPendingEntry> FAttributeBindBatch::PendingHeap;
+
 FBindEntryHandle FBindEntry::GenerateHandle(int32 LayerID, int32 Index)
 {
 	uint64 NewSerialNumber = ++GlobalSerialNumber;
@@ -31,6 +38,132 @@ void FBindEntryContainer::Allocate(int32 EntryCount)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+// FAttributeBindBatch
+void FAttributeBindBatch::Begin()
+{
+	++BatchDepth;
+}
+
+void FAttributeBindBatch::End()
+{
+	if (!ensureMsgf(BatchDepth > 0, TEXT("FAttributeBindBatch::End without Begin!")))
+	{
+		return;
+	}
+
+	// 广播期间仍处于批量中，监听者的修改继续进入 PendingHeap
+	if (BatchDepth == 1)
+	{
+		Flush();
+	}
+	--BatchDepth;
+}
+
+void FAttributeBindBatch::Flush()
+{
+	// 广播中再次 Flush（例如监听者内打开了批量作用域）由外层的循环继续处理
+	if (bFlushing)
+	{
+		return;
+	}
+
+	TGuardValue<bool> FlushingGuard(bFlushing, true);
+
+	int32 BroadcastNum = 0;
+	while (PendingHeap.Num() > 0)
+	{
+		FPendingEntry Entry;
+		PendingHeap.HeapPop(Entry, EAllowShrinking::No);
+
+		// 已被更深的标记取代，或 Tracker 已销毁
+		const uint16* Height = PendingHeights.Find(FPendingKey(Entry.Tracker, Entry.LayerID));
+		if (!Height || *Height != Entry.Height)
+		{
+			continue;
+		}
+		PendingHeights.Remove(FPendingKey(Entry.Tracker, Entry.LayerID));
+		--Entry.Tracker->BatchPendingNum;
+
+		if (!ensureMsgf(++BroadcastNum <= MaxFlushBroadcastNum, TEXT("FAttributeBindBatch::Flush does not converge, there may be a circular dependency between attributes!")))
+		{
+			for (const FPendingEntry& Remaining : PendingHeap)
+			{
+				if (PendingHeights.Remove(FPendingKey(Remaining.Tracker, Remaining.LayerID)) > 0)
+				{
+					--Remaining.Tracker->BatchPendingNum;
+				}
+			}
+			PendingHeap.Reset();
+			break;
+		}
+
+		TGuardValue<int32> HeightGuard(FlushingHeight, Entry.Height);
+		Entry.Tracker->GetBindEntry(Entry.LayerID).Broadcast();
+	}
+
+	PendingOrder = 0;
+}
+
+int32 FAttributeBindBatch::Suspend()
+{
+	Flush();
+
+	const int32 SuspendedDepth = BatchDepth;
+	BatchDepth = 0;
+	return SuspendedDepth;
+}
+
+void FAttributeBindBatch::Resume(int32 SuspendedDepth)
+{
+	ensureMsgf(BatchDepth == 0, TEXT("FAttributeBindBatch::Resume with unbalanced Begin/End!"));
+	BatchDepth = SuspendedDepth;
+}
+
+void FAttributeBindBatch::MarkPending(const FAttributeBindTracker* Tracker, int32 LayerID)
+{
+	FBindEntry& BindEntry = Tracker->GetBindEntry(LayerID);
+
+	// 在某个 BindEntry 的广播中被修改，说明依赖于它，深度至少比它大1
+	if (FlushingHeight != INDEX_NONE && BindEntry.BatchHeight <= FlushingHeight)
+	{
+		BindEntry.BatchHeight = (uint16)FMath::Min<int32>(FlushingHeight + 1, MaxBatchHeight);
+	}
+
+	const FPendingKey Key(Tracker, LayerID);
+	if (uint16* Height = PendingHeights.Find(Key))
+	{
+		if (*Height >= BindEntry.BatchHeight)
+		{
+			return;
+		}
+		// 深度变大，旧的堆项过期
+		*Height = BindEntry.BatchHeight;
+	}
+	else
+	{
+		PendingHeights.Add(Key, BindEntry.BatchHeight);
+		++Tracker->BatchPendingNum;
+	}
+
+	PendingHeap.HeapPush({ Tracker, LayerID, BindEntry.BatchHeight, PendingOrder++ });
+}
+
+void FAttributeBindBatch::RemoveTracker(const FAttributeBindTracker* Tracker)
+{
+	// 只移除 PendingHeights，PendingHeap 中的项在 Flush 时因找不到而跳过
+	for (auto It = PendingHeights.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Key == Tracker)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	Tracker->BatchPendingNum = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FAttributeBindEffect
 FAttributeBindEffect::FAttributeBindEffect(FAttributeBindEffect&& Other)
 	: _Owner(Other._Owner)
 	, _Handle(Other._Handle)
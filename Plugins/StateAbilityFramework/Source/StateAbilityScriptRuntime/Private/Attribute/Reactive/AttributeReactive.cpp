@@ -23,6 +23,12 @@ void FReactiveModelBase::OnGetAttributeValue(int32 LayerID) const
 
 void FReactiveModelBase::OnSetAttributeValue(int32 LayerID)
 {
+	if (FAttributeBindBatch::IsBatching())
+	{
+		FAttributeBindBatch::MarkPending(this, LayerID);
+		return;
+	}
+
 	FBindEntry& BindEntry = GetBindEntry(LayerID);
 	BindEntry.Broadcast();
 }
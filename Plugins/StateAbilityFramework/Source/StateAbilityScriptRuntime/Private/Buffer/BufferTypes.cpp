@@ -1,11 +1,106 @@
 #include "Buffer/BufferTypes.h"
 
+#include "Hash/xxhash.h"
+#include "UObject/UnrealType.h"
+
+DEFINE_STAT(STAT_CommandFrameSnapshotHeapAllocations);
+
+namespace
+{
+	FORCEINLINE uint64 HashBytes(const void* Data, SIZE_T Size, uint64 Seed)
+	{
+		return FXxHash64::HashBufferWithSeed(Data, Size, Seed).Hash;
+	}
+
+	// ComparisonIndex 只在本进程内有效，每个名字只在第一次遇到时按小写字符串计算一次跨进程一致的哈希
+	uint64 GetStableNameHash(FName Name)
+	{
+		static thread_local TMap<FNameEntryId, uint64> StableNameHashes;
+
+		const FNameEntryId ComparisonIndex = Name.GetComparisonIndex();
+		if (const uint64* NameHash = StableNameHashes.Find(ComparisonIndex))
+		{
+			return *NameHash;
+		}
+
+		const FString NameString = Name.GetPlainNameString().ToLower();
+		return StableNameHashes.Add(ComparisonIndex, FXxHash64::HashBuffer(*NameString, NameString.Len() * sizeof(TCHAR)).Hash);
+	}
+
+	uint64 HashPropertyValue(const FProperty* Property, const uint8* ValuePtr, uint64 Seed)
+	{
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			return FCommandFrameAttributeSnapshot::HashStruct(StructProperty->Struct, ValuePtr, Seed);
+		}
+		else if (const FFloatProperty* FloatProperty = CastField<FFloatProperty>(Property))
+		{
+			// -0 与 0 在数值上相同，统一为 0
+			const float Value = FloatProperty->GetPropertyValue(ValuePtr);
+			const float Normalized = Value == 0.0f ? 0.0f : Value;
+			return HashBytes(&Normalized, sizeof(Normalized), Seed);
+		}
+		else if (const FDoubleProperty* DoubleProperty = CastField<FDoubleProperty>(Property))
+		{
+			const double Value = DoubleProperty->GetPropertyValue(ValuePtr);
+			const double Normalized = Value == 0.0 ? 0.0 : Value;
+			return HashBytes(&Normalized, sizeof(Normalized), Seed);
+		}
+		else if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+		{
+			const uint8 Value = BoolProperty->GetPropertyValue(ValuePtr) ? 1 : 0;
+			return HashBytes(&Value, sizeof(Value), Seed);
+		}
+		else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			return HashPropertyValue(EnumProperty->GetUnderlyingProperty(), ValuePtr, Seed);
+		}
+		else if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+		{
+			return HashBytes(ValuePtr, NumericProperty->ElementSize, Seed);
+		}
+		else if (const FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+		{
+			// 按 ComparisonIndex 缓存的名字哈希加上 Number，与字符串（忽略大小写）比较的结果一致
+			const FName Name = NameProperty->GetPropertyValue(ValuePtr);
+			if (Name.IsNone())
+			{
+				return HashBytes(&Seed, sizeof(Seed), Seed);
+			}
+
+			const uint64 NameHash[2] = { GetStableNameHash(Name), (uint64)Name.GetNumber() };
+			return HashBytes(NameHash, sizeof(NameHash), Seed);
+		}
+		else if (const FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+		{
+			const FString& Value = StrProperty->GetPropertyValue(ValuePtr);
+			return HashBytes(*Value, Value.Len() * sizeof(TCHAR), Seed);
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper ArrayHelper(ArrayProperty, ValuePtr);
+
+			const int32 Num = ArrayHelper.Num();
+			Seed = HashBytes(&Num, sizeof(Num), Seed);
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Seed = HashPropertyValue(ArrayProperty->Inner, ArrayHelper.GetRawPtr(Index), Seed);
+			}
+			return Seed;
+		}
+
+		// 对象引用、委托、Set/Map等，在客户端与服务器之间没有可比较的值
+		return Seed;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FCommandFrameInputFrame
 FCommandFrameInputFrame::FCommandFrameInputFrame()
 	: CommandFrame(0)
 {
 	SharedSerialization.SetAllowResize(true);
+	DeltaSerialization.SetAllowResize(true);
 }
 
 void FCommandFrameInputFrame::AddItem(const FUniqueNetIdRepl& Key, const TArray<FCommandFrameInputAtom>& ItemData)
@@ -45,6 +140,7 @@ void FCommandFrameInputFrame::Reset(uint32 InCommandFrame)
 	OrderCounter.Reset();
 
 	SharedSerialization.Reset();
+	DeltaSerialization.Reset();
 }
 
 void FCommandFrameInputFrame::Release(uint32 InCommandFrame)
@@ -55,6 +151,7 @@ void FCommandFrameInputFrame::Release(uint32 InCommandFrame)
 	OrderCounter.Empty();
 
 	SharedSerialization.Reset();
+	DeltaSerialization.Reset();
 }
 
 bool FCommandFrameInputFrame::Verify(uint32 InCommandFrame)
@@ -73,6 +170,145 @@ bool FCommandFrameInputFrame::HasOwnerShip(const FUniqueNetIdRepl& Key)
 	return OrderCounter.Contains(Key);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// FCommandFrameSnapshotArena
+uint8* FCommandFrameSnapshotArena::Allocate(SIZE_T Size, uint32 Alignment)
+{
+	RequiredSize += Size + Alignment - 1;
+
+	const SIZE_T AlignedOffset = Align(Offset, (SIZE_T)Alignment);
+	if (Block && AlignedOffset + Size <= BlockSize)
+	{
+		Offset = AlignedOffset + Size;
+		return Block + AlignedOffset;
+	}
+
+	// 当前块不足，先用溢出块顶上，下一次Reset时再扩容
+	uint8* Memory = AllocateFromHeap(Size, Alignment);
+	OverflowBlocks.Add(Memory);
+	return Memory;
+}
+
+void FCommandFrameSnapshotArena::Reset()
+{
+	for (uint8* Memory : OverflowBlocks)
+	{
+		FMemory::Free(Memory);
+	}
+	OverflowBlocks.Reset();
+
+	if (RequiredSize > BlockSize)
+	{
+		if (Block)
+		{
+			FMemory::Free(Block);
+		}
+
+		BlockSize = FMath::RoundUpToPowerOfTwo64(RequiredSize);
+		Block = AllocateFromHeap(BlockSize, 16);
+	}
+
+	Offset = 0;
+	RequiredSize = 0;
+}
+
+void FCommandFrameSnapshotArena::Release()
+{
+	for (uint8* Memory : OverflowBlocks)
+	{
+		FMemory::Free(Memory);
+	}
+	OverflowBlocks.Empty();
+
+	if (Block)
+	{
+		FMemory::Free(Block);
+	}
+
+	Block = nullptr;
+	BlockSize = 0;
+	Offset = 0;
+	RequiredSize = 0;
+}
+
+uint8* FCommandFrameSnapshotArena::AllocateFromHeap(SIZE_T Size, uint32 Alignment)
+{
+	++HeapAllocationNum;
+	INC_DWORD_STAT(STAT_CommandFrameSnapshotHeapAllocations);
+
+	return (uint8*)FMemory::Malloc(FMath::Max<SIZE_T>(1, Size), Alignment);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FCommandFrameAttributeColumn
+void FCommandFrameAttributeColumn::Init(const UScriptStruct* InStruct)
+{
+	Struct = InStruct;
+	Stride = Align(FMath::Max(1, Struct->GetStructureSize()), Struct->GetMinAlignment());
+	bPlainOldData = (Struct->StructFlags & STRUCT_IsPlainOldData) != 0;
+	bNoDestructor = bPlainOldData || (Struct->StructFlags & STRUCT_NoDestructor) != 0;
+}
+
+void FCommandFrameAttributeColumn::Reserve(FCommandFrameSnapshotArena& Arena, int32 EntityNum)
+{
+	if (EntityNum <= Capacity)
+	{
+		return;
+	}
+
+	const int32 NewCapacity = FMath::Max3(8, (int32)FMath::RoundUpToPowerOfTwo(EntityNum), CapacityHint);
+	uint8* NewMemory = Arena.Allocate((SIZE_T)Stride * NewCapacity, Struct->GetMinAlignment());
+
+	// 旧的内存留在Arena内，随槽位回收一起释放
+	if (Memory)
+	{
+		if (bPlainOldData)
+		{
+			FMemory::Memcpy(NewMemory, Memory, (SIZE_T)Stride * Capacity);
+		}
+		else
+		{
+			for (TConstSetBitIterator<> It(UsedEntity); It; ++It)
+			{
+				uint8* NewItem = NewMemory + (SIZE_T)It.GetIndex() * Stride;
+				Struct->InitializeStruct(NewItem);
+				Struct->CopyScriptStruct(NewItem, GetItem(It.GetIndex()));
+				if (!bNoDestructor)
+				{
+					Struct->DestroyStruct(GetItem(It.GetIndex()));
+				}
+			}
+		}
+	}
+
+	Memory = NewMemory;
+	Capacity = NewCapacity;
+	CapacityHint = NewCapacity;
+	UsedEntity.SetNum(Capacity, false);
+}
+
+void FCommandFrameAttributeColumn::DestroyItems()
+{
+	if (!bNoDestructor)
+	{
+		for (TConstSetBitIterator<> It(UsedEntity); It; ++It)
+		{
+			Struct->DestroyStruct(GetItem(It.GetIndex()));
+		}
+	}
+
+	UsedEntity.SetRange(0, UsedEntity.Num(), false);
+}
+
+void FCommandFrameAttributeColumn::Reset()
+{
+	DestroyItems();
+
+	// 内存由Arena统一回收
+	Memory = nullptr;
+	Capacity = 0;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FCommandFrameAttributeSnapshot
 FCommandFrameAttributeSnapshot::FCommandFrameAttributeSnapshot()
@@ -81,54 +317,68 @@ FCommandFrameAttributeSnapshot::FCommandFrameAttributeSnapshot()
 	
 }
 
-void FCommandFrameAttributeSnapshot::AddItem(const UScriptStruct* Key, const uint8* const & ItemData)
+void FCommandFrameAttributeSnapshot::AddItem(const FCommandFrameSnapshotKey& Key, const uint8* const & ItemData)
 {
 	// 每个Key只允许被加入一次
 	// 如果ItemData数量为0，则不加入
-	if (Key != nullptr && ItemData != nullptr && !UsedKey.Contains(Key))
+	if (Key.Struct != nullptr && ItemData != nullptr)
 	{
-		uint8* Memory = AllocateItem(Key, 0);
-
-		Key->CopyScriptStruct(Memory, ItemData);
+		// 随后会被整体覆盖，POD 类型不需要先初始化
+		if (uint8* Memory = AllocateItemInternal(Key, false))
+		{
+			Key.Struct->CopyScriptStruct(Memory, ItemData);
+		}
 	}
 }
 
-uint8* FCommandFrameAttributeSnapshot::AllocateItem(const UScriptStruct* Key, uint32 DataSize)
+uint8* FCommandFrameAttributeSnapshot::AllocateItem(const FCommandFrameSnapshotKey& Key, uint32 DataSize)
 {
 	// DataSize 是无效参数
+	return AllocateItemInternal(Key, true);
+}
 
-	if (!UsedKey.Contains(Key))
+uint8* FCommandFrameAttributeSnapshot::AllocateItemInternal(const FCommandFrameSnapshotKey& Key, bool bInitialize)
+{
+	if (Key.Struct == nullptr || Key.EntityIndex == INDEX_NONE)
 	{
-		uint8* Memory = nullptr;
-		if (uint8** MemoryPtr = MemoryBuffer.Find(Key))
-		{
-			Memory = *MemoryPtr;
-			Key->DestroyStruct(Memory);
-		}
-		else
-		{
-			const int32 MinAlignment = Key->GetMinAlignment();
-			const int32 RequiredSize = Key->GetStructureSize();
-			Memory = ((uint8*)FMemory::Malloc(FMath::Max(1, RequiredSize), MinAlignment));
-		}
+		return nullptr;
+	}
+
+	FCommandFrameAttributeColumn& Column = MemoryBuffer.FindOrAdd(Key.Struct);
+	if (!Column.Struct)
+	{
+		Column.Init(Key.Struct);
+	}
 
-		Key->InitializeStruct(Memory);
+	if (Column.IsUsed(Key.EntityIndex))
+	{
+		return nullptr;
+	}
 
-		MemoryBuffer.Add(Key, Memory);
-		UsedKey.Add(Key);
+	Column.Reserve(Arena, Key.EntityIndex + 1);
 
-		return Memory;
+	uint8* Memory = Column.GetItem(Key.EntityIndex);
+	if (bInitialize || !Column.bPlainOldData)
+	{
+		Key.Struct->InitializeStruct(Memory);
 	}
-	return nullptr;
+
+	Column.UsedEntity[Key.EntityIndex] = true;
+
+	return Memory;
 }
 
 void FCommandFrameAttributeSnapshot::Reset(uint32 InCommandFrame)
 {
 	CommandFrame = InCommandFrame;
 	
-	// Empty 会释放空间
-	// MemoryBuffer.Reset();
-	UsedKey.Reset();
+	// 保留列信息，内存由Arena整体回收
+	for (auto& Pair : MemoryBuffer)
+	{
+		Pair.Value.Reset();
+	}
+
+	Arena.Reset();
 }
 
 void FCommandFrameAttributeSnapshot::Release(uint32 InCommandFrame)
@@ -137,11 +387,11 @@ void FCommandFrameAttributeSnapshot::Release(uint32 InCommandFrame)
 
 	for (auto& Pair : MemoryBuffer)
 	{
-		FMemory::Free(Pair.Value);
+		Pair.Value.Reset();
 	}
 
 	MemoryBuffer.Empty();
-	UsedKey.Empty();
+	Arena.Release();
 }
 
 bool FCommandFrameAttributeSnapshot::Verify(uint32 InCommandFrame)
@@ -155,20 +405,111 @@ bool FCommandFrameAttributeSnapshot::Verify(uint32 InCommandFrame)
 	return true;
 }
 
-bool FCommandFrameAttributeSnapshot::HasOwnerShip(const UScriptStruct* Key)
+bool FCommandFrameAttributeSnapshot::HasOwnerShip(const FCommandFrameSnapshotKey& Key)
 {
-	return UsedKey.Contains(Key);
+	if (const FCommandFrameAttributeColumn* Column = MemoryBuffer.Find(Key.Struct))
+	{
+		return Column->IsUsed(Key.EntityIndex);
+	}
+
+	return false;
 }
 
-uint8* FCommandFrameAttributeSnapshot::ReadItemData(const UScriptStruct* Key)
+uint8* FCommandFrameAttributeSnapshot::ReadItemData(const FCommandFrameSnapshotKey& Key)
 {
-	if (UsedKey.Contains(Key))
+	if (const FCommandFrameAttributeColumn* Column = MemoryBuffer.Find(Key.Struct))
 	{
-		if (uint8** MemoryPtr = MemoryBuffer.Find(Key))
+		if (Column->IsUsed(Key.EntityIndex))
 		{
-			return *MemoryPtr;
+			return Column->GetItem(Key.EntityIndex);
 		}
 	}
 
 	return nullptr;
-}
\ No newline at end of file
+}
+
+uint8* FCommandFrameAttributeSnapshot::ReadColumnData(const UScriptStruct* Struct, int32& OutEntityNum)
+{
+	if (const FCommandFrameAttributeColumn* Column = MemoryBuffer.Find(Struct))
+	{
+		OutEntityNum = Column->Capacity;
+		return Column->Memory;
+	}
+
+	OutEntityNum = 0;
+	return nullptr;
+}
+
+void FCommandFrameAttributeSnapshot::CopyColumn(const FCommandFrameAttributeSnapshot& Source, const UScriptStruct* Struct)
+{
+	const FCommandFrameAttributeColumn* SourceColumn = Source.MemoryBuffer.Find(Struct);
+	if (!SourceColumn || !SourceColumn->Memory)
+	{
+		return;
+	}
+
+	FCommandFrameAttributeColumn& Column = MemoryBuffer.FindOrAdd(Struct);
+	if (!Column.Struct)
+	{
+		Column.Init(Struct);
+	}
+
+	Column.DestroyItems();
+	Column.Reserve(Arena, SourceColumn->Capacity);
+
+	if (Column.bPlainOldData)
+	{
+		// POD 类型整列拷贝
+		FMemory::Memcpy(Column.Memory, SourceColumn->Memory, (SIZE_T)SourceColumn->Stride * SourceColumn->Capacity);
+	}
+	else
+	{
+		for (TConstSetBitIterator<> It(SourceColumn->UsedEntity); It; ++It)
+		{
+			uint8* Item = Column.GetItem(It.GetIndex());
+			Struct->InitializeStruct(Item);
+			Struct->CopyScriptStruct(Item, SourceColumn->GetItem(It.GetIndex()));
+		}
+	}
+
+	for (TConstSetBitIterator<> It(SourceColumn->UsedEntity); It; ++It)
+	{
+		Column.UsedEntity[It.GetIndex()] = true;
+	}
+}
+
+uint64 FCommandFrameAttributeSnapshot::CalcChecksum(TConstArrayView<FCommandFrameSnapshotKey> Keys) const
+{
+	uint64 Checksum = 0;
+
+	for (const FCommandFrameSnapshotKey& Key : Keys)
+	{
+		const FCommandFrameAttributeColumn* Column = MemoryBuffer.Find(Key.Struct);
+		if (Column && Column->IsUsed(Key.EntityIndex))
+		{
+			Checksum = HashStruct(Key.Struct, Column->GetItem(Key.EntityIndex), Checksum);
+		}
+		else
+		{
+			// 未写入的实体同样需要改变结果
+			const uint64 Unwritten = MAX_uint64;
+			Checksum = HashBytes(&Unwritten, sizeof(Unwritten), Checksum);
+		}
+	}
+
+	return Checksum;
+}
+
+uint64 FCommandFrameAttributeSnapshot::HashStruct(const UScriptStruct* Struct, const uint8* Data, uint64 Seed)
+{
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		const FProperty* Property = *It;
+		for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+		{
+			Seed = HashPropertyValue(Property, Property->ContainerPtrToValuePtr<uint8>(Data, Index), Seed);
+		}
+	}
+
+	return Seed;
+}
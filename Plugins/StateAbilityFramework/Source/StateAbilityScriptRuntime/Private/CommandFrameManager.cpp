@@ -6,6 +6,7 @@
 
 #include "CommandFrameSetting.h"
 #include "Net/CommandEnhancedInput.h"
+#include "Attribute/Reactive/AttributeBinding.h"
 
 // @TODO: Manager本身不应该直接使用这个
 #include "Net/CommandFrameNetChannel.h"
@@ -27,6 +28,12 @@ const uint32 UCommandFrameManager::MAX_SNAPSHOTBUFFER_NUM = 32;
 
 const float UCommandFrameManager::FixedFrameRate = 30.0f;
 
+bool bEnableSelectiveReplay = true;
+FAutoConsoleVariableRef CVarCFrame_Rewind_SelectiveReplay(TEXT("CFrame.Rewind.SelectiveReplay"), bEnableSelectiveReplay, TEXT("If true, ReplayFrames only fires OnBeginFrame/OnEndFrame for the entities marked dirty by the net procedures and their dependents."));
+
+bool bEnableAttributeBatchNotify = true;
+FAutoConsoleVariableRef CVarCFrame_Attribute_BatchNotify(TEXT("CFrame.Attribute.BatchNotify"), bEnableAttributeBatchNotify, TEXT("If true, reactive attribute notifications raised while ending a frame are coalesced and broadcast once per bind entry after OnPostEndFrame."));
+
 // 统一以秒（s）为时间单位
 
 namespace CFrameUtils
@@ -73,6 +80,114 @@ FName FCommandFrameTickFunction::DiagnosticContext(bool bDetailed)
 	return FName(TEXT("CommandFrameTick"));
 }
 
+//////////////////////////////////////////////////////////////////////////
+// FOnFixedUpdate
+
+FDelegateHandle FOnFixedUpdate::Add(FOnFixedUpdateSingle&& InDelegate)
+{
+	FDelegateHandle Handle = InDelegate.GetHandle();
+	if (InDelegate.IsBound())
+	{
+		InvocationList.Add(MoveTemp(InDelegate));
+	}
+
+	return Handle;
+}
+
+bool FOnFixedUpdate::Remove(FDelegateHandle Handle)
+{
+	for (FOnFixedUpdateSingle& Delegate : InvocationList)
+	{
+		if (Delegate.GetHandle() == Handle)
+		{
+			Delegate.Unbind();
+			bNeedsCompact = true;
+			CompactInvocationList();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 FOnFixedUpdate::RemoveAll(const void* InUserObject)
+{
+	int32 RemovedNum = 0;
+	for (FOnFixedUpdateSingle& Delegate : InvocationList)
+	{
+		if (Delegate.IsBoundToObject(InUserObject))
+		{
+			Delegate.Unbind();
+			++RemovedNum;
+		}
+	}
+
+	if (RemovedNum)
+	{
+		bNeedsCompact = true;
+		CompactInvocationList();
+	}
+
+	return RemovedNum;
+}
+
+bool FOnFixedUpdate::IsBound() const
+{
+	for (const FOnFixedUpdateSingle& Delegate : InvocationList)
+	{
+		if (Delegate.IsBound())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FOnFixedUpdate::Broadcast(float DeltaTime, uint32 RCF, uint32 ICF)
+{
+	++BroadcastDepth;
+
+	// 广播期间新增的绑定从下一次广播开始生效
+	const int32 Num = InvocationList.Num();
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		InvocationList[Index].ExecuteIfBound(DeltaTime, RCF, ICF);
+	}
+
+	--BroadcastDepth;
+	CompactInvocationList();
+}
+
+void FOnFixedUpdate::BroadcastFiltered(float DeltaTime, uint32 RCF, uint32 ICF, TFunctionRef<bool(const UObject*)> Filter)
+{
+	++BroadcastDepth;
+
+	const int32 Num = InvocationList.Num();
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		FOnFixedUpdateSingle& Delegate = InvocationList[Index];
+		if (Delegate.IsBound() && Filter(Delegate.GetUObject()))
+		{
+			Delegate.Execute(DeltaTime, RCF, ICF);
+		}
+	}
+
+	--BroadcastDepth;
+	CompactInvocationList();
+}
+
+void FOnFixedUpdate::CompactInvocationList()
+{
+	if (BroadcastDepth == 0 && bNeedsCompact)
+	{
+		InvocationList.RemoveAll([](const FOnFixedUpdateSingle& Delegate) {
+			return !Delegate.IsBound();
+		});
+		bNeedsCompact = false;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // UCommandFrameManager
 
@@ -88,6 +203,10 @@ UCommandFrameManager::UCommandFrameManager()
 	, PrevCommandFrame(0)
 	, InternalCommandFrame(0)
 	, LocalNetChannel(nullptr)
+	, SnapshotEntityNum(0)
+	, ReleasedSnapshotEntityHead(0)
+	, SnapshotDesyncNum(0)
+	, bReplaying(false)
 {
 
 }
@@ -117,6 +236,9 @@ void UCommandFrameManager::Initialize(FSubsystemCollectionBase& Collection)
 	FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UCommandFrameManager::PostLogin);
 	FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &UCommandFrameManager::LoginOut);
 
+	const UCommandFrameSettings* Settings = GetDefault<UCommandFrameSettings>();
+	InterestManager.Init(Settings->InterestRadius, Settings->InterestHysteresis);
+
 	if (IsValid(GetWorld()))
 	{
 		// 在当前帧，UWorld还未完成初始化。
@@ -257,19 +379,27 @@ void UCommandFrameManager::EndPrevFlushCommandFrame(float DeltaTime)
 			ClientSendInputNetPacket();
 		}
 		
+		// 本帧对属性的修改只标记待通知，OnPostEndFrame 之后统一广播。回滚重放的每一帧在 ReplayFrames 中暂停外层的批量，各自广播
+		FAttributeBindBatchScope AttributeBindBatch(bEnableAttributeBatchNotify);
+
 		// 检查并处理有序的Delta包等，因此这里有可能会触发回滚
 		OnPreEndFrame.Broadcast(DeltaTime, RealCommandFrame, InternalCommandFrame);
 
 		// 移动的Tick 和 状态快照基本会在这里执行
-		OnEndFrame.Broadcast(DeltaTime, RealCommandFrame, InternalCommandFrame);
+		BroadcastFixedUpdate(OnEndFrame, DeltaTime);
 		
 		if (GetWorld()->GetNetMode() == ENetMode::NM_DedicatedServer)
 		{
+			// 派生属性需要在发送前计算完成
+			FAttributeBindBatch::Flush();
 			ServerSendDeltaNetPacket();
 		}
 
 		OnPostEndFrame.Broadcast(DeltaTime, RealCommandFrame, InternalCommandFrame);
 
+		// 不论嵌套的层数，每一帧结束时都广播，之后的帧读到的派生属性与正常帧相同
+		FAttributeBindBatch::Flush();
+
 #if WITH_EDITOR
 		if (GetWorld()->GetNetMode() == ENetMode::NM_Client)
 		{
@@ -297,6 +427,9 @@ void UCommandFrameManager::AdvancedCommandFrame()
 	if (!IsInRewinding())
 	{
 		++RealCommandFrame;
+
+		// 本帧的修正没有触发回滚，标记不能留给之后的 ReplayFrames
+		ReplayDirtyEntities.Reset();
 	}
 	++InternalCommandFrame;
 }
@@ -310,7 +443,7 @@ void UCommandFrameManager::BeginNewFlushCommandFrame(float DeltaTime)
 	//////////////////////////////////////////////////////////////////////////
 	// 处理当前帧
 
-	OnBeginFrame.Broadcast(DeltaTime, RealCommandFrame, InternalCommandFrame);
+	BroadcastFixedUpdate(OnBeginFrame, DeltaTime);
 
 	if (GetWorld()->GetNetMode() == ENetMode::NM_DedicatedServer)
 	{
@@ -341,6 +474,15 @@ void UCommandFrameManager::ReplayFrames(uint32 RewindedFrame)
 
 	TimeDilationHelper.Update(GetWorld(), true);
 
+	BuildReplayEntities();
+	// 标记已转换为 ReplayEntities，回滚期间产生的新标记不会影响本次重新模拟
+	ReplayDirtyEntities.Reset();
+	bReplaying = true;
+
+	// 回滚发生在 OnPreEndFrame 的批量中。重放的帧与正常帧一样：BeginNewFlushCommandFrame 中的修改立即广播，
+	// EndPrevFlushCommandFrame 中的修改在该帧结束时广播。暂停前先广播修正产生的通知
+	FAttributeBindBatchSuspendScope AttributeBindBatchSuspend;
+
 	// 已将状态重置到RewindedFrame了，需要从ICF开始重新模拟到RCF。
 	InternalCommandFrame = RewindedFrame + 1;
 
@@ -361,6 +503,126 @@ void UCommandFrameManager::ReplayFrames(uint32 RewindedFrame)
 	// 此时需要最后模拟一次输入
 	BeginNewFlushCommandFrame(FixedDeltaTime);
 	SimulateInput(RealCommandFrame);
+
+	bReplaying = false;
+	ReplayEntities.Reset();
+}
+
+void UCommandFrameManager::MarkReplayDirty(const UObject* Object)
+{
+	if (const AActor* Entity = GetReplayEntity(Object))
+	{
+		ReplayDirtyEntities.Add(Entity);
+	}
+}
+
+void UCommandFrameManager::AddReplayDependency(AActor* Dependent, AActor* Dependency)
+{
+	if (IsValid(Dependent) && IsValid(Dependency) && Dependent != Dependency)
+	{
+		ReplayDependents.AddUnique(Dependency, Dependent);
+	}
+}
+
+void UCommandFrameManager::RemoveReplayDependency(AActor* Dependent)
+{
+	for (auto It = ReplayDependents.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid() || It.Value().Get() == Dependent || It.Key().ResolveObjectPtr() == Dependent)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UCommandFrameManager::ShouldReplay(const UObject* Object) const
+{
+	if (!bReplaying || ReplayEntities.IsEmpty())
+	{
+		return true;
+	}
+
+	// 不属于任何Actor的绑定（例如全局系统）总是需要重新模拟
+	const AActor* Entity = GetReplayEntity(Object);
+	return !Entity || ReplayEntities.Contains(Entity);
+}
+
+const AActor* UCommandFrameManager::GetReplayEntity(const UObject* Object)
+{
+	if (!Object)
+	{
+		return nullptr;
+	}
+
+	if (const AActor* Actor = Cast<AActor>(Object))
+	{
+		return Actor;
+	}
+
+	if (const UActorComponent* Component = Cast<UActorComponent>(Object))
+	{
+		return Component->GetOwner();
+	}
+
+	return Object->GetTypedOuter<AActor>();
+}
+
+void UCommandFrameManager::BuildReplayEntities()
+{
+	ReplayEntities.Reset();
+
+	if (!bEnableSelectiveReplay)
+	{
+		return;
+	}
+
+	ReplayEntityScratch.Reset();
+	for (const TObjectKey<AActor>& DirtyEntity : ReplayDirtyEntities)
+	{
+		if (AActor* Entity = DirtyEntity.ResolveObjectPtr())
+		{
+			ReplayEntityScratch.Add(Entity);
+		}
+	}
+
+	// 沿依赖关系扩散：Attach 到实体上的Actor，以及显式注册的依赖者
+	for (int32 Index = 0; Index < ReplayEntityScratch.Num(); ++Index)
+	{
+		AActor* Entity = ReplayEntityScratch[Index];
+
+		bool bAlreadyInSet = false;
+		ReplayEntities.Add(Entity, &bAlreadyInSet);
+		if (bAlreadyInSet)
+		{
+			continue;
+		}
+
+		Entity->GetAttachedActors(ReplayEntityScratch, false);
+
+		for (auto It = ReplayDependents.CreateConstKeyIterator(TObjectKey<AActor>(Entity)); It; ++It)
+		{
+			if (AActor* Dependent = It.Value().Get())
+			{
+				ReplayEntityScratch.Add(Dependent);
+			}
+		}
+	}
+
+	UE_LOG(LogCommandFrameManager, Verbose, TEXT("BuildReplayEntities Dirty[%d] Replay[%d]"), ReplayDirtyEntities.Num(), ReplayEntities.Num());
+}
+
+void UCommandFrameManager::BroadcastFixedUpdate(FOnFixedUpdate& FixedUpdate, float DeltaTime)
+{
+	if (bReplaying && !ReplayEntities.IsEmpty())
+	{
+		FixedUpdate.BroadcastFiltered(DeltaTime, RealCommandFrame, InternalCommandFrame, [this](const UObject* Object) {
+			return ShouldReplay(Object);
+		});
+	}
+	else
+	{
+		FixedUpdate.Broadcast(DeltaTime, RealCommandFrame, InternalCommandFrame);
+	}
 }
 
 void UCommandFrameManager::UpdateTimeDilationHelper(uint32 ServerCommandBufferNum, bool bFault)
@@ -489,6 +751,7 @@ void UCommandFrameManager::ClientSendInputNetPacket()
 	uint32 RedundantNum = FMath::Min(CommandBuffer.Count(), MAX_COMMANDFRAME_REDUNDANT_NUM);
 	TCircularQueueView<FCommandFrameInputFrame> RangeView = CommandBuffer.ReadRangeData_Shrink(RealCommandFrame, RedundantNum);
 	FCommandFrameInputNetPacket InputNetPacket(PC->GetNetConnection(), RangeView);
+	InputNetPacket.AckServerCommandFrame = LocalNetChannel->GetAckServerCommandFrame();
 	LocalNetChannel->ClientSend_CommandFrameInputNetPacket(InputNetPacket);
 }
 
@@ -498,15 +761,85 @@ void UCommandFrameManager::ClientReceiveCommandAck(uint32 ServerCommandFrame)
 	CommandBuffer.AckData(ServerCommandFrame);
 }
 
-FStructView UCommandFrameManager::ReadAttributeFromSnapshotBuffer(uint32 CommandFrame, const UScriptStruct* Key)
+FStructView UCommandFrameManager::ReadAttributeFromSnapshotBuffer(uint32 CommandFrame, const FCommandFrameSnapshotKey& Key)
 {
 	if (FCommandFrameAttributeSnapshot* AttributeSnapshot = AttributeSnapshotBuffer.ReadData(CommandFrame))
 	{
-		return FStructView(Key, AttributeSnapshot->ReadItemData(Key));
+		return FStructView(Key.Struct, AttributeSnapshot->ReadItemData(Key));
 	}
 	return nullptr;
 }
 
+bool UCommandFrameManager::CalcSnapshotChecksum(ACommandFrameNetChannelBase* Channel, uint32 CommandFrame, uint64& OutChecksum)
+{
+	FCommandFrameAttributeSnapshot* AttributeSnapshot = AttributeSnapshotBuffer.ReadData(CommandFrame);
+	if (!IsValid(Channel) || !AttributeSnapshot || AttributeSnapshot->CommandFrame != CommandFrame)
+	{
+		return false;
+	}
+
+	// 与 SerializeDeltaPackaged 的顺序保持一致
+	SnapshotChecksumKeys.Reset();
+	for (const EDeltaNetPacketType NetPacketType : { EDeltaNetPacketType::Movement, EDeltaNetPacketType::StateAbilityScript })
+	{
+		if (ICommandFrameNetProcedure* Procedure = Channel->GetNetPacketProcedure(NetPacketType))
+		{
+			Procedure->GetSnapshotKeys(SnapshotChecksumKeys);
+		}
+	}
+
+	if (SnapshotChecksumKeys.IsEmpty())
+	{
+		return false;
+	}
+
+	OutChecksum = AttributeSnapshot->CalcChecksum(SnapshotChecksumKeys);
+	return true;
+}
+
+void UCommandFrameManager::VerifySnapshotChecksum(ACommandFrameNetChannelBase* Channel, uint32 CommandFrame, uint64 ServerChecksum)
+{
+	uint64 LocalChecksum = 0;
+	if (!CalcSnapshotChecksum(Channel, CommandFrame, LocalChecksum))
+	{
+		return;
+	}
+
+	if (LocalChecksum != ServerChecksum)
+	{
+		++SnapshotDesyncNum;
+
+		UE_LOG(LogCommandFrameManager, Warning, TEXT("Snapshot desync at CF[%u] Server[%016llx] Local[%016llx] Total[%u]"), CommandFrame, ServerChecksum, LocalChecksum, SnapshotDesyncNum);
+	}
+}
+
+uint32 UCommandFrameManager::AllocateSnapshotEntity()
+{
+	// 刚释放的索引可能仍被历史快照引用，避免新实体回滚时读到旧实体的数据
+	if (ReleasedSnapshotEntityHead < ReleasedSnapshotEntities.Num() && RealCommandFrame - ReleasedSnapshotEntities[ReleasedSnapshotEntityHead].Value > MAX_SNAPSHOTBUFFER_NUM)
+	{
+		const uint32 EntityIndex = ReleasedSnapshotEntities[ReleasedSnapshotEntityHead++].Key;
+
+		// 已取出的部分超过一半时才整体前移，均摊 O(1)
+		if (ReleasedSnapshotEntityHead * 2 >= ReleasedSnapshotEntities.Num())
+		{
+			ReleasedSnapshotEntities.RemoveAt(0, ReleasedSnapshotEntityHead, EAllowShrinking::No);
+			ReleasedSnapshotEntityHead = 0;
+		}
+		return EntityIndex;
+	}
+
+	return SnapshotEntityNum++;
+}
+
+void UCommandFrameManager::ReleaseSnapshotEntity(uint32 EntityIndex)
+{
+	if (EntityIndex < SnapshotEntityNum)
+	{
+		ReleasedSnapshotEntities.Emplace(EntityIndex, RealCommandFrame);
+	}
+}
+
 void UCommandFrameManager::ResetCommandFrame(uint32 CommandFrame)
 {
 	RealCommandFrame = CommandFrame;
@@ -547,16 +880,13 @@ void UCommandFrameManager::ConsumeInput()
 
 void UCommandFrameManager::SimulateInput(uint32 CommandFrame)
 {
-	InputProcedureCache.Reset();
-
 	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
 	{
 		APlayerController* PC = Iterator->Get();
-		if (PC)
+		APlayerState* PS = PC ? PC->GetPlayerState<APlayerState>() : nullptr;
+		if (PS)
 		{
-			APlayerState* PS = PC->GetPlayerState<APlayerState>();
-			TMap<const UInputAction*, TArray<TSharedPtr<FEnhancedInputActionEventBinding>>>& InputEventMapRef = InputProcedureCache.FindOrAdd(PS->GetUniqueId());
-			BuildInputEventMap(PC, InputEventMapRef);
+			UpdateInputEventMap(PC, PS->GetUniqueId());
 		}
 	}
 
@@ -593,77 +923,45 @@ void UCommandFrameManager::SimulateInput(uint32 CommandFrame)
 	}
 #endif
 
-	uint32 InputIndex = 0;
+	FCommandFrameInputProcedure::Dispatch(*InputFrame, InputProcedureCache);
 
-	for (auto& Counter : InputFrame->OrderCounter)
+	// 在模拟Input完成后，需要把存入的InputSysytem记录的数据全部移除
+	if (UCommandEnhancedInputSubsystem* InputSystem = GetWorld()->GetSubsystem<UCommandEnhancedInputSubsystem>())
 	{
-		const FUniqueNetIdRepl& NetId = Counter.Key;
-		TMap<const UInputAction*, TArray<TSharedPtr<FEnhancedInputActionEventBinding>>>& InputEventMap = InputProcedureCache.FindOrAdd(NetId);
-		uint8 Count = Counter.Value;
-
-		if (!Count || InputEventMap.IsEmpty())
-		{
-			InputIndex += Count;
-			continue;
-		}
-
-		
-
-		while (Count--)
-		{
-			FCommandFrameInputAtom& InputAtom = InputFrame->InputQueue[InputIndex++];
-			TArray<TSharedPtr<FEnhancedInputActionEventBinding>>* InputBindings = InputEventMap.Find(InputAtom.InputAction);
-			if (!InputBindings)
-			{
-				continue;
-			}
-
-			static TArray<TSharedPtr<FEnhancedInputActionEventBinding>> TriggeredDelegates;
-			TriggeredDelegates.Reset();
-			
-			for (const TSharedPtr<FEnhancedInputActionEventBinding>& Binding : *InputBindings)
-			{
-				const ETriggerEvent BoundTriggerEvent = Binding->GetTriggerEvent();
-				// Raise appropriate delegate to report on event state
-				if (InputAtom.TriggerEvent == BoundTriggerEvent)
-				{
-					// Record intent to trigger started as well as triggered
-					// EmplaceAt 0 for the "Started" event it is always guaranteed to fire before Triggered
-
-					FCommandFrameInputActionInstance ActionData(InputAtom);
-
-					if (BoundTriggerEvent == ETriggerEvent::Started)
-					{
-						Binding->Execute(ActionData);
-					}
-					else
-					{
-						Binding->Execute(ActionData);
-					}
-
-					// Keep track of the triggered actions this tick so that we can quickly look them up later when determining chorded action state
-					if (BoundTriggerEvent == ETriggerEvent::Triggered)
-					{
-						// @TODO
-						// TriggeredActionsThisTick.Add(ActionData->GetSourceAction());
-					}
-				}
-			}
-			
-		}
-
-
+		InputSystem->ClearInput();
 	}
+}
 
+void UCommandFrameManager::UpdateInputEventMap(APlayerController* PC, const FUniqueNetIdRepl& NetId)
+{
+	FCommandFrameInputProcedureCache& ProcedureCache = InputProcedureCache.FindOrAdd(NetId);
 
-	// 在模拟Input完成后，需要把存入的InputSysytem记录的数据全部移除
-	if (UCommandEnhancedInputSubsystem* InputSystem = GetWorld()->GetSubsystem<UCommandEnhancedInputSubsystem>())
+	APawn* ControlledPawn = PC->GetPawnOrSpectator();
+	const bool bPawnInputEnabled = ControlledPawn && ControlledPawn->InputEnabled();
+	const bool bPCInputEnabled = PC->InputEnabled();
+	const int32 InputStackNum = PRIVATE_GET(PC, CurrentInputStack).Num();
+
+	if (ProcedureCache.BindingVersion == UCommandEnhancedInputComponent::GetBindingVersion()
+		&& ProcedureCache.Pawn.Get() == ControlledPawn
+		&& ProcedureCache.InputStackNum == InputStackNum
+		&& ProcedureCache.bPawnInputEnabled == bPawnInputEnabled
+		&& ProcedureCache.bPCInputEnabled == bPCInputEnabled)
 	{
-		InputSystem->ClearInput();
+		return;
 	}
+
+	ProcedureCache.InputEventMap.Reset();
+	BuildInputEventMap(PC, ProcedureCache.InputEventMap);
+
+	// BuildInputEventMap 会清理输入栈中的无效组件，因此在构建之后再记录
+	ProcedureCache.BindingVersion = UCommandEnhancedInputComponent::GetBindingVersion();
+	ProcedureCache.Pawn = ControlledPawn;
+	ProcedureCache.InputStackNum = PRIVATE_GET(PC, CurrentInputStack).Num();
+	ProcedureCache.bPawnInputEnabled = bPawnInputEnabled;
+	ProcedureCache.bPCInputEnabled = bPCInputEnabled;
 }
 
-void UCommandFrameManager::BuildInputEventMap(APlayerController* PC, TMap<const UInputAction*, TArray<TSharedPtr<FEnhancedInputActionEventBinding>>>& InputEventMap)
+void UCommandFrameManager::BuildInputEventMap(APlayerController* PC, FCommandInputEventMap& InputEventMap)
 {
 	static TArray<UInputComponent*> InputStack;
 	InputStack.Reset();
@@ -713,19 +1011,7 @@ void UCommandFrameManager::BuildInputEventMap(APlayerController* PC, TMap<const
 		}
 	}
 
-
-	for (UInputComponent* IC : InputStack)
-	{
-		if (UCommandEnhancedInputComponent* CEInputComp = Cast<UCommandEnhancedInputComponent>(IC))
-		{
-			for (auto& BindingPair : CEInputComp->GetCommandInputBindings())
-			{
-				const TSharedPtr<FEnhancedInputActionEventBinding>& Binding = BindingPair.Value;
-
-				InputEventMap.FindOrAdd(Binding->GetAction()).Add(Binding);
-			}
-		}
-	}
+	FCommandFrameInputProcedure::BuildInputEventMap(InputStack, InputEventMap);
 }
 
 void UCommandFrameManager::ServerSendDeltaNetPacket()
@@ -735,6 +1021,8 @@ void UCommandFrameManager::ServerSendDeltaNetPacket()
 		return;
 	}
 
+	UpdateInterest();
+
 	for (auto& ChannelPair : NetChannels)
 	{
 		FCommandFrameDeltaNetPacket Packet;
@@ -744,6 +1032,43 @@ void UCommandFrameManager::ServerSendDeltaNetPacket()
 	}
 }
 
+void UCommandFrameManager::UpdateInterest()
+{
+	if (!InterestManager.IsEnabled())
+	{
+		return;
+	}
+
+	InterestManager.BeginUpdate();
+
+	for (auto& ChannelPair : NetChannels)
+	{
+		APawn* Pawn = IsValid(ChannelPair.Key) ? ChannelPair.Key->GetPawn() : nullptr;
+		if (IsValid(Pawn) && IsValid(ChannelPair.Value))
+		{
+			InterestManager.AddEntity(ChannelPair.Value->GetUniqueID(), Pawn->GetActorLocation());
+		}
+	}
+
+	InterestManager.EndUpdate();
+}
+
+bool UCommandFrameManager::IsNetRelevantFor(AController* Viewer, ACommandFrameNetChannelBase* TargetChannel) const
+{
+	if (!InterestManager.IsEnabled() || !IsValid(TargetChannel))
+	{
+		return true;
+	}
+
+	ACommandFrameNetChannelBase* const* ViewerChannelPtr = NetChannels.Find(Viewer);
+	if (!ViewerChannelPtr || !IsValid(*ViewerChannelPtr))
+	{
+		return true;
+	}
+
+	return InterestManager.IsRelevant((*ViewerChannelPtr)->GetUniqueID(), TargetChannel->GetUniqueID());
+}
+
 uint32 UCommandFrameManager::GetCurCommandBufferNum(const FUniqueNetIdRepl& Owner)
 {
 	return CommandBuffer.Count(Owner);
@@ -753,6 +1078,12 @@ void UCommandFrameManager::PostLogin(AGameModeBase* GameMode, APlayerController*
 {
 	if (GetWorld()->GetAuthGameMode() == GameMode)
 	{
+		// 字典在整个会话内保持不变，必须在第一个NetChannel创建前完成
+		if (InputActionTable.IsEmpty())
+		{
+			BuildInputActionTable();
+		}
+
 		if (ACommandFrameNetChannelBase** ChannelPtr = NetChannels.Find(PC))
 		{
 			// 重新指向新的Owner
@@ -787,7 +1118,33 @@ void UCommandFrameManager::LoginOut(AGameModeBase* GameMode, AController* PC)
 		}
 
 		NetChannels.Remove(PC);
+
+		if (APlayerState* PS = PC ? PC->GetPlayerState<APlayerState>() : nullptr)
+		{
+			InputProcedureCache.Remove(PS->GetUniqueId());
+		}
+	}
+}
+
+void UCommandFrameManager::BuildInputActionTable()
+{
+	TArray<TObjectPtr<UInputAction>> InputActions;
+	for (const TSoftObjectPtr<UInputAction>& SoftInputAction : GetDefault<UCommandFrameSettings>()->CommandInputActions)
+	{
+		if (UInputAction* InputAction = SoftInputAction.LoadSynchronous())
+		{
+			InputActions.Add(InputAction);
+		}
 	}
+
+	InputActionTable.Init(InputActions);
+
+	UE_LOG(LogCommandFrameManager, Log, TEXT("BuildInputActionTable Num[%d] IndexBits[%u]"), InputActionTable.Num(), InputActionTable.GetIndexBits());
+}
+
+void UCommandFrameManager::SetInputActionTable(const TArray<TObjectPtr<UInputAction>>& InputActions)
+{
+	InputActionTable.Init(InputActions);
 }
 
 void UCommandFrameManager::RegisterClientChannel(ACommandFrameNetChannelBase* Channel)
@@ -0,0 +1,172 @@
+#include "Component/CFrameMoverBatchSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+
+#include "CommandFrameManager.h"
+#include "CommandFrameSetting.h"
+#include "Component/CFrameMoverComponent.h"
+#include "Component/Mover/MoveLibrary/CFrameSweepBatch.h"
+
+bool bEnableMoverVelocityBatch = true;
+FAutoConsoleVariableRef CVarCFrame_Mover_VelocityBatch(TEXT("CFrame.Mover.VelocityBatch"), bEnableMoverVelocityBatch, TEXT("If true, walking and falling movers compute their velocity together with SIMD before the sweep phase. Otherwise each mover runs its own FixedTick."));
+
+bool bEnableMoverParallelSweep = true;
+FAutoConsoleVariableRef CVarCFrame_Mover_ParallelSweep(TEXT("CFrame.Mover.ParallelSweep"), bEnableMoverParallelSweep, TEXT("If true, the first sweep of every batched mover is queried in parallel before the moves are committed in registration order. Requires CFrame.Mover.VelocityBatch."));
+
+int32 MoverParallelSweepMinBatchSize = 16;
+FAutoConsoleVariableRef CVarCFrame_Mover_ParallelSweepMinBatchSize(TEXT("CFrame.Mover.ParallelSweepMinBatchSize"), MoverParallelSweepMinBatchSize, TEXT("Minimum number of sweep queries handled by one worker. Does not affect the results."));
+
+UCFrameMoverBatchSubsystem* UCFrameMoverBatchSubsystem::Get(UObject* WorldContext)
+{
+	if (IsValid(WorldContext) && WorldContext->GetWorld())
+	{
+		return WorldContext->GetWorld()->GetSubsystem<UCFrameMoverBatchSubsystem>();
+	}
+
+	return nullptr;
+}
+
+bool UCFrameMoverBatchSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 与 UCommandFrameManager 保持一致
+	const bool bShouldCreate = GetDefault<UCommandFrameSettings>()->bEnableCommandFrameNetReplication;
+
+	return bShouldCreate && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCFrameMoverBatchSubsystem::Deinitialize()
+{
+	if (IsValid(CFrameManager))
+	{
+		CFrameManager->OnEndFrame.RemoveAll(this);
+	}
+
+	CFrameManager = nullptr;
+	Movers.Empty();
+	TickingMovers.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCFrameMoverBatchSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCFrameMoverBatchSubsystem::RegisterMover(UCFrameMoverComponent* Mover)
+{
+	if (!IsValid(Mover))
+	{
+		return;
+	}
+
+	if (!CFrameManager)
+	{
+		CFrameManager = Mover->GetCommandFrameManager();
+		check(CFrameManager);
+
+		CFrameManager->OnEndFrame.AddUObject(this, &UCFrameMoverBatchSubsystem::FixedTick);
+	}
+
+	Movers.AddUnique(Mover);
+}
+
+void UCFrameMoverBatchSubsystem::UnregisterMover(UCFrameMoverComponent* Mover)
+{
+	// 保持注册顺序，Tick顺序需要在各端一致
+	Movers.Remove(Mover);
+}
+
+void UCFrameMoverBatchSubsystem::FixedTick(float DeltaTime, uint32 RCF, uint32 ICF)
+{
+	TickingMovers.Reset();
+	for (const TWeakObjectPtr<UCFrameMoverComponent>& Mover : Movers)
+	{
+		// 选择性重新模拟时，只Tick被修正的实体
+		if (Mover.IsValid() && CFrameManager->ShouldReplay(Mover.Get()))
+		{
+			TickingMovers.Add(Mover);
+		}
+	}
+
+	if (!bEnableMoverVelocityBatch)
+	{
+		for (const TWeakObjectPtr<UCFrameMoverComponent>& Mover : TickingMovers)
+		{
+			if (Mover.IsValid())
+			{
+				Mover->FixedTick(DeltaTime, RCF, ICF);
+			}
+		}
+		return;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Gather
+	VelocityBatch.Reset();
+	for (TWeakObjectPtr<UCFrameMoverComponent>& Mover : TickingMovers)
+	{
+		if (!Mover.IsValid() || !Mover->PrepareFixedTick(DeltaTime, RCF, ICF, VelocityBatch))
+		{
+			Mover.Reset();
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Compute
+	VelocityBatch.Compute();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Scatter
+	FCFrameSweepBatch* ActiveSweepBatch = bEnableMoverParallelSweep ? &SweepBatch : nullptr;
+
+	SweepBatch.Reset();
+	for (const TWeakObjectPtr<UCFrameMoverComponent>& Mover : TickingMovers)
+	{
+		if (Mover.IsValid())
+		{
+			Mover->ResolveFixedTick(VelocityBatch, ActiveSweepBatch);
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Query：并行，只读场景
+	if (ActiveSweepBatch)
+	{
+		const UWorld* World = GetWorld();
+		SweepBatch.Query([World](const FCFrameSweepRequest& Request)
+		{
+			return FCFrameSweepBatch::QueryWorld(World, Request);
+		}, MoverParallelSweepMinBatchSize);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Commit：按注册顺序移动，之前移动过的Mover会使与其相交的预查询失效
+	for (const TWeakObjectPtr<UCFrameMoverComponent>& Mover : TickingMovers)
+	{
+		if (!Mover.IsValid())
+		{
+			continue;
+		}
+
+		UPrimitiveComponent* Primitive = Mover->GetPrimitiveComponent();
+		const FTransform StartTransform = Primitive ? Primitive->GetComponentTransform() : FTransform::Identity;
+
+		Mover->ExecuteFixedTick(ActiveSweepBatch);
+
+		if (ActiveSweepBatch && Primitive && !Primitive->GetComponentTransform().Equals(StartTransform, 0.0))
+		{
+			SweepBatch.NotifyCommitted(Primitive->Bounds.GetBox());
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Impact：所有Mover移动完成后按注册顺序派发，重叠事件已在各自的 ExecuteFixedTick 结束时合并派发
+	for (const TWeakObjectPtr<UCFrameMoverComponent>& Mover : TickingMovers)
+	{
+		if (Mover.IsValid())
+		{
+			Mover->FlushPendingImpacts();
+		}
+	}
+}
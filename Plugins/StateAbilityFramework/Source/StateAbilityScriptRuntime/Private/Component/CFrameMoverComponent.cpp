@@ -5,6 +5,7 @@
 #include "GameFramework/GameNetworkManager.h"
 
 #include "CommandFrameManager.h"
+#include "Component/CFrameMoverBatchSubsystem.h"
 #include "Net/Packet/CommandFramePacket.h"
 #include "Component/Mover/CFrameMovementMode.h"
 #include "Component/Mover/CFrameMoveModeStateMachine.h"
@@ -24,6 +25,8 @@ UCFrameMoverComponent::UCFrameMoverComponent(const FObjectInitializer& ObjectIni
 	, PrimaryVisualComponent(nullptr)
 	, CFrameManager(nullptr)
 	, ModeFSM(nullptr)
+	, SnapshotEntityIndex(INDEX_NONE)
+	, bDeferImpacts(false)
 {
 
 	bWantsInitializeComponent = true;
@@ -110,6 +113,11 @@ void UCFrameMoverComponent::BeginPlay()
 		UpdatedComponent->PrimaryComponentTick.AddPrerequisite(this, CFrameManager->GetTickFuntion());
 	}
 
+	if (SnapshotEntityIndex == INDEX_NONE)
+	{
+		SnapshotEntityIndex = CFrameManager->AllocateSnapshotEntity();
+	}
+
 	if (!ModeFSM)
 	{
 		ModeFSM = NewObject<UCFrameMoveModeStateMachine>(this);
@@ -124,7 +132,16 @@ void UCFrameMoverComponent::BeginPlay()
 void UCFrameMoverComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	CFrameManager->UnBindOnFrameNetChannelRegistered(this);
-	CFrameManager->OnEndFrame.RemoveAll(this);
+	if (UCFrameMoverBatchSubsystem* MoverBatchSubsystem = UCFrameMoverBatchSubsystem::Get(this))
+	{
+		MoverBatchSubsystem->UnregisterMover(this);
+	}
+
+	if (SnapshotEntityIndex != INDEX_NONE)
+	{
+		CFrameManager->ReleaseSnapshotEntity(SnapshotEntityIndex);
+		SnapshotEntityIndex = INDEX_NONE;
+	}
 }
 
 void UCFrameMoverComponent::PostBeginPlay()
@@ -132,7 +149,7 @@ void UCFrameMoverComponent::PostBeginPlay()
 	// 必须得在下一帧尝试绑定，因为在Actor的BeginPlay执行时，可能还未绑定PC。（例如单机、DS模式）
 	CFrameManager->BindOnFrameNetChannelRegistered(this, FOnFrameNetChannelRegistered::CreateUObject(this, &UCFrameMoverComponent::OnFrameNetChannelRegistered));
 
-	CFrameManager->OnEndFrame.AddUObject(this, &UCFrameMoverComponent::FixedTick);
+	UCFrameMoverBatchSubsystem::Get(this)->RegisterMover(this);
 }
 
 void UCFrameMoverComponent::OnFrameNetChannelRegistered(ACommandFrameNetChannelBase* Channel)
@@ -198,23 +215,68 @@ UCommandFrameManager* UCFrameMoverComponent::GetCommandFrameManager()
 	return CFrameManager;
 }
 
+FCommandFrameSnapshotKey UCFrameMoverComponent::GetMovementSnapshotKey() const
+{
+	return FCommandFrameSnapshotKey(FCFrameMovementSnapshot::StaticStruct(), SnapshotEntityIndex);
+}
+
+const FCFrameMovementQuantization& UCFrameMoverComponent::GetMovementQuantization() const
+{
+	static const FCFrameMovementQuantization DefaultQuantization;
+	return MovementConfig.MovementSetting ? MovementConfig.MovementSetting->Quantization : DefaultQuantization;
+}
+
 void UCFrameMoverComponent::FixedTick(float DeltaTime, uint32 RCF, uint32 ICF)
 {
 	ModeFSM->FixedTick(DeltaTime, RCF, ICF);
 }
 
+bool UCFrameMoverComponent::PrepareFixedTick(float DeltaTime, uint32 RCF, uint32 ICF, FCFrameVelocityBatch& VelocityBatch)
+{
+	return ModeFSM->PrepareMove(DeltaTime, RCF, ICF, &VelocityBatch);
+}
+
+void UCFrameMoverComponent::ResolveFixedTick(const FCFrameVelocityBatch& VelocityBatch, FCFrameSweepBatch* SweepBatch)
+{
+	ModeFSM->ResolveMove(&VelocityBatch);
+
+	if (SweepBatch)
+	{
+		ModeFSM->AddSweepRequest(*SweepBatch);
+	}
+}
+
+void UCFrameMoverComponent::ExecuteFixedTick(const FCFrameSweepBatch* SweepBatch)
+{
+	TGuardValue<bool> DeferImpactsGuard(bDeferImpacts, true);
+	ModeFSM->ExecuteMove(SweepBatch);
+}
+
+void UCFrameMoverComponent::FlushPendingImpacts()
+{
+	// 回调中可能产生新的碰撞，先取出
+	TArray<FCFrameMoverPendingImpact> Impacts = MoveTemp(PendingImpacts);
+	PendingImpacts.Reset();
+
+	for (const FCFrameMoverPendingImpact& Impact : Impacts)
+	{
+		OnHandleImpact(Impact.Hit, Impact.ModeName, Impact.MoveDelta);
+	}
+}
+
 void UCFrameMoverComponent::HandleImpact(const FHitResult& Hit, const FName ModeName, const FVector& MoveDelta)
 {
-	if (ModeName == NAME_None)
+	const FName ImpactModeName = ModeName == NAME_None ? ModeFSM->GetCurrentModeName() : ModeName;
+
+	if (bDeferImpacts)
 	{
-		OnHandleImpact(Hit, ModeFSM->GetCurrentModeName(), MoveDelta);
+		PendingImpacts.Add({ Hit, ImpactModeName, MoveDelta });
 	}
 	else
 	{
-		OnHandleImpact(Hit, ModeName, MoveDelta);
+		OnHandleImpact(Hit, ImpactModeName, MoveDelta);
 	}
 }
-
 	
 
 void UCFrameMoverComponent::OnHandleImpact(const FHitResult& Hit, const FName ModeName, const FVector& MoveDelta)
@@ -230,30 +292,21 @@ void UCFrameMoverComponent::OnServerNetSync(FNetProcedureSyncParam& SyncParam)
 	UPackageMap* Map = SyncParam.Map;
 	bool& bOutSuccess = SyncParam.bOutSuccess;
 	
-	FVector Location = Adapter->GetLocation_WorldSpace();
-	FVector Velocity = Adapter->GetVelocity_WorldSpace();
-	SerializePackedVector<100, 30>(Location, Ar);
-	SerializePackedVector<10, 16>(Velocity, Ar);
-	Adapter->GetOrientation_WorldSpace().SerializeCompressedShort(Ar);
-
-
-	UPrimitiveComponent* MovementBase = Adapter->GetMovementBase();
-	FName MovementBaseBoneName = Adapter->GetMovementBaseBoneName();
+	FCFrameMovementNetState State;
+	State.Frame = SyncParam.NetPacket.ServerCommandFrame;
+	State.Location = Adapter->GetLocation_WorldSpace();
+	State.Velocity = Adapter->GetVelocity_WorldSpace();
+	State.Orientation = Adapter->GetOrientation_WorldSpace();
+	State.MovementBase = Adapter->GetMovementBase();
+	State.MovementBaseBoneName = Adapter->GetMovementBaseBoneName();
 	//FVector MovementBasePos = Adapter->GetMovementBasePos();
 	//FQuat MovementBaseQuat = Adapter->GetMovementBaseQuat();
 
-	// Optional movement base
-	bool bIsUsingMovementBase = MovementBase != nullptr;
-	Ar.SerializeBits(&bIsUsingMovementBase, 1);
-
-	if (bIsUsingMovementBase)
-	{
-		Ar << MovementBase;
-		Ar << MovementBaseBoneName;	// @TODO：传递FName等同于传递FString，挺浪费的
+	// Remote 的数据由所有连接共享，只有 Local 的数据可以针对该客户端的确认帧做差量
+	const uint32 AckFrame = SyncParam.NetPacket.bLocal && SyncParam.NetPacket.NetChannel ? SyncParam.NetPacket.NetChannel->GetAckServerCommandFrame() : 0;
+	FCFrameMovementNetSerializer::NetSerialize(Ar, GetMovementQuantization(), State, NetHistory, AckFrame, (uint32)GetMovementSnapshotKey().EntityIndex);
 
-		//SerializePackedVector<100, 30>(MovementBasePos, Ar);
-		//MovementBaseQuat.NetSerialize(Ar, Map, bOutSuccess);
-	}
+	NetHistory.Record(State);
 
 	bOutSuccess = true;
 }
@@ -265,32 +318,24 @@ void UCFrameMoverComponent::OnClientNetSync(FNetProcedureSyncParam& SyncParam, b
 	UPackageMap* Map = SyncParam.Map;
 	bool& bOutSuccess = SyncParam.bOutSuccess;
 
-
-	FVector Location;
-	FVector Velocity;
-	FRotator Orientation;
-	SerializePackedVector<100, 30>(Location, Ar);
-	SerializePackedVector<10, 16>(Velocity, Ar);
-	Orientation.SerializeCompressedShort(Ar);
-
-	// Optional movement base
-	bool bIsUsingMovementBase;
-	Ar.SerializeBits(&bIsUsingMovementBase, 1);
-
-	UPrimitiveComponent* MovementBase = nullptr;
-	FName MovementBaseBoneName = NAME_None;
-	//FVector MovementBasePos;
-	//FQuat MovementBaseQuat;
-
-	if (bIsUsingMovementBase)
+	FCFrameMovementNetState State;
+	State.Frame = SyncParam.NetPacket.ServerCommandFrame;
+	if (!FCFrameMovementNetSerializer::NetSerialize(Ar, GetMovementQuantization(), State, NetHistory, 0))
 	{
-		Ar << MovementBase;
-		Ar << MovementBaseBoneName;
+		UE_LOG(LogCFrameMmoverComp, Warning, TEXT("[Client NetSync] SCF[%d] Missing delta base, wait for the next full state."), SyncParam.NetPacket.ServerCommandFrame);
 
-		//SerializePackedVector<100, 30>(MovementBasePos, Ar);
-		//MovementBaseQuat.NetSerialize(Ar, Map, bOutSuccess);
+		bOutSuccess = false;
+		return;
 	}
 
+	NetHistory.Record(State);
+
+	const FVector& Location = State.Location;
+	const FVector& Velocity = State.Velocity;
+	const FRotator& Orientation = State.Orientation;
+	UPrimitiveComponent* MovementBase = State.MovementBase.Get();
+	const FName MovementBaseBoneName = State.MovementBaseBoneName;
+
 	if (CheckClientExceedsAllowablePositionError(SyncParam, Location))
 	{
 		if (SyncParam.NetPacket.bLocal)
@@ -304,14 +349,33 @@ void UCFrameMoverComponent::OnClientNetSync(FNetProcedureSyncParam& SyncParam, b
 		}
 	}
 
+	// Local 的数据以确认帧为基准做差量，MovementBase 无法还原的帧不能被确认，服务器会继续发送 MovementBase 直到客户端完成映射；
+	// Remote 的数据总是完整同步，下一帧会再次尝试
+	if (State.bMovementBaseUnmapped && SyncParam.NetPacket.bLocal)
+	{
+		UE_LOG(LogCFrameMmoverComp, Verbose, TEXT("[Client NetSync] SCF[%d] MovementBase is not mapped yet, wait for the next sync."), SyncParam.NetPacket.ServerCommandFrame);
+
+		SyncParam.bOutUnmapped = true;
+	}
+
 	bOutSuccess = true;
 }
 
 void UCFrameMoverComponent::OnClientRewind()
 {
+	GetCommandFrameManager()->MarkReplayDirty(this);
+
 	ModeFSM->OnClientRewind();
 }
 
+void UCFrameMoverComponent::GetSnapshotKeys(TArray<FCommandFrameSnapshotKey>& OutKeys)
+{
+	if (SnapshotEntityIndex != INDEX_NONE)
+	{
+		OutKeys.Add(GetMovementSnapshotKey());
+	}
+}
+
 bool UCFrameMoverComponent::CheckClientExceedsAllowablePositionError(FNetProcedureSyncParam& SyncParam, const FVector& ServerWorldLocation)
 {
 	// 参照 UCharacterMovementComponent::ServerExceedsAllowablePositionError
@@ -320,7 +384,7 @@ bool UCFrameMoverComponent::CheckClientExceedsAllowablePositionError(FNetProcedu
 	{
 		return false;
 	}
-	FStructView MovementSnapshotView = CFrameManager->ReadAttributeFromSnapshotBuffer(SyncParam.NetPacket.ServerCommandFrame, FCFrameMovementSnapshot::StaticStruct());
+	FStructView MovementSnapshotView = CFrameManager->ReadAttributeFromSnapshotBuffer(SyncParam.NetPacket.ServerCommandFrame, GetMovementSnapshotKey());
 
 	if (!MovementSnapshotView.IsValid())
 	{
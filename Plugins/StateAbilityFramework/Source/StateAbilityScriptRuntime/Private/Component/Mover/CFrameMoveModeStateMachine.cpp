@@ -10,6 +10,8 @@
 #include "Component/Mover/CFrameMoveStateAdapter.h"
 #include "Component/Mover/Mode/CFrameWalkingMode.h"
 #include "Component/Mover/CFrameMovementTransition.h"
+#include "Component/Mover/CFrameMovementTrace.h"
+#include "Component/Mover/MoveLibrary/CFrameSweepBatch.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogMoveModeStateMachine, Log, All)
 
@@ -17,6 +19,7 @@ UCFrameMoveModeStateMachine::UCFrameMoveModeStateMachine(const FObjectInitialize
 	: Super(ObjectInitializer)
 	, CurrentMode(nullptr)
 	, CurrentModeName(NAME_None)
+	, CurrentModeId(CFrameMoveMode::InvalidId)
 	, CurrentMixer(nullptr)
 {
 
@@ -50,20 +53,24 @@ void UCFrameMoveModeStateMachine::Init(FCFrameMovementConfig& Config)
 
 	//////////////////////////////////////////////////////////////////////////
 	// Mode
-	ModeInfos.Empty(Config.MovementModes.Num());
+	check(Config.MovementModes.Num() < CFrameMoveMode::InvalidId);
+
+	Modes.Empty(Config.MovementModes.Num());
 	CurrentMode = nullptr;
 	CurrentModeName = NAME_None;
+	CurrentModeId = CFrameMoveMode::InvalidId;
 	for (auto& ModePair : Config.MovementModes)
 	{
 		UCFrameMovementMode* ModeInstance = NewObject<UCFrameMovementMode>(MoverComp, ModePair.Value);
 		ModeInstance->OnRegistered(ModePair.Key);
 		ModeInstance->SetupInputComponent(InputComp);
 
-		ModeInfos.FindOrAdd(ModePair.Key).ModeInstance = ModeInstance;
+		const uint8 ModeId = (uint8)Modes.Add(ModeInstance);
 		if (!CurrentMode || ModePair.Key == Config.DefaultModeName)
 		{
 			CurrentMode = ModeInstance;
 			CurrentModeName = ModePair.Key;
+			CurrentModeId = ModeId;
 		}
 	}
 
@@ -72,15 +79,7 @@ void UCFrameMoveModeStateMachine::Init(FCFrameMovementConfig& Config)
 
 	//////////////////////////////////////////////////////////////////////////
 	// Transitions
-
-	Config.ModeTransitionLinks.Sort([](const FCFrameModeTransitionLink& A, const FCFrameModeTransitionLink& B) {
-		return A.Priority > B.Priority;
-	});
-
-	for (auto Link : Config.ModeTransitionLinks)
-	{
-		ModeInfos.FindOrAdd(Link.FromMode).TransitionLinks.Add(Link);
-	}
+	TransitionTable.Compile(Modes, Config.ModeTransitionLinks);
 
 	//////////////////////////////////////////////////////////////////////////
 	// LayeredMoves
@@ -93,6 +92,15 @@ void UCFrameMoveModeStateMachine::Init(FCFrameMovementConfig& Config)
 }
 
 void UCFrameMoveModeStateMachine::FixedTick(float DeltaTime, uint32 RCF, uint32 ICF)
+{
+	if (PrepareMove(DeltaTime, RCF, ICF, nullptr))
+	{
+		ResolveMove(nullptr);
+		ExecuteMove(nullptr);
+	}
+}
+
+bool UCFrameMoveModeStateMachine::PrepareMove(float DeltaTime, uint32 RCF, uint32 ICF, FCFrameVelocityBatch* VelocityBatch)
 {
 	UCFrameMoverComponent* MoverComp = CastChecked<UCFrameMoverComponent>(GetOuter());
 
@@ -107,13 +115,13 @@ void UCFrameMoveModeStateMachine::FixedTick(float DeltaTime, uint32 RCF, uint32
 
 	if (!Context.IsDataValid())
 	{
-		return;
+		return false;
 	}
 
 	MoveStateAdapter->BeginMoveFrame(DeltaTime, RCF, ICF);
 
 	// Gather any layered move contributions
-	FCFrameProposedMove CombinedLayeredMove;
+	CombinedLayeredMove.Clear();
 	CombinedLayeredMove.MixMode = ECFrameMoveMixMode::AdditiveVelocity;
 
 	for (TObjectPtr<UCFrameLayeredMove> LayerMove : LayeredMoves)
@@ -124,13 +132,46 @@ void UCFrameMoveModeStateMachine::FixedTick(float DeltaTime, uint32 RCF, uint32
 	}
 
 
+	Context.VelocityBatch = VelocityBatch;
 	CurrentMode->GenerateMove(Context, Context.CombinedMove);
+	Context.VelocityBatch = nullptr;
+
+	return true;
+}
+
+void UCFrameMoveModeStateMachine::ResolveMove(const FCFrameVelocityBatch* VelocityBatch)
+{
+	if (VelocityBatch)
+	{
+		CurrentMode->ResolveBatchedMove(Context, *VelocityBatch, Context.CombinedMove);
+	}
 
 	CurrentMixer->MixProposedMoves(Context, CombinedLayeredMove, Context.CombinedMove);
+}
 
-	CurrentMode->Execute(Context);
+void UCFrameMoveModeStateMachine::AddSweepRequest(FCFrameSweepBatch& SweepBatch)
+{
+	// 预查询的是 Walking/Falling 首次移动的完整位移，位移不一致时提交阶段会退回串行扫掠
+	FCFrameSweepRequest Request;
+	if (FCFrameSweepBatch::MakeRequest(Context.UpdatedPrimitive, Context.CombinedMove.LinearVelocity * Context.DeltaTime, Request))
+	{
+		Context.SweepIndex = SweepBatch.Add(Request);
+	}
+}
+
+void UCFrameMoveModeStateMachine::ExecuteMove(const FCFrameSweepBatch* SweepBatch)
+{
+	{
+		// 批处理时合并本次移动中的多次 UpdateOverlaps，与 UCharacterMovementComponent 相同
+		FScopedMovementUpdate ScopedMovementUpdate(Context.UpdatedComponent, SweepBatch ? EScopedUpdate::DeferredUpdates : EScopedUpdate::ImmediateUpdates);
+
+		Context.SweepBatch = SweepBatch;
+		CurrentMode->Execute(Context);
+		Context.SweepBatch = nullptr;
+		Context.SweepIndex = INDEX_NONE;
+	}
 
-	MoveStateAdapter->EndMoveFrame(DeltaTime, RCF, ICF);
+	Context.MoveStateAdapter->EndMoveFrame(Context.DeltaTime, Context.RCF, Context.ICF);
 
 
 	UpdateTransition();
@@ -139,42 +180,26 @@ void UCFrameMoveModeStateMachine::FixedTick(float DeltaTime, uint32 RCF, uint32
 
 void UCFrameMoveModeStateMachine::UpdateTransition()
 {
-	FCFrameMoveModeInfo* ModeInfo = ModeInfos.Find(CurrentModeName);
-	if (!ModeInfo)
+	const uint8 ToModeId = TransitionTable.Evaluate(CurrentModeId, CurrentMode->GetModeFlags(), Context);
+	if (ToModeId == CFrameMoveMode::InvalidId)
 	{
 		return;
 	}
 
-	for (FCFrameModeTransitionLink& Transition : ModeInfo->TransitionLinks)
-	{
-		if (Transition.ModeTransition == nullptr || !Transition.ModeTransition->GetDefaultObject<UCFrameMoveModeTransition>()->OnEvaluate(Context))
-		{
-			continue;
-		}
-
-		if (FCFrameMoveModeInfo* ToModeInfo = ModeInfos.Find(Transition.ToMode))
-		{
-			CurrentMode->OnDeactivated();
-			CurrentMode = ToModeInfo->ModeInstance;
-			CurrentModeName = Transition.ToMode;
-			CurrentMode->OnActivated();
-			break;
-		}
-		else
-		{
-			UE_LOG(LogMoveModeStateMachine, Warning, TEXT("ToMode[%s] not found. Is the wrong ModeName configured?"), *(Transition.ToMode.ToString()));
-		}
-	}
+	CurrentMode->OnDeactivated();
+	CurrentMode = Modes[ToModeId];
+	CurrentModeName = CurrentMode->GetModeName();
+	CurrentModeId = ToModeId;
+	CurrentMode->OnActivated();
 }
 
 void UCFrameMoveModeStateMachine::OnClientRewind()
 {
-	for (auto& ModeInfoPair : ModeInfos)
+	for (UCFrameMovementMode* Mode : Modes)
 	{
-		FCFrameMoveModeInfo& ModeInfo = ModeInfoPair.Value;
-		if (IsValid(ModeInfo.ModeInstance))
+		if (IsValid(Mode))
 		{
-			ModeInfo.ModeInstance->OnClientRewind();
+			Mode->OnClientRewind();
 		}
 	}
 }
@@ -187,16 +212,9 @@ void UCFrameMoveModeStateMachine::RecordMovementSnapshot()
 	// 此时正在回滚并重新模拟，需重新记录快照
 	if (CFrameManager->IsInRewinding())
 	{
-		if (GetWorld()->GetNetMode() == NM_Client)
-		{
-			UE_LOG(LogMoveModeStateMachine, Log, TEXT("[Client] ICF[%d] Location[%s]"), Context.ICF, *(MoveStateAdapter->GetLocation_WorldSpace().ToCompactString()));
-		}
-		else
-		{
-			UE_LOG(LogMoveModeStateMachine, Log, TEXT("[Server] ICF[%d] Location[%s]"), Context.ICF, *(MoveStateAdapter->GetLocation_WorldSpace().ToCompactString()));
-		}
+		TraceMovement(ECFrameMovementTraceType::Replay, Context.ICF);
 		// 历史记录无法被直接覆盖，需要取出后进行修改
-		FStructView MovementSnapshotView = CFrameManager->ReadAttributeFromSnapshotBuffer(Context.ICF, FCFrameMovementSnapshot::StaticStruct());
+		FStructView MovementSnapshotView = CFrameManager->ReadAttributeFromSnapshotBuffer(Context.ICF, Context.MoverComp->GetMovementSnapshotKey());
 		if (MovementSnapshotView.IsValid())
 		{
 			FCFrameMovementSnapshot& Snapshot = MovementSnapshotView.Get<FCFrameMovementSnapshot>();
@@ -213,14 +231,7 @@ void UCFrameMoveModeStateMachine::RecordMovementSnapshot()
 	}
 	else
 	{
-		if (GetWorld()->GetNetMode() == NM_Client)
-		{
-			UE_LOG(LogMoveModeStateMachine, Log, TEXT("[Client] RCF[%d] Location[%s]"), Context.RCF, *(MoveStateAdapter->GetLocation_WorldSpace().ToCompactString()));
-		}
-		else
-		{
-			UE_LOG(LogMoveModeStateMachine, Log, TEXT("[Server] RCF[%d] Location[%s]"), Context.RCF, *(MoveStateAdapter->GetLocation_WorldSpace().ToCompactString()));
-		}
+		TraceMovement(ECFrameMovementTraceType::Tick, Context.RCF);
 		FCFrameMovementSnapshot Snapshot;
 
 		Snapshot.Location = MoveStateAdapter->GetLocation_WorldSpace();
@@ -232,6 +243,28 @@ void UCFrameMoveModeStateMachine::RecordMovementSnapshot()
 		Snapshot.MovementBasePos = MoveStateAdapter->GetMovementBasePos();
 		Snapshot.MovementBaseQuat = MoveStateAdapter->GetMovementBaseQuat();
 
-		CFrameManager->AttributeSnapshotBuffer.RecordItemData(FCFrameMovementSnapshot::StaticStruct(), (uint8*)&Snapshot, Context.RCF);
+		CFrameManager->AttributeSnapshotBuffer.RecordItemData(Context.MoverComp->GetMovementSnapshotKey(), (uint8*)&Snapshot, Context.RCF);
 	}
-}
\ No newline at end of file
+}
+
+void UCFrameMoveModeStateMachine::TraceMovement(ECFrameMovementTraceType Type, uint32 Frame)
+{
+	const bool bClient = GetWorld()->GetNetMode() == NM_Client;
+
+	UE_CFRAME_MOVE_LOG(LogMoveModeStateMachine, Verbose, TEXT("[%s] %s[%d] Location[%s]"), bClient ? TEXT("Client") : TEXT("Server"), Type == ECFrameMovementTraceType::Replay ? TEXT("ICF") : TEXT("RCF"), Frame, *(Context.MoveStateAdapter->GetLocation_WorldSpace().ToCompactString()));
+
+	if (FCFrameMovementTrace::IsEnabled())
+	{
+		FCFrameMovementTrace& Trace = FCFrameMovementTrace::Get();
+
+		FCFrameMovementTraceEvent Event;
+		Event.Frame = Frame;
+		Event.EntityIndex = Context.MoverComp->GetMovementSnapshotKey().EntityIndex;
+		Event.ModeId = Trace.GetModeId(CurrentModeName);
+		Event.Type = Type;
+		Event.bClient = bClient;
+		Event.Position = Context.MoveStateAdapter->GetLocation_WorldSpace();
+		Event.Velocity = Context.MoveStateAdapter->GetVelocity_WorldSpace();
+		Trace.Record(Event);
+	}
+}
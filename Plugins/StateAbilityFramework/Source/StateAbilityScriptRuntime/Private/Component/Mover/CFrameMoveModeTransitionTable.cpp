@@ -0,0 +1,125 @@
+#include "Component/Mover/CFrameMoveModeTransitionTable.h"
+
+#include "Component/Mover/CFrameMovementMode.h"
+#include "Component/Mover/CFrameMovementTransition.h"
+
+#include "Algo/StableSort.h"
+
+void FCFrameMoveModeTransitionTable::Compile(TConstArrayView<TObjectPtr<UCFrameMovementMode>> Modes, TConstArrayView<FCFrameModeTransitionLink> Links)
+{
+	Reset();
+
+	check(Modes.Num() < CFrameMoveMode::InvalidId);
+
+	auto FindModeId = [&Modes](FName ModeName) -> uint8
+	{
+		for (int32 ModeId = 0; ModeId < Modes.Num(); ++ModeId)
+		{
+			if (Modes[ModeId] && Modes[ModeId]->GetModeName() == ModeName)
+			{
+				return (uint8)ModeId;
+			}
+		}
+		return CFrameMoveMode::InvalidId;
+	};
+
+	struct FPendingTransition
+	{
+		FCFrameCompiledTransition Compiled;
+		uint8 FromModeId;
+		int32 Priority;
+	};
+
+	TArray<FPendingTransition> Pending;
+	Pending.Reserve(Links.Num());
+	for (const FCFrameModeTransitionLink& Link : Links)
+	{
+		if (Link.ModeTransition == nullptr)
+		{
+			continue;
+		}
+
+		const uint8 FromModeId = FindModeId(Link.FromMode);
+		const uint8 ToModeId = FindModeId(Link.ToMode);
+		if (FromModeId == CFrameMoveMode::InvalidId || ToModeId == CFrameMoveMode::InvalidId)
+		{
+			UE_LOG(LogCFrameMoveModeTransition, Warning, TEXT("Transition[%s] FromMode[%s] ToMode[%s] not found. Is the wrong ModeName configured?"),
+				*(Link.ModeTransition->GetName()), *(Link.FromMode.ToString()), *(Link.ToMode.ToString()));
+			continue;
+		}
+
+		const UCFrameMoveModeTransition* Transition = Link.ModeTransition->GetDefaultObject<UCFrameMoveModeTransition>();
+		ensureMsgf(!Transition->GetFromModeClass() || Modes[FromModeId]->GetClass()->IsChildOf(Transition->GetFromModeClass()), TEXT("FromMode[%s] is does not match Transition[%s]"),
+			*(Link.FromMode.ToString()), *(Link.ModeTransition->GetName()));
+
+		FPendingTransition& Entry = Pending.AddDefaulted_GetRef();
+		Entry.Compiled.Transition = Transition;
+		Entry.Compiled.PrecheckMask = Transition->GetPrecheckMask();
+		Entry.Compiled.PrecheckValue = Transition->GetPrecheckValue();
+		Entry.Compiled.bPrecheckOnly = Transition->IsPrecheckOnly();
+		Entry.Compiled.ToModeId = ToModeId;
+		Entry.FromModeId = FromModeId;
+		Entry.Priority = Link.Priority;
+	}
+
+	// 同优先级保持配置顺序
+	Algo::StableSort(Pending, [](const FPendingTransition& A, const FPendingTransition& B)
+	{
+		return A.FromModeId != B.FromModeId ? A.FromModeId < B.FromModeId : A.Priority > B.Priority;
+	});
+
+	check(Pending.Num() <= MAX_uint16);
+
+	Transitions.Reserve(Pending.Num());
+	ModeOffsets.SetNumZeroed(Modes.Num() + 1);
+	for (const FPendingTransition& Entry : Pending)
+	{
+		Transitions.Add(Entry.Compiled);
+		++ModeOffsets[Entry.FromModeId + 1];
+	}
+	for (int32 ModeId = 0; ModeId < Modes.Num(); ++ModeId)
+	{
+		ModeOffsets[ModeId + 1] += ModeOffsets[ModeId];
+	}
+}
+
+void FCFrameMoveModeTransitionTable::Reset()
+{
+	Transitions.Reset();
+	ModeOffsets.Reset();
+}
+
+uint8 FCFrameMoveModeTransitionTable::Evaluate(uint8 FromModeId, ECFrameMoveModeFlags ModeFlags, FCFrameMovementContext& Context) const
+{
+	if (FromModeId + 1 >= ModeOffsets.Num())
+	{
+		return CFrameMoveMode::InvalidId;
+	}
+
+	const FCFrameCompiledTransition* It = Transitions.GetData() + ModeOffsets[FromModeId];
+	const FCFrameCompiledTransition* End = Transitions.GetData() + ModeOffsets[FromModeId + 1];
+	for (; It != End; ++It)
+	{
+		if ((ModeFlags & It->PrecheckMask) != It->PrecheckValue)
+		{
+			continue;
+		}
+
+		if (It->bPrecheckOnly || It->Transition->OnEvaluate(Context))
+		{
+			return It->ToModeId;
+		}
+	}
+
+	return CFrameMoveMode::InvalidId;
+}
+
+TConstArrayView<FCFrameCompiledTransition> FCFrameMoveModeTransitionTable::GetTransitions(uint8 FromModeId) const
+{
+	if (FromModeId + 1 >= ModeOffsets.Num())
+	{
+		return TConstArrayView<FCFrameCompiledTransition>();
+	}
+
+	return TConstArrayView<FCFrameCompiledTransition>(Transitions.GetData() + ModeOffsets[FromModeId], ModeOffsets[FromModeId + 1] - ModeOffsets[FromModeId]);
+}
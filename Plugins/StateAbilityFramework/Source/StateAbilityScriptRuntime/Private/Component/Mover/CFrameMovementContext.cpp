@@ -32,13 +32,16 @@ void FCFrameMovementContext::ResetFrameData()
 	CurrentMode = nullptr;
 
 	CombinedMove.Clear();
+	VelocityBatch = nullptr;
+	SweepBatch = nullptr;
+	SweepIndex = INDEX_NONE;
 }
 
 void FCFrameMovementContext::ResetAllData()
 {
 	ResetFrameData();
 
-	PersistentDataBuffer.Empty();
+	PersistentData.Reset();
 }
 
 bool FCFrameMovementContext::IsDataValid()
@@ -47,20 +50,3 @@ bool FCFrameMovementContext::IsDataValid()
 		IsValid(MoveStateAdapter) &&
 		IsValid(CFrameManager);
 }
-
-FStructView FCFrameMovementContext::GetPersistentData(FName Key)
-{
-	return PersistentDataBuffer.FindOrAdd(Key).Data;
-}
-void FCFrameMovementContext::RemovePersistentData(FName Key)
-{
-	PersistentDataBuffer.Remove(Key);
-}
-void FCFrameMovementContext::InvalidPersistentData(FName Key)
-{
-	PersistentDataBuffer.FindOrAdd(Key).bIsHidden = true;
-}
-bool FCFrameMovementContext::HasValidPersistentData(FName Key)
-{
-	return !PersistentDataBuffer.FindOrAdd(Key).bIsHidden;
-}
\ No newline at end of file
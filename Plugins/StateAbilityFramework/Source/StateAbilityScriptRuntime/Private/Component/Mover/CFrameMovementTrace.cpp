@@ -0,0 +1,151 @@
+#include "Component/Mover/CFrameMovementTrace.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCFrameMovementTrace, Log, All)
+
+bool FCFrameMovementTrace::bEnabled = false;
+FAutoConsoleVariableRef CVarCFrame_Mover_Trace(TEXT("CFrame.Mover.Trace"), FCFrameMovementTrace::bEnabled, TEXT("If true, every mover fixed tick records a binary trace event (frame, entity, mode, position, velocity) into a ring buffer. See CFrame.Mover.TraceDump."));
+
+int32 MoverTraceCapacity = 65536;
+FAutoConsoleVariableRef CVarCFrame_Mover_TraceCapacity(TEXT("CFrame.Mover.TraceCapacity"), MoverTraceCapacity, TEXT("Number of events kept in the mover trace ring buffer, rounded up to a power of two. Read once when the buffer is created."));
+
+FAutoConsoleCommand CmdCFrame_Mover_TraceDump(TEXT("CFrame.Mover.TraceDump"), TEXT("Writes the mover trace ring buffer to Saved/Profiling/CFrameMovementTrace (or the given path). Decode it with -run=CFrameMovementTraceDecode."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString FilePath = Args.Num() > 0 ? Args[0] : FPaths::Combine(FPaths::ProfilingDir(), TEXT("CFrameMovementTrace"), FDateTime::Now().ToString() + TEXT(".cfmtrace"));
+		if (FCFrameMovementTrace::Get().SaveToFile(FilePath))
+		{
+			UE_LOG(LogCFrameMovementTrace, Display, TEXT("Saved %d events to %s"), FCFrameMovementTrace::Get().Num(), *FilePath);
+		}
+	}));
+
+FCFrameMovementTrace::FCFrameMovementTrace(int32 InCapacity)
+{
+	const int32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 1));
+	Events.SetNumZeroed(Capacity);
+	IndexMask = Capacity - 1;
+}
+
+FCFrameMovementTrace& FCFrameMovementTrace::Get()
+{
+	static FCFrameMovementTrace Trace(MoverTraceCapacity);
+	return Trace;
+}
+
+uint8 FCFrameMovementTrace::GetModeId(FName ModeName)
+{
+	int32 ModeId = ModeNames.Find(ModeName);
+	if (ModeId == INDEX_NONE && ModeNames.Num() < MAX_uint8)
+	{
+		ModeId = ModeNames.Add(ModeName);
+	}
+
+	return ModeId == INDEX_NONE ? MAX_uint8 : (uint8)ModeId;
+}
+
+FName FCFrameMovementTrace::GetModeName(uint8 ModeId) const
+{
+	return ModeNames.IsValidIndex(ModeId) ? ModeNames[ModeId] : NAME_None;
+}
+
+void FCFrameMovementTrace::Reset()
+{
+	WriteIndex.store(0, std::memory_order_relaxed);
+}
+
+int32 FCFrameMovementTrace::Num() const
+{
+	return (int32)FMath::Min<uint64>(WriteIndex.load(std::memory_order_relaxed), Events.Num());
+}
+
+void FCFrameMovementTrace::CopyEvents(TArray<FCFrameMovementTraceEvent>& OutEvents) const
+{
+	const uint64 EndIndex = WriteIndex.load(std::memory_order_relaxed);
+	const int32 EventNum = Num();
+
+	OutEvents.SetNumUninitialized(EventNum);
+	for (int32 Index = 0; Index < EventNum; ++Index)
+	{
+		OutEvents[Index] = Events[(EndIndex - EventNum + Index) & IndexMask];
+	}
+}
+
+bool FCFrameMovementTrace::SaveToFile(const FString& FilePath) const
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Ar)
+	{
+		UE_LOG(LogCFrameMovementTrace, Error, TEXT("Failed to create %s"), *FilePath);
+		return false;
+	}
+
+	TArray<FCFrameMovementTraceEvent> OrderedEvents;
+	CopyEvents(OrderedEvents);
+
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+	uint16 EventSize = sizeof(FCFrameMovementTraceEvent);
+	*Ar << Magic << Version << EventSize;
+
+	TArray<FString> ModeNameStrings;
+	for (const FName& ModeName : ModeNames)
+	{
+		ModeNameStrings.Add(ModeName.ToString());
+	}
+	*Ar << ModeNameStrings;
+
+	int32 EventNum = OrderedEvents.Num();
+	*Ar << EventNum;
+	Ar->Serialize(OrderedEvents.GetData(), EventNum * sizeof(FCFrameMovementTraceEvent));
+
+	return Ar->Close();
+}
+
+bool FCFrameMovementTrace::LoadFromFile(const FString& FilePath, TArray<FCFrameMovementTraceEvent>& OutEvents, TArray<FName>& OutModeNames)
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Ar)
+	{
+		UE_LOG(LogCFrameMovementTrace, Error, TEXT("Failed to open %s"), *FilePath);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	uint16 EventSize = 0;
+	*Ar << Magic << Version << EventSize;
+
+	if (Magic != FileMagic || Version != FileVersion || EventSize != sizeof(FCFrameMovementTraceEvent))
+	{
+		UE_LOG(LogCFrameMovementTrace, Error, TEXT("%s is not a movement trace of version %d"), *FilePath, FileVersion);
+		return false;
+	}
+
+	TArray<FString> ModeNameStrings;
+	*Ar << ModeNameStrings;
+
+	OutModeNames.Reset(ModeNameStrings.Num());
+	for (const FString& ModeName : ModeNameStrings)
+	{
+		OutModeNames.Add(FName(*ModeName));
+	}
+
+	int32 EventNum = 0;
+	*Ar << EventNum;
+
+	if (Ar->IsError() || EventNum < 0 || (int64)EventNum * (int64)sizeof(FCFrameMovementTraceEvent) > Ar->TotalSize() - Ar->Tell())
+	{
+		UE_LOG(LogCFrameMovementTrace, Error, TEXT("%s is truncated"), *FilePath);
+		return false;
+	}
+
+	OutEvents.SetNumUninitialized(EventNum);
+	Ar->Serialize(OutEvents.GetData(), EventNum * sizeof(FCFrameMovementTraceEvent));
+
+	return !Ar->IsError();
+}
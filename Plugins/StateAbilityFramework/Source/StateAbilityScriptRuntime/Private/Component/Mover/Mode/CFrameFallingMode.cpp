@@ -11,6 +11,7 @@
 #include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
 #include "Component/Mover/MoveLibrary/CFrameGroundMoveUtils.h"
 #include "Component/Mover/MoveLibrary/CFrameAirMoveUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameVelocityBatch.h"
 
 UCFrameFallingMode::UCFrameFallingMode(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -128,7 +129,7 @@ void UCFrameFallingMode::GenerateMove(FCFrameMovementContext& Context, FCFramePr
 
 	FFloorCheckResult LastFloorResult;
 	// limit our moveinput based on the floor we're on
-	if (Context.GetPersistentData(CFrameContextDataKey::LastFloorResult, LastFloorResult))
+	if (Context.GetPersistentData(LastFloorResult))
 	{
 		if (LastFloorResult.HitResult.IsValidBlockingHit() && LastFloorResult.HitResult.Normal.Z > VERTICAL_SLOPE_NORMAL_Z && !LastFloorResult.IsWalkableFloor())
 		{
@@ -142,7 +143,35 @@ void UCFrameFallingMode::GenerateMove(FCFrameMovementContext& Context, FCFramePr
 		}
 	}
 
+	if (Context.VelocityBatch)
+	{
+		// 速度由批处理统一计算，见 ResolveBatchedMove
+		PendingMoveParams = Params;
+		PendingStartVelocity = StartVelocity;
+		PendingVelocityIndex = Context.VelocityBatch->Add(FCFrameAirMoveUtils::MakeComputeVelocityParams(Params));
+		return;
+	}
+
 	FCFrameAirMoveUtils::ComputeControlledFreeMove(Params, OutProposedMove);
+	FinishGenerateMove(Context, StartVelocity, OutProposedMove);
+}
+
+void UCFrameFallingMode::ResolveBatchedMove(FCFrameMovementContext& Context, const FCFrameVelocityBatch& Batch, FCFrameProposedMove& OutProposedMove)
+{
+	if (PendingVelocityIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FCFrameAirMoveUtils::ComputeControlledFreeMove(PendingMoveParams, Batch.GetVelocity(PendingVelocityIndex), OutProposedMove);
+	PendingVelocityIndex = INDEX_NONE;
+
+	FinishGenerateMove(Context, PendingStartVelocity, OutProposedMove);
+}
+
+void UCFrameFallingMode::FinishGenerateMove(FCFrameMovementContext& Context, const FVector& StartVelocity, FCFrameProposedMove& OutProposedMove) const
+{
+	UCFrameMoverComponent* MoverComp = Context.MoverComp;
 	const FVector VelocityWithGravity = StartVelocity + FCFrameMovementUtils::ComputeVelocityFromGravity(MoverComp->GetGravityAcceleration(), Context.DeltaTime);
 
 	//  If we are going faster than TerminalVerticalVelocity apply VerticalFallingDeceleration otherwise reset Z velocity to before we applied deceleration 
@@ -178,8 +207,8 @@ void UCFrameFallingMode::Execute(FCFrameMovementContext& Context)
 
 	//const FVector GravityAccel = FVector(0.0f, 0.0f, -9800.0f);	// -9.8 m / sec^2
 
-	Context.InvalidPersistentData(CFrameContextDataKey::LastFloorResult);	// falling = no valid floor
-	Context.InvalidPersistentData(CFrameContextDataKey::LastFoundDynamicMovementBase);	// falling = no valid floor
+	Context.InvalidPersistentData<FFloorCheckResult>();	// falling = no valid floor
+	Context.InvalidPersistentData<FCFrameRelativeBaseInfo>();	// falling = no valid floor
 
 	// Use the orientation intent directly. If no intent is provided, use last frame's orientation. Note that we are assuming rotation changes can't fail. 
 	FRotator TargetOrient = MoveStateAdapter->GetOrientation_WorldSpace();
@@ -198,7 +227,7 @@ void UCFrameFallingMode::Execute(FCFrameMovementContext& Context)
 	FHitResult MoveHitResult(1.f);
 	const FQuat TargetOrientQuat = TargetOrient.Quaternion();
 
-	FCFrameMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, OrigMoveDelta, TargetOrientQuat, true, MoveHitResult, ETeleportType::None);
+	FCFrameMovementUtils::TryBatchedMoveUpdatedComponent(Context.SweepBatch, Context.SweepIndex, UpdatedComponent, UpdatedPrimitive, OrigMoveDelta, TargetOrientQuat, MoveHitResult);
 
 	// Compute final velocity based on how long we actually go until we get a hit.
 	FVector NewFallingVelocity = MoveStateAdapter->GetVelocity_WorldSpace();
@@ -222,7 +251,7 @@ void UCFrameFallingMode::Execute(FCFrameMovementContext& Context)
 		}
 
 		LandingFloor.HitResult = MoveHitResult;
-		Context.SetPersistentData(CFrameContextDataKey::LastFloorResult, LandingFloor);
+		Context.SetPersistentData(LandingFloor);
 
 		MoverComp->HandleImpact(MoveHitResult, GetModeName(), OrigMoveDelta);
 
@@ -287,7 +316,7 @@ void UCFrameFallingMode::CaptureFinalState(FCFrameMovementContext& Context, cons
 
 			bIsOnWalkableFloor = true;
 
-			Context.SetPersistentData(CFrameContextDataKey::LastFloorResult, FloorResult);
+			Context.SetPersistentData(FloorResult);
 
 			if (FCFrameBasedMoveUtils::IsADynamicBase(FloorResult.HitResult.GetComponent()))
 			{
@@ -307,7 +336,7 @@ void UCFrameFallingMode::CaptureFinalState(FCFrameMovementContext& Context, cons
 
 	if (CurrentBaseInfo.HasRelativeInfo())
 	{
-		Context.SetPersistentData(CFrameContextDataKey::LastFoundDynamicMovementBase, CurrentBaseInfo);
+		Context.SetPersistentData(CurrentBaseInfo);
 
 		Context.MoveStateAdapter->SetMovementBase(CurrentBaseInfo.MovementBase.Get(), CurrentBaseInfo.BoneName);
 	}
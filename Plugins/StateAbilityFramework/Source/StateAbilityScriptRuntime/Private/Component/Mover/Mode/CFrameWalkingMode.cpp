@@ -8,7 +8,9 @@
 #include "Component/CFrameMoverComponent.h"
 #include "Component/Mover/CFrameMovementContext.h"
 #include "Component/Mover/CFrameMoveStateAdapter.h"
+#include "Component/Mover/CFrameMovementTrace.h"
 #include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameVelocityBatch.h"
 #include "Component/Mover/MoveLibrary/CFrameGroundMoveUtils.h"
 #include "Component/Mover/MoveLibrary/CFrameBasedMoveUtils.h"
 
@@ -42,6 +44,7 @@ void UCFrameWalkingMode::OnDeactivated()
 {
 	Super::OnDeactivated();
 
+	FloorCache.Invalidate();
 
 	if (UCommandEnhancedInputComponent* CFrameInputComp = Cast<UCommandEnhancedInputComponent>(InputComponent))
 	{
@@ -73,7 +76,7 @@ void UCFrameWalkingMode::GenerateMove(FCFrameMovementContext& Context, FCFramePr
 
 
 	FFloorCheckResult LastFloorResult;
-	if (Context.GetPersistentData(CFrameContextDataKey::LastFloorResult, LastFloorResult) && LastFloorResult.IsWalkableFloor())
+	if (Context.GetPersistentData(LastFloorResult) && LastFloorResult.IsWalkableFloor())
 	{
 		MovementNormal = LastFloorResult.HitResult.ImpactNormal;
 	}
@@ -126,18 +129,42 @@ void UCFrameWalkingMode::GenerateMove(FCFrameMovementContext& Context, FCFramePr
 		Params.Friction *= BrakingFrictionFactor;
 	}
 
-	UE_LOG(LogCFrameWalkingMode, Log, TEXT("GenerateMove:	FrameInputVector[%s] OrientationIntent[%s]"), *(FrameInputVector.ToCompactString()), *(IntendedOrientation_WorldSpace.ToCompactString()));
+	UE_CFRAME_MOVE_LOG(LogCFrameWalkingMode, Verbose, TEXT("GenerateMove:	FrameInputVector[%s] OrientationIntent[%s]"), *(FrameInputVector.ToCompactString()), *(IntendedOrientation_WorldSpace.ToCompactString()));
+
+	if (Context.VelocityBatch)
+	{
+		// 速度由批处理统一计算，见 ResolveBatchedMove
+		PendingMoveParams = Params;
+		PendingVelocityIndex = Context.VelocityBatch->Add(FCFrameGroundMoveUtils::MakeComputeVelocityParams(Params));
+		return;
+	}
 
 	FCFrameGroundMoveUtils::ComputeControlledGroundMove(Params, OUT OutProposedMove);
+	FinishGenerateMove(Context, OutProposedMove);
+}
 
+void UCFrameWalkingMode::ResolveBatchedMove(FCFrameMovementContext& Context, const FCFrameVelocityBatch& Batch, FCFrameProposedMove& OutProposedMove)
+{
+	if (PendingVelocityIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FCFrameGroundMoveUtils::ComputeControlledGroundMove(PendingMoveParams, Batch.GetVelocity(PendingVelocityIndex), OUT OutProposedMove);
+	PendingVelocityIndex = INDEX_NONE;
 
+	FinishGenerateMove(Context, OutProposedMove);
+}
+
+void UCFrameWalkingMode::FinishGenerateMove(FCFrameMovementContext& Context, FCFrameProposedMove& OutProposedMove) const
+{
 	if (OutProposedMove.LinearVelocity.IsNearlyZero() && OutProposedMove.AngularVelocity.IsNearlyZero() && OutProposedMove.MovePlaneVelocity.IsNearlyZero())
 	{
-		UE_LOG(LogCFrameWalkingMode, Log, TEXT("GenerateMove:	The player stopped moving?"));
+		UE_CFRAME_MOVE_LOG(LogCFrameWalkingMode, Verbose, TEXT("GenerateMove:	The player stopped moving?"));
 	}
 	else
 	{
-		UE_LOG(LogCFrameWalkingMode, Log, TEXT("GenerateMove:	OutProposedMove RCF[%d] ICF[%d] LinearVelocity[%s] AngularVelocity[%s] MovePlaneVelocity[%s]."),
+		UE_CFRAME_MOVE_LOG(LogCFrameWalkingMode, Verbose, TEXT("GenerateMove:	OutProposedMove RCF[%d] ICF[%d] LinearVelocity[%s] AngularVelocity[%s] MovePlaneVelocity[%s]."),
 			Context.RCF, Context.ICF, *(OutProposedMove.LinearVelocity.ToCompactString()), *(OutProposedMove.AngularVelocity.ToCompactString()), *(OutProposedMove.MovePlaneVelocity.ToCompactString()));
 	}
 	/*if (TurnGenerator)
@@ -160,11 +187,11 @@ void UCFrameWalkingMode::Execute(FCFrameMovementContext& Context)
 
 	if (ProposedMove.LinearVelocity.IsNearlyZero() && ProposedMove.AngularVelocity.IsNearlyZero())
 	{
-		UE_LOG(LogCFrameWalkingMode, Log, TEXT("Execute:	The player stopped moving?"));
+		UE_CFRAME_MOVE_LOG(LogCFrameWalkingMode, Verbose, TEXT("Execute:	The player stopped moving?"));
 	}
 	else
 	{
-		UE_LOG(LogCFrameWalkingMode, Log, TEXT("Execute:	ProposedMove RCF[%d] ICF[%d] LinearVelocity[%s] AngularVelocity[%s]."), 
+		UE_CFRAME_MOVE_LOG(LogCFrameWalkingMode, Verbose, TEXT("Execute:	ProposedMove RCF[%d] ICF[%d] LinearVelocity[%s] AngularVelocity[%s]."), 
 			Context.RCF, Context.ICF, *(ProposedMove.LinearVelocity.ToCompactString()), *(ProposedMove.AngularVelocity.ToCompactString()));
 	}
 	
@@ -174,9 +201,9 @@ void UCFrameWalkingMode::Execute(FCFrameMovementContext& Context)
 	FFloorCheckResult CurrentFloor;
 
 	// If we don't have cached floor information, we need to search for it again
-	if (!Context.GetPersistentData(CFrameContextDataKey::LastFloorResult, CurrentFloor))
+	if (!Context.GetPersistentData(CurrentFloor))
 	{
-		UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
+		FloorCache.FindFloor(UpdatedComponent, UpdatedPrimitive,
 			FloorSweepDistance, MaxWalkSlopeCosine,
 			UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
 	}
@@ -216,7 +243,7 @@ void UCFrameWalkingMode::Execute(FCFrameMovementContext& Context)
 	{
 		// Attempt to move the full amount first
 		bDidAttemptMovement = true;
-		bool bMoved = FCFrameMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, CurMoveDelta, TargetOrientQuat, true, MoveHitResult, ETeleportType::None);
+		bool bMoved = FCFrameMovementUtils::TryBatchedMoveUpdatedComponent(Context.SweepBatch, Context.SweepIndex, UpdatedComponent, UpdatedPrimitive, CurMoveDelta, TargetOrientQuat, MoveHitResult);
 		float LastMoveSeconds = Context.DeltaTime;
 
 		if (MoveHitResult.bStartPenetrating)
@@ -276,7 +303,7 @@ void UCFrameWalkingMode::Execute(FCFrameMovementContext& Context)
 		}
 
 		// Search for the floor we've ended up on
-		UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
+		FloorCache.FindFloor(UpdatedComponent, UpdatedPrimitive,
 			FloorSweepDistance, MaxWalkSlopeCosine,
 			UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
 
@@ -297,7 +324,7 @@ void UCFrameWalkingMode::Execute(FCFrameMovementContext& Context)
 	else
 	{
 		// If the actor isn't moving we still need to check if they have a valid floor
-		UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
+		FloorCache.FindFloor(UpdatedComponent, UpdatedPrimitive,
 			FloorSweepDistance, MaxWalkSlopeCosine,
 			UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
 
@@ -364,7 +391,7 @@ void UCFrameWalkingMode::CaptureFinalState(FCFrameMovementContext& Context, bool
 	Context.MoveStateAdapter->UpdateMoveFrame();
 
 	FCFrameRelativeBaseInfo PriorBaseInfo;
-	const bool bHasPriorBaseInfo = Context.GetPersistentData(CFrameContextDataKey::LastFoundDynamicMovementBase, PriorBaseInfo);
+	const bool bHasPriorBaseInfo = Context.GetPersistentData(PriorBaseInfo);
 
 	FCFrameRelativeBaseInfo CurrentBaseInfo = UpdateFloorAndBaseInfo(Context, FloorResult);
 
@@ -379,13 +406,13 @@ void UCFrameWalkingMode::CaptureFinalState(FCFrameMovementContext& Context, bool
 
 	if (CurrentBaseInfo.HasRelativeInfo())
 	{
-		Context.SetPersistentData(CFrameContextDataKey::LastFoundDynamicMovementBase, CurrentBaseInfo);
+		Context.SetPersistentData(CurrentBaseInfo);
 
 		Context.MoveStateAdapter->SetMovementBase(CurrentBaseInfo.MovementBase.Get(), CurrentBaseInfo.BoneName);
 	}
 	else
 	{
-		Context.InvalidPersistentData(CFrameContextDataKey::LastFoundDynamicMovementBase);
+		Context.InvalidPersistentData<FCFrameRelativeBaseInfo>();
 
 		// no movement base
 		Context.MoveStateAdapter->SetMovementBase(nullptr, NAME_None);
@@ -405,7 +432,7 @@ FCFrameRelativeBaseInfo UCFrameWalkingMode::UpdateFloorAndBaseInfo(FCFrameMoveme
 {
 	FCFrameRelativeBaseInfo ReturnBaseInfo;
 
-	Context.SetPersistentData(CFrameContextDataKey::LastFloorResult, FloorResult);
+	Context.SetPersistentData(FloorResult);
 
 	if (FloorResult.IsWalkableFloor() && FCFrameBasedMoveUtils::IsADynamicBase(FloorResult.HitResult.GetComponent()))
 	{
@@ -6,9 +6,24 @@
 #include "Component/Mover/CFrameProposedMove.h"
 
 void FCFrameAirMoveUtils::ComputeControlledFreeMove(const FCFrameFreeMoveParams& InParams, OUT FCFrameProposedMove& OutProposedMove)
+{
+	ComputeControlledFreeMove(InParams, FCFrameMovementUtils::ComputeVelocity(MakeComputeVelocityParams(InParams)), OutProposedMove);
+}
+
+void FCFrameAirMoveUtils::ComputeControlledFreeMove(const FCFrameFreeMoveParams& InParams, const FVector& LinearVelocity, OUT FCFrameProposedMove& OutProposedMove)
 {
 	const FPlane MovementPlane(FVector::ZeroVector, FVector::UpVector);
 
+	OutProposedMove.LinearVelocity = LinearVelocity;
+	OutProposedMove.MovePlaneVelocity = FCFrameMovementUtils::ConstrainToPlane(OutProposedMove.LinearVelocity, MovementPlane, false);
+
+	// JAH TODO: this is where we can perform turning, based on aux settings. For now, just snap to the intended final orientation.
+	FVector IntendedFacingDir = InParams.OrientationIntent.RotateVector(FVector::ForwardVector).GetSafeNormal();
+	OutProposedMove.AngularVelocity = FCFrameMovementUtils::ComputeAngularVelocity(InParams.PriorOrientation, IntendedFacingDir.ToOrientationRotator(), InParams.DeltaSeconds, InParams.TurningRate);
+}
+
+FCFrameComputeVelocityParams FCFrameAirMoveUtils::MakeComputeVelocityParams(const FCFrameFreeMoveParams& InParams)
+{
 	FCFrameComputeVelocityParams ComputeVelocityParams;
 	ComputeVelocityParams.DeltaSeconds = InParams.DeltaSeconds;
 	ComputeVelocityParams.InitialVelocity = InParams.PriorVelocity;
@@ -18,12 +33,7 @@ void FCFrameAirMoveUtils::ComputeControlledFreeMove(const FCFrameFreeMoveParams&
 	ComputeVelocityParams.Deceleration = InParams.Deceleration;
 	ComputeVelocityParams.Acceleration = InParams.Acceleration;
 
-	OutProposedMove.LinearVelocity = FCFrameMovementUtils::ComputeVelocity(ComputeVelocityParams);
-	OutProposedMove.MovePlaneVelocity = FCFrameMovementUtils::ConstrainToPlane(OutProposedMove.LinearVelocity, MovementPlane, false);
-
-	// JAH TODO: this is where we can perform turning, based on aux settings. For now, just snap to the intended final orientation.
-	FVector IntendedFacingDir = InParams.OrientationIntent.RotateVector(FVector::ForwardVector).GetSafeNormal();
-	OutProposedMove.AngularVelocity = FCFrameMovementUtils::ComputeAngularVelocity(InParams.PriorOrientation, IntendedFacingDir.ToOrientationRotator(), InParams.DeltaSeconds, InParams.TurningRate);
+	return ComputeVelocityParams;
 }
 
 bool FCFrameAirMoveUtils::IsValidLandingSpot(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FHitResult& Hit, float FloorSweepDistance, float WalkableFloorZ, FFloorCheckResult& OutFloorResult)
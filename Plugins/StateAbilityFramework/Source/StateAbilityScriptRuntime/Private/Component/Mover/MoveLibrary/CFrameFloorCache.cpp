@@ -0,0 +1,152 @@
+#include "Component/Mover/MoveLibrary/CFrameFloorCache.h"
+
+#include "Components/PrimitiveComponent.h"
+
+#include "Buffer/BufferTypes.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floor Cache Hits"), STAT_CFrameFloorCacheHits, STATGROUP_CommandFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floor Cache Misses"), STAT_CFrameFloorCacheMisses, STATGROUP_CommandFrame);
+
+bool bEnableMoverFloorCache = true;
+FAutoConsoleVariableRef CVarCFrame_Mover_FloorCache(TEXT("CFrame.Mover.FloorCache"), bEnableMoverFloorCache, TEXT("If true, walking movers reuse the last FindFloor result while they and their movement base stay in place."));
+
+float MoverFloorCacheTolerance = 0.01f;
+FAutoConsoleVariableRef CVarCFrame_Mover_FloorCacheTolerance(TEXT("CFrame.Mover.FloorCacheTolerance"), MoverFloorCacheTolerance, TEXT("Quantization step and max location delta (cm) for which a cached floor result is reused."));
+
+void FCFrameFloorCache::FindFloor(const USceneComponent* UpdatedComponent, const UPrimitiveComponent* UpdatedPrimitive, float InFloorSweepDistance, float InMaxWalkSlopeCosine, const FVector& InLocation, FFloorCheckResult& OutFloorResult)
+{
+	if (!bEnableMoverFloorCache)
+	{
+		bValid = false;
+		UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, InFloorSweepDistance, InMaxWalkSlopeCosine, InLocation, OutFloorResult);
+		return;
+	}
+
+	if (IsValidFor(UpdatedPrimitive, InFloorSweepDistance, InMaxWalkSlopeCosine, InLocation))
+	{
+		++HitNum;
+		INC_DWORD_STAT(STAT_CFrameFloorCacheHits);
+
+		OutFloorResult = FloorResult;
+		return;
+	}
+
+	++MissNum;
+	INC_DWORD_STAT(STAT_CFrameFloorCacheMisses);
+
+	UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, InFloorSweepDistance, InMaxWalkSlopeCosine, InLocation, OutFloorResult);
+	Store(UpdatedPrimitive, InFloorSweepDistance, InMaxWalkSlopeCosine, InLocation, OutFloorResult);
+}
+
+void FCFrameFloorCache::Invalidate()
+{
+	bValid = false;
+	Base.Reset();
+}
+
+float FCFrameFloorCache::GetHitRate() const
+{
+	const uint32 QueryNum = HitNum + MissNum;
+	return QueryNum > 0 ? (float)HitNum / QueryNum : 0.0f;
+}
+
+void FCFrameFloorCache::ResetCounters()
+{
+	HitNum = 0;
+	MissNum = 0;
+}
+
+bool FCFrameFloorCache::IsValidFor(const UPrimitiveComponent* UpdatedPrimitive, float InFloorSweepDistance, float InMaxWalkSlopeCosine, const FVector& InLocation) const
+{
+	if (!bValid || !UpdatedPrimitive)
+	{
+		return false;
+	}
+
+	// Mover的位移超过阈值
+	if (Quantize(InLocation) != QuantizedLocation || FVector::DistSquared(InLocation, Location) > FMath::Square(MoverFloorCacheTolerance))
+	{
+		return false;
+	}
+
+	if (InFloorSweepDistance != FloorSweepDistance || InMaxWalkSlopeCosine != MaxWalkSlopeCosine)
+	{
+		return false;
+	}
+
+	// 胶囊体尺寸变化，例如蹲下
+	if (UpdatedPrimitive->GetCollisionShape().GetExtent() != ShapeExtent)
+	{
+		return false;
+	}
+
+	// 地面被销毁或移动
+	const UPrimitiveComponent* BaseComponent = Base.Get();
+	if (!BaseComponent || BaseComponent->Mobility != BaseMobility)
+	{
+		return false;
+	}
+
+	if (BaseMobility != EComponentMobility::Static && !BaseComponent->GetComponentTransform().Equals(BaseTransform, 0.0))
+	{
+		return false;
+	}
+
+	// 地面关闭碰撞，或任一方不再阻挡另一方
+	if (!IsSameCollision(UpdatedPrimitive, BaseComponent))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool FCFrameFloorCache::IsSameCollision(const UPrimitiveComponent* UpdatedPrimitive, const UPrimitiveComponent* BaseComponent) const
+{
+	return BaseComponent->GetCollisionEnabled() == BaseCollisionEnabled
+		&& BaseComponent->GetCollisionObjectType() == BaseObjectType
+		&& UpdatedPrimitive->GetCollisionObjectType() == MoverObjectType
+		&& BaseComponent->GetCollisionResponseToChannel(MoverObjectType) == BaseResponse
+		&& UpdatedPrimitive->GetCollisionResponseToChannel(BaseObjectType) == MoverResponse;
+}
+
+void FCFrameFloorCache::Store(const UPrimitiveComponent* UpdatedPrimitive, float InFloorSweepDistance, float InMaxWalkSlopeCosine, const FVector& InLocation, const FFloorCheckResult& InFloorResult)
+{
+	const UPrimitiveComponent* BaseComponent = InFloorResult.HitResult.GetComponent();
+
+	// 没有地面时没有可以监听的对象，下方随时可能出现新的地面
+	bValid = UpdatedPrimitive && BaseComponent && InFloorResult.bBlockingHit && !InFloorResult.HitResult.bStartPenetrating;
+	if (!bValid)
+	{
+		Base.Reset();
+		return;
+	}
+
+	QuantizedLocation = Quantize(InLocation);
+	Location = InLocation;
+	ShapeExtent = UpdatedPrimitive->GetCollisionShape().GetExtent();
+	FloorSweepDistance = InFloorSweepDistance;
+	MaxWalkSlopeCosine = InMaxWalkSlopeCosine;
+
+	Base = BaseComponent;
+	BaseMobility = BaseComponent->Mobility;
+	BaseTransform = BaseComponent->GetComponentTransform();
+
+	BaseCollisionEnabled = BaseComponent->GetCollisionEnabled();
+	BaseObjectType = BaseComponent->GetCollisionObjectType();
+	MoverObjectType = UpdatedPrimitive->GetCollisionObjectType();
+	BaseResponse = BaseComponent->GetCollisionResponseToChannel(MoverObjectType);
+	MoverResponse = UpdatedPrimitive->GetCollisionResponseToChannel(BaseObjectType);
+
+	FloorResult = InFloorResult;
+}
+
+FIntVector FCFrameFloorCache::Quantize(const FVector& InLocation)
+{
+	const double Step = FMath::Max((double)MoverFloorCacheTolerance, UE_DOUBLE_KINDA_SMALL_NUMBER);
+
+	return FIntVector(
+		FMath::FloorToInt32(InLocation.X / Step),
+		FMath::FloorToInt32(InLocation.Y / Step),
+		FMath::FloorToInt32(InLocation.Z / Step));
+}
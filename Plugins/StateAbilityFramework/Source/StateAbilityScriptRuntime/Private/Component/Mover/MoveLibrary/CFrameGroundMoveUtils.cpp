@@ -12,9 +12,25 @@
 DEFINE_LOG_CATEGORY_STATIC(LogCFrameGroundMove, Log, All)
 
 void FCFrameGroundMoveUtils::ComputeControlledGroundMove(const FCFrameGroundMoveParams& InParams, OUT FCFrameProposedMove& OutProposedMove)
+{
+	ComputeControlledGroundMove(InParams, FCFrameMovementUtils::ComputeVelocity(MakeComputeVelocityParams(InParams)), OutProposedMove);
+}
+
+void FCFrameGroundMoveUtils::ComputeControlledGroundMove(const FCFrameGroundMoveParams& InParams, const FVector& MovePlaneVelocity, OUT FCFrameProposedMove& OutProposedMove)
 {
 	const FPlane GroundSurfacePlane(FVector::ZeroVector, InParams.GroundNormal);
 
+	// Figure out linear velocity
+	OutProposedMove.MovePlaneVelocity = MovePlaneVelocity;
+	OutProposedMove.LinearVelocity = FCFrameMovementUtils::ConstrainToPlane(OutProposedMove.MovePlaneVelocity, GroundSurfacePlane, true);
+
+	// Linearly rotate in place
+	OutProposedMove.AngularVelocity = FCFrameMovementUtils::ComputeAngularVelocity(InParams.PriorOrientation, InParams.OrientationIntent, InParams.DeltaSeconds, InParams.TurningRate);
+
+}
+
+FCFrameComputeVelocityParams FCFrameGroundMoveUtils::MakeComputeVelocityParams(const FCFrameGroundMoveParams& InParams)
+{
 	FCFrameComputeVelocityParams ComputeVelocityParams;
 	ComputeVelocityParams.DeltaSeconds = InParams.DeltaSeconds;
 	ComputeVelocityParams.InitialVelocity = InParams.PriorVelocity;
@@ -25,13 +41,7 @@ void FCFrameGroundMoveUtils::ComputeControlledGroundMove(const FCFrameGroundMove
 	ComputeVelocityParams.Acceleration = InParams.Acceleration;
 	ComputeVelocityParams.Friction = InParams.Friction;
 
-	// Figure out linear velocity
-	OutProposedMove.MovePlaneVelocity = FCFrameMovementUtils::ComputeVelocity(ComputeVelocityParams);
-	OutProposedMove.LinearVelocity = FCFrameMovementUtils::ConstrainToPlane(OutProposedMove.MovePlaneVelocity, GroundSurfacePlane, true);
-
-	// Linearly rotate in place
-	OutProposedMove.AngularVelocity = FCFrameMovementUtils::ComputeAngularVelocity(InParams.PriorOrientation, InParams.OrientationIntent, InParams.DeltaSeconds, InParams.TurningRate);
-
+	return ComputeVelocityParams;
 }
 
 FVector FCFrameGroundMoveUtils::ComputeDeflectedMoveOntoRamp(const FVector& OrigMoveDelta, const FHitResult& RampHitResult, float MaxWalkSlopeCosine, const bool bHitFromLineTrace)
@@ -0,0 +1,94 @@
+#include "Component/Mover/MoveLibrary/CFrameMovementBaseNetSerializer.h"
+
+#include "Components/SkinnedMeshComponent.h"
+#include "Engine/SkinnedAsset.h"
+#include "Misc/Crc.h"
+
+bool FCFrameMovementBaseNetSerializer::Serialize(FArchive& Ar, UPrimitiveComponent*& MovementBase, FName& MovementBaseBoneName)
+{
+	Ar << MovementBase;
+	const bool bBoneMapped = SerializeBoneName(Ar, MovementBase, MovementBaseBoneName);
+
+	return Ar.IsSaving() || (MovementBase && bBoneMapped);
+}
+
+bool FCFrameMovementBaseNetSerializer::SerializeBoneName(FArchive& Ar, const UPrimitiveComponent* MovementBase, FName& MovementBaseBoneName)
+{
+	bool bHasBone = MovementBaseBoneName != NAME_None;
+	Ar.SerializeBits(&bHasBone, 1);
+
+	if (!bHasBone)
+	{
+		if (Ar.IsLoading())
+		{
+			MovementBaseBoneName = NAME_None;
+		}
+		return true;
+	}
+
+	uint32 BoneIndex = 0;
+	uint16 AssetCheck = 0;
+	bool bBoneIndex = false;
+	if (Ar.IsSaving())
+	{
+		const int32 FoundIndex = FindBoneIndex(MovementBase, MovementBaseBoneName);
+		bBoneIndex = FoundIndex != INDEX_NONE;
+		BoneIndex = bBoneIndex ? (uint32)FoundIndex : 0;
+		AssetCheck = bBoneIndex ? GetAssetCheck(MovementBase) : 0;
+	}
+
+	Ar.SerializeBits(&bBoneIndex, 1);
+
+	if (!bBoneIndex)
+	{
+		Ar << MovementBaseBoneName;
+		return true;
+	}
+
+	Ar.SerializeIntPacked(BoneIndex);
+	Ar << AssetCheck;
+
+	if (Ar.IsLoading())
+	{
+		// 资源不同时同一个索引对应的是另一个骨骼，不能还原
+		const bool bMapped = MovementBase && AssetCheck == GetAssetCheck(MovementBase);
+		MovementBaseBoneName = bMapped ? GetBoneName(MovementBase, (int32)BoneIndex) : NAME_None;
+		return MovementBaseBoneName != NAME_None;
+	}
+
+	return true;
+}
+
+int32 FCFrameMovementBaseNetSerializer::FindBoneIndex(const UPrimitiveComponent* MovementBase, FName BoneName)
+{
+	const USkinnedMeshComponent* SkinnedMesh = Cast<USkinnedMeshComponent>(MovementBase);
+	return SkinnedMesh && BoneName != NAME_None ? SkinnedMesh->GetBoneIndex(BoneName) : INDEX_NONE;
+}
+
+FName FCFrameMovementBaseNetSerializer::GetBoneName(const UPrimitiveComponent* MovementBase, int32 BoneIndex)
+{
+	const USkinnedMeshComponent* SkinnedMesh = Cast<USkinnedMeshComponent>(MovementBase);
+	return SkinnedMesh && BoneIndex >= 0 && BoneIndex < SkinnedMesh->GetNumBones() ? SkinnedMesh->GetBoneName(BoneIndex) : NAME_None;
+}
+
+uint16 FCFrameMovementBaseNetSerializer::GetAssetCheck(const UPrimitiveComponent* MovementBase)
+{
+	const USkinnedMeshComponent* SkinnedMesh = Cast<USkinnedMeshComponent>(MovementBase);
+	const USkinnedAsset* SkinnedAsset = SkinnedMesh ? SkinnedMesh->GetSkinnedAsset() : nullptr;
+	if (!SkinnedAsset)
+	{
+		return 0;
+	}
+
+	// 每个资源只在第一次遇到时计算路径的校验值
+	static thread_local TMap<TObjectKey<USkinnedAsset>, uint16> AssetChecks;
+	if (const uint16* AssetCheck = AssetChecks.Find(SkinnedAsset))
+	{
+		return *AssetCheck;
+	}
+
+	const uint32 PathCrc = FCrc::StrCrc32(*SkinnedAsset->GetPathName().ToLower());
+	// 0 保留给没有资源的情况
+	const uint16 AssetCheck = FMath::Max<uint16>((uint16)(PathCrc ^ (PathCrc >> 16)), 1);
+	return AssetChecks.Add(SkinnedAsset, AssetCheck);
+}
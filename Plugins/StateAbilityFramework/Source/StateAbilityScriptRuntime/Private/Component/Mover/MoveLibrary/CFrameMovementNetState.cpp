@@ -0,0 +1,104 @@
+#include "Component/Mover/MoveLibrary/CFrameMovementNetState.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "HAL/IConsoleManager.h"
+
+#include "Component/Mover/MoveLibrary/CFrameMovementBaseNetSerializer.h"
+
+bool bEnableMoverNetDelta = true;
+FAutoConsoleVariableRef CVarCFrame_Mover_NetDelta(TEXT("CFrame.Mover.NetDelta"), bEnableMoverNetDelta, TEXT("If true, the mover net sync only sends the fields that changed since the last frame the owning client acknowledged."));
+
+namespace
+{
+	void SerializeMovementBase(FArchive& Ar, FCFrameMovementNetState& State)
+	{
+		UPrimitiveComponent* MovementBase = State.MovementBase.Get();
+
+		bool bIsUsingMovementBase = MovementBase != nullptr;
+		Ar.SerializeBits(&bIsUsingMovementBase, 1);
+
+		bool bMapped = true;
+		if (bIsUsingMovementBase)
+		{
+			bMapped = FCFrameMovementBaseNetSerializer::Serialize(Ar, MovementBase, State.MovementBaseBoneName);
+		}
+		else
+		{
+			MovementBase = nullptr;
+			State.MovementBaseBoneName = NAME_None;
+		}
+
+		if (Ar.IsLoading())
+		{
+			State.MovementBase = MovementBase;
+			State.bMovementBaseUnmapped = !bMapped;
+		}
+	}
+}
+
+bool FCFrameMovementNetSerializer::NetSerialize(FArchive& Ar, const FCFrameMovementQuantization& Quantization, FCFrameMovementNetState& State, const FCFrameMovementNetHistory& History, uint32 AckFrame, uint32 KeyframeOffset)
+{
+	const FCFrameMovementNetState* BaseState = nullptr;
+	uint32 FrameGap = 0;
+
+	// 定期发送完整状态作为兜底，各Mover错开关键帧，避免同一帧内全部退化为完整同步
+	const bool bKeyframe = (State.Frame + KeyframeOffset) % FCFrameMovementNetHistory::Capacity == 0;
+
+	if (Ar.IsSaving() && bEnableMoverNetDelta && !bKeyframe && AckFrame != 0 && AckFrame < State.Frame && State.Frame - AckFrame < FCFrameMovementNetHistory::Capacity)
+	{
+		BaseState = History.Find(AckFrame);
+		FrameGap = State.Frame - AckFrame;
+	}
+
+	bool bDelta = BaseState != nullptr;
+	Ar.SerializeBits(&bDelta, 1);
+
+	ECFrameMovementNetFields Fields = ECFrameMovementNetFields::All;
+	if (bDelta)
+	{
+		Ar.SerializeIntPacked(FrameGap);
+
+		if (Ar.IsLoading())
+		{
+			BaseState = FrameGap != 0 && FrameGap < State.Frame ? History.Find(State.Frame - FrameGap) : nullptr;
+			if (!BaseState)
+			{
+				Ar.SetError();
+				return false;
+			}
+		}
+
+		// 未同步的字段沿用基准帧
+		FCFrameMovementNetState ResolvedState = *BaseState;
+		ResolvedState.Frame = State.Frame;
+
+		uint8 FieldBits = 0;
+		if (Ar.IsSaving())
+		{
+			Fields = State.GetChangedFields(*BaseState);
+			FieldBits = (uint8)Fields;
+		}
+
+		bool bUnchanged = Fields == ECFrameMovementNetFields::None;
+		Ar.SerializeBits(&bUnchanged, 1);
+		if (!bUnchanged)
+		{
+			Ar.SerializeBits(&FieldBits, CFrameMovementNetFieldBits);
+		}
+
+		if (Ar.IsLoading())
+		{
+			Fields = bUnchanged ? ECFrameMovementNetFields::None : (ECFrameMovementNetFields)FieldBits;
+			State = ResolvedState;
+		}
+	}
+
+	FCFrameMovementQuantizer::Serialize(Ar, Quantization, State.Location, State.Velocity, State.Orientation, Fields & ECFrameMovementNetFields::Quantized);
+
+	if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::MovementBase))
+	{
+		SerializeMovementBase(Ar, State);
+	}
+
+	return !Ar.IsError();
+}
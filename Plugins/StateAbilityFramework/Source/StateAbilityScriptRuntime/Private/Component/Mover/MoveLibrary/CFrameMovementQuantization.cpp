@@ -0,0 +1,47 @@
+#include "Component/Mover/MoveLibrary/CFrameMovementQuantization.h"
+
+#include "Engine/NetSerialization.h"
+
+void FCFrameMovementQuantizer::Serialize(FArchive& Ar, const FCFrameMovementQuantization& Quantization, FVector& Location, FVector& Velocity, FRotator& Orientation, ECFrameMovementNetFields Fields)
+{
+	switch (Quantization.Profile)
+	{
+	case ECFrameMovementQuantizationProfile::HighPrecision:
+		FCFrameMovementQuantizer_HighPrecision::Serialize(Ar, Location, Velocity, Orientation, Fields);
+		break;
+	case ECFrameMovementQuantizationProfile::LargeWorld:
+		FCFrameMovementQuantizer_LargeWorld::Serialize(Ar, Location, Velocity, Orientation, Fields);
+		break;
+	case ECFrameMovementQuantizationProfile::Compact:
+		FCFrameMovementQuantizer_Compact::Serialize(Ar, Location, Velocity, Orientation, Fields);
+		break;
+	case ECFrameMovementQuantizationProfile::Custom:
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Location))
+		{
+			CFrameQuantization::SerializeVector(Ar, Location, FMath::Max(Quantization.PositionScale, 1), FMath::Clamp(Quantization.PositionBits, 2, 32));
+		}
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Velocity))
+		{
+			CFrameQuantization::SerializeVector(Ar, Velocity, FMath::Max(Quantization.VelocityScale, 1), FMath::Clamp(Quantization.VelocityBits, 2, 32));
+		}
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Orientation))
+		{
+			CFrameQuantization::SerializeRotator(Ar, Orientation, FMath::Clamp(Quantization.RotationBits, 2, 24), Quantization.bYawOnly);
+		}
+		break;
+	default:
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Location))
+		{
+			SerializePackedVector<100, 30>(Location, Ar);
+		}
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Velocity))
+		{
+			SerializePackedVector<10, 16>(Velocity, Ar);
+		}
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Orientation))
+		{
+			Orientation.SerializeCompressedShort(Ar);
+		}
+		break;
+	}
+}
@@ -1,6 +1,7 @@
 #include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
 
 #include "Component/CFrameMoverComponent.h"
+#include "Component/Mover/MoveLibrary/CFrameSweepBatch.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogCFrameMovement, Log, All)
 
@@ -423,6 +424,25 @@ bool FCFrameMovementUtils::TrySafeMoveUpdatedComponent(USceneComponent* UpdatedC
 	return bMoveResult;
 }
 
+bool FCFrameMovementUtils::TryBatchedMoveUpdatedComponent(const FCFrameSweepBatch* SweepBatch, int32 SweepIndex, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Delta, const FQuat& NewRotation, FHitResult& OutHit)
+{
+	if (!SweepBatch || !UpdatedComponent || !SweepBatch->IsClearSweep(SweepIndex, UpdatedComponent->GetComponentLocation(), Delta))
+	{
+		return TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, Delta, NewRotation, true, OutHit, ETeleportType::None);
+	}
+
+	// 预查询确认整段路径没有任何命中，结果与扫掠完全相同：移动到终点，Time 为 1
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const EMoveComponentFlags MoveComponentFlags = (MOVECOMP_NeverIgnoreBlockingOverlaps | MOVECOMP_DisableBlockingOverlapDispatch);
+	const bool bMoveResult = TryMoveUpdatedComponent_Internal(UpdatedComponent, Delta, NewRotation, false, MoveComponentFlags, nullptr, ETeleportType::None);
+	OutHit.Init(Start, Start + Delta);
+
+	UE_LOG(LogCFrameMovement, VeryVerbose, TEXT("TryBatchedMove clear: %s (role %i) Delta=%s DidMove=%i"),
+		*GetNameSafe(UpdatedComponent->GetOwner()), UpdatedComponent->GetOwnerRole(), *Delta.ToCompactString(), bMoveResult);
+
+	return bMoveResult;
+}
+
 bool FCFrameMovementUtils::TryMoveUpdatedComponent_Internal(USceneComponent* UpdatedComponent, const FVector& Delta, const FQuat& NewRotation, bool bSweep, EMoveComponentFlags MoveComponentFlags, FHitResult* OutHit, ETeleportType Teleport)
 {
 
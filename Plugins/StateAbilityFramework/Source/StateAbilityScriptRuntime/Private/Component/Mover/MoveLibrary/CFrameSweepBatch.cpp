@@ -0,0 +1,174 @@
+#include "Component/Mover/MoveLibrary/CFrameSweepBatch.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+
+namespace CFrameSweepBatch
+{
+	// 已提交包围盒的网格大小，约等于几个胶囊体
+	constexpr double CellSize = 256.0;
+}
+
+FBox FCFrameSweepRequest::GetSweptBounds() const
+{
+	// 按外接球计算，不受旋转影响
+	const FVector Extent(Shape.GetExtent().GetMax());
+	const FVector End = Start + Delta;
+
+	return FBox(Start.ComponentMin(End) - Extent, Start.ComponentMax(End) + Extent);
+}
+
+void FCFrameSweepBatch::Reset()
+{
+	Requests.Reset();
+	ClearResults.Reset();
+	ClearNum = 0;
+
+	for (TPair<FIntVector, TArray<FBox>>& Cell : CommittedCells)
+	{
+		Cell.Value.Reset();
+	}
+}
+
+int32 FCFrameSweepBatch::Add(const FCFrameSweepRequest& Request)
+{
+	ClearResults.Add(0);
+	return Requests.Add(Request);
+}
+
+void FCFrameSweepBatch::Query(FQueryFunc QueryFunc, int32 MinBatchSize, bool bForceSingleThread)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_CFrameSweepBatch_Query);
+
+	const EParallelForFlags Flags = bForceSingleThread ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+
+	// 查询只读场景，每个查询只写自己的槽位
+	ParallelFor(TEXT("CFrameSweepBatch"), Requests.Num(), FMath::Max(MinBatchSize, 1), [this, &QueryFunc](int32 Index)
+	{
+		ClearResults[Index] = QueryFunc(Requests[Index]) ? 1 : 0;
+	}, Flags);
+
+	ClearNum = 0;
+	for (const uint8 bClear : ClearResults)
+	{
+		ClearNum += bClear;
+	}
+}
+
+bool FCFrameSweepBatch::QueryWorld(const UWorld* World, const FCFrameSweepRequest& Request)
+{
+	if (!World)
+	{
+		return false;
+	}
+
+	// 任何命中（阻挡、Touch、初始穿透）都交给提交阶段的串行扫掠处理
+	TArray<FHitResult> Hits;
+	World->SweepMultiByChannel(Hits, Request.Start, Request.Start + Request.Delta, Request.Rotation, Request.Channel, Request.Shape, Request.QueryParams, Request.ResponseParams);
+
+	return Hits.IsEmpty();
+}
+
+bool FCFrameSweepBatch::MakeRequest(UPrimitiveComponent* Primitive, const FVector& Delta, FCFrameSweepRequest& OutRequest)
+{
+	if (!Cast<UCapsuleComponent>(Primitive))
+	{
+		return false;
+	}
+
+	// MoveComponent 不扫掠过小的位移，见 UPrimitiveComponent::MoveComponentImpl
+	if (Delta.SizeSquared() <= FMath::Square(4.f * UE_KINDA_SMALL_NUMBER))
+	{
+		return false;
+	}
+
+	OutRequest.Start = Primitive->GetComponentLocation();
+	OutRequest.Delta = Delta;
+	OutRequest.Rotation = Primitive->GetComponentQuat();
+	OutRequest.Shape = Primitive->GetCollisionShape();
+	OutRequest.Channel = Primitive->GetCollisionObjectType();
+
+	// 与 MoveComponent 一致：忽略自身Actor，Touch 只在生成重叠事件时才需要
+	OutRequest.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(CFrameSweepBatch), false, Primitive->GetOwner());
+	OutRequest.ResponseParams = FCollisionResponseParams();
+	Primitive->InitSweepCollisionParams(OutRequest.QueryParams, OutRequest.ResponseParams);
+	OutRequest.QueryParams.bIgnoreTouches |= !Primitive->GetGenerateOverlapEvents();
+
+	return true;
+}
+
+bool FCFrameSweepBatch::IsClearSweep(int32 Index, const FVector& Start, const FVector& Delta) const
+{
+	if (!Requests.IsValidIndex(Index) || !ClearResults[Index])
+	{
+		return false;
+	}
+
+	const FCFrameSweepRequest& Request = Requests[Index];
+
+	// 位置或位移有任何变化（例如被之前提交的Mover推动），预查询都不再可信
+	if (Request.Start != Start || Request.Delta != Delta)
+	{
+		return false;
+	}
+
+	const FBox SweptBounds = Request.GetSweptBounds();
+	const FIntVector MinCell = GetCell(SweptBounds.Min);
+	const FIntVector MaxCell = GetCell(SweptBounds.Max);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<FBox>* Cell = CommittedCells.Find(FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (const FBox& Committed : *Cell)
+				{
+					if (Committed.Intersect(SweptBounds))
+					{
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void FCFrameSweepBatch::NotifyCommitted(const FBox& Bounds)
+{
+	if (!Bounds.IsValid)
+	{
+		return;
+	}
+
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				CommittedCells.FindOrAdd(FIntVector(X, Y, Z)).Add(Bounds);
+			}
+		}
+	}
+}
+
+FIntVector FCFrameSweepBatch::GetCell(const FVector& Location)
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CFrameSweepBatch::CellSize),
+		FMath::FloorToInt32(Location.Y / CFrameSweepBatch::CellSize),
+		FMath::FloorToInt32(Location.Z / CFrameSweepBatch::CellSize));
+}
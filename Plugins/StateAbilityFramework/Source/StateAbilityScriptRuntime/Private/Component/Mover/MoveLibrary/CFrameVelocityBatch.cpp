@@ -0,0 +1,195 @@
+#include "Component/Mover/MoveLibrary/CFrameVelocityBatch.h"
+
+namespace CFrameVelocityBatch
+{
+	typedef VectorRegister4Double FLane;
+
+	// double -> float -> double，复现标量版本中赋值给 float 时的截断
+	FORCEINLINE FLane RoundToFloat(const FLane& Value)
+	{
+		return FLane(MakeVectorRegisterFloatFromDouble(Value));
+	}
+
+	// 与 FVector::SizeSquared 的运算顺序一致
+	FORCEINLINE FLane SizeSquared(const FLane& X, const FLane& Y, const FLane& Z)
+	{
+		return VectorAdd(VectorAdd(VectorMultiply(X, X), VectorMultiply(Y, Y)), VectorMultiply(Z, Z));
+	}
+
+	// FCFrameMovementUtils::IsExceedingMaxSpeed 的阈值，MaxSpeed 为 float 精度
+	FORCEINLINE FLane ExceedingSpeedSquared(const FLane& InMaxSpeed)
+	{
+		const FLane OverVelocityPercent = VectorSetFloat1((double)1.01f);
+		const FLane ClampedMaxSpeed = VectorMax(GlobalVectorConstants::DoubleZero, InMaxSpeed);
+		const FLane MaxSpeedSquared = RoundToFloat(VectorMultiply(ClampedMaxSpeed, ClampedMaxSpeed));
+		return RoundToFloat(VectorMultiply(MaxSpeedSquared, OverVelocityPercent));
+	}
+
+	FORCEINLINE void Select(const FLane& Mask, const FLane& TrueX, const FLane& TrueY, const FLane& TrueZ, FLane& InOutX, FLane& InOutY, FLane& InOutZ)
+	{
+		InOutX = VectorSelect(Mask, TrueX, InOutX);
+		InOutY = VectorSelect(Mask, TrueY, InOutY);
+		InOutZ = VectorSelect(Mask, TrueZ, InOutZ);
+	}
+}
+
+void FCFrameVelocityBatch::Reset()
+{
+	Count = 0;
+
+	for (TArray<double>* Array : { &VelocityX, &VelocityY, &VelocityZ, &IntentX, &IntentY, &IntentZ, &DeltaSeconds, &MaxSpeed, &TurningBoost, &Friction, &Deceleration, &Acceleration, &ResultX, &ResultY, &ResultZ })
+	{
+		Array->Reset();
+	}
+}
+
+int32 FCFrameVelocityBatch::Add(const FCFrameComputeVelocityParams& InParams)
+{
+	const int32 Index = Count++;
+
+	if (Index == VelocityX.Num())
+	{
+		// 每次扩展一组 Lane，剩余部分以0填充，参与计算但不会被读取
+		for (TArray<double>* Array : { &VelocityX, &VelocityY, &VelocityZ, &IntentX, &IntentY, &IntentZ, &DeltaSeconds, &MaxSpeed, &TurningBoost, &Friction, &Deceleration, &Acceleration, &ResultX, &ResultY, &ResultZ })
+		{
+			Array->AddZeroed(LaneNum);
+		}
+	}
+
+	VelocityX[Index] = InParams.InitialVelocity.X;
+	VelocityY[Index] = InParams.InitialVelocity.Y;
+	VelocityZ[Index] = InParams.InitialVelocity.Z;
+	IntentX[Index] = InParams.MoveDirectionIntent.X;
+	IntentY[Index] = InParams.MoveDirectionIntent.Y;
+	IntentZ[Index] = InParams.MoveDirectionIntent.Z;
+	DeltaSeconds[Index] = InParams.DeltaSeconds;
+	MaxSpeed[Index] = InParams.MaxSpeed;
+	TurningBoost[Index] = InParams.TurningBoost;
+	Friction[Index] = InParams.Friction;
+	Deceleration[Index] = InParams.Deceleration;
+	Acceleration[Index] = InParams.Acceleration;
+
+	return Index;
+}
+
+void FCFrameVelocityBatch::Compute()
+{
+	using namespace CFrameVelocityBatch;
+
+	const FLane Zero = GlobalVectorConstants::DoubleZero;
+	const FLane One = GlobalVectorConstants::DoubleOne;
+	const FLane SmallNumber = VectorSetFloat1((double)UE_SMALL_NUMBER);
+	const FLane KindaSmallNumber = VectorSetFloat1((double)UE_KINDA_SMALL_NUMBER);
+
+	for (int32 Index = 0; Index < Count; Index += LaneNum)
+	{
+		FLane VelX = VectorLoad(&VelocityX[Index]);
+		FLane VelY = VectorLoad(&VelocityY[Index]);
+		FLane VelZ = VectorLoad(&VelocityZ[Index]);
+		const FLane Dt = VectorLoad(&DeltaSeconds[Index]);
+		const FLane LaneFriction = VectorLoad(&Friction[Index]);
+
+		//////////////////////////////////////////////////////////////////////////
+		// ControlAcceleration = MoveDirectionIntent.GetClampedToMaxSize(1.f)
+		FLane AccelX = VectorLoad(&IntentX[Index]);
+		FLane AccelY = VectorLoad(&IntentY[Index]);
+		FLane AccelZ = VectorLoad(&IntentZ[Index]);
+		{
+			const FLane IntentSizeSquared = SizeSquared(AccelX, AccelY, AccelZ);
+			const FLane Scale = VectorDivide(One, VectorSqrt(IntentSizeSquared));
+			Select(VectorCompareGT(IntentSizeSquared, One), VectorMultiply(AccelX, Scale), VectorMultiply(AccelY, Scale), VectorMultiply(AccelZ, Scale), AccelX, AccelY, AccelZ);
+		}
+
+		const FLane AccelSizeSquared = SizeSquared(AccelX, AccelY, AccelZ);
+		const FLane AnalogInputModifier = VectorSelect(VectorCompareGT(AccelSizeSquared, Zero), RoundToFloat(VectorSqrt(AccelSizeSquared)), Zero);
+		const FLane MaxPawnSpeed = RoundToFloat(VectorMultiply(VectorLoad(&MaxSpeed[Index]), AnalogInputModifier));
+		const FLane MaxPawnSpeedThreshold = ExceedingSpeedSquared(MaxPawnSpeed);
+
+		const FLane VelSizeSquared = SizeSquared(VelX, VelY, VelZ);
+		const FLane VelSize = VectorSqrt(VelSizeSquared);
+		const FLane HasVelocity = VectorCompareGT(VelSizeSquared, Zero);
+		const FLane ExceedingMaxSpeed = VectorCompareGT(VelSizeSquared, MaxPawnSpeedThreshold);
+		const FLane Accelerating = VectorBitwiseAnd(VectorCompareGT(AnalogInputModifier, Zero), VectorCompareLE(VelSizeSquared, MaxPawnSpeedThreshold));
+
+		//////////////////////////////////////////////////////////////////////////
+		// 有输入：改变速度方向，但不增加速度大小
+		FLane TurnX, TurnY, TurnZ;
+		{
+			const FLane TimeScale = VectorMin(VectorMax(Zero, RoundToFloat(VectorMultiply(Dt, VectorLoad(&TurningBoost[Index])))), One);
+			const FLane Factor = VectorMin(RoundToFloat(VectorMultiply(TimeScale, LaneFriction)), One);
+
+			TurnX = VectorAdd(VelX, VectorMultiply(VectorSubtract(VectorMultiply(AccelX, VelSize), VelX), Factor));
+			TurnY = VectorAdd(VelY, VectorMultiply(VectorSubtract(VectorMultiply(AccelY, VelSize), VelY), Factor));
+			TurnZ = VectorAdd(VelZ, VectorMultiply(VectorSubtract(VectorMultiply(AccelZ, VelSize), VelZ), Factor));
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 无输入或超速：按摩擦和减速度制动
+		FLane BrakeX, BrakeY, BrakeZ;
+		{
+			// Velocity.GetSafeNormal()
+			const FLane InvalidNormal = VectorCompareLT(VelSizeSquared, SmallNumber);
+			const FLane NormalScale = VectorDivide(One, VelSize);
+			const FLane NormalX = VectorSelect(InvalidNormal, Zero, VectorMultiply(VelX, NormalScale));
+			const FLane NormalY = VectorSelect(InvalidNormal, Zero, VectorMultiply(VelY, NormalScale));
+			const FLane NormalZ = VectorSelect(InvalidNormal, Zero, VectorMultiply(VelZ, NormalScale));
+
+			const FLane BrakeAmount = VectorMultiply(VectorAbs(VectorAdd(VectorMultiply(LaneFriction, VelSize), VectorLoad(&Deceleration[Index]))), Dt);
+			const FLane BrakeSize = RoundToFloat(VectorMax(VectorSubtract(VelSize, BrakeAmount), Zero));
+
+			BrakeX = VectorMultiply(NormalX, BrakeSize);
+			BrakeY = VectorMultiply(NormalY, BrakeSize);
+			BrakeZ = VectorMultiply(NormalZ, BrakeSize);
+
+			// 起始超速时，制动不能低于最大速度
+			const FLane BelowMaxSpeed = VectorCompareLT(SizeSquared(BrakeX, BrakeY, BrakeZ), RoundToFloat(VectorMultiply(MaxPawnSpeed, MaxPawnSpeed)));
+			Select(VectorBitwiseAnd(ExceedingMaxSpeed, BelowMaxSpeed), VectorMultiply(NormalX, MaxPawnSpeed), VectorMultiply(NormalY, MaxPawnSpeed), VectorMultiply(NormalZ, MaxPawnSpeed), BrakeX, BrakeY, BrakeZ);
+		}
+
+		Select(HasVelocity, VectorSelect(Accelerating, TurnX, BrakeX), VectorSelect(Accelerating, TurnY, BrakeY), VectorSelect(Accelerating, TurnZ, BrakeZ), VelX, VelY, VelZ);
+
+		//////////////////////////////////////////////////////////////////////////
+		// 施加加速度并限制速度大小
+		{
+			const FLane NewVelSizeSquared = SizeSquared(VelX, VelY, VelZ);
+			const FLane NewMaxSpeed = VectorSelect(VectorCompareGT(NewVelSizeSquared, MaxPawnSpeedThreshold), RoundToFloat(VectorSqrt(NewVelSizeSquared)), MaxPawnSpeed);
+
+			const FLane AccelScale = VectorAbs(VectorLoad(&Acceleration[Index]));
+			VelX = VectorAdd(VelX, VectorMultiply(VectorMultiply(AccelX, AccelScale), Dt));
+			VelY = VectorAdd(VelY, VectorMultiply(VectorMultiply(AccelY, AccelScale), Dt));
+			VelZ = VectorAdd(VelZ, VectorMultiply(VectorMultiply(AccelZ, AccelScale), Dt));
+
+			// Velocity.GetClampedToMaxSize(NewMaxSpeed)
+			const FLane ClampSizeSquared = SizeSquared(VelX, VelY, VelZ);
+			const FLane ClampScale = VectorMultiply(NewMaxSpeed, VectorDivide(One, VectorSqrt(ClampSizeSquared)));
+			Select(VectorCompareGT(ClampSizeSquared, VectorMultiply(NewMaxSpeed, NewMaxSpeed)), VectorMultiply(VelX, ClampScale), VectorMultiply(VelY, ClampScale), VectorMultiply(VelZ, ClampScale), VelX, VelY, VelZ);
+			Select(VectorCompareLT(NewMaxSpeed, KindaSmallNumber), Zero, Zero, Zero, VelX, VelY, VelZ);
+		}
+
+		VectorStore(VelX, &ResultX[Index]);
+		VectorStore(VelY, &ResultY[Index]);
+		VectorStore(VelZ, &ResultZ[Index]);
+	}
+}
+
+void FCFrameVelocityBatch::ComputeScalar()
+{
+	FCFrameComputeVelocityParams Params;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Params.InitialVelocity = FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]);
+		Params.MoveDirectionIntent = FVector(IntentX[Index], IntentY[Index], IntentZ[Index]);
+		Params.DeltaSeconds = DeltaSeconds[Index];
+		Params.MaxSpeed = MaxSpeed[Index];
+		Params.TurningBoost = TurningBoost[Index];
+		Params.Friction = Friction[Index];
+		Params.Deceleration = Deceleration[Index];
+		Params.Acceleration = Acceleration[Index];
+
+		const FVector Velocity = FCFrameMovementUtils::ComputeVelocity(Params);
+		ResultX[Index] = Velocity.X;
+		ResultY[Index] = Velocity.Y;
+		ResultZ[Index] = Velocity.Z;
+	}
+}
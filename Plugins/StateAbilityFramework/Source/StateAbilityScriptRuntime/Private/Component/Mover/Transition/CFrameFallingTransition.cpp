@@ -6,7 +6,9 @@
 UCFrameMoveModeTransition_FallToWalk::UCFrameMoveModeTransition_FallToWalk()
 	: Super(UCFrameFallingMode::StaticClass(), UCFrameWalkingMode::StaticClass())
 {
-
+	PrecheckMask = ECFrameMoveModeFlags::OnWalkableFloor;
+	PrecheckValue = ECFrameMoveModeFlags::OnWalkableFloor;
+	bPrecheckOnly = true;
 }
 
 bool UCFrameMoveModeTransition_FallToWalk::OnEvaluate(FCFrameMovementContext& Context) const
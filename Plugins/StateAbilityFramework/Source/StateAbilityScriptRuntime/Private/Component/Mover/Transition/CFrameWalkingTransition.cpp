@@ -6,7 +6,9 @@
 UCFrameMoveModeTransition_WalkToFall::UCFrameMoveModeTransition_WalkToFall()
 	: Super(UCFrameWalkingMode::StaticClass(), UCFrameFallingMode::StaticClass())
 {
-	
+	PrecheckMask = ECFrameMoveModeFlags::OnWalkableFloor;
+	PrecheckValue = ECFrameMoveModeFlags::None;
+	bPrecheckOnly = true;
 }
 
 bool UCFrameMoveModeTransition_WalkToFall::OnEvaluate(FCFrameMovementContext& Context) const
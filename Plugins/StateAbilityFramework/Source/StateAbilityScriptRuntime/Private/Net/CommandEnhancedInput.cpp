@@ -6,6 +6,7 @@
 #include "Engine/InputDelegateBinding.h"
 
 #include "CommandFrameSetting.h"
+#include "Buffer/BufferTypes.h"
 
 PRIVATE_DEFINE_FUNC_NAMESPACE(UCommandEnhancedInputComponent, APawn, void, SetupPlayerInputComponent, UInputComponent*);
 
@@ -204,10 +205,15 @@ const TArray<FCommandFrameInputAtom>& FCommandEnhancedInputFilter::GetInputData(
 
 //////////////////////////////////////////////////////////////////////////
 // UCommandEnhancedInputComponent
+uint32 UCommandEnhancedInputComponent::BindingVersion = 0;
+
 void UCommandEnhancedInputComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// 输入栈发生了变化
+	++BindingVersion;
+
 	APawn* Owner = GetOwner<APawn>();
 	if (!IsValid(Owner))
 	{
@@ -225,9 +231,18 @@ void UCommandEnhancedInputComponent::BeginPlay()
 	}
 }
 
+void UCommandEnhancedInputComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	++BindingVersion;
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UCommandEnhancedInputComponent::ClearActionBindings()
 {
 	Super::ClearActionBindings();
+
+	++BindingVersion;
 }
 
 void UCommandEnhancedInputComponent::ClearBindingsForObject(UObject* InOwner)
@@ -241,6 +256,8 @@ void UCommandEnhancedInputComponent::ClearBindingsForObject(UObject* InOwner)
 			It.RemoveCurrent();
 		}
 	}
+
+	++BindingVersion;
 }
 
 void UCommandEnhancedInputComponent::RemoveCommandInputByHandle(const uint32 Handle)
@@ -248,9 +265,77 @@ void UCommandEnhancedInputComponent::RemoveCommandInputByHandle(const uint32 Han
 	Super::RemoveBindingByHandle(Handle);
 
 	CommandInputEventBindingMap.Remove(Handle);
+
+	++BindingVersion;
 }
 
 void UCommandEnhancedInputComponent::RemoveCommandInput(const FInputBindingHandle& BindingToRemove)
 {
 	RemoveCommandInputByHandle(BindingToRemove.GetHandle());
-}
\ No newline at end of file
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FCommandFrameInputProcedure
+void FCommandFrameInputProcedure::BuildInputEventMap(TConstArrayView<UInputComponent*> InputStack, FCommandInputEventMap& OutInputEventMap)
+{
+	for (UInputComponent* IC : InputStack)
+	{
+		if (UCommandEnhancedInputComponent* CEInputComp = Cast<UCommandEnhancedInputComponent>(IC))
+		{
+			for (auto& BindingPair : CEInputComp->GetCommandInputBindings())
+			{
+				const TSharedPtr<FEnhancedInputActionEventBinding>& Binding = BindingPair.Value;
+
+				OutInputEventMap.FindOrAdd(Binding->GetAction()).Add(Binding);
+			}
+		}
+	}
+}
+
+void FCommandFrameInputProcedure::Dispatch(FCommandFrameInputFrame& InputFrame, const TMap<const FUniqueNetIdRepl, FCommandFrameInputProcedureCache>& ProcedureCaches)
+{
+	uint32 InputIndex = 0;
+
+	for (auto& Counter : InputFrame.OrderCounter)
+	{
+		const FUniqueNetIdRepl& NetId = Counter.Key;
+		const FCommandFrameInputProcedureCache* ProcedureCache = ProcedureCaches.Find(NetId);
+		uint8 Count = Counter.Value;
+
+		if (!Count || !ProcedureCache || ProcedureCache->InputEventMap.IsEmpty())
+		{
+			InputIndex += Count;
+			continue;
+		}
+
+		const FCommandInputEventMap& InputEventMap = ProcedureCache->InputEventMap;
+
+		while (Count--)
+		{
+			FCommandFrameInputAtom& InputAtom = InputFrame.InputQueue[InputIndex++];
+			const TArray<TSharedPtr<FEnhancedInputActionEventBinding>>* InputBindings = InputEventMap.Find(InputAtom.InputAction);
+			if (!InputBindings)
+			{
+				continue;
+			}
+
+			for (const TSharedPtr<FEnhancedInputActionEventBinding>& Binding : *InputBindings)
+			{
+				const ETriggerEvent BoundTriggerEvent = Binding->GetTriggerEvent();
+				// Raise appropriate delegate to report on event state
+				if (InputAtom.TriggerEvent == BoundTriggerEvent)
+				{
+					FCommandFrameInputActionInstance ActionData(InputAtom);
+					Binding->Execute(ActionData);
+
+					// Keep track of the triggered actions this tick so that we can quickly look them up later when determining chorded action state
+					if (BoundTriggerEvent == ETriggerEvent::Triggered)
+					{
+						// @TODO
+						// TriggeredActionsThisTick.Add(ActionData->GetSourceAction());
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,168 @@
+#include "Net/CommandFrameInterest.h"
+
+#include "Algo/BinarySearch.h"
+
+FCommandFrameInterestManager::FCommandFrameInterestManager()
+	: EnterRadius(0.0f)
+	, ExitRadius(0.0f)
+	, CellSize(0.0f)
+{
+
+}
+
+void FCommandFrameInterestManager::Init(float InEnterRadius, float InHysteresis)
+{
+	EnterRadius = FMath::Max(InEnterRadius, 0.0f);
+	ExitRadius = EnterRadius * (1.0f + FMath::Max(InHysteresis, 0.0f));
+	CellSize = ExitRadius;
+
+	Reset();
+}
+
+void FCommandFrameInterestManager::Reset()
+{
+	Entities.Reset();
+	Cells.Reset();
+	EntityIndices.Reset();
+	Relevancy.Reset();
+}
+
+void FCommandFrameInterestManager::BeginUpdate()
+{
+	Entities.Reset();
+	Cells.Reset();
+	EntityIndices.Reset();
+}
+
+void FCommandFrameInterestManager::AddEntity(uint32 EntityId, const FVector& Location)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	FEntity& Entity = Entities.AddDefaulted_GetRef();
+	Entity.EntityId = EntityId;
+	Entity.CellKey = MakeCellKey(GetCellCoord(Location));
+	Entity.Location = Location;
+}
+
+void FCommandFrameInterestManager::EndUpdate()
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	Entities.Sort([](const FEntity& A, const FEntity& B) {
+		return A.CellKey < B.CellKey;
+	});
+
+	for (int32 Index = 0; Index < Entities.Num(); ++Index)
+	{
+		const FEntity& Entity = Entities[Index];
+
+		FCellRange& Range = Cells.FindOrAdd(Entity.CellKey, FCellRange{ Index, Index });
+		Range.End = Index + 1;
+
+		EntityIndices.Add(Entity.EntityId, Index);
+	}
+
+	for (const FEntity& Viewer : Entities)
+	{
+		UpdateRelevantEntities(Viewer, Relevancy.FindOrAdd(Viewer.EntityId));
+	}
+
+	// 已离开的观察者不再保留滞后状态
+	RemovedViewers.Reset();
+	for (const auto& RelevancyPair : Relevancy)
+	{
+		if (!EntityIndices.Contains(RelevancyPair.Key))
+		{
+			RemovedViewers.Add(RelevancyPair.Key);
+		}
+	}
+	for (const uint32 ViewerId : RemovedViewers)
+	{
+		Relevancy.Remove(ViewerId);
+	}
+}
+
+bool FCommandFrameInterestManager::IsRelevant(uint32 ViewerId, uint32 TargetId) const
+{
+	if (!IsEnabled() || ViewerId == TargetId)
+	{
+		return true;
+	}
+
+	const TArray<uint32>* RelevantEntities = Relevancy.Find(ViewerId);
+	if (!RelevantEntities || !EntityIndices.Contains(TargetId))
+	{
+		return true;
+	}
+
+	return Algo::BinarySearch(*RelevantEntities, TargetId) != INDEX_NONE;
+}
+
+TConstArrayView<uint32> FCommandFrameInterestManager::GetRelevantEntities(uint32 ViewerId) const
+{
+	if (const TArray<uint32>* RelevantEntities = Relevancy.Find(ViewerId))
+	{
+		return *RelevantEntities;
+	}
+
+	return TConstArrayView<uint32>();
+}
+
+FIntPoint FCommandFrameInterestManager::GetCellCoord(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+uint64 FCommandFrameInterestManager::MakeCellKey(const FIntPoint& CellCoord)
+{
+	return (uint64(uint32(CellCoord.X)) << 32) | uint64(uint32(CellCoord.Y));
+}
+
+void FCommandFrameInterestManager::UpdateRelevantEntities(const FEntity& Viewer, TArray<uint32>& RelevantEntities)
+{
+	const double EnterRadiusSquared = FMath::Square((double)EnterRadius);
+	const double ExitRadiusSquared = FMath::Square((double)ExitRadius);
+	const FIntPoint ViewerCell = GetCellCoord(Viewer.Location);
+
+	RelevantScratch.Reset();
+
+	for (int32 OffsetX = -1; OffsetX <= 1; ++OffsetX)
+	{
+		for (int32 OffsetY = -1; OffsetY <= 1; ++OffsetY)
+		{
+			const FCellRange* Range = Cells.Find(MakeCellKey(ViewerCell + FIntPoint(OffsetX, OffsetY)));
+			if (!Range)
+			{
+				continue;
+			}
+
+			for (int32 Index = Range->Begin; Index < Range->End; ++Index)
+			{
+				const FEntity& Target = Entities[Index];
+				if (Target.EntityId == Viewer.EntityId)
+				{
+					continue;
+				}
+
+				// 已经相关的实体使用更大的离开半径
+				const bool bWasRelevant = Algo::BinarySearch(RelevantEntities, Target.EntityId) != INDEX_NONE;
+				const double DistSquared = FVector::DistSquared2D(Viewer.Location, Target.Location);
+				if (DistSquared <= (bWasRelevant ? ExitRadiusSquared : EnterRadiusSquared))
+				{
+					RelevantScratch.Add(Target.EntityId);
+				}
+			}
+		}
+	}
+
+	RelevantScratch.Sort();
+
+	RelevantEntities.Reset();
+	RelevantEntities.Append(RelevantScratch);
+}
@@ -2,6 +2,7 @@
 
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
 #include "CommandFrameManager.h"
 
 #if WITH_EDITOR
@@ -36,6 +37,10 @@ namespace DeltaNetPacketUtils
 				{
 					NetPacket.NetChannel->RewindFrame();
 				}
+				if (SyncParam.bOutUnmapped)
+				{
+					NetPacket.NetChannel->DeferAckFrame();
+				}
 			}
 		}
 		else
@@ -66,6 +71,10 @@ namespace DeltaNetPacketUtils
 				{
 					NetPacket.NetChannel->RewindFrame();
 				}
+				if (SyncParam.bOutUnmapped)
+				{
+					NetPacket.NetChannel->DeferAckFrame();
+				}
 			}
 		}
 		else
@@ -81,6 +90,9 @@ ADefaultCommandFrameNetChannel::ADefaultCommandFrameNetChannel(const FObjectInit
 	: Super(ObjectInitializer)
 	, LastServerCommandFrame(0)
 	, LastClientCommandFrame(0)
+	, AckServerCommandFrame(0)
+	, bDeferAckFrame(false)
+	, UnorderedPackets(UCommandFrameManager::MAX_COMMANDFRAME_NUM)
 	, NetChannelState(ECommandFrameNetChannelState::Unkown)
 	, CFrameManager(nullptr)
 {
@@ -92,6 +104,23 @@ ADefaultCommandFrameNetChannel::ADefaultCommandFrameNetChannel(const FObjectInit
 	bNetLoadOnClient = false;
 }
 
+void ADefaultCommandFrameNetChannel::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(ADefaultCommandFrameNetChannel, InputActionTable, COND_InitialOnly);
+}
+
+void ADefaultCommandFrameNetChannel::RegisterCFrameManager(UCommandFrameManager* CommandFrameManager)
+{
+	CFrameManager = CommandFrameManager;
+
+	if (IsValid(CFrameManager))
+	{
+		InputActionTable = CFrameManager->GetInputActionTable().GetActions();
+	}
+}
+
 void ADefaultCommandFrameNetChannel::BeginPlay()
 {
 	if (GetWorld()->GetNetMode() == NM_Client)
@@ -167,6 +196,9 @@ void ADefaultCommandFrameNetChannel::ServerReceive_CommandFrameInputNetPacket_Im
 
 		GetCommandFrameManager()->ReceiveInput(this, PS->GetUniqueId(), InputNetPacket);
 
+		// Input 不可靠且可能乱序，只接受更新的确认
+		AckServerCommandFrame = FMath::Max(AckServerCommandFrame, InputNetPacket.AckServerCommandFrame);
+
 		// 异常情况处理
 		// 1. 客户端CF过期，且BufferNum == 0。此时需要同步所有状态。
 		// 2. 客户端CF异常领先？暂时不处理，不好判断是否异常。
@@ -216,14 +248,14 @@ void ADefaultCommandFrameNetChannel::ClientReceive_CommandFrameDeltaNetPacket_Im
 	if (LastServerCommandFrame < DeltaNetPacket.PrevServerCommandFrame && LastServerCommandFrame != 0)
 	{
 		// 乱序了，提前到达。加入待处理队列。
-		UnorderedPackets.Add(DeltaNetPacket.PrevServerCommandFrame, DeltaNetPacket);
+		AddUnorderedPacket(DeltaNetPacket);
 	}
 	else if(LastServerCommandFrame == DeltaNetPacket.PrevServerCommandFrame || LastServerCommandFrame == 0)
 	{
 		// ProcessDeltaPackaged(DeltaNetPacket, NetBitReader);
 
 		// 即使是没乱序的包，也需要入队列，这样可以避免在接收RPC的处理时间过长。可以参考Iris
-		UnorderedPackets.Add(DeltaNetPacket.PrevServerCommandFrame, DeltaNetPacket);
+		AddUnorderedPacket(DeltaNetPacket);
 	}
 	else
 	{
@@ -236,7 +268,7 @@ void ADefaultCommandFrameNetChannel::ProcessDeltaPrefix(const FCommandFrameDelta
 	if (DeltaNetPacket.bLocal && IsValid(GetCommandFrameManager()))
 	{
 		bool bOutSuccess = true;
-		auto Func = [&DeltaNetPacket, this](int32 PrefixDataSize, uint32 ServerCommandBufferNum, bool bFault) {
+		auto Func = [&DeltaNetPacket, this](int32 PrefixDataSize, uint32 ServerCommandBufferNum, bool bFault, const uint64* SnapshotChecksum) {
 			uint32 RealCommandFrame = GetCommandFrameManager()->GetRCF();
 			if (RealCommandFrame <= DeltaNetPacket.ServerCommandFrame)
 			{
@@ -269,12 +301,30 @@ void ADefaultCommandFrameNetChannel::ProcessDeltaPackaged(FCommandFrameDeltaNetP
 
 	bool bOutSuccess = true;
 	int32 OutPrefixDataSize = 0;
-	DeltaNetPacketUtils::SerializeDeltaPrefix(DeltaNetPacket, NetBitReader, NetBitReader.PackageMap, bOutSuccess, [&OutPrefixDataSize](int32 PrefixDataSize, uint32 ServerCommandBufferNum, bool bFault) {
+	DeltaNetPacketUtils::SerializeDeltaPrefix(DeltaNetPacket, NetBitReader, NetBitReader.PackageMap, bOutSuccess, [&OutPrefixDataSize, &DeltaNetPacket, this](int32 PrefixDataSize, uint32 ServerCommandBufferNum, bool bFault, const uint64* SnapshotChecksum) {
 		OutPrefixDataSize = PrefixDataSize;
+
+		// 在应用服务器的修正之前比较，反映的是本地预测的结果
+		if (SnapshotChecksum && IsValid(GetCommandFrameManager()))
+		{
+			GetCommandFrameManager()->VerifySnapshotChecksum(this, DeltaNetPacket.ServerCommandFrame, *SnapshotChecksum);
+		}
 	});
 	//PRIVATE_GET_NAMESPACE(ADefaultCommandFrameNetChannel, &NetBitReader, Pos) = OutPrefixDataSize;
 
+	bDeferAckFrame = false;
 	DeltaNetPacketUtils::SerializeDeltaPackaged(DeltaNetPacket, NetBitReader, NetBitReader.PackageMap, bOutSuccess);
+	if (DeltaNetPacket.bLocal && bOutSuccess && !bDeferAckFrame)
+	{
+		// 数据已完整解码并记录，之后的Input会确认该帧，作为服务器差量同步的基准
+		AckServerCommandFrame = DeltaNetPacket.ServerCommandFrame;
+	}
+	else if (DeltaNetPacket.bLocal)
+	{
+		// 沿用上一次成功解码的帧，服务器会以它为基准，或在它超出历史范围后发送完整状态
+		UE_LOG(LogCommandFrameNetChannel, Verbose, TEXT("Keep Ack[%d], SCF[%d] is not fully decoded"), AckServerCommandFrame, DeltaNetPacket.ServerCommandFrame);
+	}
+
 	if (NetChannelState == ECommandFrameNetChannelState::WaitRewind)
 	{
 		// Rewinding...
@@ -310,13 +360,7 @@ void ADefaultCommandFrameNetChannel::VerifyUnorderedPackets()
 
 void ADefaultCommandFrameNetChannel::ShrinkUnorderedPackets()
 {
-	for (auto It = UnorderedPackets.CreateIterator(); It; ++It)
-	{
-		if (It->Key < LastServerCommandFrame)
-		{
-			It.RemoveCurrent();
-		}
-	}
+	UnorderedPackets.Expire(LastServerCommandFrame);
 }
 
 void ADefaultCommandFrameNetChannel::RemoveUnorderedPacket(uint32 CommandFrame)
@@ -324,23 +368,41 @@ void ADefaultCommandFrameNetChannel::RemoveUnorderedPacket(uint32 CommandFrame)
 	UnorderedPackets.Remove(CommandFrame);
 }
 
+void ADefaultCommandFrameNetChannel::AddUnorderedPacket(const FCommandFrameDeltaNetPacket& DeltaNetPacket)
+{
+	if (FCommandFrameDeltaNetPacket* Packet = UnorderedPackets.Insert(DeltaNetPacket.PrevServerCommandFrame))
+	{
+		Packet->CopyReuseRawData(DeltaNetPacket);
+	}
+	else
+	{
+		UE_LOG(LogCommandFrameNetChannel, Verbose, TEXT("Discard UnorderedPacket SCF[%d] Prev[%d] LocalLast[%d]"), DeltaNetPacket.ServerCommandFrame, DeltaNetPacket.PrevServerCommandFrame, LastServerCommandFrame);
+	}
+}
+
 void ADefaultCommandFrameNetChannel::ResetCommandFrame(uint32 ServerCommandFrame, uint32 PrevServerCommandFrame)
 {
 	CFrameManager->ResetCommandFrame(ServerCommandFrame);
 	LastServerCommandFrame = PrevServerCommandFrame;
 
-	for (auto It = UnorderedPackets.CreateIterator(); It; ++It)
+	UnorderedPackets.Expire(PrevServerCommandFrame);
+	for (uint32 CommandFrame = PrevServerCommandFrame; CommandFrame <= ServerCommandFrame && CommandFrame - PrevServerCommandFrame < UnorderedPackets.GetCapacity(); ++CommandFrame)
 	{
-		if (It->Key <= ServerCommandFrame)
-		{
-			It.RemoveCurrent();
-		}
+		UnorderedPackets.Remove(CommandFrame);
 	}
 
 	// 需要尝试赶上服务器的进度
 	CFrameManager->UpdateTimeDilationHelper(0, true);
 }
 
+void ADefaultCommandFrameNetChannel::OnRep_InputActionTable()
+{
+	if (UCommandFrameManager* CommandFrameManager = GetCommandFrameManager())
+	{
+		CommandFrameManager->SetInputActionTable(InputActionTable);
+	}
+}
+
 UCommandFrameManager* ADefaultCommandFrameNetChannel::GetCommandFrameManager()
 {
 	if (!IsValid(CFrameManager))
@@ -1,8 +1,242 @@
 #include "Net/Packet/CommandFrameInput.h"
 
 #include "Serialization/Archive.h"
+#include "Engine/PackageMapClient.h"
+#include "Engine/NetConnection.h"
 
 #include "InputAction.h"
+#include "CommandFrameManager.h"
+
+namespace
+{
+	// ETriggerEvent 是单bit的标记位，按位序号编码只需要 3bit
+	constexpr uint32 TriggerEventBits = 3;
+	constexpr uint32 ValueTypeBits = 2;
+
+	uint8 EncodeTriggerEvent(ETriggerEvent TriggerEvent)
+	{
+		const uint8 Flag = (uint8)TriggerEvent;
+		return Flag ? (uint8)(FMath::FloorLog2(Flag) + 1) : 0;
+	}
+
+	ETriggerEvent DecodeTriggerEvent(uint8 Code)
+	{
+		return Code ? (ETriggerEvent)(1 << (Code - 1)) : ETriggerEvent::None;
+	}
+
+	int32 GetValueAxisNum(EInputActionValueType ValueType)
+	{
+		switch (ValueType)
+		{
+		case EInputActionValueType::Axis1D:	return 1;
+		case EInputActionValueType::Axis2D:	return 2;
+		case EInputActionValueType::Axis3D:	return 3;
+		default:							return 0;
+		}
+	}
+
+	FVector::FReal QuantizeValue(FVector::FReal Value, float Scale)
+	{
+		return FMath::RoundToInt(Value * Scale) / (FVector::FReal)Scale;
+	}
+
+	int32 QuantizeToInt(FVector::FReal Value, float Scale)
+	{
+		return FMath::RoundToInt(Value * Scale);
+	}
+
+	// ZigZag 编码，使绝对值较小的负数也能用较少的bit表示
+	uint32 ZigZagEncode(int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	int32 ZigZagDecode(uint32 Packed)
+	{
+		return (int32)(Packed >> 1) ^ -(int32)(Packed & 1);
+	}
+
+	uint32 EncodeQuantizedValue(FVector::FReal Value, float Scale)
+	{
+		return ZigZagEncode(QuantizeToInt(Value, Scale));
+	}
+
+	FVector::FReal DecodeQuantizedValue(uint32 Packed, float Scale)
+	{
+		return ZigZagDecode(Packed) / (FVector::FReal)Scale;
+	}
+
+	uint32 EncodeQuantizedTime(float Time, float Scale)
+	{
+		return (uint32)FMath::Max(FMath::RoundToInt(Time * Scale), 0);
+	}
+
+	float DecodeQuantizedTime(uint32 Packed, float Scale)
+	{
+		return (float)(Packed / (FVector::FReal)Scale);
+	}
+
+	void SerializeQuantizedValue(FArchive& Ar, FVector::FReal& Value, float Scale)
+	{
+		uint32 Packed = Ar.IsSaving() ? EncodeQuantizedValue(Value, Scale) : 0;
+
+		Ar.SerializeIntPacked(Packed);
+
+		if (Ar.IsLoading())
+		{
+			Value = DecodeQuantizedValue(Packed, Scale);
+		}
+	}
+
+	void SerializeQuantizedTime(FArchive& Ar, float& Time, float Scale)
+	{
+		uint32 Packed = Ar.IsSaving() ? EncodeQuantizedTime(Time, Scale) : 0;
+
+		Ar.SerializeIntPacked(Packed);
+
+		if (Ar.IsLoading())
+		{
+			Time = DecodeQuantizedTime(Packed, Scale);
+		}
+	}
+
+	// 优先使用会话字典中的稠密索引，未登记的 InputAction 退化为对象引用
+	bool SerializeInputAction(FArchive& Ar, const UInputAction*& InputAction, const FCommandFrameInputActionTable* ActionTable)
+	{
+		uint16 ActionIndex = 0;
+		if (Ar.IsSaving() && ActionTable)
+		{
+			ActionIndex = ActionTable->FindIndex(InputAction);
+		}
+
+		uint8 bIndexed = ActionIndex != 0;
+		Ar.SerializeBits(&bIndexed, 1);
+
+		if (bIndexed)
+		{
+			if (!ActionTable || ActionTable->IsEmpty())
+			{
+				// 双方的字典必须一致，无法解析时只能丢弃
+				Ar.SetError();
+				return false;
+			}
+
+			Ar.SerializeBits(&ActionIndex, ActionTable->GetIndexBits());
+
+			if (Ar.IsLoading())
+			{
+				InputAction = ActionTable->GetAction(ActionIndex);
+			}
+		}
+		else
+		{
+			UInputAction* IA = const_cast<UInputAction*>(InputAction);
+			Ar << IA;
+			InputAction = IA;
+		}
+
+		return true;
+	}
+
+	// 以 Base 为基准，写入量化后的差值
+	void SerializeQuantizedDelta(FArchive& Ar, FVector::FReal& Value, FVector::FReal BaseValue, float Scale)
+	{
+		uint32 Packed = Ar.IsSaving() ? ZigZagEncode(QuantizeToInt(Value, Scale) - QuantizeToInt(BaseValue, Scale)) : 0;
+
+		Ar.SerializeIntPacked(Packed);
+
+		if (Ar.IsLoading())
+		{
+			Value = (QuantizeToInt(BaseValue, Scale) + ZigZagDecode(Packed)) / (FVector::FReal)Scale;
+		}
+	}
+
+	void SerializeQuantizedTimeDelta(FArchive& Ar, float& Time, float BaseTime, float Scale)
+	{
+		FVector::FReal Value = Time;
+		SerializeQuantizedDelta(Ar, Value, BaseTime, Scale);
+		Time = (float)Value;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Bulk
+
+	// 列宽本身使用 6bit 记录，最大支持 32bit
+	constexpr uint32 ColumnWidthBits = 6;
+
+	uint32 GetColumnWidth(uint32 ValueMask)
+	{
+		return ValueMask ? FMath::FloorLog2(ValueMask) + 1 : 0;
+	}
+
+	void SerializeColumnWidth(FArchive& Ar, uint32& Width)
+	{
+		Ar.SerializeBits(&Width, ColumnWidthBits);
+	}
+
+	void SerializeColumnValue(FArchive& Ar, uint32& Value, uint32 Width)
+	{
+		if (Width)
+		{
+			Ar.SerializeBits(&Value, Width);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FCommandFrameInputActionTable
+const FCommandFrameInputActionTable* FCommandFrameInputActionTable::Get(UPackageMap* Map)
+{
+	UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+	UNetConnection* Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+	UWorld* World = Connection ? Connection->GetWorld() : nullptr;
+	if (UCommandFrameManager* CFManager = World ? World->GetSubsystem<UCommandFrameManager>() : nullptr)
+	{
+		return &CFManager->GetInputActionTable();
+	}
+
+	return nullptr;
+}
+
+void FCommandFrameInputActionTable::Init(const TArray<TObjectPtr<UInputAction>>& InActions)
+{
+	Reset();
+
+	for (UInputAction* InputAction : InActions)
+	{
+		if (!InputAction || ActionIndices.Contains(InputAction) || Actions.Num() >= MAX_uint16 - 1)
+		{
+			continue;
+		}
+
+		Actions.Add(InputAction);
+		ActionIndices.Add(InputAction, (uint16)Actions.Num());
+	}
+}
+
+void FCommandFrameInputActionTable::Reset()
+{
+	Actions.Reset();
+	ActionIndices.Reset();
+}
+
+uint16 FCommandFrameInputActionTable::FindIndex(const UInputAction* InputAction) const
+{
+	if (const uint16* Index = ActionIndices.Find(InputAction))
+	{
+		return *Index;
+	}
+
+	return 0;
+}
+
+const UInputAction* FCommandFrameInputActionTable::GetAction(uint16 Index) const
+{
+	return Actions.IsValidIndex(Index - 1) ? Actions[Index - 1].Get() : nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FCommandFrameInputAtom
 
 FCommandFrameInputAtom::FCommandFrameInputAtom(float InLastTriggeredWorldTime, float InElapsedProcessedTime, float InElapsedTriggeredTime, const UInputAction* InInputAction, ETriggerEvent InTriggerEvent, const FInputActionValue& InValue)
 {
@@ -15,6 +249,8 @@ FCommandFrameInputAtom::FCommandFrameInputAtom(float InLastTriggeredWorldTime, f
 
 	ValueType = InValue.GetValueType();
 	Value = InValue.Get<FVector>();
+
+	Quantize();
 }
 
 FCommandFrameInputAtom::FCommandFrameInputAtom(const FInputActionInstance& ActionData)
@@ -29,13 +265,274 @@ FCommandFrameInputAtom::FCommandFrameInputAtom(const FInputActionInstance& Actio
 
 	ElapsedProcessedTime = ActionData.GetElapsedTime();
 	ElapsedTriggeredTime = ActionData.GetTriggeredTime();
+
+	Quantize();
 }
 
-void FCommandFrameInputAtom::BulkMemoryBlob(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+void FCommandFrameInputAtom::Quantize()
 {
-	// 借助Connection来处理UObject
+	const int32 AxisNum = GetValueAxisNum(ValueType);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		Value[Axis] = Axis < AxisNum ? QuantizeValue(Value[Axis], ValueQuantizeScale) : 0;
+	}
 
+	if (ValueType == EInputActionValueType::Boolean)
+	{
+		Value.X = Value.X != 0 ? 1 : 0;
+	}
 
+	ElapsedProcessedTime = (float)QuantizeValue(FMath::Max(ElapsedProcessedTime, 0.0f), TimeQuantizeScale);
+	ElapsedTriggeredTime = (float)QuantizeValue(FMath::Max(ElapsedTriggeredTime, 0.0f), TimeQuantizeScale);
+}
+
+bool FCommandFrameInputAtom::BulkNetSerialize(FArchive& Ar, class UPackageMap* Map, TArrayView<FCommandFrameInputAtom> InputAtoms, const FCommandFrameInputActionTable* ActionTable)
+{
+	const int32 AtomNum = InputAtoms.Num();
+
+	uint32 IndexWidth = ActionTable && !ActionTable->IsEmpty() ? ActionTable->GetIndexBits() : 0;
+	uint32 TimeWidth = 0;
+	uint32 AxisWidth = 0;
+
+	if (Ar.IsSaving())
+	{
+		// 预先遍历一次，确定每列的定长位宽（按位或即可得到最高有效位）
+		uint32 TimeMask = 0;
+		uint32 AxisMask = 0;
+		for (const FCommandFrameInputAtom& InputAtom : InputAtoms)
+		{
+			TimeMask |= EncodeQuantizedTime(InputAtom.ElapsedProcessedTime, TimeQuantizeScale);
+			TimeMask |= EncodeQuantizedTime(InputAtom.ElapsedTriggeredTime, TimeQuantizeScale);
+
+			const int32 AxisNum = GetValueAxisNum(InputAtom.ValueType);
+			for (int32 Axis = 0; Axis < AxisNum; ++Axis)
+			{
+				AxisMask |= EncodeQuantizedValue(InputAtom.Value[Axis], ValueQuantizeScale);
+			}
+		}
+
+		TimeWidth = GetColumnWidth(TimeMask);
+		AxisWidth = GetColumnWidth(AxisMask);
+	}
+
+	// Header
+	uint32 SerializedIndexWidth = IndexWidth;
+	SerializeColumnWidth(Ar, SerializedIndexWidth);
+	SerializeColumnWidth(Ar, TimeWidth);
+	SerializeColumnWidth(Ar, AxisWidth);
+
+	if (Ar.IsLoading())
+	{
+		// 宽度为 0 表示写入时还没有字典，所有InputAction都是对象引用
+		if (SerializedIndexWidth && SerializedIndexWidth != IndexWidth)
+		{
+			// 双方的字典不一致，无法解析
+			Ar.SetError();
+			return false;
+		}
+
+		IndexWidth = SerializedIndexWidth;
+	}
+
+	// ActionIndex，0 表示未登记，需要在末尾传递对象引用
+	TBitArray<TInlineAllocator<4>> UnindexedAtoms(false, AtomNum);
+	int32 UnindexedNum = 0;
+	for (int32 Index = 0; Index < AtomNum; ++Index)
+	{
+		FCommandFrameInputAtom& InputAtom = InputAtoms[Index];
+		uint32 ActionIndex = Ar.IsSaving() && IndexWidth ? ActionTable->FindIndex(InputAtom.InputAction) : 0;
+		SerializeColumnValue(Ar, ActionIndex, IndexWidth);
+
+		if (Ar.IsLoading())
+		{
+			InputAtom.InputAction = ActionIndex ? ActionTable->GetAction((uint16)ActionIndex) : nullptr;
+			InputAtom.LastTriggeredWorldTime = 0.0f;
+		}
+
+		if (!ActionIndex)
+		{
+			UnindexedAtoms[Index] = true;
+			++UnindexedNum;
+		}
+	}
+
+	// TriggerEvent
+	for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+	{
+		uint32 TriggerEventCode = Ar.IsSaving() ? EncodeTriggerEvent(InputAtom.TriggerEvent) : 0;
+		SerializeColumnValue(Ar, TriggerEventCode, TriggerEventBits);
+		InputAtom.TriggerEvent = DecodeTriggerEvent((uint8)TriggerEventCode);
+	}
+
+	// ValueType
+	for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+	{
+		uint32 ValueTypeCode = Ar.IsSaving() ? (uint32)InputAtom.ValueType : 0;
+		SerializeColumnValue(Ar, ValueTypeCode, ValueTypeBits);
+		InputAtom.ValueType = (EInputActionValueType)ValueTypeCode;
+	}
+
+	// ElapsedTime
+	for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+	{
+		uint32 ProcessedTime = Ar.IsSaving() ? EncodeQuantizedTime(InputAtom.ElapsedProcessedTime, TimeQuantizeScale) : 0;
+		uint32 TriggeredTime = Ar.IsSaving() ? EncodeQuantizedTime(InputAtom.ElapsedTriggeredTime, TimeQuantizeScale) : 0;
+		SerializeColumnValue(Ar, ProcessedTime, TimeWidth);
+		SerializeColumnValue(Ar, TriggeredTime, TimeWidth);
+
+		if (Ar.IsLoading())
+		{
+			InputAtom.ElapsedProcessedTime = DecodeQuantizedTime(ProcessedTime, TimeQuantizeScale);
+			InputAtom.ElapsedTriggeredTime = DecodeQuantizedTime(TriggeredTime, TimeQuantizeScale);
+		}
+	}
+
+	// Value，Boolean 只占 1bit，其余类型只传递有效的轴
+	for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+	{
+		if (InputAtom.ValueType == EInputActionValueType::Boolean)
+		{
+			uint32 bValue = Ar.IsSaving() && InputAtom.Value.X != 0;
+			SerializeColumnValue(Ar, bValue, 1);
+			InputAtom.Value = FVector(bValue ? 1 : 0, 0, 0);
+			continue;
+		}
+
+		const int32 AxisNum = GetValueAxisNum(InputAtom.ValueType);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (Axis >= AxisNum)
+			{
+				InputAtom.Value[Axis] = 0;
+				continue;
+			}
+
+			uint32 Packed = Ar.IsSaving() ? EncodeQuantizedValue(InputAtom.Value[Axis], ValueQuantizeScale) : 0;
+			SerializeColumnValue(Ar, Packed, AxisWidth);
+
+			if (Ar.IsLoading())
+			{
+				InputAtom.Value[Axis] = DecodeQuantizedValue(Packed, ValueQuantizeScale);
+			}
+		}
+	}
+
+	// 未登记的InputAction，借助PackageMap来处理UObject
+	if (UnindexedNum)
+	{
+		for (TConstSetBitIterator<TInlineAllocator<4>> It(UnindexedAtoms); It; ++It)
+		{
+			FCommandFrameInputAtom& InputAtom = InputAtoms[It.GetIndex()];
+
+			UInputAction* IA = const_cast<UInputAction*>(InputAtom.InputAction);
+			Ar << IA;
+			InputAtom.InputAction = IA;
+		}
+	}
+
+	return !Ar.IsError();
+}
+
+bool FCommandFrameInputAtom::DeltaNetSerialize(FArchive& Ar, class UPackageMap* Map, TArrayView<FCommandFrameInputAtom> InputAtoms, TConstArrayView<FCommandFrameInputAtom> BaseAtoms, const FCommandFrameInputActionTable* ActionTable)
+{
+	check(InputAtoms.Num() == BaseAtoms.Num());
+
+	const int32 AtomNum = InputAtoms.Num();
+
+	TBitArray<TInlineAllocator<4>> ChangedAtoms(false, AtomNum);
+	if (Ar.IsSaving())
+	{
+		for (int32 Index = 0; Index < AtomNum; ++Index)
+		{
+			ChangedAtoms[Index] = !InputAtoms[Index].IsSameInput(BaseAtoms[Index]);
+		}
+	}
+
+	// 与基准帧完全一致时只需要 1bit
+	uint8 bSame = Ar.IsSaving() && ChangedAtoms.Find(true) == INDEX_NONE;
+	Ar.SerializeBits(&bSame, 1);
+
+	if (!bSame)
+	{
+		for (int32 Index = 0; Index < AtomNum; ++Index)
+		{
+			uint8 bChanged = ChangedAtoms[Index];
+			Ar.SerializeBits(&bChanged, 1);
+			ChangedAtoms[Index] = bChanged != 0;
+		}
+	}
+
+	for (int32 Index = 0; Index < AtomNum; ++Index)
+	{
+		FCommandFrameInputAtom& InputAtom = InputAtoms[Index];
+		const FCommandFrameInputAtom& BaseAtom = BaseAtoms[Index];
+
+		if (Ar.IsLoading())
+		{
+			InputAtom = BaseAtom;
+		}
+
+		if (bSame || !ChangedAtoms[Index])
+		{
+			continue;
+		}
+
+		// InputAction、TriggerEvent、ValueType 很少变化，用 1bit 标记
+		uint8 bHeaderChanged = Ar.IsSaving() && (InputAtom.InputAction != BaseAtom.InputAction || InputAtom.TriggerEvent != BaseAtom.TriggerEvent || InputAtom.ValueType != BaseAtom.ValueType);
+		Ar.SerializeBits(&bHeaderChanged, 1);
+
+		if (bHeaderChanged)
+		{
+			if (!SerializeInputAction(Ar, InputAtom.InputAction, ActionTable))
+			{
+				return false;
+			}
+
+			uint8 TriggerEventCode = Ar.IsSaving() ? EncodeTriggerEvent(InputAtom.TriggerEvent) : 0;
+			Ar.SerializeBits(&TriggerEventCode, TriggerEventBits);
+			InputAtom.TriggerEvent = DecodeTriggerEvent(TriggerEventCode);
+
+			uint8 ValueTypeCode = Ar.IsSaving() ? (uint8)InputAtom.ValueType : 0;
+			Ar.SerializeBits(&ValueTypeCode, ValueTypeBits);
+			InputAtom.ValueType = (EInputActionValueType)ValueTypeCode;
+		}
+
+		SerializeQuantizedTimeDelta(Ar, InputAtom.ElapsedProcessedTime, BaseAtom.ElapsedProcessedTime, TimeQuantizeScale);
+		SerializeQuantizedTimeDelta(Ar, InputAtom.ElapsedTriggeredTime, BaseAtom.ElapsedTriggeredTime, TimeQuantizeScale);
+
+		if (InputAtom.ValueType == EInputActionValueType::Boolean)
+		{
+			uint8 bValue = Ar.IsSaving() && InputAtom.Value.X != 0;
+			Ar.SerializeBits(&bValue, 1);
+			InputAtom.Value = FVector(bValue ? 1 : 0, 0, 0);
+			continue;
+		}
+
+		const int32 AxisNum = GetValueAxisNum(InputAtom.ValueType);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (Axis < AxisNum)
+			{
+				SerializeQuantizedDelta(Ar, InputAtom.Value[Axis], BaseAtom.Value[Axis], ValueQuantizeScale);
+			}
+			else
+			{
+				InputAtom.Value[Axis] = 0;
+			}
+		}
+	}
+
+	return !Ar.IsError();
+}
+
+bool FCommandFrameInputAtom::IsSameInput(const FCommandFrameInputAtom& Other) const
+{
+	return InputAction == Other.InputAction
+		&& TriggerEvent == Other.TriggerEvent
+		&& ValueType == Other.ValueType
+		&& Value == Other.Value
+		&& ElapsedProcessedTime == Other.ElapsedProcessedTime
+		&& ElapsedTriggeredTime == Other.ElapsedTriggeredTime;
 }
 
 bool FCommandFrameInputAtom::Serialize(FArchive& Ar)
@@ -63,27 +560,57 @@ bool FCommandFrameInputAtom::Serialize(FArchive& Ar)
 
 bool FCommandFrameInputAtom::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
-	if (Ar.IsSaving())
+	return NetSerialize(Ar, Map, bOutSuccess, FCommandFrameInputActionTable::Get(Map));
+}
+
+bool FCommandFrameInputAtom::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, const FCommandFrameInputActionTable* ActionTable)
+{
+	bOutSuccess = true;
+
+	if (!SerializeInputAction(Ar, InputAction, ActionTable))
 	{
-		UInputAction* IA = const_cast<UInputAction*>(InputAction);
-		Ar << IA;
+		bOutSuccess = false;
+		return false;
 	}
-	else if (Ar.IsLoading())
+
+	// TriggerEvent
+	uint8 TriggerEventCode = EncodeTriggerEvent(TriggerEvent);
+	Ar.SerializeBits(&TriggerEventCode, TriggerEventBits);
+	TriggerEvent = DecodeTriggerEvent(TriggerEventCode);
+
+	SerializeQuantizedTime(Ar, ElapsedProcessedTime, TimeQuantizeScale);
+	SerializeQuantizedTime(Ar, ElapsedTriggeredTime, TimeQuantizeScale);
+
+	// Value
+	uint8 ValueTypeCode = (uint8)ValueType;
+	Ar.SerializeBits(&ValueTypeCode, ValueTypeBits);
+	ValueType = (EInputActionValueType)ValueTypeCode;
+
+	if (ValueType == EInputActionValueType::Boolean)
 	{
-		UInputAction* IA;
-		Ar << IA;
-		InputAction = IA;
+		uint8 bValue = Value.X != 0;
+		Ar.SerializeBits(&bValue, 1);
+		Value = FVector(bValue ? 1 : 0, 0, 0);
+	}
+	else
+	{
+		const int32 AxisNum = GetValueAxisNum(ValueType);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (Axis < AxisNum)
+			{
+				SerializeQuantizedValue(Ar, Value[Axis], ValueQuantizeScale);
+			}
+			else if (Ar.IsLoading())
+			{
+				Value[Axis] = 0;
+			}
+		}
 	}
-	Ar << TriggerEvent;
-	Ar << LastTriggeredWorldTime;
-	Ar << ElapsedProcessedTime;
-	Ar << ElapsedTriggeredTime;
-	Ar << ValueType;
-	Ar << Value;
 
-	bOutSuccess = true;
+	bOutSuccess = !Ar.IsError();
 
-	return true;
+	return bOutSuccess;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -11,7 +11,11 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogCommandFrameNetPacket, Log, Verbose)
 
-PRIVATE_DEFINE_NAMESPACE(FCommandFrameInputNetPacket, FBitReader, Pos)
+bool bEnableDeltaRedundantInput = true;
+FAutoConsoleVariableRef CVarCFrame_Net_DeltaRedundantInput(TEXT("CFrame.Net.DeltaRedundantInput"), bEnableDeltaRedundantInput, TEXT("If true, redundant input frames are delta-coded against the previously written frame."));
+
+bool bEnableSnapshotChecksum = true;
+FAutoConsoleVariableRef CVarCFrame_Net_SnapshotChecksum(TEXT("CFrame.Net.SnapshotChecksum"), bEnableSnapshotChecksum, TEXT("If true, the server sends a hash of the owning player's snapshot with every delta packet so the client can detect simulation drift."));
 
 struct FBitArchiveSizeScope
 {
@@ -72,6 +76,8 @@ namespace DeltaNetPacketUtils
 		int32 PrefixDataSize = 0;
 		uint32 ServerCommandBufferNum = 0;
 		bool bFault = false;
+		bool bHasSnapshotChecksum = false;
+		uint64 SnapshotChecksum = 0;
 
 		// 非Local暂时没有Prefix
 		if (!NetPacket.bLocal)
@@ -95,9 +101,16 @@ namespace DeltaNetPacketUtils
 			Ar << ServerCommandBufferNum;
 			Ar << bFault;
 
+			bHasSnapshotChecksum = bEnableSnapshotChecksum && CFManager->CalcSnapshotChecksum(NetPacket.NetChannel, NetPacket.ServerCommandFrame, SnapshotChecksum);
+			Ar << bHasSnapshotChecksum;
+			if (bHasSnapshotChecksum)
+			{
+				Ar << SnapshotChecksum;
+			}
+
 			if (CallBack)
 			{
-				CallBack(PrefixDataSize, ServerCommandBufferNum, bFault);
+				CallBack(PrefixDataSize, ServerCommandBufferNum, bFault, bHasSnapshotChecksum ? &SnapshotChecksum : nullptr);
 			}
 		}
 		else if (Ar.IsLoading())
@@ -106,9 +119,15 @@ namespace DeltaNetPacketUtils
 			Ar << ServerCommandBufferNum;
 			Ar << bFault;
 
+			Ar << bHasSnapshotChecksum;
+			if (bHasSnapshotChecksum)
+			{
+				Ar << SnapshotChecksum;
+			}
+
 			if (CallBack)
 			{
-				CallBack(PrefixDataSize, ServerCommandBufferNum, bFault);
+				CallBack(PrefixDataSize, ServerCommandBufferNum, bFault, bHasSnapshotChecksum ? &SnapshotChecksum : nullptr);
 			}
 		}
 	}
@@ -173,6 +192,19 @@ namespace DeltaNetPacketUtils
 
 	}
 
+	bool IsRelevantFor(const FCommandFrameDeltaNetPacket& NetPacket, UNetConnection* NetConnection)
+	{
+		if (!NetPacket.NetChannel || !NetConnection)
+		{
+			return true;
+		}
+
+		UCommandFrameManager* CFManager = NetPacket.NetChannel->GetWorld()->GetSubsystem<UCommandFrameManager>();
+		AController* Viewer = Cast<AController>(NetConnection->OwningActor);
+
+		return !IsValid(CFManager) || CFManager->IsNetRelevantFor(Viewer, NetPacket.NetChannel);
+	}
+
 	template<>
 	void NetSync<EDeltaNetPacketType::Fault_FrameExpiry>(const FCommandFrameDeltaNetPacket& NetPacket, FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 	{
@@ -205,8 +237,27 @@ FCommandFrameDeltaNetPacket::FCommandFrameDeltaNetPacket(uint32 InServerCommandF
 
 }
 
+void FCommandFrameDeltaNetPacket::CopyReuseRawData(const FCommandFrameDeltaNetPacket& Other)
+{
+	ServerCommandFrame = Other.ServerCommandFrame;
+	PrevServerCommandFrame = Other.PrevServerCommandFrame;
+	NetChannel = Other.NetChannel;
+	PacketType = Other.PacketType;
+	bLocal = Other.bLocal;
+	PackageMap = Other.PackageMap;
+
+	// SetNumUninitialized 只在容量不足时扩容
+	RawData.SetNumUninitialized(Other.RawData.Num());
+	if (Other.RawData.Num())
+	{
+		FMemory::Memcpy(RawData.GetData(), Other.RawData.GetData(), FBitSet::CalculateNumWords(Other.RawData.Num()) * sizeof(uint32));
+	}
+}
+
 bool FCommandFrameDeltaNetPacket::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
+	bool bRelevant = true;
+
 	if (Ar.IsSaving())
 	{
 		PackageMap = Map;
@@ -216,6 +267,8 @@ bool FCommandFrameDeltaNetPacket::NetSerialize(FArchive& Ar, class UPackageMap*
 
 		UNetConnection* OwnerConnection = NetChannel->GetNetConnection();
 		bLocal = NetConnection == OwnerConnection;
+
+		bRelevant = bLocal || DeltaNetPacketUtils::IsRelevantFor(*this, NetConnection);
 	}
 	else if (Ar.IsLoading())
 	{
@@ -228,6 +281,19 @@ bool FCommandFrameDeltaNetPacket::NetSerialize(FArchive& Ar, class UPackageMap*
 
 	Ar << bLocal;
 
+	if (Ar.IsSaving() && !bRelevant)
+	{
+		// 不在AOI范围内，只维持帧号链，不携带任何同步内容，也不影响已缓存的Remote数据
+		uint32 IntPacketType = uint32(PacketType) & 0xF0000000;
+		Ar << IntPacketType;
+
+		uint32 NumBits = 0;
+		Ar.SerializeIntPacked(NumBits);
+
+		bOutSuccess = true;
+		return !Ar.IsError();
+	}
+
 	if (Ar.IsSaving())
 	{
 		FNetBitWriter NetBitWriter;
@@ -290,6 +356,7 @@ bool FCommandFrameDeltaNetPacket::NetSerialize(FArchive& Ar, class UPackageMap*
 // FCommandFrameInputNetPacket
 FCommandFrameInputNetPacket::FCommandFrameInputNetPacket(UNetConnection* Connection, TCircularQueueView<FCommandFrameInputFrame>& InputFrames)
 	: ClientCommandFrame(0)
+	, AckServerCommandFrame(0)
 {
 	WriteRedundantData(Connection, InputFrames);
 }
@@ -297,6 +364,7 @@ FCommandFrameInputNetPacket::FCommandFrameInputNetPacket(UNetConnection* Connect
 bool FCommandFrameInputNetPacket::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
 	Ar << ClientCommandFrame;
+	Ar << AckServerCommandFrame;
 
 	// Array size in bits, using minimal number of bytes to write it out.
 	uint32 NumBits = RawData.Num();
@@ -316,118 +384,202 @@ bool FCommandFrameInputNetPacket::NetSerialize(FArchive& Ar, class UPackageMap*
 
 void FCommandFrameInputNetPacket::WriteRedundantData(UNetConnection* Connection, TCircularQueueView<FCommandFrameInputFrame>& InputFrames)
 {
-	if (!InputFrames.IsEmpty())
+	WriteRedundantData(Connection->PackageMap, FCommandFrameInputActionTable::Get(Connection->PackageMap), InputFrames);
+}
+
+void FCommandFrameInputNetPacket::WriteRedundantData(UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, TCircularQueueView<FCommandFrameInputFrame>& InputFrames)
+{
+	RawData.Empty();
+
+	if (InputFrames.IsEmpty())
 	{
-		ClientCommandFrame = InputFrames[InputFrames.Num() - 1].CommandFrame;
+		return;
 	}
 
-	// FNetBitWriter
-	RawData.Empty();
+	ClientCommandFrame = InputFrames[InputFrames.Num() - 1].CommandFrame;
 
 	UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("WriteRedundantData Begin"));
 
 	UE_LOG(LogCommandFrameNetPacket, Log, TEXT("WriteRedundantData FramesCount[%d]"), InputFrames.Num());
 
-	int64 TotalNumBits = 0;
+	FNetBitWriter PacketWriter(Map, 0);
+	PacketWriter.SetAllowResize(true);
+
+	uint32 FrameNum = InputFrames.Num();
+	PacketWriter.SerializeIntPacked(FrameNum);
+
+	// 从最新的帧开始写入，之后的每一帧都以前一个写入的帧为基准
 	for (int32 Index = InputFrames.Num() - 1; Index >= 0; --Index)
 	{
 		FCommandFrameInputFrame& InputFrame = InputFrames[Index];
 
-		FNetBitWriter& NetBitWriter = InputFrame.SharedSerialization;
-		NetBitWriter.PackageMap = Connection->PackageMap;
-
-		if (!NetBitWriter.GetNumBits())
+		if (Index == InputFrames.Num() - 1)
+		{
+			FNetBitWriter& FullWriter = GetFullSerialization(Map, ActionTable, InputFrame);
+			PacketWriter.SerializeBits(FullWriter.GetData(), FullWriter.GetNumBits());
+		}
+		else
 		{
-			NetBitWriter << InputFrame.CommandFrame;
+			FNetBitWriter& DeltaWriter = GetDeltaSerialization(Map, ActionTable, InputFrame, InputFrames[Index + 1]);
+			PacketWriter.SerializeBits(DeltaWriter.GetData(), DeltaWriter.GetNumBits());
+		}
 
-			int32 DataCount = InputFrame.InputQueue.Num();
+		UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("WriteRedundantData Frame[%d] DataCount[%d]"), InputFrame.CommandFrame, InputFrame.InputQueue.Num());
+	}
 
-			NetBitWriter << DataCount;
+	UE_LOG(LogCommandFrameNetPacket, Log, TEXT("WriteRedundantData Allocate RawData[%d]"), PacketWriter.GetNumBits());
 
-			int32 DataSize = 0;
-			{
-				FBitArchiveSizeScope Scope(NetBitWriter, DataSize);
-
-				// GetTypeSize() 返回字节数，实际需要bit数，所以*8
-				// 但FCommandFrameInputAtom目前内部包含UObject，不能直接拷贝，只有启用了FNetworkGUID，才能直接拷贝
-				//NetBitWriter.SerializeBits(InputFrame.InputQueue.GetData(), InputFrame.InputQueue.GetTypeSize() * DataCount * 8);
-				
-				bool bOutSuccess = false;
-				UScriptStruct* InputAtomStruct = FCommandFrameInputAtom::StaticStruct();
-				for (FCommandFrameInputAtom& InputAtom : InputFrame.InputQueue)
-				{
-					InputAtomStruct->GetCppStructOps()->NetSerialize(NetBitWriter, NetBitWriter.PackageMap, bOutSuccess, &InputAtom);
-				}
-			}
+	// 按bit拼接，每帧的数据不一定是字节对齐的
+	RawData.SetNumUninitialized(PacketWriter.GetNumBits());
 
-			UE_LOG(LogCommandFrameNetPacket, Log, TEXT("WriteRedundantData Frame[%d] DataCount[%d] DataSize[%d]"), InputFrame.CommandFrame, DataCount, DataSize);
-		}
+	check(RawData.Num() >= PacketWriter.GetNumBits());
+	FMemory::Memcpy(RawData.GetData(), PacketWriter.GetData(), PacketWriter.GetNumBytes());
+
+	UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("WriteRedundantData End"));
+}
 
-		UE_LOG(LogCommandFrameNetPacket, Log, TEXT("WriteRedundantData Frame[%d] SharedSerialization NumBits[%d]"), InputFrame.CommandFrame, NetBitWriter.GetNumBits());
+FNetBitWriter& FCommandFrameInputNetPacket::GetFullSerialization(UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, FCommandFrameInputFrame& InputFrame)
+{
+	// [DataCount] [BulkNetSerialize]
+	FNetBitWriter& NetBitWriter = InputFrame.SharedSerialization;
+	NetBitWriter.PackageMap = Map;
 
-		TotalNumBits += NetBitWriter.GetNumBits();
+	if (!NetBitWriter.GetNumBits())
+	{
+		uint32 DataCount = InputFrame.InputQueue.Num();
+		NetBitWriter.SerializeIntPacked(DataCount);
+
+		// 按列批量写入，FCommandFrameInputAtom 内部包含UObject，不能直接拷贝内存
+		FCommandFrameInputAtom::BulkNetSerialize(NetBitWriter, Map, InputFrame.InputQueue, ActionTable);
 	}
 
-	UE_LOG(LogCommandFrameNetPacket, Log, TEXT("WriteRedundantData Allocate RawData[%d]"), TotalNumBits);
-	RawData.SetNumUninitialized(TotalNumBits);
+	return NetBitWriter;
+}
 
-	check(RawData.Num() >= TotalNumBits);
+FNetBitWriter& FCommandFrameInputNetPacket::GetDeltaSerialization(UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, FCommandFrameInputFrame& InputFrame, FCommandFrameInputFrame& BaseFrame)
+{
+	// [FrameGap] [bDelta] [DeltaNetSerialize | Full]
+	FNetBitWriter& NetBitWriter = InputFrame.DeltaSerialization;
+	NetBitWriter.PackageMap = Map;
 
-	uint8* DataStream = (uint8*)RawData.GetData();
-	for (int32 Index = InputFrames.Num() - 1; Index >= 0; --Index)
+	if (NetBitWriter.GetNumBits() && InputFrame.DeltaBaseFrame == BaseFrame.CommandFrame)
 	{
-		FCommandFrameInputFrame& InputFrame = InputFrames[Index];
+		return NetBitWriter;
+	}
+
+	NetBitWriter.Reset();
+	InputFrame.DeltaBaseFrame = BaseFrame.CommandFrame;
+
+	// 通常是连续的帧，只需要 1Byte
+	uint32 FrameGap = BaseFrame.CommandFrame - InputFrame.CommandFrame;
+	NetBitWriter.SerializeIntPacked(FrameGap);
 
-		FBitWriter& BitWriter = InputFrame.SharedSerialization;
-		int64 NumBytes = BitWriter.GetNumBytes();
-		FMemory::Memcpy(DataStream, BitWriter.GetData(), NumBytes);
+	FNetBitWriter& FullWriter = GetFullSerialization(Map, ActionTable, InputFrame);
 
-		DataStream += NumBytes;
+	if (bEnableDeltaRedundantInput && InputFrame.InputQueue.Num() == BaseFrame.InputQueue.Num())
+	{
+		FNetBitWriter DeltaWriter(Map, 0);
+		DeltaWriter.SetAllowResize(true);
+		FCommandFrameInputAtom::DeltaNetSerialize(DeltaWriter, Map, InputFrame.InputQueue, BaseFrame.InputQueue, ActionTable);
+
+		// 变化剧烈时差量未必更小
+		if (DeltaWriter.GetNumBits() < FullWriter.GetNumBits())
+		{
+			uint8 bDelta = 1;
+			NetBitWriter.SerializeBits(&bDelta, 1);
+			NetBitWriter.SerializeBits(DeltaWriter.GetData(), DeltaWriter.GetNumBits());
+			return NetBitWriter;
+		}
 	}
 
-	UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("WriteRedundantData End"));
+	uint8 bDelta = 0;
+	NetBitWriter.SerializeBits(&bDelta, 1);
+	NetBitWriter.SerializeBits(FullWriter.GetData(), FullWriter.GetNumBits());
+
+	return NetBitWriter;
 }
 
 void FCommandFrameInputNetPacket::ReadRedundantData(UNetConnection* Connection, TFunction<uint8*(uint32 CommandFrame, int32 DataCount)> AllocateData) const
 {
-	FNetBitReader Ar;
-	Ar.PackageMap = Connection->PackageMap;
-	Ar.SetData((uint8*)RawData.GetData(), RawData.Num());
+	ReadRedundantData(Connection->PackageMap, FCommandFrameInputActionTable::Get(Connection->PackageMap), AllocateData);
+}
 
-	bool bPaused = false;
+void FCommandFrameInputNetPacket::ReadRedundantData(UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, TFunction<uint8*(uint32 CommandFrame, int32 DataCount)> AllocateData) const
+{
+	FNetBitReader Ar(Map, (uint8*)RawData.GetData(), RawData.Num());
 
 	UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("ReadRedundantData Begin"));
 	UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("ReadRedundantData DataTotalSize[%d]"), RawData.Num());
 
-	while (!Ar.AtEnd() && !bPaused)
+	if (RawData.IsEmpty())
 	{
-		uint32 CommandFrame;
-		int32 DataCount;
-		int32 DataSize;
+		return;
+	}
+
+	uint32 FrameNum = 0;
+	Ar.SerializeIntPacked(FrameNum);
 
-		Ar << CommandFrame;
-		Ar << DataCount;
+	if (FrameNum > UCommandFrameManager::MAX_COMMANDFRAME_NUM)
+	{
+		UE_LOG(LogCommandFrameNetPacket, Warning, TEXT("ReadRedundantData invalid FrameNum[%u]"), FrameNum);
+		return;
+	}
 
-		FBitArchiveSizeScope Scope(Ar, DataSize);
+	// 差量帧依赖前一个解析的帧，所以即使是已经收到过的帧也需要完整解析
+	TArray<FCommandFrameInputAtom, TInlineAllocator<16>> BaseAtoms;
+	TArray<FCommandFrameInputAtom, TInlineAllocator<16>> InputAtoms;
 
-		UE_LOG(LogCommandFrameNetPacket, Log, TEXT("ReadRedundantData CF[%d] DataCount[%d] DataSize[%d]"), CommandFrame, DataCount, DataSize);
+	uint32 CommandFrame = ClientCommandFrame;
 
-		FCommandFrameInputAtom* InputAtomData = (FCommandFrameInputAtom*)AllocateData(CommandFrame, DataCount);
-		if (InputAtomData)
+	for (uint32 FrameIndex = 0; FrameIndex < FrameNum && !Ar.IsError(); ++FrameIndex)
+	{
+		uint8 bDelta = 0;
+		if (FrameIndex)
+		{
+			uint32 FrameGap = 0;
+			Ar.SerializeIntPacked(FrameGap);
+			CommandFrame -= FrameGap;
+
+			Ar.SerializeBits(&bDelta, 1);
+		}
+
+		bool bSuccess = false;
+		if (bDelta)
+		{
+			InputAtoms.SetNumUninitialized(BaseAtoms.Num());
+			bSuccess = FCommandFrameInputAtom::DeltaNetSerialize(Ar, Map, InputAtoms, BaseAtoms, ActionTable);
+		}
+		else
 		{
-			bool bOutSuccess = false;
-			UScriptStruct* InputAtomStruct = FCommandFrameInputAtom::StaticStruct();
-			for (int32 index = 0; index < DataCount; ++index)
+			uint32 DataCount = 0;
+			Ar.SerializeIntPacked(DataCount);
+
+			// OrderCounter 以 uint8 计数
+			if (DataCount > MAX_uint8)
 			{
-				InputAtomStruct->GetCppStructOps()->NetSerialize(Ar, Ar.PackageMap, bOutSuccess, InputAtomData + index);
+				Ar.SetError();
+				break;
 			}
+
+			InputAtoms.SetNumUninitialized(DataCount);
+			bSuccess = FCommandFrameInputAtom::BulkNetSerialize(Ar, Map, InputAtoms, ActionTable);
 		}
-		else
+
+		if (!bSuccess)
 		{
-			PRIVATE_GET_NAMESPACE(FCommandFrameInputNetPacket, &Ar, Pos) = Ar.GetPosBits() + DataSize;
+			UE_LOG(LogCommandFrameNetPacket, Warning, TEXT("ReadRedundantData CF[%u] failed to serialize input"), CommandFrame);
+			break;
 		}
-		
+
+		UE_LOG(LogCommandFrameNetPacket, Log, TEXT("ReadRedundantData CF[%u] DataCount[%d] bDelta[%d]"), CommandFrame, InputAtoms.Num(), bDelta);
+
+		if (uint8* InputAtomData = AllocateData(CommandFrame, InputAtoms.Num()))
+		{
+			FMemory::Memcpy(InputAtomData, InputAtoms.GetData(), InputAtoms.Num() * InputAtoms.GetTypeSize());
+		}
+
+		Swap(BaseAtoms, InputAtoms);
 	}
 
 	UE_LOG(LogCommandFrameNetPacket, Verbose, TEXT("ReadRedundantData End"));
-}
\ No newline at end of file
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "CoreMinimal.h"
+
+struct FBitReader;
+struct FAttributeNetGuidReferences;
+
+/**
+ * AttributeBag 中一个 TArray 属性的逐元素同步状态，思路与 FFastArraySerializer 相同：
+ * 每个元素有一个 ReplicationID，只发送被删除元素的ID、新增或修改的元素以及必要时的新顺序。
+ *
+ * 普通 TArray 的元素本身不携带ID，Server 通过与上一次同步时的数组副本（Shadow）按值匹配来推断元素身份，
+ * 因此移动位置的元素保留原ID，不会重新发送数据。差量相对上一个 ReplicationFrame，每帧只计算一次。
+ *
+ * 与 FFastArraySerializer 的 ArrayReplicationKey 相同，每次数组变化后生成新的 ReplicationKey，
+ * 各连接在自己的 INetDeltaBaseState 中记录已收到的 ReplicationKey。只有基准恰好是本帧差量的基准时才发送共享的差量，
+ * 首次同步或丢失了中间的差量时发送完整数组。
+ *
+ * 格式：[bReset] [NumRemoved][ID...] [NumChanged]([ID][Element])... [bOrderChanged]([Num][ID...])
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FAttributeArrayReplicationState
+{
+	// 单次差量中元素数量的上限，超过时视为数据损坏
+	static constexpr int32 MaxNetElementNum = 1 << 16;
+
+	explicit FAttributeArrayReplicationState(const FArrayProperty* InArrayProperty);
+	~FAttributeArrayReplicationState();
+
+	FAttributeArrayReplicationState(const FAttributeArrayReplicationState&) = delete;
+	FAttributeArrayReplicationState& operator=(const FAttributeArrayReplicationState&) = delete;
+
+	// Server：与 Shadow 比较生成本帧的差量，同一 ReplicationFrame 内重复调用直接返回
+	void UpdateDelta(const void* ArrayValue, uint32 ReplicationFrame);
+
+	/**
+	 * Server：为一个连接写入差量，元素数据按连接序列化（对象引用依赖各自的 PackageMap）。
+	 * BaseKey 为该连接已收到的 ReplicationKey，未知时为 INDEX_NONE；写入后连接的基准应更新为 GetReplicationKey()。
+	 */
+	void WriteDelta(FArchive& Ar, UPackageMap* Map, void* ArrayValue, int32 BaseKey) const;
+
+	/**
+	 * Client：读取差量并应用到数组上。
+	 * GuidReferences 不为空时，为包含对象引用的元素记录 GUID 引用，Key 为 (PropIndex, ReplicationID)，
+	 * 只有本次收到的元素会重新生成引用，被删除的元素移除引用。
+	 */
+	bool ReadDelta(FBitReader& Ar, UPackageMap* Map, void* ArrayValue, FAttributeNetGuidReferences* GuidReferences = nullptr, uint16 PropIndex = 0);
+
+	int32 FindIndexByID(int32 ReplicationID) const { return ReplicationIDs.IndexOfByKey(ReplicationID); }
+
+	const FArrayProperty* GetArrayProperty() const { return ArrayProperty; }
+	TConstArrayView<int32> GetReplicationIDs() const { return ReplicationIDs; }
+
+	// Server：当前数组对应的 ReplicationKey，在所有 FAttributeArrayReplicationState 之间唯一，重新创建状态后不会与旧值混淆
+	int32 GetReplicationKey() const { return ReplicationKey; }
+
+	// 本帧差量的统计，用于调试
+	int32 GetRemovedNum() const { return RemovedIDs.Num(); }
+	int32 GetChangedNum() const { return ChangedIndices.Num(); }
+	bool IsOrderChanged() const { return bOrderChanged; }
+
+private:
+	uint32 HashElement(const void* Element) const;
+	void WriteFullState(FArchive& Ar, UPackageMap* Map, void* ArrayValue) const;
+
+	const FArrayProperty* ArrayProperty;
+
+	// 与数组元素一一对应
+	TArray<int32> ReplicationIDs;
+	// Server：元素值的哈希，用于按值匹配移动过的元素
+	TArray<uint32> ReplicationKeys;
+	int32 IDCounter = 0;
+
+	// Server：上一次同步时的数组
+	void* ShadowValue = nullptr;
+
+	// Server：当前数组与本帧差量基准的 ReplicationKey
+	int32 ReplicationKey = INDEX_NONE;
+	int32 DeltaBaseKey = INDEX_NONE;
+
+	// Server：本帧的差量
+	uint32 DeltaFrame = 0;
+	bool bHasDelta = false;
+	bool bReset = false;
+	bool bOrderChanged = false;
+	TArray<int32> RemovedIDs;
+	TArray<int32> ChangedIndices;
+};
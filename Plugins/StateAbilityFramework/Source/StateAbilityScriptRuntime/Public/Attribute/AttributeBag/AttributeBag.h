@@ -5,6 +5,8 @@
 #include "Templates/ValueOrError.h"
 #include "Containers/StaticArray.h"
 
+#include "Attribute/AttributeBag/AttributeBagLayout.h"
+
 #include "AttributeBag.generated.h"
 
 typedef int32 int32;
@@ -388,6 +390,9 @@ public:
 
 	int32 GetPropertyDescsNum() const { return PropertyDescs.Num(); }
 
+	/** Immutable name/offset lookup table, built in GetOrCreateFromDescs. */
+	const FAttributeBagLayout& GetLayout() const { return Layout; }
+
 #if WITH_ENGINE && WITH_EDITOR
 	/** @return true if any of the properties on the bag has type of the specified user defined struct. */
 	bool ContainsUserDefinedStruct(const UUserDefinedStruct* UserDefinedStruct) const;
@@ -405,6 +410,8 @@ protected:
 	UPROPERTY()
 	TArray<FAttributeBagPropertyDesc> PropertyDescs;
 
+	FAttributeBagLayout Layout;
+
 	std::atomic<int32> RefCount = 0;
 };
 
@@ -0,0 +1,121 @@
+#pragma once
+#include "CoreMinimal.h"
+
+struct FAttributeBagPropertyDesc;
+
+/**
+ * 属性的序号、偏移、大小等布局信息，每个 UScriptStruct 构建一次，之后不可修改。
+ * UAttributeBagStruct 在 GetOrCreateFromDescs 中构建，序号即 FAttributeBagPropertyDesc::Index；
+ * 普通 UScriptStruct 在第一次访问时构建，序号为 TFieldIterator 的遍历顺序。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FAttributeBagLayout
+{
+	// Data 为属性值的地址
+	typedef bool (*FNetSerializeFunc)(const FProperty* Property, FArchive& Ar, UPackageMap* Map, void* Data);
+
+	struct FPropertyLayout
+	{
+		const FProperty* Property = nullptr;
+		FName Name = NAME_None;
+		int32 Offset = INDEX_NONE;
+		int32 Size = 0;
+		// 可以直接 memcpy / memcmp
+		bool bPOD = false;
+		// 按属性类型预先选定，序列化时不再逐个 CastField
+		FNetSerializeFunc NetSerialize = nullptr;
+		// TArray 属性，脏标记同步时按元素发送差量，见 FAttributeArrayReplicationState
+		const FArrayProperty* ArrayProperty = nullptr;
+	};
+
+	FAttributeBagLayout() = default;
+	explicit FAttributeBagLayout(const UScriptStruct* ScriptStruct);
+	explicit FAttributeBagLayout(TConstArrayView<FAttributeBagPropertyDesc> PropertyDescs);
+
+	// UAttributeBagStruct 返回自身的布局，其他结构体从全局表中查找或构建。频繁访问时使用 FAttributeBagLayoutCache
+	static const FAttributeBagLayout& Get(const UScriptStruct* ScriptStruct);
+
+	// 从全局表中移除 ScriptStruct 的布局，之后的 Get 会重新构建；编辑器中结构体被重新实例化时自动调用
+	static void Invalidate(const UScriptStruct* ScriptStruct);
+	// 全局表中有布局被移除时递增
+	static uint32 GetGeneration();
+	static FNetSerializeFunc GetNetSerializeFunc(const FProperty* Property);
+
+	int32 Num() const { return Properties.Num(); }
+
+	int32 FindIndex(const FName Name) const
+	{
+		const uint32 NameHash = GetTypeHash(Name);
+		if (bPerfectHash)
+		{
+			// 第一级按名字选桶，第二级用桶的种子选槽位，每个名字都有独立的槽位
+			const int32 Index = HashSlots[SlotHash(NameHash, BucketSeeds[BucketHash(NameHash) & BucketMask]) & HashMask];
+			return (Index != INDEX_NONE && Properties[Index].Name == Name) ? Index : INDEX_NONE;
+		}
+
+		uint32 Slot = SlotHash(NameHash, 0) & HashMask;
+		for (;;)
+		{
+			const int32 Index = HashSlots[Slot];
+			if (Index == INDEX_NONE || Properties[Index].Name == Name)
+			{
+				return Index;
+			}
+			Slot = (Slot + 1) & HashMask;
+		}
+	}
+
+	const FPropertyLayout& GetProperty(int32 Index) const { return Properties[Index]; }
+	TConstArrayView<FPropertyLayout> GetProperties() const { return Properties; }
+
+	// 构建时为每个桶挑选的种子能使所有名字落在不同的槽位中，此时 FindIndex 只访问一个槽位
+	bool IsPerfectHash() const { return bPerfectHash; }
+
+private:
+	static uint32 BucketHash(uint32 NameHash)
+	{
+		return MurmurFinalize32(NameHash);
+	}
+
+	static uint32 SlotHash(uint32 NameHash, uint32 Seed)
+	{
+		return MurmurFinalize32(NameHash ^ (Seed * 0x9E3779B9u + 0x7F4A7C15u));
+	}
+
+	// 两级的 hash-and-displace 表，同一个桶中的名字共用一个种子，从大桶开始逐个挑选
+	bool BuildPerfectHash(int32 SlotNum);
+	void BuildHash();
+
+	TArray<FPropertyLayout> Properties;
+
+	// 槽位数至少为属性数的两倍，保证存在空槽；没有找到完美哈希时为线性探测的开放寻址表
+	TArray<int32> HashSlots = { INDEX_NONE };
+	uint32 HashMask = 0;
+	// 每个桶的种子
+	TArray<uint32> BucketSeeds = { 0 };
+	uint32 BucketMask = 0;
+	bool bPerfectHash = true;
+};
+
+/**
+ * 缓存 FAttributeBagLayout::Get 的结果，结构体不变时不再加锁查找全局表。
+ * 全局表中有布局被移除（结构体被重新实例化）后重新查找。
+ */
+struct FAttributeBagLayoutCache
+{
+	const FAttributeBagLayout& Get(const UScriptStruct* ScriptStruct) const
+	{
+		const uint32 Generation = FAttributeBagLayout::GetGeneration();
+		if (!Layout || ScriptStruct != LayoutStruct || Generation != LayoutGeneration)
+		{
+			Layout = &FAttributeBagLayout::Get(ScriptStruct);
+			LayoutStruct = ScriptStruct;
+			LayoutGeneration = Generation;
+		}
+		return *Layout;
+	}
+
+private:
+	mutable const FAttributeBagLayout* Layout = nullptr;
+	mutable const UScriptStruct* LayoutStruct = nullptr;
+	mutable uint32 LayoutGeneration = 0;
+};
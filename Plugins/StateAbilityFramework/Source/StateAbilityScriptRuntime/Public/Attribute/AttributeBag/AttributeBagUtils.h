@@ -4,6 +4,8 @@
 #include "UObject/Interface.h"
 
 #include "Attribute/AttributeBag/AttributeBag.h"
+#include "Attribute/AttributeBag/AttributeArrayReplication.h"
+#include "Attribute/AttributeBag/AttributeNetGuidReferences.h"
 #include "Attribute/NetBitArray.h"
 #include "Attribute/AttributeEntity.h"
 
@@ -36,17 +38,6 @@ void IDSExtraBackActionInterface::Execute_BindExtraBackAction(UObject* O, UInput
 /************************************************************************/
 
 
-//////////////////////////////////////////////////////////////////////////
-struct FAttributeNetGuidReference
-{
-	TSet<FNetworkGUID> UnmappedGUIDs;
-	TSet<FNetworkGUID> MappedDynamicGUIDs;
-	/** Buffer of data to re-serialize when the guids are mapped */
-	TArray<uint8> Buffer;
-	/** Number of bits in the buffer */
-	int32 NumBufferBits;
-};
-
 //////////////////////////////////////////////////////////////////////////
 // Mass Tag
 USTRUCT()
@@ -83,7 +74,8 @@ struct FAttributeNetFragment : public FMassFragment
 	GENERATED_BODY()
 
 	typedef uint16 FRepPropIndex;
-	TMap<FRepPropIndex, FAttributeNetGuidReference> GuidReferencesMap;
+	// 按 (属性序号, 元素的 ReplicationID) 排序的对象引用，非 TArray 属性的元素ID为 INDEX_NONE
+	FAttributeNetGuidReferences GuidReferences;
 };
 
 // Mass Shared Fragment
@@ -155,6 +147,9 @@ public:
 	const uint8* GetMemory() const;
 	uint8* GetMutableMemory();
 
+	// DataStruct 的属性布局，按名字查找序号为 O(1)
+	const FAttributeBagLayout& GetLayout() const;
+
 	template<typename T>
 	T& Get()
 	{
@@ -163,9 +158,11 @@ public:
 protected:
 	virtual bool SerializeRead(FNetDeltaSerializeInfo& deltaParms);
 	virtual bool SerializeWrite(FNetDeltaSerializeInfo& deltaParms);
-	virtual bool NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map, const FNetBitArray& Changes);
+	// ArrayReplicationKeys 为写入时连接的基准（属性序号 -> ReplicationKey），写入后更新为本次发送的值
+	virtual bool NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map, const FNetBitArray& Changes, TMap<int32, int32>* ArrayReplicationKeys = nullptr);
 
 	bool NetSerializeItem(const FProperty* Prop, FArchive& Ar, UPackageMap* Map, void* Data);
+	bool NetSerializeArrayItem(int32 Index, const FArrayProperty* ArrayProp, FArchive& Ar, UPackageMap* Map, void* Data, FAttributeNetGuidReferences* GuidReferences, TMap<int32, int32>* ArrayReplicationKeys);
 
 	FAttributeNetFragment& GetNetFragment();
 	FAttributeNetSharedFragment& GetNetSharedFragment();
@@ -175,6 +172,11 @@ protected:
 
 	FAttributeEntity AttributeEntity;
 
+	// TArray 属性的元素ID等同步状态，按属性序号索引，不随拷贝传递
+	TMap<int32, TUniquePtr<FAttributeArrayReplicationState>> ArrayReplicationStates;
+
+	// 以 DataStruct 为键，DataStruct 改变时自动重新查找
+	FAttributeBagLayoutCache LayoutCache;
 };
 
 template<>
@@ -221,8 +223,6 @@ public:
 	bool NetDeltaSerialize(FNetDeltaSerializeInfo& deltaParms);
 
 protected:
-	virtual bool NetSerializeDirtyItem(FArchive& Ar, UPackageMap* Map, const FNetBitArray& Changes) override;
-
 	const void* GetValueAddress(const FAttributeBagPropertyDesc* Desc) const;
 	void* GetMutableValueAddress(const FAttributeBagPropertyDesc* Desc);
 };
@@ -0,0 +1,89 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Misc/NetworkGuid.h"
+#include "Serialization/BitReader.h"
+
+class UPackageMap;
+class UPackageMapClient;
+
+// 属性（或 TArray 属性的一个元素）引用的一个对象
+struct FAttributeNetGuidRef
+{
+	uint16 PropIndex = 0;
+	// TArray 属性为元素的 ReplicationID，其他属性为 INDEX_NONE
+	int32 ElementID = INDEX_NONE;
+	FNetworkGUID NetGUID;
+	// 已映射的动态对象，对象被销毁后（MoveToUnmapped）重新变为未映射
+	bool bMapped = false;
+
+	uint64 GetKey() const { return ((uint64)PropIndex << 32) | (uint32)ElementID; }
+};
+
+// 对象映射后需要重新读取的数据
+struct FAttributeNetGuidBuffer
+{
+	uint16 PropIndex = 0;
+	int32 ElementID = INDEX_NONE;
+	TArray<uint8> Buffer;
+	int32 NumBufferBits = 0;
+
+	uint64 GetKey() const { return ((uint64)PropIndex << 32) | (uint32)ElementID; }
+};
+
+/**
+ * 属性中尚未映射、或已映射但可能被销毁的动态对象引用。
+ * 所有引用按 (PropIndex, ElementID) 排序存放在一个数组中，每个 Key 对应一份重新读取的数据，
+ * 查找都是二分，少量引用时不分配堆内存。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FAttributeNetGuidReferences
+{
+	static constexpr int32 InlineReferenceNum = 4;
+	static constexpr int32 InlineBufferNum = 2;
+
+	// 用本次读取时追踪到的 guids 替换 Key 的所有引用，两者都为空时等同于 Remove
+	void Set(uint16 PropIndex, int32 ElementID, const TSet<FNetworkGUID>& UnmappedGUIDs, const TSet<FNetworkGUID>& MappedDynamicGUIDs, TArray<uint8>&& Buffer, int32 NumBufferBits);
+	void Remove(uint16 PropIndex, int32 ElementID);
+	// 移除属性的所有引用，包括 TArray 属性的全部元素
+	void RemoveProperty(uint16 PropIndex);
+	void Reset();
+
+	int32 Num() const { return References.Num(); }
+	bool IsEmpty() const { return References.IsEmpty(); }
+
+	TConstArrayView<FAttributeNetGuidRef> GetReferences() const { return References; }
+	const FAttributeNetGuidBuffer* FindBuffer(uint16 PropIndex, int32 ElementID) const;
+
+	// GatherGuidReferences 阶段
+	void Gather(TSet<FNetworkGUID>& OutGUIDs) const;
+
+	// MoveGuidToUnmapped 阶段，返回是否引用了该 guid
+	bool MoveToUnmapped(const FNetworkGUID& GUID);
+
+	/**
+	 * UpdateUnmappedObjects 阶段：检查未映射的 guids 是否已经加载，
+	 * 对每个映射了新 guid 的 Key 按顺序调用一次 OnMapped，之后移除不再需要追踪的引用和数据。
+	 */
+	void UpdateUnmapped(UPackageMap* Map, TFunctionRef<void(const FAttributeNetGuidBuffer& Buffer)> OnMapped);
+
+private:
+	TArray<FAttributeNetGuidRef, TInlineAllocator<InlineReferenceNum>> References;
+	TArray<FAttributeNetGuidBuffer, TInlineAllocator<InlineBufferNum>> Buffers;
+};
+
+/**
+ * 读取一个属性或元素期间追踪 UPackageMapClient 遇到的 guids，析构时写入 FAttributeNetGuidReferences。
+ * References 为空或 Map 不是 UPackageMapClient 时不做任何事。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FAttributeNetGuidTrackingScope
+{
+	FAttributeNetGuidTrackingScope(FAttributeNetGuidReferences* InReferences, UPackageMap* Map, FBitReader& InReader, uint16 InPropIndex, int32 InElementID = INDEX_NONE);
+	~FAttributeNetGuidTrackingScope();
+
+private:
+	FAttributeNetGuidReferences* References;
+	UPackageMapClient* MapClient;
+	FBitReader& Reader;
+	FBitReaderMark Mark;
+	uint16 PropIndex;
+	int32 ElementID;
+};
@@ -111,17 +111,10 @@ public:
             return *this;
         }
 
-        // From http://graphics.stanford.edu/~seander/bithacks.html
-        FORCEINLINE static int32 Log2(WordType Power2Num)
-        {
-            //x=2^k
-            static const int32 Log2Map[32]={31,0,27,1,28,18,23,2,29,21,19,12,24,9,14,3,30,26,17,22,20,11,8,13,25,16,10,7,15,6,5,4};
-            return Log2Map[Power2Num*263572066>>27];
-        }
-
+        // 只访问置位的bit：逐字跳过空字，字内用 CTZ 定位最低位
         FORCEINLINE int32 operator * () const
         {
-            return BitIndex * WordSize + Log2(CurrentWord ^ (CurrentWord & (CurrentWord - 1)));
+            return BitIndex * WordSize + (int32)FMath::CountTrailingZeros(CurrentWord);
         }
 
     protected:
@@ -225,12 +225,15 @@ struct STATEABILITYSCRIPTRUNTIME_API FBindEntry
 	}
 private:
 	friend struct FBindEntryContainer;
+	friend struct FAttributeBindBatch;
 	static uint64 GlobalSerialNumber;
 	static const FBindEntryHandle InValidHandle;
 
 	static FBindEntryHandle GenerateHandle(int32 LayerID, int32 Index);
 
 	int16 LayerID = 0;
+	// ֪ͨʱеȣ FAttributeBindBatch ڹ㲥ʱѧϰ֡
+	uint16 BatchHeight = 0;
 	// If don't open the entrust memory allocation inline, FMulticastInvocationListAllocatorType == FDefaultSparseArrayAllocator::ElementAllocator
 	TSparseArray<FBindEntryItem> EntryItems;
 };
@@ -284,6 +287,126 @@ private:
 	TArray<FBindEntry> DataBindings;
 };
 
+struct FAttributeBindTracker;
+
+/**
+ * ֪ͨ޸Բ㲥ֻ¼֪ͨ BindEntryʱͳһ㲥
+ * ͬһ BindEntry һ Flush ֻ㲥һΣǹ㲥ڼֱε޸ıǣ
+ *
+ * 㲥 BindEntry ȣBatchHeightСУ㲥Ϊ H  BindEntry ʱǵ BindEntry Ϊ H + 1
+ * ֮㲥ڹ㲥ѧϰ BindEntry ϣ
+ * һγʱܶ㲥һΣ֮֡˳ÿ BindEntry ֻ㲥һΡ
+ *
+ * Not Thread Safe!
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FAttributeBindBatch
+{
+	// ȵޣѭʱȲ
+	static constexpr uint16 MaxBatchHeight = 1024;
+	// һ Flush 㲥ޣʱΪѭ޷ʣ֪ͨ
+	static constexpr int32 MaxFlushBroadcastNum = 1 << 20;
+
+	static void Begin();
+	static void End();
+
+	// 㲥ǰд֪ͨ BindEntry
+	static void Flush();
+
+	// ͣȹ㲥ǰд֪ͨ BindEntry֮޸㲥ֱ ResumeͣǰĲ
+	static int32 Suspend();
+	static void Resume(int32 SuspendedDepth);
+
+	FORCEINLINE static bool IsBatching()
+	{
+		return BatchDepth > 0;
+	}
+
+	static void MarkPending(const FAttributeBindTracker* Tracker, int32 LayerID);
+
+	// Tracker ʱƳ֪ͨ BindEntry
+	static void RemoveTracker(const FAttributeBindTracker* Tracker);
+
+	FORCEINLINE static int32 GetPendingNum()
+	{
+		return PendingHeights.Num();
+	}
+
+private:
+	using FPendingKey = TPair<const FAttributeBindTracker*, int32>;
+
+	struct FPendingEntry
+	{
+		const FAttributeBindTracker* Tracker = nullptr;
+		int32 LayerID = 0;
+		uint16 Height = 0;
+		uint32 Order = 0;
+
+		// СѣСȹ㲥ͬһȰ˳
+		bool operator<(const FPendingEntry& Other) const
+		{
+			return Height != Other.Height ? Height < Other.Height : Order < Other.Order;
+		}
+	};
+
+	static int32 BatchDepth;
+	static bool bFlushing;
+	// ڹ㲥 BindEntry ȣڹ㲥ʱΪ INDEX_NONE
+	static int32 FlushingHeight;
+	static uint32 PendingOrder;
+	// ֪ͨ BindEntry  PendingHeap еЧȣȲһµѹ
+	static TMap<FPendingKey, uint16> PendingHeights;
+	static TArray<FPendingEntry> PendingHeap;
+};
+
+struct FAttributeBindBatchScope
+{
+	explicit FAttributeBindBatchScope(bool bInEnabled = true)
+		: bEnabled(bInEnabled)
+	{
+		if (bEnabled)
+		{
+			FAttributeBindBatch::Begin();
+		}
+	}
+
+	~FAttributeBindBatchScope()
+	{
+		if (bEnabled)
+		{
+			FAttributeBindBatch::End();
+		}
+	}
+
+	FAttributeBindBatchScope(const FAttributeBindBatchScope&) = delete;
+	FAttributeBindBatchScope& operator=(const FAttributeBindBatchScope&) = delete;
+
+private:
+	bool bEnabled;
+};
+
+/**
+ * ͣٴ򿪵ʱ㲥
+ * عطŵÿһ֡Ҫ֪֡ͬͨʱ
+ */
+struct FAttributeBindBatchSuspendScope
+{
+	FAttributeBindBatchSuspendScope()
+		: SuspendedDepth(FAttributeBindBatch::Suspend())
+	{
+	}
+
+	~FAttributeBindBatchSuspendScope()
+	{
+		FAttributeBindBatch::Resume(SuspendedDepth);
+	}
+
+	FAttributeBindBatchSuspendScope(const FAttributeBindBatchSuspendScope&) = delete;
+	FAttributeBindBatchSuspendScope& operator=(const FAttributeBindBatchSuspendScope&) = delete;
+
+private:
+	int32 SuspendedDepth;
+};
+
 /**
  * Not recommended for use in code with performance requirements.
  * Not Thread Safe!
@@ -374,6 +497,7 @@ private:
 struct STATEABILITYSCRIPTRUNTIME_API FAttributeBindTracker
 {
 	friend struct FAttributeBindEffect;
+	friend struct FAttributeBindBatch;
 
 	~FAttributeBindTracker()
 	{
@@ -434,10 +558,16 @@ struct STATEABILITYSCRIPTRUNTIME_API FAttributeBindTracker
 		{
 			FAttributeBindEffect::GlobalActiveTracker.Remove(this);
 		}
+		if (BatchPendingNum > 0)
+		{
+			FAttributeBindBatch::RemoveTracker(this);
+		}
 	}
 
 protected:
 	mutable FBindEntryContainer BindEntryContainer;
 private:
 	mutable bool bResgiter = false;
+	// FAttributeBindBatch д֪ͨ BindEntry 
+	mutable int32 BatchPendingNum = 0;
 };
\ No newline at end of file
@@ -6,11 +6,15 @@
 
 #include "GameFramework/OnlineReplStructs.h"
 #include "Serialization/BitWriter.h"
+#include "Stats/Stats.h"
 #include "UObject/Class.h"
 
 #include "Net/Packet/CommandFrameInput.h"
 
-struct FCommandFrameInputFrame
+DECLARE_STATS_GROUP(TEXT("CommandFrame"), STATGROUP_CommandFrame, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Snapshot Heap Allocations"), STAT_CommandFrameSnapshotHeapAllocations, STATGROUP_CommandFrame, STATEABILITYSCRIPTRUNTIME_API);
+
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameInputFrame
 {
 	FCommandFrameInputFrame();
 
@@ -18,7 +22,9 @@ struct FCommandFrameInputFrame
 	TArray<FCommandFrameInputAtom> InputQueue;
 	TMap<FUniqueNetIdRepl, uint8> OrderCounter;
 
-	FNetBitWriter SharedSerialization;
+	FNetBitWriter SharedSerialization;	// 完整的序列化结果
+	FNetBitWriter DeltaSerialization;	// 以 DeltaBaseFrame 为基准的差量序列化结果
+	uint32 DeltaBaseFrame = 0;
 
 	void AddItem(const FUniqueNetIdRepl& Key, const TArray<FCommandFrameInputAtom>& ItemData);
 	uint8* AllocateItem(const FUniqueNetIdRepl& Key, uint32 DataSize);
@@ -28,30 +34,139 @@ struct FCommandFrameInputFrame
 	bool HasOwnerShip(const FUniqueNetIdRepl& Key);
 };
 
+/**
+ * 快照内的实体键。
+ * EntityIndex 由 UCommandFrameManager 统一分配，同一实体在所有帧内都对应同一个列索引。
+ */
+struct FCommandFrameSnapshotKey
+{
+	FCommandFrameSnapshotKey() {}
+	FCommandFrameSnapshotKey(const UScriptStruct* InStruct, uint32 InEntityIndex)
+		: Struct(InStruct)
+		, EntityIndex(InEntityIndex)
+	{}
+
+	const UScriptStruct* Struct = nullptr;
+	uint32 EntityIndex = INDEX_NONE;
+
+	bool operator==(const FCommandFrameSnapshotKey& Other) const
+	{
+		return Struct == Other.Struct && EntityIndex == Other.EntityIndex;
+	}
+
+	friend uint32 GetTypeHash(const FCommandFrameSnapshotKey& Key)
+	{
+		return HashCombineFast(PointerHash(Key.Struct), ::GetTypeHash(Key.EntityIndex));
+	}
+};
+
+/**
+ * 帧内线性分配器，每个快照帧（环形队列的槽位）持有一个，在槽位被回收时整体重置。
+ * 当一帧内的需求超过当前块大小时，临时从堆上申请溢出块，并在下一次重置时按峰值扩容，
+ * 因此稳定运行后不会再产生任何堆分配。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameSnapshotArena
+{
+	FCommandFrameSnapshotArena() {}
+	~FCommandFrameSnapshotArena() { Release(); }
+	FCommandFrameSnapshotArena(const FCommandFrameSnapshotArena& Param) = delete;
+	FCommandFrameSnapshotArena& operator=(const FCommandFrameSnapshotArena& Param) = delete;
+
+	uint8* Allocate(SIZE_T Size, uint32 Alignment);
+	void Reset();
+	void Release();
+
+	// 该分配器累计的堆分配次数
+	uint32 GetHeapAllocationNum() const { return HeapAllocationNum; }
+
+private:
+	uint8* AllocateFromHeap(SIZE_T Size, uint32 Alignment);
+
+	uint8* Block = nullptr;
+	SIZE_T BlockSize = 0;
+	SIZE_T Offset = 0;
+
+	// 本轮（自上次Reset起）所需的总大小，按最坏对齐计算
+	SIZE_T RequiredSize = 0;
+
+	TArray<uint8*> OverflowBlocks;
+
+	uint32 HeapAllocationNum = 0;
+};
+
+/**
+ * 同一种结构体的所有实体数据，按 EntityIndex 连续存放，内存来自所在快照帧的 Arena。
+ * 只有 UsedEntity 标记的实体处于已初始化状态。
+ */
+struct FCommandFrameAttributeColumn
+{
+	const UScriptStruct* Struct = nullptr;
+	uint8* Memory = nullptr;
+	int32 Stride = 0;
+	int32 Capacity = 0;
+
+	// 槽位回收后，按上一次的容量重新划分，避免列在帧内反复扩容
+	int32 CapacityHint = 0;
+
+	// POD 类型可以按内存整体拷贝，也不需要执行 InitializeStruct
+	bool bPlainOldData = false;
+	// 没有析构的类型不需要执行 DestroyStruct，但仍可能有自定义的构造与拷贝
+	bool bNoDestructor = false;
+
+	// 当前帧已写入的实体
+	TBitArray<> UsedEntity;
+
+	FORCEINLINE uint8* GetItem(uint32 EntityIndex) const { return Memory + (SIZE_T)EntityIndex * Stride; }
+	FORCEINLINE bool IsUsed(uint32 EntityIndex) const { return (int32)EntityIndex < UsedEntity.Num() && UsedEntity[EntityIndex]; }
+
+	void Init(const UScriptStruct* InStruct);
+	void Reserve(FCommandFrameSnapshotArena& Arena, int32 EntityNum);
+	void DestroyItems();
+	void Reset();
+};
+
 /**
  * 不能存储UObject，因为其内存空间在Reset后并不会被实际释放，并且也不会有GC的引用保护。
  * 同样不建议使用有自定义内存管理的结构体。
  */
-struct FCommandFrameAttributeSnapshot
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameAttributeSnapshot
 {
 	uint32 CommandFrame = 0;
 
 	// 为什么不用FInstancedStruct？
 	// 因为FInstancedStruct占用额外的空间，且在扩容等操作时会产生不必要的内存拷贝。
-	TMap<const UScriptStruct*, uint8*> MemoryBuffer;
-	TSet<const UScriptStruct*> UsedKey;
+	// 每种结构体一列，列内按实体索引连续存放（SoA），以便回滚时按实体读取，或整列拷贝。
+	TMap<const UScriptStruct*, FCommandFrameAttributeColumn> MemoryBuffer;
+
+	// 所有列的内存都来自这里，Reset时整体回收
+	FCommandFrameSnapshotArena Arena;
 
 	FCommandFrameAttributeSnapshot();
 	~FCommandFrameAttributeSnapshot() { Release(0); }
 	FCommandFrameAttributeSnapshot(const FCommandFrameAttributeSnapshot& Param) = delete;
 	FCommandFrameAttributeSnapshot& operator=(const FCommandFrameAttributeSnapshot& Param) = delete;
 
-	void AddItem(const UScriptStruct* Key, const uint8* const& ItemData);
-	uint8* AllocateItem(const UScriptStruct* Key, uint32 DataSize);
+	void AddItem(const FCommandFrameSnapshotKey& Key, const uint8* const& ItemData);
+	uint8* AllocateItem(const FCommandFrameSnapshotKey& Key, uint32 DataSize);
 	void Reset(uint32 InCommandFrame);
 	void Release(uint32 InCommandFrame);
 	bool Verify(uint32 InCommandFrame);
-	bool HasOwnerShip(const UScriptStruct* Key);
+	bool HasOwnerShip(const FCommandFrameSnapshotKey& Key);
+
+	uint8* ReadItemData(const FCommandFrameSnapshotKey& Key);
+
+	// 返回整列连续内存，OutEntityNum 为列的容量，其中只有已写入的实体是有效数据
+	uint8* ReadColumnData(const UScriptStruct* Struct, int32& OutEntityNum);
+	// 将 Source 中同类型的整列数据拷贝过来
+	void CopyColumn(const FCommandFrameAttributeSnapshot& Source, const UScriptStruct* Struct);
+
+	// 按 Keys 的顺序对各实体的数据做滚动哈希，用于校验客户端与服务器的模拟结果是否一致。
+	// 只与数据有关，与 EntityIndex 无关，未写入的实体也会参与计算。
+	uint64 CalcChecksum(TConstArrayView<FCommandFrameSnapshotKey> Keys) const;
+
+	// 逐属性哈希。浮点按位参与计算（仅 -0 与 0 视为相同），对象引用等跨进程不可比较的属性会被跳过
+	static uint64 HashStruct(const UScriptStruct* Struct, const uint8* Data, uint64 Seed);
 
-	uint8* ReadItemData(const UScriptStruct* Key);
+private:
+	uint8* AllocateItemInternal(const FCommandFrameSnapshotKey& Key, bool bInitialize);
 };
\ No newline at end of file
@@ -84,6 +84,8 @@ struct TJOwnerShipCircularQueue
 		MaxFramesNum = Buffer.Num() - 1;
 		
 		// 额外的一个空间用来判断队尾
+
+		OwnerMasks.SetNumZeroed(Buffer.Num() * MaskWordNum);
 	}
 	FORCEINLINE virtual ~TJOwnerShipCircularQueue() {}
 
@@ -93,14 +95,25 @@ public:
 		return EndFrame - HeadFrame - 1;
 	}
 
+	// 统计有效范围内持有该Owner数据的帧数，最多只会遍历 MaxFramesNum 个掩码位
 	FORCEINLINE uint32 Count(const OwnerShipDataType& Owner) const
 	{
-		if (auto CountPtr = Counter.Find(Owner))
+		const int32 Slot = FindOwnerSlot(Owner);
+		if (Slot == INDEX_NONE)
+		{
+			return 0;
+		}
+
+		const uint32 WordIndex = (uint32)Slot >> 6;
+		const uint64 BitMask = 1ULL << (Slot & 63);
+
+		uint32 Num = 0;
+		for (uint32 Frame = HeadFrame; Frame < EndFrame; ++Frame)
 		{
-			return *CountPtr;
+			Num += (OwnerMasks[(Frame & MaxFramesNum) * MaskWordNum + WordIndex] & BitMask) ? 1 : 0;
 		}
 
-		return 0;
+		return Num;
 	}
 
 	FORCEINLINE bool IsFull() const
@@ -115,12 +128,13 @@ public:
 
 	FORCEINLINE bool IsEmpty(const OwnerShipDataType& Owner) const
 	{
-		if (uint32 CountPtr = Counter.Find(Owner))
-		{
-			return *CountPtr == 0;
-		}
+		return Count(Owner) == 0;
+	}
 
-		return true;
+	// 当前持有槽位的Owner数量，Owner的最后一帧掩码被清理后释放
+	FORCEINLINE int32 GetOwnerNum() const
+	{
+		return OwnerSlots.Num();
 	}
 
 	FORCEINLINE void CheckInvariants() const
@@ -138,22 +152,7 @@ public:
 
 		if (AckFrame < EndFrame)
 		{
-
-			// 遍历所有目标并更新计数
-			for (uint32 Frame = HeadFrame; Frame <= AckFrame; ++Frame)
-			{
-				for (auto& CountPair : Counter)
-				{
-					if (Buffer[Frame & MaxFramesNum].HasOwnerShip(CountPair.Key))
-					{
-						if (CountPair.Value)
-						{
-							--(CountPair.Value);
-						}
-					}
-				}
-			}
-
+			// 每个Owner的计数由有效范围内的掩码推导得出，所以这里只需要移动队头，不再需要逐个Owner更新计数。
 			HeadFrame = AckFrame + 1;
 			HeadIndex = HeadFrame & MaxFramesNum;
 			// 此时可能变成空哦~。
@@ -176,14 +175,6 @@ public:
 		{
 			HeadIndex = HeadFrame & MaxFramesNum;
 			// 此时可能变成空哦~。
-			for (auto& CountPair : Counter)
-			{
-				if (CountPair.Value)
-				{
-					--(CountPair.Value);
-				}
-			}
-
 		}
 		else
 		{
@@ -201,8 +192,8 @@ public:
 
 		HeadIndex = 0;
 		EndIndex = 0;
-		
-		Counter.Empty();
+
+		// Owner的槽位保持不变，掩码会在帧重新分配时清理
 	}
 
 	//////////////////////////////////////////////////////////////////////////
@@ -276,24 +267,32 @@ public:
 
 		if (InsertFrame < EndFrame)
 		{
-			// 是否为已有效数据
-			if (!Buffer[Index].Verify(InsertFrame))
+			// 是否为已有效数据，先清理失效帧的掩码再分配槽位，避免刚取到的槽位在清理时被释放
+			const bool bValidFrame = Buffer[Index].Verify(InsertFrame);
+			if (!bValidFrame)
 			{
-				Buffer[Index].AddItem(Owner, ItemData);
-				++(Counter.FindOrAdd(Owner));
+				ClearOwnerShip(Index);
 			}
-			else
+
+			const int32 Slot = FindOrAddOwnerSlot(Owner);
+			if (bValidFrame && HasOwnerShip(Index, Slot))
 			{
 				// 不能覆盖存在的有效数据
 				return false;
 			}
+
+			// 同一帧允许不同的Owner分别写入
+			Buffer[Index].AddItem(Owner, ItemData);
+			MarkOwnerShip(Index, Slot);
 		}
 		else
 		{
 			// 未分配数据
+			ClearOwnerShipRange(EndFrame, InsertFrame);
+
 			Buffer[Index].Reset(InsertFrame);
 			Buffer[Index].AddItem(Owner, ItemData);
-			++(Counter.FindOrAdd(Owner));
+			MarkOwnerShip(Index, FindOrAddOwnerSlot(Owner));
 
 			if (InsertFrame - HeadFrame + 1 > MaxFramesNum)
 			{
@@ -335,18 +334,26 @@ public:
 		if (InsertFrame < EndFrame)
 		{
 			// 是否为已有效数据
-			if (!Buffer[Index].Verify(InsertFrame))
+			const bool bValidFrame = Buffer[Index].Verify(InsertFrame);
+			if (!bValidFrame)
 			{
-				++(Counter.FindOrAdd(Owner));
-				return Buffer[Index].AllocateItem(Owner, DataSize);
+				ClearOwnerShip(Index);
 			}
-			else
+
+			const int32 Slot = FindOrAddOwnerSlot(Owner);
+			if (bValidFrame && HasOwnerShip(Index, Slot))
 			{
 				return nullptr;
 			}
+
+			// 同一帧允许不同的Owner分别写入
+			MarkOwnerShip(Index, Slot);
+			return Buffer[Index].AllocateItem(Owner, DataSize);
 		}
 		else
 		{
+			ClearOwnerShipRange(EndFrame, InsertFrame);
+
 			if (InsertFrame - HeadFrame + 1 > MaxFramesNum)
 			{
 				// 没有空间了
@@ -366,7 +373,7 @@ public:
 				EndFrame = InsertFrame + 1;
 			}
 
-			++(Counter.FindOrAdd(Owner));
+			MarkOwnerShip(Index, FindOrAddOwnerSlot(Owner));
 
 			// 未分配数据
 			Buffer[Index].Reset(InsertFrame);
@@ -374,12 +381,129 @@ public:
 		}
 	}
 
+protected:
+	//////////////////////////////////////////////////////////////////////////
+	// OwnerShip Mask
+	FORCEINLINE int32 FindOwnerSlot(const OwnerShipDataType& Owner) const
+	{
+		if (const int32* SlotPtr = OwnerSlots.Find(Owner))
+		{
+			return *SlotPtr;
+		}
+
+		return INDEX_NONE;
+	}
+
+	// 为新的Owner分配稠密的槽位，优先复用已释放的槽位，槽位超出当前掩码宽度时重新排布掩码
+	int32 FindOrAddOwnerSlot(const OwnerShipDataType& Owner)
+	{
+		if (const int32* SlotPtr = OwnerSlots.Find(Owner))
+		{
+			return *SlotPtr;
+		}
+
+		if (FreeSlots.Num() > 0)
+		{
+			// 释放的槽位在所有帧上的掩码都已清零
+			const int32 Slot = FreeSlots.Pop(EAllowShrinking::No);
+			SlotOwners[Slot] = Owner;
+			OwnerSlots.Add(Owner, Slot);
+			return Slot;
+		}
+
+		const int32 Slot = SlotOwners.Add(Owner);
+		SlotFrameNums.Add(0);
+		OwnerSlots.Add(Owner, Slot);
+
+		const uint32 NewMaskWordNum = ((uint32)Slot >> 6) + 1;
+		if (NewMaskWordNum > MaskWordNum)
+		{
+			TArray<uint64> NewOwnerMasks;
+			NewOwnerMasks.SetNumZeroed(Buffer.Num() * NewMaskWordNum);
+
+			for (int32 Index = 0; Index < Buffer.Num(); ++Index)
+			{
+				FMemory::Memcpy(&NewOwnerMasks[Index * NewMaskWordNum], &OwnerMasks[Index * MaskWordNum], MaskWordNum * sizeof(uint64));
+			}
+
+			OwnerMasks = MoveTemp(NewOwnerMasks);
+			MaskWordNum = NewMaskWordNum;
+		}
+
+		return Slot;
+	}
+
+	FORCEINLINE void MarkOwnerShip(const uint32 Index, const int32 Slot)
+	{
+		uint64& Word = OwnerMasks[Index * MaskWordNum + ((uint32)Slot >> 6)];
+		const uint64 BitMask = 1ULL << (Slot & 63);
+		if (!(Word & BitMask))
+		{
+			Word |= BitMask;
+			++SlotFrameNums[Slot];
+		}
+	}
+
+	FORCEINLINE bool HasOwnerShip(const uint32 Index, const int32 Slot) const
+	{
+		return (OwnerMasks[Index * MaskWordNum + ((uint32)Slot >> 6)] & (1ULL << (Slot & 63))) != 0;
+	}
+
+	FORCEINLINE void ClearOwnerShip(const uint32 Index)
+	{
+		for (uint32 WordIndex = 0; WordIndex < MaskWordNum; ++WordIndex)
+		{
+			uint64& Word = OwnerMasks[Index * MaskWordNum + WordIndex];
+			for (uint64 Bits = Word; Bits; Bits &= Bits - 1)
+			{
+				const int32 Slot = (int32)(WordIndex << 6) + (int32)FMath::CountTrailingZeros64(Bits);
+				if (--SlotFrameNums[Slot] == 0)
+				{
+					ReleaseOwnerSlot(Slot);
+				}
+			}
+			Word = 0;
+		}
+	}
+
+	// Owner在所有帧上都不再持有数据，移除映射并回收槽位
+	void ReleaseOwnerSlot(const int32 Slot)
+	{
+		OwnerSlots.Remove(SlotOwners[Slot]);
+		SlotOwners[Slot] = OwnerShipDataType();
+		FreeSlots.Add(Slot);
+	}
+
+	// 清理 [BeginFrame, InsertFrame] 之间的掩码，跳帧写入时中间的帧也会进入有效范围
+	FORCEINLINE void ClearOwnerShipRange(const uint32 BeginFrame, const uint32 InsertFrame)
+	{
+		const uint32 FrameNum = FMath::Min(InsertFrame - BeginFrame + 1, MaxFramesNum + 1);
+		for (uint32 Offset = 0; Offset < FrameNum; ++Offset)
+		{
+			ClearOwnerShip((InsertFrame - Offset) & MaxFramesNum);
+		}
+	}
+
 protected:
 
 	/** 数据缓冲区 */
 	TArray<DataType> Buffer;
 
-	TMap<OwnerShipDataType, uint32> Counter;
+	/** Owner到稠密槽位的映射，槽位在首次写入时分配，Owner的最后一帧掩码被清理时释放 */
+	TMap<OwnerShipDataType, int32> OwnerSlots;
+
+	/** 槽位到Owner的反向映射，已释放的槽位为默认值 */
+	TArray<OwnerShipDataType> SlotOwners;
+
+	/** 每个槽位在环形缓冲中被标记的帧数，归零时释放槽位 */
+	TArray<int32> SlotFrameNums;
+
+	/** 已释放、可复用的槽位 */
+	TArray<int32> FreeSlots;
+
+	/** 每个环形槽位持有 MaskWordNum 个64位掩码，记录哪些Owner在该帧写入了数据 */
+	TArray<uint64> OwnerMasks;
+	uint32 MaskWordNum = 1;
 
 	/** 一直指向队尾无效数据的占位帧 */
 	uint32 EndFrame;
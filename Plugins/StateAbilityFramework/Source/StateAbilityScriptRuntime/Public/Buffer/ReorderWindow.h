@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+//////////////////////////////////////////////////////////////////////////
+// 固定容量的乱序重排窗口，以 Key (帧号) 对容量取模来定位槽位
+// 槽位内的 Payload 会被反复复用，稳定运行后插入、按序取出、过期都不会产生堆分配
+//////////////////////////////////////////////////////////////////////////
+template<typename PayloadType>
+struct TReorderWindow
+{
+	FORCEINLINE TReorderWindow()
+		: MinValidKey(0)
+		, KeyMask(0)
+		, ValidNum(0)
+	{}
+	FORCEINLINE TReorderWindow(const uint32 Capacity)
+		: MinValidKey(0)
+		, ValidNum(0)
+	{
+		checkSlow(Capacity > 0);
+
+		Slots.SetNum(FMath::RoundUpToPowerOfTwo(Capacity));
+		KeyMask = Slots.Num() - 1;
+	}
+
+public:
+	FORCEINLINE int32 Num() const
+	{
+		return ValidNum;
+	}
+
+	FORCEINLINE uint32 GetCapacity() const
+	{
+		return Slots.Num();
+	}
+
+	// 返回可写入的Payload，调用方负责填充。Key已过期、重复或槽位被更早的Key占用时返回nullptr
+	PayloadType* Insert(const uint32 Key)
+	{
+		if (Key < MinValidKey || Slots.IsEmpty())
+		{
+			return nullptr;
+		}
+
+		FSlot& Slot = Slots[Key & KeyMask];
+		if (IsSlotValid(Slot))
+		{
+			// 重复的Key，或是超出窗口的Key（保留更早需要处理的那个）
+			if (Slot.Key <= Key)
+			{
+				return nullptr;
+			}
+		}
+		else
+		{
+			++ValidNum;
+		}
+
+		Slot.Key = Key;
+		Slot.bValid = true;
+		return &Slot.Payload;
+	}
+
+	FORCEINLINE PayloadType* Find(const uint32 Key)
+	{
+		if (Key < MinValidKey || Slots.IsEmpty())
+		{
+			return nullptr;
+		}
+
+		FSlot& Slot = Slots[Key & KeyMask];
+		return IsSlotValid(Slot) && Slot.Key == Key ? &Slot.Payload : nullptr;
+	}
+
+	// 只标记无效，Payload 留给下一次 Insert 复用
+	void Remove(const uint32 Key)
+	{
+		if (Find(Key))
+		{
+			Slots[Key & KeyMask].bValid = false;
+			--ValidNum;
+		}
+	}
+
+	// 使所有 Key < InMinValidKey 的数据失效
+	void Expire(const uint32 InMinValidKey)
+	{
+		if (InMinValidKey <= MinValidKey)
+		{
+			return;
+		}
+
+		// 跨度超过容量时所有槽位都会过期，不需要逐个检查
+		if (InMinValidKey - MinValidKey >= (uint32)Slots.Num())
+		{
+			for (FSlot& Slot : Slots)
+			{
+				Slot.bValid = false;
+			}
+			ValidNum = 0;
+		}
+		else
+		{
+			for (uint32 Key = MinValidKey; Key < InMinValidKey; ++Key)
+			{
+				FSlot& Slot = Slots[Key & KeyMask];
+				if (Slot.bValid && Slot.Key < InMinValidKey)
+				{
+					Slot.bValid = false;
+					--ValidNum;
+				}
+			}
+		}
+
+		MinValidKey = InMinValidKey;
+	}
+
+	void Empty()
+	{
+		for (FSlot& Slot : Slots)
+		{
+			Slot.bValid = false;
+		}
+		ValidNum = 0;
+	}
+
+private:
+	struct FSlot
+	{
+		uint32 Key = 0;
+		bool bValid = false;
+		PayloadType Payload;
+	};
+
+	FORCEINLINE bool IsSlotValid(const FSlot& Slot) const
+	{
+		return Slot.bValid && Slot.Key >= MinValidKey;
+	}
+
+	TArray<FSlot> Slots;
+	uint32 MinValidKey;
+	uint32 KeyMask;
+	int32 ValidNum;
+};
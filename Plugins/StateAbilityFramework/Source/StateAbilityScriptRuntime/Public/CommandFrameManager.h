@@ -13,7 +13,9 @@
 #include "Buffer/BufferTypes.h"
 #include "Buffer/CircularQueueCore.h"
 #include "Net/Packet/CommandFrameInput.h"
+#include "Net/CommandEnhancedInput.h"
 #include "Net/CommandFrameNetTypes.h"
+#include "Net/CommandFrameInterest.h"
 #include "TimeDilationHelper.h"
 
 #include "CommandFrameManager.generated.h"
@@ -55,7 +57,44 @@ struct TStructOpsTypeTraits<FCommandFrameTickFunction> : public TStructOpsTypeTr
 	};
 };
 
-DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnFixedUpdate, float /* DeltaTime */, uint32 /* RCF */, uint32 /* ICF */);
+DECLARE_DELEGATE_ThreeParams(FOnFixedUpdateSingle, float /* DeltaTime */, uint32 /* RCF */, uint32 /* ICF */);
+
+/**
+ * 固定帧更新事件，接口与多播委托保持一致。
+ * 额外记录了每个绑定所属的UObject，回滚时可以只通知需要重新模拟的实体，见 UCommandFrameManager::ReplayFrames
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FOnFixedUpdate
+{
+	template<typename UserClass>
+	FDelegateHandle AddUObject(UserClass* InUserObject, void (UserClass::*InFunc)(float, uint32, uint32))
+	{
+		return Add(FOnFixedUpdateSingle::CreateUObject(InUserObject, InFunc));
+	}
+
+	template<typename FunctorType>
+	FDelegateHandle AddWeakLambda(UObject* InUserObject, FunctorType&& InFunctor)
+	{
+		return Add(FOnFixedUpdateSingle::CreateWeakLambda(InUserObject, Forward<FunctorType>(InFunctor)));
+	}
+
+	FDelegateHandle Add(FOnFixedUpdateSingle&& InDelegate);
+	bool Remove(FDelegateHandle Handle);
+	int32 RemoveAll(const void* InUserObject);
+
+	bool IsBound() const;
+
+	void Broadcast(float DeltaTime, uint32 RCF, uint32 ICF);
+	// 只通知 Filter 返回 true 的绑定，Filter 的参数为绑定所属的UObject（可能为空）
+	void BroadcastFiltered(float DeltaTime, uint32 RCF, uint32 ICF, TFunctionRef<bool(const UObject*)> Filter);
+
+private:
+	// 广播期间的移除只解绑，等广播结束后再统一清理
+	void CompactInvocationList();
+
+	TArray<FOnFixedUpdateSingle> InvocationList;
+	int32 BroadcastDepth = 0;
+	bool bNeedsCompact = false;
+};
 DECLARE_DELEGATE_OneParam(FOnFrameNetChannelRegistered, ACommandFrameNetChannelBase* Channel);
 
 UCLASS()
@@ -91,6 +130,10 @@ public:
 	void LoginOut(AGameModeBase* GameMode, AController* PC);
 	void RegisterClientChannel(ACommandFrameNetChannelBase* Channel);
 
+	// InputAction字典，服务器在会话开始时构建，客户端由NetChannel同步
+	const FCommandFrameInputActionTable& GetInputActionTable() const { return InputActionTable; }
+	void SetInputActionTable(const TArray<TObjectPtr<UInputAction>>& InputActions);
+
 	// 注册时，如果存在就会立即调用
 	void BindOnFrameNetChannelRegistered(UActorComponent* Key, FOnFrameNetChannelRegistered OnFrameNetChannelRegistered);
 	void BindOnFrameNetChannelRegistered(AActor* Key, FOnFrameNetChannelRegistered OnFrameNetChannelRegistered);
@@ -123,12 +166,22 @@ public:
 	void ReplayFrames(uint32 RewindedFrame);
 	bool IsInRewinding();
 
+	// 标记被修正的实体（Object所属的Actor），同一帧内的 ReplayFrames 只重新模拟这些实体及依赖它们的实体。
+	// 标记在 ReplayFrames 开始时被消耗，没有触发回滚的标记在进入下一帧时清除。
+	// 没有任何标记时会退化为全量重新模拟
+	void MarkReplayDirty(const UObject* Object);
+	// Dependent 依赖 Dependency 的模拟结果。附加（Attach）到被标记实体上的Actor会自动视为依赖
+	void AddReplayDependency(AActor* Dependent, AActor* Dependency);
+	void RemoveReplayDependency(AActor* Dependent);
+	bool ShouldReplay(const UObject* Object) const;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Input
 
 	void SimulateInput(uint32 CommandFrame);
-	// @TODO：轮询开销太大了
-	void BuildInputEventMap(APlayerController* PC, TMap<const UInputAction*, TArray<TSharedPtr<FEnhancedInputActionEventBinding>>>& InputEventMap);
+	// 仅在绑定版本或输入栈变化时重建，否则直接复用上次的结果
+	void UpdateInputEventMap(APlayerController* PC, const FUniqueNetIdRepl& NetId);
+	void BuildInputEventMap(APlayerController* PC, FCommandInputEventMap& InputEventMap);
 
 	TJOwnerShipCircularQueue<FCommandFrameInputFrame, FUniqueNetIdRepl, TArray<FCommandFrameInputAtom>> CommandBuffer;
 
@@ -139,9 +192,20 @@ public:
 	void RecordCommandSnapshot();
 	void ClientSendInputNetPacket();
 	void ClientReceiveCommandAck(uint32 ServerCommandFrame);
-	FStructView ReadAttributeFromSnapshotBuffer(uint32 CommandFrame, const UScriptStruct* Key);
+	FStructView ReadAttributeFromSnapshotBuffer(uint32 CommandFrame, const FCommandFrameSnapshotKey& Key);
+
+	// 快照实体索引，释放后需要等待快照缓冲区完整轮转一次才会被复用
+	uint32 AllocateSnapshotEntity();
+	void ReleaseSnapshotEntity(uint32 EntityIndex);
 
-	TJOwnerShipCircularQueue<FCommandFrameAttributeSnapshot, UScriptStruct*, uint8*> AttributeSnapshotBuffer;
+	TJOwnerShipCircularQueue<FCommandFrameAttributeSnapshot, FCommandFrameSnapshotKey, uint8*> AttributeSnapshotBuffer;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 确定性校验：服务器在DeltaPacket前缀中附带该帧快照的哈希，客户端与自己同一帧的快照比较
+
+	bool CalcSnapshotChecksum(ACommandFrameNetChannelBase* Channel, uint32 CommandFrame, uint64& OutChecksum);
+	void VerifySnapshotChecksum(ACommandFrameNetChannelBase* Channel, uint32 CommandFrame, uint64 ServerChecksum);
+	uint32 GetSnapshotDesyncNum() const { return SnapshotDesyncNum; }
 
 	//////////////////////////////////////////////////////////////////////////
 	// Server
@@ -152,6 +216,11 @@ public:
 	void ServerSendDeltaNetPacket();
 	uint32 GetCurCommandBufferNum(const FUniqueNetIdRepl& Owner);
 
+	// AOI，每次发送DeltaNetPacket前以各玩家Pawn的位置重建
+	void UpdateInterest();
+	bool IsNetRelevantFor(AController* Viewer, ACommandFrameNetChannelBase* TargetChannel) const;
+	const FCommandFrameInterestManager& GetInterestManager() const { return InterestManager; }
+
 	//////////////////////////////////////////////////////////////////////////
 
 private:
@@ -168,7 +237,32 @@ private:
 
 	TMap<UObject*, FOnFrameNetChannelRegistered> NetChannelDelegateMap;
 
-	TMap<const FUniqueNetIdRepl, TMap<const UInputAction*, TArray<TSharedPtr<FEnhancedInputActionEventBinding>>>> InputProcedureCache;
+	UPROPERTY()
+	FCommandFrameInputActionTable InputActionTable;
+	void BuildInputActionTable();
+
+	TMap<const FUniqueNetIdRepl, FCommandFrameInputProcedureCache> InputProcedureCache;
+
+	FCommandFrameInterestManager InterestManager;
+
+	uint32 SnapshotEntityNum;
+	TArray<TPair<uint32, uint32>> ReleasedSnapshotEntities;	// <EntityIndex, ReleaseFrame>，按释放顺序排列的队列
+	int32 ReleasedSnapshotEntityHead;	// 队首在 ReleasedSnapshotEntities 中的位置
+
+	uint32 SnapshotDesyncNum;
+	TArray<FCommandFrameSnapshotKey> SnapshotChecksumKeys;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Replay
+	static const AActor* GetReplayEntity(const UObject* Object);
+	void BuildReplayEntities();
+	void BroadcastFixedUpdate(FOnFixedUpdate& FixedUpdate, float DeltaTime);
+
+	bool bReplaying;
+	TSet<TObjectKey<AActor>> ReplayDirtyEntities;							// 被修正的实体
+	TSet<const AActor*> ReplayEntities;										// 本次需要重新模拟的实体（包含依赖者）
+	TMultiMap<TObjectKey<AActor>, TWeakObjectPtr<AActor>> ReplayDependents;	// Dependency -> Dependent
+	TArray<AActor*> ReplayEntityScratch;
 
 	//////////////////////////////////////////////////////////////////////////
 	// Debug
@@ -15,4 +15,16 @@ class UCommandFrameSettings : public UDeveloperSettings
 public: 
 	UPROPERTY(config, EditAnywhere, Category = Default)
 	bool bEnableCommandFrameNetReplication;
+
+	// 会话开始时为这些InputAction分配稠密索引，网络同步时只传递索引
+	UPROPERTY(config, EditAnywhere, Category = Input)
+	TArray<TSoftObjectPtr<class UInputAction>> CommandInputActions;
+
+	// 服务器只向半径内的客户端同步各NetChannel的内容，<= 0 时关闭AOI
+	UPROPERTY(config, EditAnywhere, Category = Interest, meta = (ClampMin = "0", Units = "cm"))
+	float InterestRadius = 0.0f;
+
+	// 离开半径 = InterestRadius * (1 + InterestHysteresis)，避免相关性在边界附近反复切换
+	UPROPERTY(config, EditAnywhere, Category = Interest, meta = (ClampMin = "0"))
+	float InterestHysteresis = 0.1f;
 };
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "Component/Mover/MoveLibrary/CFrameVelocityBatch.h"
+#include "Component/Mover/MoveLibrary/CFrameSweepBatch.h"
+
+#include "CFrameMoverBatchSubsystem.generated.h"
+
+class UCommandFrameManager;
+class UCFrameMoverComponent;
+
+/**
+ * 统一驱动所有 UCFrameMoverComponent 的 FixedTick（OnEndFrame），代替每个Mover各自绑定委托。
+ *
+ * 每帧分为：
+ * 1. 按注册顺序让每个Mover生成移动，Walking/Falling 只把速度计算的输入写入 FCFrameVelocityBatch
+ * 2. 批量计算速度
+ * 3. 按注册顺序写回速度并混合，把首次移动的扫掠写入 FCFrameSweepBatch
+ * 4. 并行预查询扫掠（只读），结果与线程数无关
+ * 5. 按注册顺序提交移动和模式切换，预查询畅通时跳过扫掠
+ * 6. 按注册顺序派发碰撞
+ */
+UCLASS()
+class STATEABILITYSCRIPTRUNTIME_API UCFrameMoverBatchSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UCFrameMoverBatchSubsystem* Get(UObject* WorldContext);
+
+	//~ Begin UWorldSubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem interface
+
+	void RegisterMover(UCFrameMoverComponent* Mover);
+	void UnregisterMover(UCFrameMoverComponent* Mover);
+
+	int32 GetMoverNum() const { return Movers.Num(); }
+
+private:
+	void FixedTick(float DeltaTime, uint32 RCF, uint32 ICF);
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UCommandFrameManager> CFrameManager;
+
+	TArray<TWeakObjectPtr<UCFrameMoverComponent>> Movers;
+	TArray<TWeakObjectPtr<UCFrameMoverComponent>> TickingMovers;	// 本帧需要Tick的Mover，Tick期间注销不影响遍历
+
+	FCFrameVelocityBatch VelocityBatch;
+	FCFrameSweepBatch SweepBatch;
+};
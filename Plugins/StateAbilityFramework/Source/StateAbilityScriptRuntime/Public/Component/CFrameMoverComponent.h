@@ -4,9 +4,11 @@
 
 #include "CoreMinimal.h"
 
+#include "Buffer/BufferTypes.h"
 #include "Net/CommandFrameNetTypes.h"
 #include "Component/Mover/CFrameMovementTypes.h"
 #include "Component/Mover/CFrameMovementContext.h"
+#include "Component/Mover/MoveLibrary/CFrameMovementNetState.h"
 
 #include "CFrameMoverComponent.generated.h"
 
@@ -14,6 +16,16 @@ class UCFrameMovementMode;
 class UCFrameLayeredMoveBase;
 class UCommandFrameManager;
 class UCFrameMoveModeStateMachine;
+struct FCFrameVelocityBatch;
+struct FCFrameSweepBatch;
+
+// 批处理执行期间推迟派发的碰撞，见 UCFrameMoverComponent::FlushPendingImpacts
+struct FCFrameMoverPendingImpact
+{
+	FHitResult Hit;
+	FName ModeName;
+	FVector MoveDelta;
+};
 
 UCLASS(BlueprintType, meta = (BlueprintSpawnableComponent))
 class STATEABILITYSCRIPTRUNTIME_API UCFrameMoverComponent : public UActorComponent, public ICommandFrameNetProcedure
@@ -34,12 +46,19 @@ public:
 
 	virtual void PostBeginPlay();
 	virtual void FixedTick(float DeltaTime, uint32 RCF, uint32 ICF);
+	// 由 UCFrameMoverBatchSubsystem 调用，FixedTick 拆分为生成、混合、执行移动三步，中间批量计算速度、并行预查询扫掠
+	bool PrepareFixedTick(float DeltaTime, uint32 RCF, uint32 ICF, FCFrameVelocityBatch& VelocityBatch);
+	void ResolveFixedTick(const FCFrameVelocityBatch& VelocityBatch, FCFrameSweepBatch* SweepBatch);
+	void ExecuteFixedTick(const FCFrameSweepBatch* SweepBatch);
+	// ExecuteFixedTick 期间的碰撞在所有Mover执行完后才派发，避免回调改变之后Mover的移动
+	void FlushPendingImpacts();
 	virtual void OnHandleImpact(const FHitResult& Hit, const FName ModeName, const FVector& MoveDelta);
 
 	// ICommandFrameNetProcedure
 	virtual void OnServerNetSync(FNetProcedureSyncParam& SyncParam) override;
 	virtual void OnClientNetSync(FNetProcedureSyncParam& SyncParam, bool& bNeedRewind) override;
 	virtual void OnClientRewind() override;
+	virtual void GetSnapshotKeys(TArray<FCommandFrameSnapshotKey>& OutKeys) override;
 	// ~ICommandFrameNetProcedure
 
 	void HandleImpact(const FHitResult& Hit, const FName ModeName = NAME_None, const FVector& MoveDelta = FVector::ZeroVector);
@@ -56,6 +75,8 @@ public:
 	UPrimitiveComponent* GetPrimitiveComponent() const { return UpdatedCompAsPrimitive; }
 	FCFrameMovementConfig& GetMovementConfig() { return MovementConfig; }
 	UCommandFrameManager* GetCommandFrameManager();
+	FCommandFrameSnapshotKey GetMovementSnapshotKey() const;
+	const FCFrameMovementQuantization& GetMovementQuantization() const;
 protected:
 	// Basic "Update Component/Ticking"
 	void SetUpdatedComponent(USceneComponent* NewUpdatedComponent);
@@ -107,4 +128,13 @@ private:
 
 	UPROPERTY(Transient)
 	TObjectPtr<UCFrameMoveModeStateMachine> ModeFSM;
+
+	// 在快照缓冲区内的实体索引
+	uint32 SnapshotEntityIndex;
+
+	bool bDeferImpacts;
+	TArray<FCFrameMoverPendingImpact> PendingImpacts;
+
+	// 最近同步过的状态，作为差量同步的基准。Server 为发送的状态，Client 为解码后的状态
+	FCFrameMovementNetHistory NetHistory;
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "Component/Mover/CFrameMovementTypes.h"
 #include "Component/Mover/CFrameMovementContext.h"
+#include "Component/Mover/CFrameMoveModeTransitionTable.h"
 
 #include "CFrameMoveModeStateMachine.generated.h"
 
@@ -13,17 +14,9 @@ struct FCFrameMovementConfig;
 class UCFrameMovementMixer;
 class UCFrameMovementMode;
 class UCFrameMoveModeTransition;
-
-USTRUCT()
-struct FCFrameMoveModeInfo
-{
-	GENERATED_BODY()
-
-	UPROPERTY()
-	TObjectPtr<UCFrameMovementMode> ModeInstance;
-	UPROPERTY()
-	TArray<FCFrameModeTransitionLink> TransitionLinks;
-};
+struct FCFrameVelocityBatch;
+struct FCFrameSweepBatch;
+enum class ECFrameMovementTraceType : uint8;
 
 UCLASS()
 class UCFrameMoveModeStateMachine : public UObject
@@ -32,19 +25,32 @@ class UCFrameMoveModeStateMachine : public UObject
 public:
 	void Init(FCFrameMovementConfig& Config);
 	void FixedTick(float DeltaTime, uint32 RCF, uint32 ICF);
+
+	// 批处理：PrepareMove 生成移动并把速度计算写入 VelocityBatch，计算完成后由 ResolveMove 写回并混合，
+	// AddSweepRequest 提交首次移动的扫掠预查询，最后由 ExecuteMove 完成扫掠和模式切换
+	bool PrepareMove(float DeltaTime, uint32 RCF, uint32 ICF, FCFrameVelocityBatch* VelocityBatch);
+	void ResolveMove(const FCFrameVelocityBatch* VelocityBatch);
+	void AddSweepRequest(FCFrameSweepBatch& SweepBatch);
+	void ExecuteMove(const FCFrameSweepBatch* SweepBatch);
+
 	void UpdateTransition();
 	void OnClientRewind();
 
 	const FCFrameMovementContext& GetMovementContext() { return Context; }
 	UCFrameMovementMode* GetCurrentMode() { return CurrentMode; }
 	FName GetCurrentModeName() { return CurrentModeName; }
+	uint8 GetCurrentModeId() const { return CurrentModeId; }
+	const FCFrameMoveModeTransitionTable& GetTransitionTable() const { return TransitionTable; }
 
 protected:
 	void RecordMovementSnapshot();
+	void TraceMovement(ECFrameMovementTraceType Type, uint32 Frame);
 
 protected:
+	// 下标即模式ID
 	UPROPERTY(Transient)
-	TMap<FName, FCFrameMoveModeInfo> ModeInfos;
+	TArray<TObjectPtr<UCFrameMovementMode>> Modes;
+	FCFrameMoveModeTransitionTable TransitionTable;
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<UCFrameLayeredMove>> LayeredMoves;
 
@@ -52,10 +58,13 @@ protected:
 	TObjectPtr<UCFrameMovementMode> CurrentMode;
 	UPROPERTY(Transient)
 	FName CurrentModeName;
+	uint8 CurrentModeId;
 	UPROPERTY(Transient)
 	TObjectPtr<UCFrameMovementMixer> CurrentMixer;
 	UPROPERTY(Transient)
 	FCFrameMovementContext Context;
+
+	FCFrameProposedMove CombinedLayeredMove;
 private:
 	
 };
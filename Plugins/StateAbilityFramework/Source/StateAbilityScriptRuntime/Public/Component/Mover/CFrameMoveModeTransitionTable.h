@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Component/Mover/CFrameMovementTypes.h"
+
+class UCFrameMovementMode;
+class UCFrameMoveModeTransition;
+struct FCFrameMovementContext;
+
+namespace CFrameMoveMode
+{
+	// 模式ID即模式在 UCFrameMoveModeStateMachine 中的下标
+	constexpr uint8 InvalidId = MAX_uint8;
+}
+
+struct FCFrameCompiledTransition
+{
+	// 转换的 CDO
+	const UCFrameMoveModeTransition* Transition = nullptr;
+	ECFrameMoveModeFlags PrecheckMask = ECFrameMoveModeFlags::None;
+	ECFrameMoveModeFlags PrecheckValue = ECFrameMoveModeFlags::None;
+	bool bPrecheckOnly = false;
+	uint8 ToModeId = CFrameMoveMode::InvalidId;
+};
+
+/**
+ * 初始化时由 FCFrameModeTransitionLink 编译得到的转换表。
+ * 同一模式的转换连续存放并按优先级从高到低排列，运行时只需顺序扫描，先比较状态位，必要时才调用 OnEvaluate。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameMoveModeTransitionTable
+{
+	// Modes 的下标即模式ID，模式名找不到或没有转换类的 Link 会被丢弃
+	void Compile(TConstArrayView<TObjectPtr<UCFrameMovementMode>> Modes, TConstArrayView<FCFrameModeTransitionLink> Links);
+	void Reset();
+
+	// 返回第一个成立的转换的目标模式ID，没有则返回 CFrameMoveMode::InvalidId
+	uint8 Evaluate(uint8 FromModeId, ECFrameMoveModeFlags ModeFlags, FCFrameMovementContext& Context) const;
+
+	TConstArrayView<FCFrameCompiledTransition> GetTransitions(uint8 FromModeId) const;
+	int32 Num() const { return Transitions.Num(); }
+
+private:
+	TArray<FCFrameCompiledTransition> Transitions;
+	// Transitions[ModeOffsets[Id], ModeOffsets[Id + 1]) 为模式 Id 的转换
+	TArray<uint16> ModeOffsets;
+};
@@ -4,11 +4,10 @@
 
 #include "CoreMinimal.h"
 
-#include "StructView.h"
-#include "InstancedStruct.h"
 #include "MoveLibrary/FloorQueryUtils.h"
 
 #include "Component/Mover/CFrameProposedMove.h"
+#include "Component/Mover/CFrameMovementPersistentData.h"
 
 #include "CFrameMovementContext.generated.h"
 
@@ -16,22 +15,8 @@ class UCFrameMoveStateAdapter;
 class UCFrameMoverComponent;
 class UCommandFrameManager;
 class UCFrameMovementMode;
-
-namespace CFrameContextDataKey
-{
-	const FName LastFloorResult = TEXT("LastFloor");
-	const FName LastFoundDynamicMovementBase = TEXT("LastFoundDynamicMovementBase");
-}
-
-USTRUCT()
-struct FCFrameMovementContextPersistentData
-{
-	GENERATED_BODY()
-	UPROPERTY()
-	bool bIsHidden = true;
-	UPROPERTY()
-	FInstancedStruct Data;
-};
+struct FCFrameVelocityBatch;
+struct FCFrameSweepBatch;
 
 USTRUCT()
 struct FCFrameMovementContext
@@ -64,48 +49,40 @@ struct FCFrameMovementContext
 
 	FCFrameProposedMove CombinedMove;
 
+	// 仅在批处理的 GenerateMove 期间有效，见 UCFrameMovementMode::ResolveBatchedMove
+	FCFrameVelocityBatch* VelocityBatch = nullptr;
+
+	// 仅在批处理的 Execute 期间有效，首次移动的扫掠预查询结果，见 FCFrameMovementUtils::TryBatchedMoveUpdatedComponent
+	const FCFrameSweepBatch* SweepBatch = nullptr;
+	int32 SweepIndex = INDEX_NONE;
+
 	//////////////////////////////////////////////////////////////////////////
-	// 跨帧数据 
+	// 跨帧数据，类型需在 FCFrameMovementPersistentSlots 中注册
 	template<typename T>
-	void SetPersistentData(FName Key, T Data);
+	void SetPersistentData(const T& Data) { PersistentData.Set(Data); }
 	template<typename T>
-	bool GetPersistentData(FName Key, T& Data);
-	FStructView GetPersistentData(FName Key);
-	void RemovePersistentData(FName Key);
-	void InvalidPersistentData(FName Key);
-	bool HasValidPersistentData(FName Key);
-	UPROPERTY()
-	TMap<FName, FCFrameMovementContextPersistentData> PersistentDataBuffer;
+	bool GetPersistentData(T& Data) const;
+	template<typename T>
+	T* FindPersistentData() { return PersistentData.Find<T>(); }
+	template<typename T>
+	void InvalidPersistentData() { PersistentData.Invalid<T>(); }
+	template<typename T>
+	bool HasValidPersistentData() const { return PersistentData.IsValid<T>(); }
+
+	FCFrameMovementPersistentData PersistentData;
 	//////////////////////////////////////////////////////////////////////////
 
 };
 
 
 template<typename T>
-void FCFrameMovementContext::SetPersistentData(FName Key, T Data)
+bool FCFrameMovementContext::GetPersistentData(T& Data) const
 {
-	FCFrameMovementContextPersistentData& PersistentData = PersistentDataBuffer.FindOrAdd(Key);
-	PersistentData.bIsHidden = false;
-
-	if (PersistentData.Data.IsValid())
-	{
-		PersistentData.Data.GetMutable<T>() = Data;
-	}
-	else
-	{
-		PersistentData.Data.InitializeAs(T::StaticStruct(), (uint8*)&Data);
-	}
-}
-
-template<typename T>
-bool FCFrameMovementContext::GetPersistentData(FName Key, T& Data)
-{
-	FCFrameMovementContextPersistentData& PersistentData = PersistentDataBuffer.FindOrAdd(Key);
-	if (PersistentData.bIsHidden || !PersistentData.Data.IsValid())
+	if (!PersistentData.IsValid<T>())
 	{
 		return false;
 	}
 
-	Data = PersistentData.Data.GetMutable<T>();
+	Data = PersistentData.Get<T>();
 	return true;
-}
\ No newline at end of file
+}
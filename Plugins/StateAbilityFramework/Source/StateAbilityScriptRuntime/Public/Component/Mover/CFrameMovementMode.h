@@ -4,12 +4,15 @@
 
 #include "CoreMinimal.h"
 
+#include "Component/Mover/CFrameMovementTypes.h"
 #include "Component/Mover/CFrameProposedMove.h"
 #include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameMovementQuantization.h"
 
 #include "CFrameMovementMode.generated.h"
 
 struct FCFrameMovementContext;
+struct FCFrameVelocityBatch;
 
 namespace CFrameMovementModeUtils
 {
@@ -111,6 +114,10 @@ class UCFrameMovementSetting : public UDataAsset
 	/** Depth at which the pawn stops swimming */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Swimming", meta = (Units = "cm"))
 	float SwimmingStopImmersionDepth = 39.9f;
+
+	/** Quantization of location, velocity and orientation in the movement net sync. Server and clients must use the same setting. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Network")
+	FCFrameMovementQuantization Quantization;
 };
 
 UCLASS(Abstract, Blueprintable, BlueprintType, EditInlineNew)
@@ -124,8 +131,12 @@ public:
 	virtual void OnActivated() {}
 	virtual void OnDeactivated() {}
 	virtual void GenerateMove(FCFrameMovementContext& Context, FCFrameProposedMove& OutProposedMove) {}
+	// Context.VelocityBatch 有效时，GenerateMove 可以只把速度计算写入批次，批量计算完成后在这里写回 OutProposedMove
+	virtual void ResolveBatchedMove(FCFrameMovementContext& Context, const FCFrameVelocityBatch& Batch, FCFrameProposedMove& OutProposedMove) {}
 	virtual void Execute(FCFrameMovementContext& Context) {}
 	virtual void OnClientRewind() {}
+	// 每帧转换前读取一次，用于转换表的预检查
+	virtual ECFrameMoveModeFlags GetModeFlags() const { return ECFrameMoveModeFlags::None; }
 
 	virtual void SetupInputComponent(UInputComponent* InInputComponent);
 
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <type_traits>
+
+#include "MoveLibrary/FloorQueryUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameBasedMoveUtils.h"
+
+namespace CFramePersistentSlot
+{
+	template<int32 Num>
+	struct TLayout
+	{
+		SIZE_T Offsets[Num] = {};
+		SIZE_T Size = 0;
+		SIZE_T Alignment = 1;
+	};
+
+	// 内存块头部是每个槽位的有效标记，之后按各类型的对齐依次排列
+	template<typename... SlotTypes>
+	constexpr TLayout<sizeof...(SlotTypes)> MakeLayout()
+	{
+		constexpr SIZE_T Sizes[] = { sizeof(SlotTypes)... };
+		constexpr SIZE_T Alignments[] = { alignof(SlotTypes)... };
+
+		TLayout<sizeof...(SlotTypes)> Result;
+		SIZE_T Offset = sizeof...(SlotTypes);
+		for (int32 Index = 0; Index < (int32)sizeof...(SlotTypes); ++Index)
+		{
+			Offset = Align(Offset, Alignments[Index]);
+			Result.Offsets[Index] = Offset;
+			Offset += Sizes[Index];
+			Result.Alignment = Alignments[Index] > Result.Alignment ? Alignments[Index] : Result.Alignment;
+		}
+		Result.Size = Align(Offset, Result.Alignment);
+		return Result;
+	}
+
+	template<typename T, typename... SlotTypes>
+	constexpr int32 IndexOf()
+	{
+		constexpr bool Matches[] = { std::is_same_v<T, SlotTypes>... };
+		for (int32 Index = 0; Index < (int32)sizeof...(SlotTypes); ++Index)
+		{
+			if (Matches[Index])
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+}
+
+/**
+ * 跨帧数据的槽位表，每种结构体在编译期得到固定的索引和偏移
+ */
+template<typename... SlotTypes>
+struct TCFramePersistentSlotTable
+{
+	static_assert((std::is_trivially_destructible_v<SlotTypes> && ...), "Persistent slots are copied with memcpy and never destructed.");
+
+	static constexpr int32 Num = sizeof...(SlotTypes);
+	static constexpr CFramePersistentSlot::TLayout<sizeof...(SlotTypes)> Layout = CFramePersistentSlot::MakeLayout<SlotTypes...>();
+
+	template<typename T>
+	static constexpr int32 IndexOf()
+	{
+		constexpr int32 Index = CFramePersistentSlot::IndexOf<T, SlotTypes...>();
+		static_assert(Index != INDEX_NONE, "Type is not registered in the persistent slot table.");
+		return Index;
+	}
+
+	template<typename T>
+	static constexpr SIZE_T OffsetOf()
+	{
+		return Layout.Offsets[IndexOf<T>()];
+	}
+
+	static void Construct(uint8* Block)
+	{
+		(new (Block + OffsetOf<SlotTypes>()) SlotTypes(), ...);
+	}
+};
+
+/**
+ * 新增跨帧数据时在此注册类型
+ * FFloorCheckResult：上一帧的地面
+ * FCFrameRelativeBaseInfo：上一帧找到的动态 MovementBase
+ */
+typedef TCFramePersistentSlotTable<FFloorCheckResult, FCFrameRelativeBaseInfo> FCFrameMovementPersistentSlots;
+
+/**
+ * FCFrameMovementContext 的跨帧数据，所有槽位位于一块对齐的连续内存中。
+ * 访问只需一次指针偏移，复制（快照、回滚）只需一次 memcpy。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameMovementPersistentData
+{
+	FCFrameMovementPersistentData()
+	{
+		Reset();
+	}
+
+	FCFrameMovementPersistentData(const FCFrameMovementPersistentData& Other)
+	{
+		FMemory::Memcpy(Block, Other.Block, sizeof(Block));
+	}
+
+	FCFrameMovementPersistentData& operator=(const FCFrameMovementPersistentData& Other)
+	{
+		FMemory::Memcpy(Block, Other.Block, sizeof(Block));
+		return *this;
+	}
+
+	void Reset()
+	{
+		FMemory::Memzero(Block, sizeof(Block));
+		FCFrameMovementPersistentSlots::Construct(Block);
+	}
+
+	template<typename T>
+	T& Get()
+	{
+		return *reinterpret_cast<T*>(Block + FCFrameMovementPersistentSlots::OffsetOf<T>());
+	}
+
+	template<typename T>
+	const T& Get() const
+	{
+		return *reinterpret_cast<const T*>(Block + FCFrameMovementPersistentSlots::OffsetOf<T>());
+	}
+
+	template<typename T>
+	T* Find()
+	{
+		return IsValid<T>() ? &Get<T>() : nullptr;
+	}
+
+	template<typename T>
+	bool IsValid() const
+	{
+		return Block[FCFrameMovementPersistentSlots::IndexOf<T>()] != 0;
+	}
+
+	template<typename T>
+	void Set(const T& Data)
+	{
+		Get<T>() = Data;
+		Block[FCFrameMovementPersistentSlots::IndexOf<T>()] = 1;
+	}
+
+	template<typename T>
+	void Invalid()
+	{
+		Block[FCFrameMovementPersistentSlots::IndexOf<T>()] = 0;
+	}
+
+	static constexpr SIZE_T GetBlockSize() { return FCFrameMovementPersistentSlots::Layout.Size; }
+
+private:
+	alignas(FCFrameMovementPersistentSlots::Layout.Alignment) uint8 Block[FCFrameMovementPersistentSlots::Layout.Size];
+};
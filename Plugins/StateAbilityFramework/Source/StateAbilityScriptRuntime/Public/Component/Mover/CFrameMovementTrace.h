@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+#include <type_traits>
+
+// 每帧的移动日志在 Shipping 中完全不编译，需要时用 CFrame.Mover.Trace 记录二进制事件
+#ifndef CFRAME_MOVEMENT_VERBOSE_LOG
+	#if UE_BUILD_SHIPPING
+		#define CFRAME_MOVEMENT_VERBOSE_LOG 0
+	#else
+		#define CFRAME_MOVEMENT_VERBOSE_LOG 1
+	#endif
+#endif
+
+#if CFRAME_MOVEMENT_VERBOSE_LOG
+	#define UE_CFRAME_MOVE_LOG(CategoryName, Verbosity, Format, ...) UE_LOG(CategoryName, Verbosity, Format, ##__VA_ARGS__)
+#else
+	#define UE_CFRAME_MOVE_LOG(CategoryName, Verbosity, Format, ...)
+#endif
+
+enum class ECFrameMovementTraceType : uint8
+{
+	Tick,		// 正常的 FixedTick
+	Replay,		// 回滚后重新模拟
+};
+
+/**
+ * 一次移动的记录，只包含POD数据，记录时不做任何格式化
+ */
+struct FCFrameMovementTraceEvent
+{
+	uint32 Frame = 0;			// Tick 为 RCF，Replay 为 ICF
+	uint32 EntityIndex = INDEX_NONE;
+	uint8 ModeId = 0;			// 见 FCFrameMovementTrace::GetModeName
+	ECFrameMovementTraceType Type = ECFrameMovementTraceType::Tick;
+	uint8 bClient = 0;
+	uint8 Padding = 0;
+	FVector Position = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+};
+static_assert(std::is_trivially_copyable_v<FCFrameMovementTraceEvent>, "Trace events are written to the ring buffer and to disk as raw bytes.");
+
+/**
+ * 移动事件的二进制环形缓冲区，写满后覆盖最旧的事件。
+ * CFrame.Mover.Trace 开启记录，CFrame.Mover.TraceDump 写入文件，之后用 CFrameMovementTraceDecode 命令行工具解码。
+ */
+class STATEABILITYSCRIPTRUNTIME_API FCFrameMovementTrace
+{
+public:
+	static constexpr uint32 FileMagic = 0x544D4643;	// 'CFMT'
+	static constexpr uint16 FileVersion = 1;
+
+	explicit FCFrameMovementTrace(int32 InCapacity);
+
+	static FCFrameMovementTrace& Get();
+	static bool IsEnabled() { return bEnabled; }
+
+	// CFrame.Mover.Trace
+	static bool bEnabled;
+
+	void Record(const FCFrameMovementTraceEvent& Event)
+	{
+		const uint64 Index = WriteIndex.fetch_add(1, std::memory_order_relaxed);
+		Events.GetData()[Index & IndexMask] = Event;
+	}
+
+	uint8 GetModeId(FName ModeName);
+	FName GetModeName(uint8 ModeId) const;
+
+	void Reset();
+	int32 Num() const;
+	int32 GetCapacity() const { return Events.Num(); }
+	// 从旧到新
+	void CopyEvents(TArray<FCFrameMovementTraceEvent>& OutEvents) const;
+
+	bool SaveToFile(const FString& FilePath) const;
+	static bool LoadFromFile(const FString& FilePath, TArray<FCFrameMovementTraceEvent>& OutEvents, TArray<FName>& OutModeNames);
+
+private:
+	TArray<FCFrameMovementTraceEvent> Events;
+	uint64 IndexMask = 0;
+	std::atomic<uint64> WriteIndex = 0;
+
+	TArray<FName> ModeNames;
+};
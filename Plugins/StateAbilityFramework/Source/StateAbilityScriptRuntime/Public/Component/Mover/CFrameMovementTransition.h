@@ -15,7 +15,7 @@ class UCFrameMovementMode;
 struct FCFrameMovementContext;
 
 UCLASS(Abstract, BlueprintType)
-class UCFrameMoveModeTransition : public UObject
+class STATEABILITYSCRIPTRUNTIME_API UCFrameMoveModeTransition : public UObject
 {
 	GENERATED_BODY()
 public:
@@ -24,10 +24,21 @@ public:
 
 	virtual bool OnEvaluate(FCFrameMovementContext& Context) const;
 
+	TSubclassOf<UCFrameMovementMode> GetFromModeClass() const { return FromModeClass; }
+	ECFrameMoveModeFlags GetPrecheckMask() const { return PrecheckMask; }
+	ECFrameMoveModeFlags GetPrecheckValue() const { return PrecheckValue; }
+	bool IsPrecheckOnly() const { return bPrecheckOnly; }
+
 protected:
 	UPROPERTY()
 	TSubclassOf<UCFrameMovementMode> FromModeClass;
 	UPROPERTY()
 	TSubclassOf<UCFrameMovementMode> ToModeClass;
+
+	// 预检查：(Mode->GetModeFlags() & PrecheckMask) == PrecheckValue 不成立时不会调用 OnEvaluate
+	ECFrameMoveModeFlags PrecheckMask = ECFrameMoveModeFlags::None;
+	ECFrameMoveModeFlags PrecheckValue = ECFrameMoveModeFlags::None;
+	// 预检查已经等价于 OnEvaluate，通过后直接转换
+	bool bPrecheckOnly = false;
 };
 
@@ -11,6 +11,17 @@ class UCFrameMoveStateAdapter;
 class UCFrameMovementMixer;
 class UCFrameMovementMode;
 class UCFrameLayeredMove;
+class UCFrameMovementSetting;
+
+/**
+ * 模式公开给转换表的状态位，转换可以只凭这些位做预检查，见 UCFrameMoveModeTransition
+ */
+enum class ECFrameMoveModeFlags : uint32
+{
+	None				= 0,
+	OnWalkableFloor		= 1 << 0,
+};
+ENUM_CLASS_FLAGS(ECFrameMoveModeFlags);
 
 /**
  * @TODO: 最好改为可视化编辑
@@ -44,6 +55,9 @@ public:
 	TMap<FName, TSubclassOf<UCFrameMovementMode>> MovementModes;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced, Category = Config)
 	TArray<TObjectPtr<UCFrameLayeredMove>> LayeredMoves;
+	// 为空时使用默认的同步量化方式
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Config)
+	TObjectPtr<UCFrameMovementSetting> MovementSetting;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Config)
 	FName DefaultModeName;
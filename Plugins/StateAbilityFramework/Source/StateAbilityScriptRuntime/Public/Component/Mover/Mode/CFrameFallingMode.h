@@ -6,6 +6,7 @@
 
 #include "Component/Mover/CFrameMovementMode.h"
 #include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameAirMoveUtils.h"
 #include "Component/Mover/MoveLibrary/CFrameBasedMoveUtils.h"
 
 #include "CFrameFallingMode.generated.h"
@@ -23,8 +24,10 @@ public:
 	virtual void OnActivated() override;
 	virtual void OnDeactivated() override;
 	virtual void GenerateMove(FCFrameMovementContext& Context, FCFrameProposedMove& OutProposedMove) override;
+	virtual void ResolveBatchedMove(FCFrameMovementContext& Context, const FCFrameVelocityBatch& Batch, FCFrameProposedMove& OutProposedMove) override;
 	virtual void Execute(FCFrameMovementContext& Context) override;
 	virtual void OnClientRewind() override;
+	virtual ECFrameMoveModeFlags GetModeFlags() const override { return bIsOnWalkableFloor ? ECFrameMoveModeFlags::OnWalkableFloor : ECFrameMoveModeFlags::None; }
 
 protected:
 	void OnMoveTriggered(const FInputActionValue& Value);
@@ -33,6 +36,7 @@ protected:
 	void CaptureFinalState(FCFrameMovementContext& Context, const FFloorCheckResult& FloorResult) const;
 
 	FVector ConsumeControlInputVector();
+	void FinishGenerateMove(FCFrameMovementContext& Context, const FVector& StartVelocity, FCFrameProposedMove& OutProposedMove) const;
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input")
 	TObjectPtr<UInputAction> IA_Move;
@@ -133,4 +137,9 @@ private:
 	uint32 MoveCompletedHandle;
 
 	FVector LastAffirmativeMoveInput = FVector::ZeroVector;	// Movement input (intent or velocity) the last time we had one that wasn't zero
+
+	// 批处理时等待写回的移动
+	FCFrameFreeMoveParams PendingMoveParams;
+	FVector PendingStartVelocity = FVector::ZeroVector;
+	int32 PendingVelocityIndex = INDEX_NONE;
 };
\ No newline at end of file
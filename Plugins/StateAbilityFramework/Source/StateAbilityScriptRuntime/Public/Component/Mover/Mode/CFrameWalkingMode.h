@@ -6,7 +6,9 @@
 
 #include "Component/Mover/CFrameMovementMode.h"
 #include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameGroundMoveUtils.h"
 #include "Component/Mover/MoveLibrary/CFrameBasedMoveUtils.h"
+#include "Component/Mover/MoveLibrary/CFrameFloorCache.h"
 
 #include "CFrameWalkingMode.generated.h"
 
@@ -23,8 +25,12 @@ public:
 	virtual void OnActivated() override;
 	virtual void OnDeactivated() override;
 	virtual void GenerateMove(FCFrameMovementContext& Context, FCFrameProposedMove& OutProposedMove) override;
+	virtual void ResolveBatchedMove(FCFrameMovementContext& Context, const FCFrameVelocityBatch& Batch, FCFrameProposedMove& OutProposedMove) override;
 	virtual void Execute(FCFrameMovementContext& Context) override;
 	virtual void OnClientRewind() override;
+	virtual ECFrameMoveModeFlags GetModeFlags() const override { return bIsOnWalkableFloor ? ECFrameMoveModeFlags::OnWalkableFloor : ECFrameMoveModeFlags::None; }
+
+	const FCFrameFloorCache& GetFloorCache() const { return FloorCache; }
 
 protected:
 	void OnMoveTriggered(const FInputActionValue& Value);
@@ -33,6 +39,7 @@ protected:
 	void CaptureFinalState(FCFrameMovementContext& Context, bool bDidAttemptMovement, const FFloorCheckResult& FloorResult) const;
 
 	FVector ConsumeControlInputVector();
+	void FinishGenerateMove(FCFrameMovementContext& Context, FCFrameProposedMove& OutProposedMove) const;
 	FCFrameRelativeBaseInfo UpdateFloorAndBaseInfo(FCFrameMovementContext& Context, const FFloorCheckResult& FloorResult) const;
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input")
@@ -135,4 +142,11 @@ private:
 	uint32 MoveCompletedHandle;
 
 	FVector LastAffirmativeMoveInput = FVector::ZeroVector;	// Movement input (intent or velocity) the last time we had one that wasn't zero
+
+	// 批处理时等待写回的移动
+	FCFrameGroundMoveParams PendingMoveParams;
+	int32 PendingVelocityIndex = INDEX_NONE;
+
+	// 站立不动时复用上次的地面检测结果
+	FCFrameFloorCache FloorCache;
 };
\ No newline at end of file
@@ -40,6 +40,12 @@ struct STATEABILITYSCRIPTRUNTIME_API FCFrameAirMoveUtils
 public:
 	/** Generate a new movement based on move/orientation intents and the prior state, unconstrained like when flying */
 	static void ComputeControlledFreeMove(const FCFrameFreeMoveParams& InParams, OUT FCFrameProposedMove& OutProposedMove);
+
+	/** Same as above, using a linear velocity already computed from MakeComputeVelocityParams (e.g. by FCFrameVelocityBatch) */
+	static void ComputeControlledFreeMove(const FCFrameFreeMoveParams& InParams, const FVector& LinearVelocity, OUT FCFrameProposedMove& OutProposedMove);
+
+	/** Inputs of the FCFrameMovementUtils::ComputeVelocity call made by ComputeControlledFreeMove */
+	static FCFrameComputeVelocityParams MakeComputeVelocityParams(const FCFrameFreeMoveParams& InParams);
 	
 	// Checks if a hit result represents a walkable location that an actor can land on
 	static bool IsValidLandingSpot(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FHitResult& Hit, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult);
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "MoveLibrary/FloorQueryUtils.h"
+
+class USceneComponent;
+class UPrimitiveComponent;
+
+/**
+ * 单个Mover的 UFloorQueryUtils::FindFloor 缓存。
+ *
+ * 以量化后的位置、地面组件（MovementBase）及其 Mobility/Transform、胶囊体尺寸和查询参数为键，命中时直接复用上次的结果，跳过扫掠和射线检测。
+ * 地面与Mover之间的碰撞状态（CollisionEnabled、ObjectType 与双方的 Response）同样是键的一部分。
+ * 地面移动、碰撞状态变化，或Mover的位移超过 CFrame.Mover.FloorCacheTolerance 时失效。只缓存找到了地面且没有初始穿透的结果。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameFloorCache
+{
+	void FindFloor(const USceneComponent* UpdatedComponent, const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, FFloorCheckResult& OutFloorResult);
+	void Invalidate();
+
+	uint32 GetHitNum() const { return HitNum; }
+	uint32 GetMissNum() const { return MissNum; }
+	float GetHitRate() const;
+	void ResetCounters();
+
+private:
+	bool IsValidFor(const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location) const;
+	void Store(const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, const FFloorCheckResult& FloorResult);
+
+	static FIntVector Quantize(const FVector& Location);
+	bool IsSameCollision(const UPrimitiveComponent* UpdatedPrimitive, const UPrimitiveComponent* BaseComponent) const;
+
+private:
+	bool bValid = false;
+
+	// Key
+	FIntVector QuantizedLocation = FIntVector::ZeroValue;
+	FVector Location = FVector::ZeroVector;
+	FVector ShapeExtent = FVector::ZeroVector;
+	float FloorSweepDistance = 0.0f;
+	float MaxWalkSlopeCosine = 0.0f;
+
+	TWeakObjectPtr<const UPrimitiveComponent> Base;
+	EComponentMobility::Type BaseMobility = EComponentMobility::Static;
+	FTransform BaseTransform = FTransform::Identity;
+
+	// 地面与Mover之间的碰撞状态
+	ECollisionEnabled::Type BaseCollisionEnabled = ECollisionEnabled::NoCollision;
+	ECollisionChannel BaseObjectType = ECC_WorldStatic;
+	ECollisionChannel MoverObjectType = ECC_Pawn;
+	ECollisionResponse BaseResponse = ECR_Ignore;
+	ECollisionResponse MoverResponse = ECR_Ignore;
+
+	// Value
+	FFloorCheckResult FloorResult;
+
+	uint32 HitNum = 0;
+	uint32 MissNum = 0;
+};
@@ -35,6 +35,12 @@ struct STATEABILITYSCRIPTRUNTIME_API FCFrameGroundMoveUtils
 	/** Generate a new movement based on move/orientation intents and the prior state, constrained to the ground movement plane. Also applies deceleration friction as necessary. */
 	static void ComputeControlledGroundMove(const FCFrameGroundMoveParams& InParams, OUT FCFrameProposedMove& OutProposedMove);
 
+	/** Same as above, using a move plane velocity already computed from MakeComputeVelocityParams (e.g. by FCFrameVelocityBatch) */
+	static void ComputeControlledGroundMove(const FCFrameGroundMoveParams& InParams, const FVector& MovePlaneVelocity, OUT FCFrameProposedMove& OutProposedMove);
+
+	/** Inputs of the FCFrameMovementUtils::ComputeVelocity call made by ComputeControlledGroundMove */
+	static FCFrameComputeVelocityParams MakeComputeVelocityParams(const FCFrameGroundMoveParams& InParams);
+
 	/** Used to change a movement to be along a ramp's surface, typically to prevent slow movement when running up/down a ramp */
 	static FVector ComputeDeflectedMoveOntoRamp(const FVector& OrigMoveDelta, const FHitResult& RampHitResult, float MaxWalkSlopeCosine, const bool bHitFromLineTrace);
 
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+
+/**
+ * MovementBase 的网络序列化。
+ * MovementBase 本身通过 PackageMap 传递 NetGUID（首次引用时才会导出完整路径）。
+ * 骨骼名优先传递其在 MovementBase 骨架中的索引，并附带骨骼网格体资源路径的校验值，接收方的资源不同时不会还原出错误的骨骼；
+ * 只有找不到对应骨骼的名字（例如非骨骼的 Socket）才退化为传递 FName。
+ *
+ * [bHasBone] [bBoneIndex] [BoneIndex (IntPacked) AssetCheck (16bit) | FName]
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameMovementBaseNetSerializer
+{
+	// 读取时返回 false 表示 MovementBase 尚未映射或骨骼无法还原，调用方需要等待之后重新同步的数据
+	static bool Serialize(FArchive& Ar, UPrimitiveComponent*& MovementBase, FName& MovementBaseBoneName);
+
+	// 读取时 MovementBase 为空（例如客户端尚未映射的对象）、资源校验不一致或索引越界时返回 false，此时 MovementBaseBoneName 为 NAME_None
+	static bool SerializeBoneName(FArchive& Ar, const UPrimitiveComponent* MovementBase, FName& MovementBaseBoneName);
+
+	// 返回 INDEX_NONE 表示 MovementBase 不是骨骼网格体，或没有这个骨骼
+	static int32 FindBoneIndex(const UPrimitiveComponent* MovementBase, FName BoneName);
+	static FName GetBoneName(const UPrimitiveComponent* MovementBase, int32 BoneIndex);
+
+	// 骨骼网格体资源路径的校验值，与进程无关；不是骨骼网格体或没有资源时为 0
+	static uint16 GetAssetCheck(const UPrimitiveComponent* MovementBase);
+};
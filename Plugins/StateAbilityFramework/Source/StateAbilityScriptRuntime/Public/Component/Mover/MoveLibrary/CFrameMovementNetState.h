@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/StaticArray.h"
+
+#include "Component/Mover/MoveLibrary/CFrameMovementQuantization.h"
+
+class UPrimitiveComponent;
+
+/**
+ * 一帧内同步的移动状态，服务器记录的是量化前的值，客户端记录的是解码后的值
+ */
+struct FCFrameMovementNetState
+{
+	uint32 Frame = 0;
+
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	FRotator Orientation = FRotator::ZeroRotator;
+
+	TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+	FName MovementBaseBoneName = NAME_None;
+	// 仅客户端：MovementBase 尚未映射或骨骼无法还原，这一帧的 MovementBase 字段不可信，不能被确认为差量基准
+	bool bMovementBaseUnmapped = false;
+
+	// 与 Base 不同的字段，逐位比较
+	ECFrameMovementNetFields GetChangedFields(const FCFrameMovementNetState& Base) const
+	{
+		ECFrameMovementNetFields Fields = ECFrameMovementNetFields::None;
+		Fields |= Location != Base.Location ? ECFrameMovementNetFields::Location : ECFrameMovementNetFields::None;
+		Fields |= Velocity != Base.Velocity ? ECFrameMovementNetFields::Velocity : ECFrameMovementNetFields::None;
+		Fields |= Orientation != Base.Orientation ? ECFrameMovementNetFields::Orientation : ECFrameMovementNetFields::None;
+		Fields |= MovementBase != Base.MovementBase || MovementBaseBoneName != Base.MovementBaseBoneName ? ECFrameMovementNetFields::MovementBase : ECFrameMovementNetFields::None;
+		return Fields;
+	}
+};
+
+/**
+ * 最近 Capacity 帧的同步状态，以帧号取模索引
+ */
+struct FCFrameMovementNetHistory
+{
+	static constexpr uint32 Capacity = 64;
+
+	void Record(const FCFrameMovementNetState& State)
+	{
+		FSlot& Slot = Slots[State.Frame % Capacity];
+		Slot.State = State;
+		Slot.bValid = true;
+	}
+
+	const FCFrameMovementNetState* Find(uint32 Frame) const
+	{
+		const FSlot& Slot = Slots[Frame % Capacity];
+		return Slot.bValid && Slot.State.Frame == Frame ? &Slot.State : nullptr;
+	}
+
+	void Reset()
+	{
+		for (FSlot& Slot : Slots)
+		{
+			Slot.bValid = false;
+		}
+	}
+
+private:
+	struct FSlot
+	{
+		FCFrameMovementNetState State;
+		bool bValid = false;
+	};
+
+	TStaticArray<FSlot, Capacity> Slots;
+};
+
+/**
+ * 以客户端已确认的帧为基准做差量同步：
+ * [bDelta] [FrameGap (IntPacked)] [bUnchanged] [ChangedFields (4bit)] [变化的字段...]
+ * 基准帧不可用时（未确认、超出历史范围、关键帧）退化为完整同步：[bDelta = 0] [所有字段]
+ * 客户端只确认完整解码的帧，关键帧（每 Capacity 帧一次）只是兜底
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameMovementNetSerializer
+{
+	// State.Frame 需要由调用方预先设置。写入时 AckFrame 为客户端已确认的帧，0 表示不做差量；
+	// KeyframeOffset 用于错开各Mover的关键帧，例如传入实体索引。
+	// 读取失败（找不到基准帧）时返回 false
+	static bool NetSerialize(FArchive& Ar, const FCFrameMovementQuantization& Quantization, FCFrameMovementNetState& State, const FCFrameMovementNetHistory& History, uint32 AckFrame, uint32 KeyframeOffset = 0);
+};
@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "CFrameMovementQuantization.generated.h"
+
+UENUM(BlueprintType)
+enum class ECFrameMovementQuantizationProfile : uint8
+{
+	// 与 UCharacterMovementComponent 相同：SerializePackedVector<100, 30> / <10, 16> + SerializeCompressedShort，位数随数值变化
+	Default,
+	// 0.01cm / 32bit（±214km），0.1cm/s / 20bit（±524m/s），完整旋转 16bit
+	HighPrecision,
+	// 0.1cm / 32bit（±2147km），0.1cm/s / 20bit，完整旋转 16bit
+	LargeWorld,
+	// 0.1cm / 24bit（±8.3km），1cm/s / 16bit（±327m/s），仅Yaw 12bit
+	Compact,
+	// 使用 FCFrameMovementQuantization 中的参数
+	Custom,
+};
+
+/**
+ * 移动状态同步时位置、速度、朝向的量化方式
+ */
+USTRUCT(BlueprintType)
+struct FCFrameMovementQuantization
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization)
+	ECFrameMovementQuantizationProfile Profile = ECFrameMovementQuantizationProfile::Default;
+
+	// 1 / 精度，例如 100 表示精确到 0.01cm
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization, meta = (ClampMin = "1", EditCondition = "Profile == ECFrameMovementQuantizationProfile::Custom"))
+	int32 PositionScale = 100;
+	// 每个轴的位数（含符号），超出范围的值会被截断
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization, meta = (ClampMin = "2", ClampMax = "32", EditCondition = "Profile == ECFrameMovementQuantizationProfile::Custom"))
+	int32 PositionBits = 32;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization, meta = (ClampMin = "1", EditCondition = "Profile == ECFrameMovementQuantizationProfile::Custom"))
+	int32 VelocityScale = 10;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization, meta = (ClampMin = "2", ClampMax = "32", EditCondition = "Profile == ECFrameMovementQuantizationProfile::Custom"))
+	int32 VelocityBits = 20;
+
+	// 只同步 Yaw，Pitch 和 Roll 视为0
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization, meta = (EditCondition = "Profile == ECFrameMovementQuantizationProfile::Custom"))
+	bool bYawOnly = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Quantization, meta = (ClampMin = "2", ClampMax = "24", EditCondition = "Profile == ECFrameMovementQuantizationProfile::Custom"))
+	int32 RotationBits = 16;
+};
+
+namespace CFrameQuantization
+{
+	// 定长有符号量化，Bits 位中保存 [-(2^(Bits-1)-1), 2^(Bits-1)-1]
+	FORCEINLINE void SerializeComponent(FArchive& Ar, double& Value, int32 Scale, int32 Bits)
+	{
+		const int64 MaxValue = (int64(1) << (Bits - 1)) - 1;
+
+		uint32 Raw = 0;
+		if (Ar.IsSaving())
+		{
+			const int64 Quantized = FMath::Clamp<int64>(FMath::RoundToInt64(Value * Scale), -MaxValue, MaxValue);
+			Raw = (uint32)(Quantized + MaxValue);
+		}
+
+		Ar.SerializeBits(&Raw, Bits);
+
+		if (Ar.IsLoading())
+		{
+			Value = (double)((int64)Raw - MaxValue) / Scale;
+		}
+	}
+
+	FORCEINLINE void SerializeVector(FArchive& Ar, FVector& Vector, int32 Scale, int32 Bits)
+	{
+		SerializeComponent(Ar, Vector.X, Scale, Bits);
+		SerializeComponent(Ar, Vector.Y, Scale, Bits);
+		SerializeComponent(Ar, Vector.Z, Scale, Bits);
+	}
+
+	// 角度映射到 [0, 2^Bits)
+	FORCEINLINE void SerializeAngle(FArchive& Ar, double& Angle, int32 Bits)
+	{
+		const uint32 Mask = (1u << Bits) - 1;
+
+		uint32 Raw = 0;
+		if (Ar.IsSaving())
+		{
+			Raw = (uint32)FMath::RoundToInt64(FRotator::ClampAxis(Angle) * (double)(1u << Bits) / 360.0) & Mask;
+		}
+
+		Ar.SerializeBits(&Raw, Bits);
+
+		if (Ar.IsLoading())
+		{
+			Angle = FRotator::NormalizeAxis(Raw * 360.0 / (double)(1u << Bits));
+		}
+	}
+
+	FORCEINLINE void SerializeRotator(FArchive& Ar, FRotator& Rotator, int32 Bits, bool bYawOnly)
+	{
+		if (bYawOnly)
+		{
+			SerializeAngle(Ar, Rotator.Yaw, Bits);
+			if (Ar.IsLoading())
+			{
+				Rotator.Pitch = 0.0;
+				Rotator.Roll = 0.0;
+			}
+			return;
+		}
+
+		SerializeAngle(Ar, Rotator.Pitch, Bits);
+		SerializeAngle(Ar, Rotator.Yaw, Bits);
+		SerializeAngle(Ar, Rotator.Roll, Bits);
+	}
+}
+
+// 参与同步的移动字段，用于差量同步时只序列化变化的部分
+enum class ECFrameMovementNetFields : uint8
+{
+	None			= 0,
+	Location		= 1 << 0,
+	Velocity		= 1 << 1,
+	Orientation		= 1 << 2,
+	MovementBase	= 1 << 3,
+
+	Quantized		= Location | Velocity | Orientation,
+	All				= Quantized | MovementBase,
+};
+ENUM_CLASS_FLAGS(ECFrameMovementNetFields);
+
+constexpr int32 CFrameMovementNetFieldBits = 4;
+
+/**
+ * 编译期确定参数的量化器，常用配置直接特化，内层循环中的移位和缩放都是常量
+ */
+template<int32 PositionScale, int32 PositionBits, int32 VelocityScale, int32 VelocityBits, int32 RotationBits, bool bYawOnly>
+struct TCFrameMovementQuantizer
+{
+	static_assert(PositionBits >= 2 && PositionBits <= 32 && VelocityBits >= 2 && VelocityBits <= 32, "Vector components are packed into at most 32 bits.");
+	static_assert(RotationBits >= 2 && RotationBits <= 24, "Angles are packed into at most 24 bits.");
+
+	static constexpr int32 NumBits = 3 * PositionBits + 3 * VelocityBits + (bYawOnly ? 1 : 3) * RotationBits;
+
+	static void Serialize(FArchive& Ar, FVector& Location, FVector& Velocity, FRotator& Orientation, ECFrameMovementNetFields Fields = ECFrameMovementNetFields::Quantized)
+	{
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Location))
+		{
+			CFrameQuantization::SerializeVector(Ar, Location, PositionScale, PositionBits);
+		}
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Velocity))
+		{
+			CFrameQuantization::SerializeVector(Ar, Velocity, VelocityScale, VelocityBits);
+		}
+		if (EnumHasAnyFlags(Fields, ECFrameMovementNetFields::Orientation))
+		{
+			CFrameQuantization::SerializeRotator(Ar, Orientation, RotationBits, bYawOnly);
+		}
+	}
+};
+
+typedef TCFrameMovementQuantizer<100, 32, 10, 20, 16, false> FCFrameMovementQuantizer_HighPrecision;
+typedef TCFrameMovementQuantizer<10, 32, 10, 20, 16, false> FCFrameMovementQuantizer_LargeWorld;
+typedef TCFrameMovementQuantizer<10, 24, 1, 16, 12, true> FCFrameMovementQuantizer_Compact;
+
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameMovementQuantizer
+{
+	// 按 Quantization.Profile 分派，服务器与客户端必须使用相同的配置
+	// Fields 之外的参数保持不变
+	static void Serialize(FArchive& Ar, const FCFrameMovementQuantization& Quantization, FVector& Location, FVector& Velocity, FRotator& Orientation, ECFrameMovementNetFields Fields = ECFrameMovementNetFields::Quantized);
+};
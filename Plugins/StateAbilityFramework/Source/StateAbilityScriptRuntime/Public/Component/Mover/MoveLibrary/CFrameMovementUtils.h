@@ -8,6 +8,7 @@
 #include "CFrameMovementUtils.generated.h"
 
 class UCFrameMoverComponent;
+struct FCFrameSweepBatch;
 
 // Used to identify how to interpret a movement input vector's values
 UENUM(BlueprintType)
@@ -113,6 +114,8 @@ struct STATEABILITYSCRIPTRUNTIME_API FCFrameMovementUtils
 
 	/** Attempts to move a component and resolve any penetration issues with the proposed move Delta */
 	static bool TrySafeMoveUpdatedComponent(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult& OutHit, ETeleportType Teleport);
+	/** Same as TrySafeMoveUpdatedComponent with bSweep, but skips the sweep if the FCFrameSweepBatch query phase already found this exact move clear */
+	static bool TryBatchedMoveUpdatedComponent(const FCFrameSweepBatch* SweepBatch, int32 SweepIndex, USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Delta, const FQuat& NewRotation, FHitResult& OutHit);
 	
 	// Internal functions - not meant to be called outside of this library
 
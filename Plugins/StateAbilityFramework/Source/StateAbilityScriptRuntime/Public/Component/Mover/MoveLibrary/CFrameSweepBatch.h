@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+
+class UWorld;
+class UPrimitiveComponent;
+
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameSweepRequest
+{
+	FVector Start = FVector::ZeroVector;
+	FVector Delta = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	FCollisionShape Shape;
+	ECollisionChannel Channel = ECC_Pawn;
+	FCollisionQueryParams QueryParams;
+	FCollisionResponseParams ResponseParams;
+
+	FBox GetSweptBounds() const;
+};
+
+/**
+ * Mover首次移动（完整的 ProposedMove）的扫掠预查询。
+ *
+ * Query：在一帧开始时并行执行只读的扫掠查询，每个查询只写自己的槽位，结果与线程数无关。
+ * Commit：按稳定的实体顺序逐个移动。查询畅通（没有任何命中）且路径没有被之前提交的Mover占用时，直接移动到终点而不再扫掠；否则退回串行扫掠。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameSweepBatch
+{
+	// 返回 true 表示路径畅通
+	typedef TFunctionRef<bool(const FCFrameSweepRequest& Request)> FQueryFunc;
+
+	void Reset();
+	int32 Add(const FCFrameSweepRequest& Request);
+	int32 Num() const { return Requests.Num(); }
+	const FCFrameSweepRequest& GetRequest(int32 Index) const { return Requests[Index]; }
+
+	//////////////////////////////////////////////////////////////////////////
+	// Query
+	void Query(FQueryFunc QueryFunc, int32 MinBatchSize = 16, bool bForceSingleThread = false);
+	// 与 UPrimitiveComponent::MoveComponent 的扫掠使用相同的碰撞参数，可在工作线程调用
+	static bool QueryWorld(const UWorld* World, const FCFrameSweepRequest& Request);
+	// 胶囊体才能用 FCollisionShape 精确复现 MoveComponent 的扫掠
+	static bool MakeRequest(UPrimitiveComponent* Primitive, const FVector& Delta, FCFrameSweepRequest& OutRequest);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Commit
+	// 本次移动与预查询完全一致、查询畅通且未被已提交的Mover占用
+	bool IsClearSweep(int32 Index, const FVector& Start, const FVector& Delta) const;
+	// 记录已提交Mover的最终包围盒，之后与其相交的预查询结果失效
+	void NotifyCommitted(const FBox& Bounds);
+
+	int32 GetClearNum() const { return ClearNum; }
+
+private:
+	static FIntVector GetCell(const FVector& Location);
+
+	TArray<FCFrameSweepRequest> Requests;
+	TArray<uint8> ClearResults;
+	int32 ClearNum = 0;
+
+	TMap<FIntVector, TArray<FBox>> CommittedCells;
+};
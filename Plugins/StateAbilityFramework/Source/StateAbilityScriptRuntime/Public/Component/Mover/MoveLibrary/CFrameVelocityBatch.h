@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Component/Mover/MoveLibrary/CFrameMovementUtils.h"
+
+/**
+ * FCFrameMovementUtils::ComputeVelocity 的批量版本。
+ * 以SoA布局收集多个Mover的输入，用 VectorRegister4Double 每次计算4个Mover。
+ * 计算过程逐步复现标量版本中的 float 截断，因此与 ComputeVelocity 的结果逐位一致，可以与标量路径混用而不影响确定性。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCFrameVelocityBatch
+{
+	static constexpr int32 LaneNum = 4;
+
+	void Reset();
+	int32 Add(const FCFrameComputeVelocityParams& InParams);
+	int32 Num() const { return Count; }
+
+	// SIMD，结果写入 Result
+	void Compute();
+	// 逐个调用 FCFrameMovementUtils::ComputeVelocity
+	void ComputeScalar();
+
+	FVector GetVelocity(int32 Index) const { return FVector(ResultX[Index], ResultY[Index], ResultZ[Index]); }
+
+private:
+	int32 Count = 0;
+
+	// 均按 LaneNum 对齐，尾部以0填充
+	TArray<double> VelocityX;
+	TArray<double> VelocityY;
+	TArray<double> VelocityZ;
+	TArray<double> IntentX;
+	TArray<double> IntentY;
+	TArray<double> IntentZ;
+	TArray<double> DeltaSeconds;
+	TArray<double> MaxSpeed;
+	TArray<double> TurningBoost;
+	TArray<double> Friction;
+	TArray<double> Deceleration;
+	TArray<double> Acceleration;
+
+	TArray<double> ResultX;
+	TArray<double> ResultY;
+	TArray<double> ResultZ;
+};
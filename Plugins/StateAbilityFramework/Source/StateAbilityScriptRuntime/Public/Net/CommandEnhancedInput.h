@@ -8,6 +8,7 @@
 #include "Subsystems/WorldSubsystem.h"
 #include "Tickable.h"
 #include "EnhancedInputComponent.h"
+#include "GameFramework/OnlineReplStructs.h"
 
 #include "PrivateAccessor.h"
 #include "Net/Packet/CommandFrameInput.h"
@@ -15,6 +16,7 @@
 #include "CommandEnhancedInput.generated.h"
 
 struct FInputActionInstance;
+struct FCommandFrameInputFrame;
 
 #define INPUTFILTER_PRIORITY_COMMON 1
 #define INPUTFILTER_PRIORITY_AIM 10
@@ -181,6 +183,7 @@ class STATEABILITYSCRIPTRUNTIME_API UCommandEnhancedInputComponent
 	PRIVATE_DECLARE_FUNC_NAMESPACE(APawn, void, SetupPlayerInputComponent, UInputComponent*);
 public:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	/** Removes all action bindings. */
 	virtual void ClearActionBindings() override;
 
@@ -206,6 +209,7 @@ public:
 		TArray<TUniquePtr<FEnhancedInputActionEventBinding>>& Bindings = PRIVATE_GET(this, EnhancedActionEventBindings);																\
 		FEnhancedInputActionEventBinding& Handle = *(Bindings.Add_GetRef(MoveTemp(AB)));																								\
 		CommandInputEventBindingMap.Add(Handle.GetHandle(), FCommandDynamicBinding::CloneAsShared((FCommandDynamicBinding&)Handle));													\
+		++BindingVersion;																																								\
 		return Handle;																																									\
 	}
 
@@ -231,18 +235,52 @@ public:
 		FEnhancedInputActionEventBinding& Handle = *(Bindings.Add_GetRef(MoveTemp(AB)));
 
 		CommandInputEventBindingMap.Add(Handle.GetHandle(), FCommandDynamicBinding::CloneAsShared((FCommandDynamicBinding&)Handle));
+		++BindingVersion;
 
 		return Handle;
 	}
 
+	// 任意帧同步输入绑定发生变化时递增，UCommandFrameManager 以此判断缓存的输入事件表是否失效
+	static uint32 GetBindingVersion() { return BindingVersion; }
+
 
 private:
 	friend class UCommandFrameManager;
+	friend struct FCommandFrameInputProcedure;
 
 	const TMap<uint32, TSharedPtr<FEnhancedInputActionEventBinding>>& GetCommandInputBindings() const { return CommandInputEventBindingMap; }
 
 	/** The collection of action bindings. */
 	TMap<uint32, TSharedPtr<FEnhancedInputActionEventBinding>> CommandInputEventBindingMap;
+
+	static uint32 BindingVersion;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// SimulateInput
+
+using FCommandInputEventMap = TMap<const UInputAction*, TArray<TSharedPtr<FEnhancedInputActionEventBinding>>>;
+
+// 一个玩家的输入事件表，构建时的输入栈状态不变时跨帧复用
+struct FCommandFrameInputProcedureCache
+{
+	// 构建时的输入栈状态，任一变化都需要重建 InputEventMap
+	uint32 BindingVersion = 0;
+	TWeakObjectPtr<APawn> Pawn;
+	int32 InputStackNum = INDEX_NONE;
+	bool bPawnInputEnabled = false;
+	bool bPCInputEnabled = false;
+
+	FCommandInputEventMap InputEventMap;
+};
+
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameInputProcedure
+{
+	// 按输入栈的顺序收集其中所有 UCommandEnhancedInputComponent 的帧同步绑定
+	static void BuildInputEventMap(TConstArrayView<UInputComponent*> InputStack, FCommandInputEventMap& OutInputEventMap);
+
+	// 按 InputQueue 的顺序将一帧的输入分发给各玩家的绑定，没有事件表的玩家跳过
+	static void Dispatch(FCommandFrameInputFrame& InputFrame, const TMap<const FUniqueNetIdRepl, FCommandFrameInputProcedureCache>& ProcedureCaches);
 };
 
 template<>
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 基于网格哈希的兴趣管理（AOI）。
+ *
+ * 每帧由 BeginUpdate/AddEntity/EndUpdate 重建网格，并为每个实体（同时也是观察者）计算相关实体列表。
+ * 进入半径为 EnterRadius，离开半径为 EnterRadius * (1 + Hysteresis)，避免实体在边界附近反复切换相关性。
+ * 网格边长等于离开半径，因此每次查询只需要检查周围 3x3 个格子。
+ *
+ * EntityId 由调用方分配，通常是 NetChannel 的 UniqueID。
+ */
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameInterestManager
+{
+	FCommandFrameInterestManager();
+
+	// Radius <= 0 时关闭，所有实体彼此相关
+	void Init(float InEnterRadius, float InHysteresis);
+	void Reset();
+
+	bool IsEnabled() const { return EnterRadius > 0.0f; }
+	float GetEnterRadius() const { return EnterRadius; }
+	float GetExitRadius() const { return ExitRadius; }
+
+	void BeginUpdate();
+	void AddEntity(uint32 EntityId, const FVector& Location);
+	void EndUpdate();
+
+	// 本帧未加入网格的观察者或目标视为相关（保守处理）
+	bool IsRelevant(uint32 ViewerId, uint32 TargetId) const;
+	// 观察者的相关实体，按 EntityId 升序，不包含自身
+	TConstArrayView<uint32> GetRelevantEntities(uint32 ViewerId) const;
+
+	int32 Num() const { return Entities.Num(); }
+
+private:
+	struct FEntity
+	{
+		uint32 EntityId = 0;
+		uint64 CellKey = 0;
+		FVector Location = FVector::ZeroVector;
+	};
+
+	struct FCellRange
+	{
+		int32 Begin = 0;
+		int32 End = 0;
+	};
+
+	FIntPoint GetCellCoord(const FVector& Location) const;
+	static uint64 MakeCellKey(const FIntPoint& CellCoord);
+
+	void UpdateRelevantEntities(const FEntity& Viewer, TArray<uint32>& RelevantEntities);
+
+	float EnterRadius;
+	float ExitRadius;
+	float CellSize;
+
+	TArray<FEntity> Entities;					// 按 CellKey 排序
+	TMap<uint64, FCellRange> Cells;				// CellKey -> Entities 中的区间
+	TMap<uint32, int32> EntityIndices;			// EntityId -> Entities 下标
+
+	TMap<uint32, TArray<uint32>> Relevancy;		// 观察者 -> 上一次的相关实体，用于滞后判断
+	TArray<uint32> RelevantScratch;
+	TArray<uint32> RemovedViewers;
+};
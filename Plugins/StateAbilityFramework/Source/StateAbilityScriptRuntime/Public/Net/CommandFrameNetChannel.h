@@ -7,11 +7,13 @@
 #include "Net/CommandFrameNetTypes.h"
 
 #include "Net/Packet/CommandFramePacket.h"
+#include "Buffer/ReorderWindow.h"
 #include "PrivateAccessor.h"
 
 #include "CommandFrameNetChannel.generated.h"
 
 class UCommandFrameManager;
+class UInputAction;
 
 UENUM()
 enum class ECommandFrameNetChannelState : uint8
@@ -25,7 +27,8 @@ enum class ECommandFrameNetChannelState : uint8
 /**
  * 通用CFrameNetChannel，支持的同步：Movement、StateAbilityScript。
  * 
- * @TODO：需要考虑AOI优化
+ * NetChannel本身始终相关（需要维持帧号链），AOI范围外的连接只会收到不含同步内容的空包。
+ * 见 UCommandFrameManager::UpdateInterest
  */
 UCLASS()
 class ADefaultCommandFrameNetChannel : public ACommandFrameNetChannelBase
@@ -36,17 +39,20 @@ class ADefaultCommandFrameNetChannel : public ACommandFrameNetChannelBase
 	friend struct FCommandFrameDeltaNetPacket;
 public:
 	//virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void RewindFrame() { NetChannelState = ECommandFrameNetChannelState::WaitRewind; }
+	virtual void DeferAckFrame() override { bDeferAckFrame = true; }
 
 	virtual void FixedTick(float DeltaTime, uint32 RCF, uint32 ICF) override;
-	virtual void RegisterCFrameManager(UCommandFrameManager* CommandFrameManager) override { CFrameManager = CommandFrameManager; }
+	virtual void RegisterCFrameManager(UCommandFrameManager* CommandFrameManager) override;
 	
 	virtual void ClientSend_CommandFrameInputNetPacket(FCommandFrameInputNetPacket& InputNetPacket) override;
 	virtual void ServerSend_CommandFrameDeltaNetPacket(FCommandFrameDeltaNetPacket& DeltaNetPacket) override;
 
 	virtual uint32 GetLastServerCommandFrame() override { return LastServerCommandFrame; }
+	virtual uint32 GetAckServerCommandFrame() override { return AckServerCommandFrame; }
 	virtual ICommandFrameNetProcedure* GetNetPacketProcedure(EDeltaNetPacketType NetPacketType) override;
 	virtual void RegisterNetPacketProcedure(EDeltaNetPacketType NetPacketType, UObject* Procedure) override;
 private:
@@ -59,6 +65,9 @@ private:
 
 	UCommandFrameManager* GetCommandFrameManager();
 
+	UFUNCTION()
+	void OnRep_InputActionTable();
+
 	//////////////////////////////////////////////////////////////////////////
 	// 处理数据包前缀（只要收到数据就处理，不保证有序）
 	void ProcessDeltaPrefix(const FCommandFrameDeltaNetPacket& DeltaNetPacket, FNetBitReader& NetBitReader);
@@ -74,17 +83,24 @@ private:
 
 	void ShrinkUnorderedPackets();
 	void RemoveUnorderedPacket(uint32 CommandFrame);
+	void AddUnorderedPacket(const FCommandFrameDeltaNetPacket& DeltaNetPacket);
 	
 private:
 	uint32 LastServerCommandFrame;									// Client收到的最新的来自服务器的CF，用于确保Delta按序处理
 	uint32 LastClientCommandFrame;									// Server收到的最新的来自客户端的CF
-	TMap<uint32, FCommandFrameDeltaNetPacket> UnorderedPackets;		// 乱序而缓存的包
+	uint32 AckServerCommandFrame;									// Client已处理的最新的来自服务器的CF，随Input发送给Server
+	bool bDeferAckFrame;											// 正在处理的帧引用了尚未映射的对象
+	TReorderWindow<FCommandFrameDeltaNetPacket> UnorderedPackets;	// 乱序而缓存的包，以 PrevServerCommandFrame 为Key
 
 	ECommandFrameNetChannelState NetChannelState;
 
 	UPROPERTY(Transient)
 	UCommandFrameManager* CFrameManager;
 
+	// 会话开始时同步一次的InputAction字典
+	UPROPERTY(ReplicatedUsing = OnRep_InputActionTable)
+	TArray<TObjectPtr<UInputAction>> InputActionTable;
+
 	//////////////////////////////////////////////////////////////////////////
 	TMap<EDeltaNetPacketType, TWeakObjectPtr<UObject>> NetPacketProcedures;
 
@@ -11,6 +11,7 @@
 
 struct FCommandFrameInputNetPacket;
 struct FCommandFrameDeltaNetPacket;
+struct FCommandFrameSnapshotKey;
 class UCommandFrameManager;
 enum EDeltaNetPacketType : uint32;
 
@@ -31,6 +32,8 @@ struct FNetProcedureSyncParam
 	FArchive& Ar;
 	UPackageMap* Map;
 	bool& bOutSuccess;
+	// 仅客户端：数据已完整读取，但引用的对象尚未映射，这一帧不能被确认为服务器差量同步的基准
+	bool bOutUnmapped = false;
 };
 
 /**
@@ -47,7 +50,10 @@ class STATEABILITYSCRIPTRUNTIME_API ICommandFrameNetProcedure
 public:
 	virtual void OnServerNetSync(FNetProcedureSyncParam& SyncParam) {}
 	virtual void OnClientNetSync(FNetProcedureSyncParam& SyncParam, bool& bNeedRewind) {}
+	// 被修正的Procedure需要调用 UCommandFrameManager::MarkReplayDirty，回滚时才能只重新模拟相关的实体
 	virtual void OnClientRewind() {}
+	// 参与确定性校验的快照实体
+	virtual void GetSnapshotKeys(TArray<FCommandFrameSnapshotKey>& OutKeys) {}
 };
 
 /**
@@ -62,11 +68,15 @@ public:
 	virtual void FixedTick(float DeltaTime, uint32 RCF, uint32 ICF) {}
 	virtual void RegisterCFrameManager(UCommandFrameManager* CommandFrameManager) {}
 	virtual void RewindFrame() {}
+	// 正在处理的服务器帧引用了尚未映射的对象，不确认这一帧
+	virtual void DeferAckFrame() {}
 
 	virtual void ClientSend_CommandFrameInputNetPacket(FCommandFrameInputNetPacket& InputNetPacket) {}
 	virtual void ServerSend_CommandFrameDeltaNetPacket(FCommandFrameDeltaNetPacket& DeltaNetPacket) {}
 
 	virtual uint32 GetLastServerCommandFrame() { return 0; }
+	// Client：已处理的最新服务器帧；Server：客户端确认过的最新帧
+	virtual uint32 GetAckServerCommandFrame() { return 0; }
 	virtual ICommandFrameNetProcedure* GetNetPacketProcedure(EDeltaNetPacketType NetPacketType) { return nullptr; }
 	virtual void RegisterNetPacketProcedure(EDeltaNetPacketType NetPacketType, UObject* Procedure) {}
 };
\ No newline at end of file
@@ -8,8 +8,41 @@
 
 #include "CommandFrameInput.generated.h"
 
+/**
+ * 会话级的 InputAction 字典。
+ * 服务器在会话开始时为 UCommandFrameSettings::CommandInputActions 分配稠密索引，并通过 ADefaultCommandFrameNetChannel 同步一次给客户端。
+ * 索引 0 保留为无效值，未登记的 InputAction 在序列化时退化为对象引用。
+ */
 USTRUCT()
-struct FCommandFrameInputAtom
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameInputActionTable
+{
+	GENERATED_BODY()
+public:
+	static const FCommandFrameInputActionTable* Get(class UPackageMap* Map);
+
+	void Init(const TArray<TObjectPtr<UInputAction>>& InActions);
+	void Reset();
+
+	bool IsEmpty() const { return Actions.IsEmpty(); }
+	int32 Num() const { return Actions.Num(); }
+	const TArray<TObjectPtr<UInputAction>>& GetActions() const { return Actions; }
+
+	// 返回 0 表示未登记
+	uint16 FindIndex(const UInputAction* InputAction) const;
+	const UInputAction* GetAction(uint16 Index) const;
+
+	// 字典较小时使用 8bit 索引
+	uint32 GetIndexBits() const { return Actions.Num() < MAX_uint8 ? 8 : 16; }
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<UInputAction>> Actions;	// Index = ArrayIndex + 1
+
+	TMap<const UInputAction*, uint16> ActionIndices;
+};
+
+USTRUCT()
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameInputAtom
 {
 	GENERATED_BODY()
 public:
@@ -17,26 +50,41 @@ public:
 	FCommandFrameInputAtom(float InLastTriggeredWorldTime, float InElapsedProcessedTime, float InElapsedTriggeredTime, const UInputAction* InInputAction, ETriggerEvent InTriggerEvent, const FInputActionValue& InValue);
 	FCommandFrameInputAtom(const FInputActionInstance& ActionData);
 
-	// @TODO：在序列化数据前，遍历所有Atom并执行。这种能提高多少速度？
-	// 尝试将存储的数据转为a single memory blob，或者说是POD？
-	void BulkMemoryBlob(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+	/**
+	 * 以列的形式批量序列化一帧内的所有Atom：
+	 * [Header: IndexWidth | TimeWidth | AxisWidth] [ActionIndex...] [TriggerEvent...] [ValueType...] [ElapsedTime...] [Value...] [未登记的InputAction...]
+	 * 每列都是定长的，解析时只需要顺序读一遍。
+	 */
+	static bool BulkNetSerialize(FArchive& Ar, class UPackageMap* Map, TArrayView<FCommandFrameInputAtom> InputAtoms, const FCommandFrameInputActionTable* ActionTable);
+
+	/**
+	 * 以数量相同的 BaseAtoms 为基准进行差量序列化：
+	 * [bSame] [ChangedMask...] [每个变化的Atom: bHeaderChanged (InputAction/TriggerEvent/ValueType) + 量化后的差值]
+	 */
+	static bool DeltaNetSerialize(FArchive& Ar, class UPackageMap* Map, TArrayView<FCommandFrameInputAtom> InputAtoms, TConstArrayView<FCommandFrameInputAtom> BaseAtoms, const FCommandFrameInputActionTable* ActionTable);
+
+	// 比较所有参与网络同步的数据
+	bool IsSameInput(const FCommandFrameInputAtom& Other) const;
 
 	bool Serialize(FArchive& Ar);
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+	// 批量序列化时由调用方预先取得字典，避免逐个Atom查找
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, const FCommandFrameInputActionTable* ActionTable);
 
-	// 对于有可靠地址的InputAction，网络同步时是直接传递的ObjectPath，可以通过LoadObject查到。
-	// 但是直接传输FString路径是有开销的 (FName受限于NamePool，在 C/S 不相同)，所以理想情况下，可以在每次序列化数据时，查找FNetworkGUID，如果不存在，则继续序列化路径，并利用 1个bit 来记录类型。
-	// 当服务器收到Input包后，会解析是否存在FNetworkGUID，如果不存在，则会在Delta包内回传InputAction，帮助建立FNetworkGUID映射。
-	union
-	{
-		const UInputAction* InputAction;
-		FNetworkGUID IA_NetGUID;
-	};
+	// 网络同步会对数值做量化，构造时就完成量化，保证 C/S 模拟的输入一致
+	static constexpr float ValueQuantizeScale = 1000.0f;
+	static constexpr float TimeQuantizeScale = 1000.0f;
+	void Quantize();
+
+	// 网络同步时优先传递 FCommandFrameInputActionTable 中的稠密索引，并利用 1个bit 来记录类型。
+	// 未登记的InputAction才会直接传递对象引用 (ObjectPath/FNetworkGUID)。
+	const UInputAction* InputAction = nullptr;
 
 	// Trigger state
 	ETriggerEvent TriggerEvent = ETriggerEvent::None;
 
 	// The last time that this evaluated to a Triggered State
+	// 这是客户端的本地时间，对服务器没有意义，因此不参与网络同步
 	float LastTriggeredWorldTime = 0.0f;
 
 	// Total trigger processing/evaluation time (How long this action has been in event Started, Ongoing, or Triggered
@@ -45,9 +93,9 @@ public:
 	// Triggered time (How long this action has been in event Triggered only)
 	float ElapsedTriggeredTime = 0.f;
 
-	EInputActionValueType ValueType;
+	EInputActionValueType ValueType = EInputActionValueType::Boolean;
 
-	FVector Value;
+	FVector Value = FVector::ZeroVector;
 
 	// 不需要这个，因为Client经过验证后的都符合。
 	// ETriggerEventInternal TriggerEventInternal = ETriggerEventInternal(0);
@@ -19,6 +19,8 @@ class ACommandFrameNetChannelBase;
 class UNetConnection;
 struct FCommandFrameInputFrame;
 struct FCommandFrameInputAtom;
+struct FCommandFrameInputActionTable;
+class FNetBitWriter;
 
 enum EDeltaNetPacketType : uint32
 {
@@ -39,8 +41,11 @@ enum EDeltaNetPacketType : uint32
  * 
  * - [RAW DATA]
  * Autonomous:
- * -- bool bFault
+ * -- int32 PrefixDataSize
  * -- uint32 ServerInputBufferNum
+ * -- bool bFault
+ * -- bool bHasSnapshotChecksum
+ * -- uint64 SnapshotChecksum (bHasSnapshotChecksum)
  *
  * Simulated:
  * --
@@ -62,13 +67,17 @@ namespace DeltaNetPacketUtils
 {
 	// 必须严格按照PacketType顺序执行
 
-	using FPrefixCallBackFunc = TFunction<void(int32 PrefixDataSize, uint32 ServerCommandBufferNum, bool bFault)>;
+	// SnapshotChecksum 为空表示服务器没有附带该帧的快照哈希
+	using FPrefixCallBackFunc = TFunction<void(int32 PrefixDataSize, uint32 ServerCommandBufferNum, bool bFault, const uint64* SnapshotChecksum)>;
 
 	void BuildPacket_Fault_FrameExpiry(FCommandFrameDeltaNetPacket& Packet);
 
 	void SerializeDeltaPrefix(const FCommandFrameDeltaNetPacket& NetPacket, FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess, FPrefixCallBackFunc CallBack = FPrefixCallBackFunc());
 	void SerializeDeltaPackaged(FCommandFrameDeltaNetPacket& NetPacket, FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
+	// 非Local的连接只接收其AOI范围内的同步内容
+	bool IsRelevantFor(const FCommandFrameDeltaNetPacket& NetPacket, UNetConnection* NetConnection);
+
 	template<EDeltaNetPacketType Type>
 	void NetSync(const FCommandFrameDeltaNetPacket& NetPacket, FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
@@ -86,6 +95,9 @@ public:
 
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
+	// 复用已有的RawData空间，避免缓存乱序包时重复申请
+	void CopyReuseRawData(const FCommandFrameDeltaNetPacket& Other);
+
 	uint32 ServerCommandFrame;
 	uint32 PrevServerCommandFrame;
 	ACommandFrameNetChannelBase* NetChannel;
@@ -110,29 +122,46 @@ struct TStructOpsTypeTraits<FCommandFrameDeltaNetPacket> : public TStructOpsType
 };
 
 /**
- * @TODO：考虑允许启用BulkSerialize来优化
+ * InputNetPacket:
+ *
+ * - uint32 ClientCommandFrame
+ * - uint32 AckServerCommandFrame
+ *
+ * - [RAW DATA]
+ * -- FrameNum
+ * -- 最新帧: DataCount + FCommandFrameInputAtom::BulkNetSerialize
+ * -- 其余帧: FrameGap + bDelta + (FCommandFrameInputAtom::DeltaNetSerialize | DataCount + BulkNetSerialize)
+ *
+ * 冗余帧之间大多相同或仅有少量轴变化，因此以前一个写入的帧为基准做差量编码。
  */
 USTRUCT()
-struct FCommandFrameInputNetPacket
+struct STATEABILITYSCRIPTRUNTIME_API FCommandFrameInputNetPacket
 {
 	GENERATED_BODY()
 
-	PRIVATE_DECLARE_NAMESPACE(FBitReader, int64, Pos);
-
 public:
-	FCommandFrameInputNetPacket() {}
+	FCommandFrameInputNetPacket() : ClientCommandFrame(0), AckServerCommandFrame(0) {}
 	FCommandFrameInputNetPacket(UNetConnection* Connection, TCircularQueueView<FCommandFrameInputFrame>& InputFrames);
 
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 	
 	// 冗余读写
 	void WriteRedundantData(UNetConnection* Connection, TCircularQueueView<FCommandFrameInputFrame>& InputFrames);
+	void WriteRedundantData(class UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, TCircularQueueView<FCommandFrameInputFrame>& InputFrames);
 	void ReadRedundantData(UNetConnection* Connection, TFunction<uint8*(uint32 CommandFrame, int32 DataCount)> AllocateData) const;
+	void ReadRedundantData(class UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, TFunction<uint8*(uint32 CommandFrame, int32 DataCount)> AllocateData) const;
 
 	// 客户端的最新帧号
 	uint32 ClientCommandFrame;
+	// 客户端已处理的最新服务器帧号，服务器以此为基准做差量同步
+	uint32 AckServerCommandFrame;
 
 	TBitArray<TInlineAllocator<CHARACTER_SERIALIZATION_PACKEDBITS_RESERVED_SIZE / NumBitsPerDWORD>> RawData;
+
+private:
+	// 每帧的序列化结果都缓存在帧内，只有基准帧变化时才重新生成
+	static FNetBitWriter& GetFullSerialization(class UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, FCommandFrameInputFrame& InputFrame);
+	static FNetBitWriter& GetDeltaSerialization(class UPackageMap* Map, const FCommandFrameInputActionTable* ActionTable, FCommandFrameInputFrame& InputFrame, FCommandFrameInputFrame& BaseFrame);
 };
 
 template<>
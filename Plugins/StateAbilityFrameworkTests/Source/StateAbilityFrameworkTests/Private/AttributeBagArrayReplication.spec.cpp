@@ -0,0 +1,331 @@
+#include "AttributeBagTest.h"
+
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+#include "Attribute/AttributeBag/AttributeArrayReplication.h"
+#include "Attribute/AttributeBag/AttributeBagLayout.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const FArrayProperty* GetPositionsProperty()
+	{
+		return FindFProperty<FArrayProperty>(FAttributeArrayReplicationTestData::StaticStruct(), GET_MEMBER_NAME_CHECKED(FAttributeArrayReplicationTestData, Positions));
+	}
+
+	// 整数坐标，序列化前后完全相等
+	FVector MakePosition(FRandomStream& Random)
+	{
+		return FVector(Random.RandRange(-10000, 10000), Random.RandRange(-10000, 10000), Random.RandRange(0, 1000));
+	}
+
+	// 一个连接：客户端的数组与服务器记录的该连接的基准
+	struct FArrayReplicationClient
+	{
+		FArrayReplicationClient()
+			: ClientState(GetPositionsProperty())
+		{
+		}
+
+		// 返回差量的位数，客户端读取失败时返回 INDEX_NONE
+		int64 Replicate(FAttributeArrayReplicationState& ServerState, FAttributeArrayReplicationTestData& Server)
+		{
+			FBitWriter Writer(0, true);
+			ServerState.WriteDelta(Writer, nullptr, &Server.Positions, BaseKey);
+			BaseKey = ServerState.GetReplicationKey();
+
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			if (!ClientState.ReadDelta(Reader, nullptr, &Client.Positions))
+			{
+				return INDEX_NONE;
+			}
+			return Writer.GetNumBits();
+		}
+
+		FAttributeArrayReplicationTestData Client;
+		FAttributeArrayReplicationState ClientState;
+		int32 BaseKey = INDEX_NONE;
+	};
+
+	struct FArrayReplicationPeer
+	{
+		FArrayReplicationPeer()
+			: ServerState(GetPositionsProperty())
+		{
+		}
+
+		// 返回差量的位数，客户端读取失败时返回 INDEX_NONE
+		int64 Replicate(uint32 Frame)
+		{
+			ServerState.UpdateDelta(&Server.Positions, Frame);
+			return Connection.Replicate(ServerState, Server);
+		}
+
+		FAttributeArrayReplicationTestData Server;
+		FAttributeArrayReplicationState ServerState;
+		FArrayReplicationClient Connection;
+		FAttributeArrayReplicationTestData& Client = Connection.Client;
+		FAttributeArrayReplicationState& ClientState = Connection.ClientState;
+	};
+
+	struct FArrayReplicationReport
+	{
+		int64 FullBits = 0;
+		int64 DeltaBits = 0;
+		int32 FailedNum = 0;
+		int32 MismatchNum = 0;
+	};
+
+	/**
+	 * 第一帧同步 InitialNum 个元素，之后每帧调用 Mutate 修改服务器的数组，
+	 * 分别统计整个数组完整序列化（修改前的做法）和逐元素差量的位数，不计第一帧。
+	 */
+	template<typename FMutate>
+	FArrayReplicationReport SimulateArrayReplication(int32 InitialNum, int32 FrameNum, FMutate&& Mutate)
+	{
+		const FArrayProperty* ArrayProp = GetPositionsProperty();
+		const FAttributeBagLayout::FNetSerializeFunc FullSerialize = FAttributeBagLayout::GetNetSerializeFunc(ArrayProp);
+
+		FRandomStream Random(0xA77A);
+		FArrayReplicationPeer Peer;
+		for (int32 Index = 0; Index < InitialNum; ++Index)
+		{
+			Peer.Server.Positions.Add(MakePosition(Random));
+		}
+		// 客户端的默认值应在第一次同步时被清空
+		Peer.Client.Positions.Add(FVector::OneVector);
+
+		FArrayReplicationReport Report;
+		for (uint32 Frame = 1; Frame <= (uint32)FrameNum; ++Frame)
+		{
+			if (Frame > 1)
+			{
+				Mutate(Peer.Server.Positions, Random);
+
+				FBitWriter FullWriter(0, true);
+				FullSerialize(ArrayProp, FullWriter, nullptr, &Peer.Server.Positions);
+				Report.FullBits += FullWriter.GetNumBits();
+			}
+
+			const int64 DeltaBits = Peer.Replicate(Frame);
+			if (DeltaBits == INDEX_NONE)
+			{
+				++Report.FailedNum;
+				continue;
+			}
+			if (Frame > 1)
+			{
+				Report.DeltaBits += DeltaBits;
+			}
+
+			if (Peer.Client.Positions != Peer.Server.Positions)
+			{
+				++Report.MismatchNum;
+			}
+		}
+		return Report;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FAttributeBagArrayReplicationSpec, "StateAbilityFramework.Attribute.ArrayReplication", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FAttributeBagArrayReplicationSpec)
+
+void FAttributeBagArrayReplicationSpec::Define()
+{
+	Describe("Delta", [this]()
+	{
+		It("Should send appended elements without the order", [this]()
+		{
+			FArrayReplicationPeer Peer;
+			Peer.Server.Positions = { FVector(1, 0, 0), FVector(2, 0, 0) };
+			TEST_TRUE(Peer.Replicate(1) != INDEX_NONE);
+
+			Peer.Server.Positions.Add(FVector(3, 0, 0));
+			TEST_TRUE(Peer.Replicate(2) != INDEX_NONE);
+
+			TEST_EQUAL(Peer.ServerState.GetChangedNum(), 1);
+			TEST_EQUAL(Peer.ServerState.GetRemovedNum(), 0);
+			TEST_FALSE(Peer.ServerState.IsOrderChanged());
+			TEST_TRUE(Peer.Client.Positions == Peer.Server.Positions);
+		});
+
+		It("Should keep the IDs of moved elements and send only the order", [this]()
+		{
+			FArrayReplicationPeer Peer;
+			Peer.Server.Positions = { FVector(1, 0, 0), FVector(2, 0, 0), FVector(3, 0, 0), FVector(4, 0, 0) };
+			TEST_TRUE(Peer.Replicate(1) != INDEX_NONE);
+			const TArray<int32> IDs(Peer.ServerState.GetReplicationIDs());
+
+			Peer.Server.Positions.Swap(0, 3);
+			TEST_TRUE(Peer.Replicate(2) != INDEX_NONE);
+
+			TEST_EQUAL(Peer.ServerState.GetChangedNum(), 0);
+			TEST_EQUAL(Peer.ServerState.GetRemovedNum(), 0);
+			TEST_TRUE(Peer.ServerState.IsOrderChanged());
+			TEST_EQUAL(Peer.ServerState.GetReplicationIDs()[0], IDs[3]);
+			TEST_EQUAL(Peer.ServerState.GetReplicationIDs()[3], IDs[0]);
+			TEST_TRUE(Peer.Client.Positions == Peer.Server.Positions);
+			TEST_TRUE(TArray<int32>(Peer.ClientState.GetReplicationIDs()) == TArray<int32>(Peer.ServerState.GetReplicationIDs()));
+		});
+
+		It("Should send removals as IDs and modifications under the same ID", [this]()
+		{
+			FArrayReplicationPeer Peer;
+			Peer.Server.Positions = { FVector(1, 0, 0), FVector(2, 0, 0), FVector(3, 0, 0) };
+			TEST_TRUE(Peer.Replicate(1) != INDEX_NONE);
+			const TArray<int32> IDs(Peer.ServerState.GetReplicationIDs());
+
+			Peer.Server.Positions.RemoveAt(0);
+			Peer.Server.Positions[1] = FVector(30, 0, 0);
+			TEST_TRUE(Peer.Replicate(2) != INDEX_NONE);
+
+			TEST_EQUAL(Peer.ServerState.GetRemovedNum(), 1);
+			TEST_EQUAL(Peer.ServerState.GetChangedNum(), 1);
+			TEST_FALSE(Peer.ServerState.IsOrderChanged());
+			TEST_EQUAL(Peer.ServerState.GetReplicationIDs()[1], IDs[2]);
+			TEST_TRUE(Peer.Client.Positions == Peer.Server.Positions);
+		});
+
+		It("Should reuse the delta within one replication frame", [this]()
+		{
+			FArrayReplicationPeer Peer;
+			Peer.Server.Positions = { FVector(1, 0, 0) };
+			Peer.ServerState.UpdateDelta(&Peer.Server.Positions, 1);
+			Peer.ServerState.UpdateDelta(&Peer.Server.Positions, 1);
+
+			// 第二次调用没有与 Shadow 重新比较，元素仍然是新增的
+			TEST_EQUAL(Peer.ServerState.GetChangedNum(), 1);
+
+			Peer.ServerState.UpdateDelta(&Peer.Server.Positions, 2);
+			TEST_EQUAL(Peer.ServerState.GetChangedNum(), 0);
+		});
+	});
+
+	Describe("Connection", [this]()
+	{
+		It("Should send the full array to a connection that missed a delta", [this]()
+		{
+			FAttributeArrayReplicationTestData Server;
+			FAttributeArrayReplicationState ServerState(GetPositionsProperty());
+			FArrayReplicationClient Connections[2];
+
+			Server.Positions = { FVector(1, 0, 0), FVector(2, 0, 0), FVector(3, 0, 0) };
+			ServerState.UpdateDelta(&Server.Positions, 1);
+			TEST_TRUE(Connections[0].Replicate(ServerState, Server) != INDEX_NONE);
+			TEST_TRUE(Connections[1].Replicate(ServerState, Server) != INDEX_NONE);
+
+			// 第二个连接没有收到这一帧
+			Server.Positions.RemoveAt(0);
+			Server.Positions.Add(FVector(4, 0, 0));
+			ServerState.UpdateDelta(&Server.Positions, 2);
+			TEST_TRUE(Connections[0].Replicate(ServerState, Server) != INDEX_NONE);
+			Connections[1].Client.Positions.Add(FVector::OneVector);
+
+			Server.Positions.Swap(0, 2);
+			ServerState.UpdateDelta(&Server.Positions, 3);
+			const int64 DeltaBits = Connections[0].Replicate(ServerState, Server);
+			const int64 FullBits = Connections[1].Replicate(ServerState, Server);
+
+			TEST_TRUE(DeltaBits != INDEX_NONE);
+			TEST_TRUE(FullBits > DeltaBits);
+			for (const FArrayReplicationClient& Connection : Connections)
+			{
+				TEST_TRUE(Connection.Client.Positions == Server.Positions);
+				TEST_TRUE(TArray<int32>(Connection.ClientState.GetReplicationIDs()) == TArray<int32>(ServerState.GetReplicationIDs()));
+				TEST_EQUAL(Connection.BaseKey, ServerState.GetReplicationKey());
+			}
+		});
+
+		It("Should send an empty delta to a connection that is up to date", [this]()
+		{
+			FArrayReplicationPeer Peer;
+			Peer.Server.Positions = { FVector(1, 0, 0), FVector(2, 0, 0) };
+			TEST_TRUE(Peer.Replicate(1) != INDEX_NONE);
+			const int32 ReplicationKey = Peer.ServerState.GetReplicationKey();
+
+			// bReset + NumRemoved(8bit) + NumChanged(8bit) + bOrderChanged
+			TEST_EQUAL(Peer.Connection.Replicate(Peer.ServerState, Peer.Server), (int64)18);
+			TEST_EQUAL(Peer.Replicate(2), (int64)18);
+			TEST_EQUAL(Peer.ServerState.GetReplicationKey(), ReplicationKey);
+			TEST_TRUE(Peer.Client.Positions == Peer.Server.Positions);
+		});
+
+		It("Should not reuse the keys of a recreated state", [this]()
+		{
+			FArrayReplicationPeer Peer;
+			Peer.Server.Positions = { FVector(1, 0, 0) };
+			TEST_TRUE(Peer.Replicate(1) != INDEX_NONE);
+
+			FAttributeArrayReplicationState RecreatedState(GetPositionsProperty());
+			RecreatedState.UpdateDelta(&Peer.Server.Positions, 1);
+			TEST_FALSE(RecreatedState.GetReplicationKey() == Peer.ServerState.GetReplicationKey());
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report bits for append-, remove- and reorder-heavy workloads", [this]()
+		{
+			const int32 FrameNum = 200;
+
+			struct FWorkload
+			{
+				const TCHAR* Name;
+				int32 InitialNum;
+				TFunction<void(TArray<FVector>&, FRandomStream&)> Mutate;
+			};
+
+			const FWorkload Workloads[] =
+			{
+				// 每帧追加两个元素，每4帧修改一个元素
+				{ TEXT("Append"), 32, [](TArray<FVector>& Positions, FRandomStream& Random)
+				{
+					Positions.Add(MakePosition(Random));
+					Positions.Add(MakePosition(Random));
+					if (Random.RandHelper(4) == 0)
+					{
+						Positions[Random.RandHelper(Positions.Num())] = MakePosition(Random);
+					}
+				} },
+				// 每帧删除两个元素，保持顺序
+				{ TEXT("Remove"), 2 * FrameNum + 32, [](TArray<FVector>& Positions, FRandomStream& Random)
+				{
+					Positions.RemoveAt(Random.RandHelper(Positions.Num()));
+					Positions.RemoveAt(Random.RandHelper(Positions.Num()));
+				} },
+				// 每帧交换四对元素
+				{ TEXT("Reorder"), 128, [](TArray<FVector>& Positions, FRandomStream& Random)
+				{
+					for (int32 Count = 0; Count < 4; ++Count)
+					{
+						Positions.Swap(Random.RandHelper(Positions.Num()), Random.RandHelper(Positions.Num()));
+					}
+				} },
+			};
+
+			for (const FWorkload& Workload : Workloads)
+			{
+				const FArrayReplicationReport Report = SimulateArrayReplication(Workload.InitialNum, FrameNum, Workload.Mutate);
+
+				TEST_EQUAL(Report.FailedNum, 0);
+				TEST_EQUAL(Report.MismatchNum, 0);
+				TEST_TRUE(Report.DeltaBits < Report.FullBits);
+
+				AddInfo(FString::Printf(TEXT("%s (%d initial elements) x %d frames: full %lld bytes, delta %lld bytes (%.1f%%)"),
+					Workload.Name, Workload.InitialNum, FrameNum, (Report.FullBits + 7) / 8, (Report.DeltaBits + 7) / 8, 100.0 * Report.DeltaBits / FMath::Max<int64>(Report.FullBits, 1)));
+			}
+		});
+	});
+}
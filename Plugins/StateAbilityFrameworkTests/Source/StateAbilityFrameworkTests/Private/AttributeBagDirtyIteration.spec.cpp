@@ -0,0 +1,155 @@
+#include "AttributeBagTest.h"
+
+#include "InstancedStruct.h"
+#include "HAL/PlatformTime.h"
+#include "Serialization/BitWriter.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const UAttributeBagStruct* CreateDirtyTestBagStruct(int32 PropertyNum)
+	{
+		TArray<FAttributeBagPropertyDesc> PropertyDescs;
+		for (int32 Index = 0; Index < PropertyNum; ++Index)
+		{
+			PropertyDescs.Emplace(FName(*FString::Printf(TEXT("DirtyTestAttr_%d"), Index)), EAttributeBagPropertyType::Int32);
+		}
+		return UAttributeBagStruct::GetOrCreateFromDescs(PropertyDescs);
+	}
+
+	FNetBitArray MakeChanges(int32 PropertyNum, int32 DirtyNum, FRandomStream& Random)
+	{
+		TArray<int32> Indices;
+		for (int32 Index = 0; Index < PropertyNum; ++Index)
+		{
+			Indices.Add(Index);
+		}
+		for (int32 Index = 0; Index < DirtyNum; ++Index)
+		{
+			Indices.Swap(Index, Random.RandRange(Index, PropertyNum - 1));
+		}
+
+		FNetBitArray Changes(PropertyNum);
+		for (int32 Index = 0; Index < DirtyNum; ++Index)
+		{
+			Changes.Add(Indices[Index]);
+		}
+		return Changes;
+	}
+
+	// 修改前：逐个检查每个属性的脏标记，再查找 Desc 和处理函数
+	void SerializeByFullScan(const UAttributeBagStruct* BagStruct, const FNetBitArray& Changes, uint8* Memory, FArchive& Ar)
+	{
+		const int32 PropNum = BagStruct->GetPropertyDescsNum();
+		for (int32 Index = 0; Index < PropNum; ++Index)
+		{
+			if (Changes.IsDirty(Index))
+			{
+				const FProperty* Property = BagStruct->FindPropertyDescByIndex(Index)->CachedProperty;
+				FAttributeBagLayout::GetNetSerializeFunc(Property)(Property, Ar, nullptr, Memory + Property->GetOffset_ForInternal());
+			}
+		}
+	}
+
+	// 修改后：只访问置位的bit，处理函数来自布局表
+	void SerializeByDirtyBits(const FAttributeBagLayout& Layout, const FNetBitArray& Changes, uint8* Memory, FArchive& Ar)
+	{
+		for (FNetBitArray::FIterator It(Changes); It; ++It)
+		{
+			const FAttributeBagLayout::FPropertyLayout& Property = Layout.GetProperty(*It);
+			Property.NetSerialize(Property.Property, Ar, nullptr, Memory + Property.Offset);
+		}
+	}
+}
+
+BEGIN_DEFINE_SPEC(FAttributeBagDirtyIterationSpec, "StateAbilityFramework.Attribute.DirtyIteration", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FAttributeBagDirtyIterationSpec)
+
+void FAttributeBagDirtyIterationSpec::Define()
+{
+	Describe("Iterator", [this]()
+	{
+		It("Should visit exactly the set bits in ascending order", EAsyncExecution::ThreadPool, [this]()
+		{
+			const TArray<int32> Expected = { 0, 1, 31, 32, 63, 64, 150, 199 };
+
+			FNetBitArray Changes(200);
+			for (int32 Index : Expected)
+			{
+				Changes.Add(Index);
+			}
+
+			TArray<int32> Visited;
+			for (FNetBitArray::FIterator It(Changes); It; ++It)
+			{
+				Visited.Add(*It);
+			}
+			TEST_TRUE(Visited == Expected);
+
+			FNetBitArray Empty(200);
+			TEST_FALSE((bool)FNetBitArray::FIterator(Empty));
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should serialize only dirty properties at 1%, 10% and 100% dirty ratios", [this]()
+		{
+			const int32 PropertyNum = 200;
+			const int32 Iterations = 1000;
+
+			const UAttributeBagStruct* BagStruct = CreateDirtyTestBagStruct(PropertyNum);
+			const FAttributeBagLayout& Layout = BagStruct->GetLayout();
+
+			FInstancedStruct Instance;
+			Instance.InitializeAs(BagStruct);
+			uint8* Memory = Instance.GetMutableMemory();
+			for (int32 Index = 0; Index < PropertyNum; ++Index)
+			{
+				*(int32*)(Memory + Layout.GetProperty(Index).Offset) = Index * 7;
+			}
+
+			FRandomStream Random(0xD1B7);
+			for (const float DirtyRatio : { 0.01f, 0.1f, 1.0f })
+			{
+				const int32 DirtyNum = FMath::Max(1, FMath::RoundToInt(PropertyNum * DirtyRatio));
+				const FNetBitArray Changes = MakeChanges(PropertyNum, DirtyNum, Random);
+
+				FBitWriter FullScanWriter(0, true);
+				const double FullScanStart = FPlatformTime::Seconds();
+				for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+				{
+					FullScanWriter.Reset();
+					SerializeByFullScan(BagStruct, Changes, Memory, FullScanWriter);
+				}
+				const double FullScanSeconds = FPlatformTime::Seconds() - FullScanStart;
+
+				FBitWriter DirtyWriter(0, true);
+				const double DirtyStart = FPlatformTime::Seconds();
+				for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+				{
+					DirtyWriter.Reset();
+					SerializeByDirtyBits(Layout, Changes, Memory, DirtyWriter);
+				}
+				const double DirtySeconds = FPlatformTime::Seconds() - DirtyStart;
+
+				TEST_EQUAL(DirtyWriter.GetNumBits(), FullScanWriter.GetNumBits());
+				TEST_EQUAL(FMemory::Memcmp(DirtyWriter.GetData(), FullScanWriter.GetData(), DirtyWriter.GetNumBytes()), 0);
+
+				AddInfo(FString::Printf(TEXT("%d/%d dirty (%.0f%%) x %d: full scan %.3f ms, dirty bits %.3f ms"),
+					DirtyNum, PropertyNum, DirtyRatio * 100.0f, Iterations, FullScanSeconds * 1000.0, DirtySeconds * 1000.0));
+			}
+		});
+	});
+}
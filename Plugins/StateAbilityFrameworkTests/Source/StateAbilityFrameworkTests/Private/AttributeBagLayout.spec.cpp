@@ -0,0 +1,215 @@
+#include "AttributeBagTest.h"
+
+#include "InstancedStruct.h"
+#include "HAL/PlatformTime.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const UAttributeBagStruct* CreateInt32BagStruct(int32 PropertyNum, TArray<FName>& OutNames)
+	{
+		TArray<FAttributeBagPropertyDesc> PropertyDescs;
+		for (int32 Index = 0; Index < PropertyNum; ++Index)
+		{
+			OutNames.Add(FName(*FString::Printf(TEXT("LayoutTestAttr_%d"), Index)));
+			PropertyDescs.Emplace(OutNames.Last(), EAttributeBagPropertyType::Int32);
+		}
+		return UAttributeBagStruct::GetOrCreateFromDescs(PropertyDescs);
+	}
+
+	// 原先的做法：按 TFieldIterator 的顺序逐个比较名字
+	int32 FindIndexByFieldIterator(const UScriptStruct* ScriptStruct, const FName Name)
+	{
+		int32 Index = 0;
+		for (TFieldIterator<FProperty> It(ScriptStruct); It; ++It, ++Index)
+		{
+			if (It->GetFName() == Name)
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FAttributeBagLayoutSpec, "StateAbilityFramework.Attribute.AttributeBagLayout", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FAttributeBagLayoutSpec)
+
+void FAttributeBagLayoutSpec::Define()
+{
+	Describe("Layout", [this]()
+	{
+		It("Should match the field iterator order of a native struct", [this]()
+		{
+			const UScriptStruct* ScriptStruct = FAttributeReactiveBagTestData::StaticStruct();
+			const FAttributeBagLayout& Layout = FAttributeBagLayout::Get(ScriptStruct);
+
+			TEST_TRUE(&Layout == &FAttributeBagLayout::Get(ScriptStruct));
+
+			int32 Index = 0;
+			for (TFieldIterator<FProperty> It(ScriptStruct); It; ++It, ++Index)
+			{
+				TEST_EQUAL(Layout.FindIndex(It->GetFName()), Index);
+				TEST_EQUAL(Layout.GetProperty(Index).Offset, It->GetOffset_ForInternal());
+				TEST_EQUAL(Layout.GetProperty(Index).Size, It->GetSize());
+			}
+			TEST_EQUAL(Layout.Num(), Index);
+			TEST_EQUAL(Layout.FindIndex(TEXT("NotAnAttribute")), INDEX_NONE);
+		});
+
+		It("Should map every desc name of a bag struct to its desc index", [this]()
+		{
+			TArray<FName> Names;
+			const UAttributeBagStruct* BagStruct = CreateInt32BagStruct(256, Names);
+			const FAttributeBagLayout& Layout = BagStruct->GetLayout();
+
+			TEST_EQUAL(Layout.Num(), 256);
+			TEST_TRUE(Layout.IsPerfectHash());
+
+			for (const FAttributeBagPropertyDesc& Desc : BagStruct->GetPropertyDescs())
+			{
+				TEST_EQUAL(Layout.FindIndex(Desc.Name), Desc.Index);
+				TEST_EQUAL(Layout.GetProperty(Desc.Index).Offset, Desc.CachedProperty->GetOffset_ForInternal());
+				TEST_TRUE(Layout.GetProperty(Desc.Index).bPOD);
+			}
+			TEST_TRUE(BagStruct->FindPropertyDescByName(Names[42]) == BagStruct->FindPropertyDescByIndex(42));
+			TEST_TRUE(BagStruct->FindPropertyDescByName(TEXT("NotAnAttribute")) == nullptr);
+		});
+
+		It("Should build a perfect hash for large bag structs", [this]()
+		{
+			for (const int32 PropertyNum : { 1, 3, 50, 1024, 4096 })
+			{
+				TArray<FName> Names;
+				const UAttributeBagStruct* BagStruct = CreateInt32BagStruct(PropertyNum, Names);
+				const FAttributeBagLayout& Layout = BagStruct->GetLayout();
+
+				TEST_TRUE(Layout.IsPerfectHash());
+				int32 MismatchNum = 0;
+				for (int32 Index = 0; Index < PropertyNum; ++Index)
+				{
+					MismatchNum += Layout.FindIndex(Names[Index]) != Index ? 1 : 0;
+				}
+				TEST_EQUAL(MismatchNum, 0);
+
+				// 不存在的名字落在其他名字的槽位或空槽位上
+				int32 FoundNum = 0;
+				for (int32 Index = 0; Index < PropertyNum; ++Index)
+				{
+					FoundNum += Layout.FindIndex(FName(*FString::Printf(TEXT("LayoutMissingAttr_%d"), Index))) != INDEX_NONE ? 1 : 0;
+				}
+				TEST_EQUAL(FoundNum, 0);
+			}
+		});
+
+		It("Should mark the named attribute dirty", [this]()
+		{
+			TArray<FName> Names;
+			FAttributeDynamicBag_Test Bag;
+			Bag.ResetDataStruct(CreateInt32BagStruct(64, Names));
+			Bag.ResetDirtyMark();
+
+			Bag.MarkDirty(Names[37]);
+			Bag.MarkDirty(FName(TEXT("NotAnAttribute")));
+
+			TEST_EQUAL(Bag.GetPropertyNum(), 64);
+			TEST_TRUE(Bag.IsDirty(37));
+			TEST_FALSE(Bag.IsDirty(36));
+		});
+
+		It("Should reuse the cached layout until the struct is invalidated", [this]()
+		{
+			const UScriptStruct* ScriptStruct = FAttributeReactiveBagTestData::StaticStruct();
+
+			FAttributeBagLayoutCache LayoutCache;
+			const FAttributeBagLayout* Layout = &LayoutCache.Get(ScriptStruct);
+			TEST_TRUE(Layout == &FAttributeBagLayout::Get(ScriptStruct));
+			TEST_TRUE(Layout == &LayoutCache.Get(ScriptStruct));
+
+			// 模拟结构体被重新实例化
+			const uint32 Generation = FAttributeBagLayout::GetGeneration();
+			FAttributeBagLayout::Invalidate(ScriptStruct);
+			TEST_EQUAL(FAttributeBagLayout::GetGeneration(), Generation + 1);
+
+			const FAttributeBagLayout* RebuiltLayout = &LayoutCache.Get(ScriptStruct);
+			TEST_FALSE(RebuiltLayout == Layout);
+			TEST_TRUE(RebuiltLayout == &FAttributeBagLayout::Get(ScriptStruct));
+			TEST_EQUAL(RebuiltLayout->Num(), Layout->Num());
+
+			// 没有被移除的结构体不影响版本
+			FAttributeBagLayout::Invalidate(nullptr);
+			TEST_EQUAL(FAttributeBagLayout::GetGeneration(), Generation + 1);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should set 10k attributes by name", [this]()
+		{
+			const int32 PropertyNum = 256;
+			const int32 SetNum = 10000;
+
+			TArray<FName> Names;
+			const UAttributeBagStruct* BagStruct = CreateInt32BagStruct(PropertyNum, Names);
+
+			FAttributeDynamicBag_Test Bag;
+			Bag.ResetDataStruct(BagStruct);
+			Bag.ResetDirtyMark();
+
+			FInstancedStruct Instance;
+			Instance.InitializeAs(BagStruct);
+			uint8* Memory = Instance.GetMutableMemory();
+
+			FRandomStream Random(0xA77B);
+			TArray<int32> Order;
+			for (int32 Index = 0; Index < SetNum; ++Index)
+			{
+				Order.Add(Random.RandHelper(PropertyNum));
+			}
+
+			// 修改前：遍历字段查找序号
+			const double LinearStart = FPlatformTime::Seconds();
+			int64 LinearChecksum = 0;
+			for (int32 Index = 0; Index < SetNum; ++Index)
+			{
+				const FName Name = Names[Order[Index]];
+				const int32 PropertyIndex = FindIndexByFieldIterator(BagStruct, Name);
+				const FProperty* Property = BagStruct->FindPropertyDescByIndex(PropertyIndex)->CachedProperty;
+				*(int32*)(Memory + Property->GetOffset_ForInternal()) = Index;
+				LinearChecksum += PropertyIndex;
+			}
+			const double LinearSeconds = FPlatformTime::Seconds() - LinearStart;
+
+			// 修改后：布局表
+			const FAttributeBagLayout& Layout = BagStruct->GetLayout();
+			const double LayoutStart = FPlatformTime::Seconds();
+			int64 LayoutChecksum = 0;
+			for (int32 Index = 0; Index < SetNum; ++Index)
+			{
+				const FName Name = Names[Order[Index]];
+				const int32 PropertyIndex = Layout.FindIndex(Name);
+				*(int32*)(Memory + Layout.GetProperty(PropertyIndex).Offset) = Index;
+				Bag.MarkDirty(Name);
+				LayoutChecksum += PropertyIndex;
+			}
+			const double LayoutSeconds = FPlatformTime::Seconds() - LayoutStart;
+
+			TEST_EQUAL(LayoutChecksum, LinearChecksum);
+			TEST_TRUE(Bag.IsDirty(Order.Last()));
+
+			AddInfo(FString::Printf(TEXT("Set %d attributes by name on a %d-property bag: field iterator %.3f ms, layout table + MarkDirty %.3f ms"),
+				SetNum, PropertyNum, LinearSeconds * 1000.0, LayoutSeconds * 1000.0));
+		});
+	});
+}
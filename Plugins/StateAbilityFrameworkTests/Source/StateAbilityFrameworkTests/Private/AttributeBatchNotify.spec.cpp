@@ -0,0 +1,365 @@
+#include "AttributeModelTest.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	using FChainModel = FAttributeModelTest_Chain;
+
+	// Stage(N+1) = Stage(N) + 1，每个监听者计数一次
+	void BindChain(FChainModel* Model, int32& ListenerCount)
+	{
+		Bind(Model, FChainModel::Stage0Property(), [Model, &ListenerCount] { ++ListenerCount; Model->SetStage1(Model->GetStage0() + 1); });
+		Bind(Model, FChainModel::Stage1Property(), [Model, &ListenerCount] { ++ListenerCount; Model->SetStage2(Model->GetStage1() + 1); });
+		Bind(Model, FChainModel::Stage2Property(), [Model, &ListenerCount] { ++ListenerCount; Model->SetStage3(Model->GetStage2() + 1); });
+		Bind(Model, FChainModel::Stage3Property(), [Model, &ListenerCount] { ++ListenerCount; Model->SetStage4(Model->GetStage3() + 1); });
+		Bind(Model, FChainModel::Stage4Property(), [Model, &ListenerCount] { ++ListenerCount; Model->SetStage5(Model->GetStage4() + 1); });
+		Bind(Model, FChainModel::Stage5Property(), [&ListenerCount] { ++ListenerCount; });
+	}
+
+	struct FChainReport
+	{
+		int32 ListenerCount = 0;
+		int32 MismatchNum = 0;
+		double Seconds = 0.0;
+	};
+
+	// EntityNum 个实体，每帧每个实体写 Stage0 WriteNum 次
+	FChainReport SimulateChain(int32 EntityNum, int32 FrameNum, int32 WriteNum, bool bBatch)
+	{
+		FChainReport Report;
+
+		TArray<TUniquePtr<FChainModel>> Models;
+		Models.Reserve(EntityNum);
+		for (int32 Index = 0; Index < EntityNum; ++Index)
+		{
+			FChainModel* Model = Models.Add_GetRef(MakeUnique<FChainModel>()).Get();
+			BindChain(Model, Report.ListenerCount);
+		}
+		Report.ListenerCount = 0;
+
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Frame = 1; Frame <= FrameNum; ++Frame)
+		{
+			FAttributeBindBatchScope BatchScope(bBatch);
+			for (const TUniquePtr<FChainModel>& Model : Models)
+			{
+				for (int32 Write = 1; Write <= WriteNum; ++Write)
+				{
+					Model->SetStage0(Frame * 100 + Write);
+				}
+			}
+		}
+		Report.Seconds = FPlatformTime::Seconds() - Start;
+
+		for (const TUniquePtr<FChainModel>& Model : Models)
+		{
+			if (Model->GetStage5() != Model->GetStage0() + 5)
+			{
+				++Report.MismatchNum;
+			}
+		}
+		return Report;
+	}
+
+	/**
+	 * 与 UCommandFrameManager 相同的帧流程与批量作用域：
+	 * BeginNewFrame（开始新的一帧与模拟输入）不在批量中，EndPrevFrame 在批量中并于 OnPostEndFrame 之后广播，
+	 * 回滚发生在 EndPrevFrame 的 OnPreEndFrame 阶段，由 ReplayFrames 暂停外层批量后重新模拟。
+	 *
+	 * Stage1 = Stage0 + 1、Stage3 = Stage2 + 1 为派生属性，每一帧读取上一阶段的派生属性：
+	 * BeginNewFrame: Stage0 = Stage3 + Input(Frame)，EndPrevFrame: Stage2 = Stage1 * 2
+	 */
+	struct FReplayFrameLoop
+	{
+		FReplayFrameLoop(uint32 FrameNum)
+		{
+			Bind(&Model, FChainModel::Stage0Property(), [this] { Model.SetStage1(Model.GetStage0() + 1); });
+			Bind(&Model, FChainModel::Stage2Property(), [this] { Model.SetStage3(Model.GetStage2() + 1); });
+
+			Stage3ByFrame.Init(0, FrameNum + 1);
+			BaseByFrame.Init(TPair<int32, int32>(0, 0), FrameNum + 1);
+		}
+
+		int32 Input(uint32 Frame) const
+		{
+			return (int32)Frame + (Frame == MispredictFrame ? 7 : 0);
+		}
+
+		void BeginNewFrame(uint32 Frame)
+		{
+			Model.SetStage0((Model.GetStage3() + Input(Frame)) % 100003);
+		}
+
+		void EndPrevFrame(uint32 Frame)
+		{
+			FAttributeBindBatchScope BatchScope;
+
+			// OnPreEndFrame
+			if (RewindFrame == Frame)
+			{
+				Rewind(RewindedFrame);
+			}
+
+			// OnEndFrame
+			Model.SetStage2(Model.GetStage1() * 2);
+
+			// OnPostEndFrame 之后
+			FAttributeBindBatch::Flush();
+
+			Stage3ByFrame[Frame] = Model.GetStage3();
+			BaseByFrame[Frame] = TPair<int32, int32>(Model.GetStage0(), Model.GetStage2());
+		}
+
+		void FlushFrame()
+		{
+			if (RealFrame)
+			{
+				EndPrevFrame(RealFrame);
+			}
+			++RealFrame;
+			BeginNewFrame(RealFrame);
+		}
+
+		// 修正为 RewindedFrame 的状态并重新模拟到 RealFrame
+		void Rewind(uint32 InRewindedFrame)
+		{
+			MispredictFrame = 0;
+			Model.SetStage0(BaseByFrame[InRewindedFrame].Key);
+			Model.SetStage2(BaseByFrame[InRewindedFrame].Value);
+
+			FAttributeBindBatchSuspendScope BatchSuspend;
+			for (uint32 Frame = InRewindedFrame + 1; Frame < RealFrame; ++Frame)
+			{
+				BeginNewFrame(Frame);
+				EndPrevFrame(Frame);
+			}
+			BeginNewFrame(RealFrame);
+		}
+
+		FChainModel Model;
+		TArray<int32> Stage3ByFrame;
+		TArray<TPair<int32, int32>> BaseByFrame;
+		uint32 RealFrame = 0;
+
+		uint32 MispredictFrame = 0;
+		uint32 RewindFrame = 0;
+		uint32 RewindedFrame = 0;
+	};
+}
+
+BEGIN_DEFINE_SPEC(FAttributeBatchNotifySpec, "StateAbilityFramework.Attribute.BatchNotify", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FAttributeBatchNotifySpec)
+
+void FAttributeBatchNotifySpec::Define()
+{
+	Describe("Scope", [this]()
+	{
+		It("Should defer and deduplicate notifications until the outermost scope ends", [this]()
+		{
+			FChainModel Model;
+			int32 ExecCount = 0;
+			int32 LastValue = 0;
+			Bind(&Model, FChainModel::Stage0Property(), [&Model, &ExecCount, &LastValue] { ++ExecCount; LastValue = Model.GetStage0(); });
+
+			{
+				FAttributeBindBatchScope OuterScope;
+				{
+					FAttributeBindBatchScope InnerScope;
+					for (int32 Value = 1; Value <= 5; ++Value)
+					{
+						Model.SetStage0(Value);
+					}
+				}
+				TEST_EQUAL(ExecCount, 0);
+				TEST_EQUAL(FAttributeBindBatch::GetPendingNum(), 1);
+			}
+
+			TEST_EQUAL(ExecCount, 1);
+			TEST_EQUAL(LastValue, 5);
+			TEST_EQUAL(FAttributeBindBatch::GetPendingNum(), 0);
+
+			// 作用域外立即广播
+			Model.SetStage0(6);
+			TEST_EQUAL(ExecCount, 2);
+		});
+
+		It("Should not broadcast when the scope is disabled", [this]()
+		{
+			FChainModel Model;
+			int32 ExecCount = 0;
+			Bind(&Model, FChainModel::Stage0Property(), [&ExecCount] { ++ExecCount; });
+
+			FAttributeBindBatchScope BatchScope(false);
+			Model.SetStage0(1);
+			Model.SetStage0(2);
+			TEST_EQUAL(ExecCount, 2);
+			TEST_FALSE(FAttributeBindBatch::IsBatching());
+		});
+
+		It("Should drop the pending entries of a destroyed model", [this]()
+		{
+			int32 ExecCount = 0;
+			{
+				FAttributeBindBatchScope BatchScope;
+
+				TUniquePtr<FChainModel> Model = MakeUnique<FChainModel>();
+				Bind(Model.Get(), FChainModel::Stage0Property(), [&ExecCount] { ++ExecCount; });
+				Model->SetStage0(1);
+				TEST_EQUAL(FAttributeBindBatch::GetPendingNum(), 1);
+
+				Model.Reset();
+				TEST_EQUAL(FAttributeBindBatch::GetPendingNum(), 0);
+			}
+			TEST_EQUAL(ExecCount, 0);
+		});
+	});
+
+	Describe("Replay", [this]()
+	{
+		It("Should broadcast every replayed frame like a live frame", [this]()
+		{
+			const uint32 FrameNum = 30;
+			const uint32 RewindedFrame = 10;
+			const uint32 RewindFrame = 20;
+
+			FReplayFrameLoop Live(FrameNum);
+			for (uint32 Frame = 1; Frame <= FrameNum; ++Frame)
+			{
+				Live.FlushFrame();
+			}
+
+			// RewindedFrame 之后预测错了一帧的输入，RewindFrame 时修正并重新模拟
+			FReplayFrameLoop Replayed(FrameNum);
+			Replayed.MispredictFrame = RewindedFrame + 2;
+			Replayed.RewindFrame = RewindFrame;
+			Replayed.RewindedFrame = RewindedFrame;
+			for (uint32 Frame = 1; Frame <= FrameNum; ++Frame)
+			{
+				Replayed.FlushFrame();
+			}
+
+			int32 MismatchNum = 0;
+			for (uint32 Frame = 1; Frame < FrameNum; ++Frame)
+			{
+				MismatchNum += Replayed.Stage3ByFrame[Frame] != Live.Stage3ByFrame[Frame] ? 1 : 0;
+			}
+			TEST_EQUAL(MismatchNum, 0);
+			TEST_EQUAL(Replayed.Model.GetStage0(), Live.Model.GetStage0());
+			TEST_EQUAL(Replayed.Model.GetStage1(), Live.Model.GetStage1());
+			TEST_EQUAL(Replayed.Model.GetStage3(), Live.Model.GetStage3());
+			TEST_FALSE(FAttributeBindBatch::IsBatching());
+			TEST_EQUAL(FAttributeBindBatch::GetPendingNum(), 0);
+		});
+
+		It("Should broadcast the pending notifications when suspended", [this]()
+		{
+			FChainModel Model;
+			int32 ExecCount = 0;
+			Bind(&Model, FChainModel::Stage0Property(), [&ExecCount] { ++ExecCount; });
+
+			FAttributeBindBatchScope OuterScope;
+			Model.SetStage0(1);
+			TEST_EQUAL(ExecCount, 0);
+			{
+				FAttributeBindBatchSuspendScope BatchSuspend;
+				TEST_EQUAL(ExecCount, 1);
+				TEST_FALSE(FAttributeBindBatch::IsBatching());
+
+				Model.SetStage0(2);
+				TEST_EQUAL(ExecCount, 2);
+				{
+					FAttributeBindBatchScope InnerScope;
+					Model.SetStage0(3);
+					TEST_EQUAL(ExecCount, 2);
+				}
+				TEST_EQUAL(ExecCount, 3);
+			}
+			TEST_TRUE(FAttributeBindBatch::IsBatching());
+		});
+	});
+
+	Describe("Order", [this]()
+	{
+		It("Should broadcast a diamond dependency once after both of its inputs", [this]()
+		{
+			// Stage0 -> Stage1, Stage2 -> Stage3
+			FChainModel Model;
+			Bind(&Model, FChainModel::Stage0Property(), [&Model] { Model.SetStage1(Model.GetStage0() + 1); });
+			Bind(&Model, FChainModel::Stage0Property(), [&Model] { Model.SetStage2(Model.GetStage0() + 2); });
+			Bind(&Model, FChainModel::Stage1Property(), [&Model] { Model.SetStage3(Model.GetStage1() + Model.GetStage2()); });
+			Bind(&Model, FChainModel::Stage2Property(), [&Model] { Model.SetStage3(Model.GetStage1() + Model.GetStage2()); });
+
+			TArray<int32> Stage3Values;
+			Bind(&Model, FChainModel::Stage3Property(), [&Model, &Stage3Values] { Stage3Values.Add(Model.GetStage3()); });
+
+			{
+				FAttributeBindBatchScope BatchScope;
+				Model.SetStage0(10);
+			}
+
+			TEST_EQUAL(Stage3Values.Num(), 1);
+			TEST_TRUE(Stage3Values.Num() == 1 && Stage3Values[0] == 23);
+		});
+
+		It("Should learn the depth of a longer path and broadcast once from the next flush", [this]()
+		{
+			// Stage0 -> Stage5 与 Stage0 -> Stage1 -> Stage2 -> Stage5，第一次 Flush 时尚不知道 Stage5 在更深的位置
+			FChainModel Model;
+			Bind(&Model, FChainModel::Stage0Property(), [&Model] { Model.SetStage5(Model.GetStage0() + Model.GetStage2()); });
+			Bind(&Model, FChainModel::Stage0Property(), [&Model] { Model.SetStage1(Model.GetStage0() + 1); });
+			Bind(&Model, FChainModel::Stage1Property(), [&Model] { Model.SetStage2(Model.GetStage1() + 1); });
+			Bind(&Model, FChainModel::Stage2Property(), [&Model] { Model.SetStage5(Model.GetStage0() + Model.GetStage2()); });
+
+			TArray<int32> Stage5Values;
+			Bind(&Model, FChainModel::Stage5Property(), [&Model, &Stage5Values] { Stage5Values.Add(Model.GetStage5()); });
+
+			{
+				FAttributeBindBatchScope BatchScope;
+				Model.SetStage0(10);
+			}
+			TEST_TRUE(Stage5Values.Num() > 0 && Stage5Values.Last() == 22);
+
+			Stage5Values.Reset();
+			{
+				FAttributeBindBatchScope BatchScope;
+				Model.SetStage0(20);
+			}
+			TEST_EQUAL(Stage5Values.Num(), 1);
+			TEST_TRUE(Stage5Values.Num() == 1 && Stage5Values[0] == 42);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report listener invocations of a 5-deep derived chain with 1k entities", [this]()
+		{
+			const int32 EntityNum = 1000;
+			const int32 FrameNum = 20;
+			const int32 WriteNum = 5;
+
+			const FChainReport Immediate = SimulateChain(EntityNum, FrameNum, WriteNum, false);
+			const FChainReport Batched = SimulateChain(EntityNum, FrameNum, WriteNum, true);
+
+			TEST_EQUAL(Immediate.MismatchNum, 0);
+			TEST_EQUAL(Batched.MismatchNum, 0);
+			// 每次写入都沿整条链广播：6 个监听者 x 5 次写入
+			TEST_EQUAL(Immediate.ListenerCount, EntityNum * FrameNum * WriteNum * 6);
+			// 每个 BindEntry 每帧只广播一次
+			TEST_EQUAL(Batched.ListenerCount, EntityNum * FrameNum * 6);
+
+			AddInfo(FString::Printf(TEXT("%d entities x %d frames x %d writes: immediate %d listener calls in %.2f ms, batched %d listener calls in %.2f ms"),
+				EntityNum, FrameNum, WriteNum, Immediate.ListenerCount, Immediate.Seconds * 1000.0, Batched.ListenerCount, Batched.Seconds * 1000.0));
+		});
+	});
+}
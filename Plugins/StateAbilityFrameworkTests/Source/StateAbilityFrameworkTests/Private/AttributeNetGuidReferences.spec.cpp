@@ -0,0 +1,353 @@
+#include "AttributeBagTest.h"
+
+#include "HAL/PlatformTLS.h"
+
+#include "Attribute/AttributeBag/AttributeNetGuidReferences.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	constexpr int32 AttributeNum = 1000;
+
+	// 奇数序号为静态对象，偶数为动态对象
+	FNetworkGUID MakeGUID(int32 PropIndex)
+	{
+		return FNetworkGUID::CreateFromIndex(PropIndex + 1, PropIndex % 2 == 1);
+	}
+
+	TArray<uint8> MakeBuffer(int32 PropIndex)
+	{
+		TArray<uint8> Buffer;
+		Buffer.Append((const uint8*)&PropIndex, sizeof(PropIndex));
+		return Buffer;
+	}
+
+	void AddAttributeReference(FAttributeNetGuidReferences& References, int32 PropIndex, int32 ElementID = INDEX_NONE)
+	{
+		TSet<FNetworkGUID> UnmappedGUIDs;
+		UnmappedGUIDs.Add(MakeGUID(PropIndex));
+		References.Set((uint16)PropIndex, ElementID, UnmappedGUIDs, TSet<FNetworkGUID>(), MakeBuffer(PropIndex), sizeof(int32) * 8);
+	}
+
+	// 修改前的结构：每个属性一个 Map 元素，各自持有两个 TSet 和一份数据
+	struct FLegacyGuidReference
+	{
+		TSet<FNetworkGUID> UnmappedGUIDs;
+		TSet<FNetworkGUID> MappedDynamicGUIDs;
+		TArray<uint8> Buffer;
+		int32 NumBufferBits = 0;
+	};
+
+	/**
+	 * 统计当前线程在作用域内的堆分配次数（Malloc 和扩容的 Realloc），
+	 * 临时替换 GMalloc，其他线程的分配照常转发但不计数。
+	 */
+	class FScopedAllocationCounter final : public FMalloc
+	{
+	public:
+		FScopedAllocationCounter()
+			: Inner(GMalloc)
+			, ThreadId(FPlatformTLS::GetCurrentThreadId())
+		{
+			GMalloc = this;
+		}
+
+		virtual ~FScopedAllocationCounter() override
+		{
+			GMalloc = Inner;
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("ScopedAllocationCounter");
+		}
+
+		int32 GetAllocationNum() const { return AllocationNum; }
+
+	private:
+		void CountAllocation()
+		{
+			if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+			{
+				++AllocationNum;
+			}
+		}
+
+		FMalloc* Inner;
+		uint32 ThreadId;
+		int32 AllocationNum = 0;
+	};
+}
+
+BEGIN_DEFINE_SPEC(FAttributeNetGuidReferencesSpec, "StateAbilityFramework.Attribute.NetGuidReferences", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FAttributeNetGuidReferencesSpec)
+
+void FAttributeNetGuidReferencesSpec::Define()
+{
+	Describe("References", [this]()
+	{
+		It("Should keep references sorted by property and element", [this]()
+		{
+			FAttributeNetGuidReferences References;
+
+			TArray<int32> Order;
+			for (int32 PropIndex = 0; PropIndex < AttributeNum; ++PropIndex)
+			{
+				Order.Add(PropIndex);
+			}
+			FRandomStream Random(0x6D1D);
+			for (int32 Index = Order.Num() - 1; Index > 0; --Index)
+			{
+				Order.Swap(Index, Random.RandHelper(Index + 1));
+			}
+			for (const int32 PropIndex : Order)
+			{
+				AddAttributeReference(References, PropIndex);
+			}
+
+			TEST_EQUAL(References.Num(), AttributeNum);
+
+			bool bSorted = true;
+			TConstArrayView<FAttributeNetGuidRef> Refs = References.GetReferences();
+			for (int32 Index = 1; Index < Refs.Num(); ++Index)
+			{
+				bSorted &= Refs[Index - 1].GetKey() < Refs[Index].GetKey();
+			}
+			TEST_TRUE(bSorted);
+
+			const FAttributeNetGuidBuffer* Buffer = References.FindBuffer(421, INDEX_NONE);
+			TEST_TRUE(Buffer != nullptr && Buffer->Buffer == MakeBuffer(421));
+			TEST_TRUE(References.FindBuffer(421, 0) == nullptr);
+
+			// 再次设置同一个 Key 会替换原有引用
+			AddAttributeReference(References, 421);
+			TEST_EQUAL(References.Num(), AttributeNum);
+
+			References.Set(421, INDEX_NONE, TSet<FNetworkGUID>(), TSet<FNetworkGUID>(), TArray<uint8>(), 0);
+			TEST_EQUAL(References.Num(), AttributeNum - 1);
+			TEST_TRUE(References.FindBuffer(421, INDEX_NONE) == nullptr);
+		});
+
+		It("Should drop every element of an array property together", [this]()
+		{
+			FAttributeNetGuidReferences References;
+			AddAttributeReference(References, 5, 2);
+			AddAttributeReference(References, 5, 1);
+			AddAttributeReference(References, 5);
+			AddAttributeReference(References, 6, 1);
+
+			References.Remove(5, 1);
+			TEST_EQUAL(References.Num(), 3);
+			TEST_TRUE(References.FindBuffer(5, 2) != nullptr);
+
+			References.RemoveProperty(5);
+			TEST_EQUAL(References.Num(), 1);
+			TEST_TRUE(References.FindBuffer(5, 2) == nullptr);
+			TEST_TRUE(References.FindBuffer(6, 1) != nullptr);
+		});
+
+		It("Should resolve 1k object references and re-read only the mapped ones", [this]()
+		{
+			UAttributeNetGuidTestPackageMap* Map = NewObject<UAttributeNetGuidTestPackageMap>();
+
+			FAttributeNetGuidReferences References;
+			for (int32 PropIndex = 0; PropIndex < AttributeNum; ++PropIndex)
+			{
+				AddAttributeReference(References, PropIndex);
+			}
+
+			int32 ExpectedRemaining = 0;
+			TArray<int32> ExpectedMapped;
+			for (int32 PropIndex = 0; PropIndex < AttributeNum; ++PropIndex)
+			{
+				const FNetworkGUID GUID = MakeGUID(PropIndex);
+				if (PropIndex % 3 == 0)
+				{
+					Map->LoadedGUIDs.Add(GUID);
+					ExpectedMapped.Add(PropIndex);
+					ExpectedRemaining += GUID.IsDynamic() ? 1 : 0;
+				}
+				else if (PropIndex % 7 == 0)
+				{
+					Map->BrokenGUIDs.Add(GUID);
+				}
+				else
+				{
+					++ExpectedRemaining;
+				}
+			}
+
+			TArray<int32> Mapped;
+			bool bBufferMatched = true;
+			References.UpdateUnmapped(Map, [&Mapped, &bBufferMatched](const FAttributeNetGuidBuffer& Buffer)
+			{
+				Mapped.Add(Buffer.PropIndex);
+				bBufferMatched &= Buffer.Buffer == MakeBuffer(Buffer.PropIndex);
+			});
+
+			TEST_TRUE(Mapped == ExpectedMapped);
+			TEST_TRUE(bBufferMatched);
+			TEST_EQUAL(References.Num(), ExpectedRemaining);
+
+			// 静态对象映射后不再追踪，动态对象保留数据以便对象销毁后重新读取
+			TEST_TRUE(References.FindBuffer(3, INDEX_NONE) == nullptr);
+			TEST_TRUE(References.FindBuffer(6, INDEX_NONE) != nullptr);
+			TEST_TRUE(References.FindBuffer(14, INDEX_NONE) == nullptr);
+
+			TSet<FNetworkGUID> Gathered;
+			References.Gather(Gathered);
+			TEST_EQUAL(Gathered.Num(), ExpectedRemaining);
+
+			// 第二次没有新加载的对象
+			Mapped.Reset();
+			References.UpdateUnmapped(Map, [&Mapped](const FAttributeNetGuidBuffer& Buffer) { Mapped.Add(Buffer.PropIndex); });
+			TEST_EQUAL(Mapped.Num(), 0);
+
+			// 动态对象被销毁后重新变为未映射，再次加载时只重新读取这一个属性
+			TEST_TRUE(References.MoveToUnmapped(MakeGUID(6)));
+			TEST_FALSE(References.MoveToUnmapped(MakeGUID(1)));
+			References.UpdateUnmapped(Map, [&Mapped](const FAttributeNetGuidBuffer& Buffer) { Mapped.Add(Buffer.PropIndex); });
+			TEST_TRUE(Mapped == TArray<int32>({ 6 }));
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report allocations for 1k object-ref attributes", [this]()
+		{
+			UAttributeNetGuidTestPackageMap* Map = NewObject<UAttributeNetGuidTestPackageMap>();
+			for (int32 PropIndex = 0; PropIndex < AttributeNum; PropIndex += 4)
+			{
+				Map->LoadedGUIDs.Add(MakeGUID(PropIndex));
+			}
+
+			TArray<TSet<FNetworkGUID>> TrackedGUIDs;
+			TrackedGUIDs.SetNum(AttributeNum);
+			for (int32 PropIndex = 0; PropIndex < AttributeNum; ++PropIndex)
+			{
+				TrackedGUIDs[PropIndex].Add(MakeGUID(PropIndex));
+			}
+
+			// 修改前：TMap<FRepPropIndex, FAttributeNetGuidReference>
+			int32 LegacyBuildAllocations = 0;
+			int32 LegacyResolveAllocations = 0;
+			int32 LegacyMappedNum = 0;
+			{
+				TMap<uint16, FLegacyGuidReference> GuidReferencesMap;
+				{
+					FScopedAllocationCounter Counter;
+					for (int32 PropIndex = 0; PropIndex < AttributeNum; ++PropIndex)
+					{
+						FLegacyGuidReference& GuidReference = GuidReferencesMap.FindOrAdd((uint16)PropIndex);
+						GuidReference.UnmappedGUIDs = TrackedGUIDs[PropIndex];
+						GuidReference.Buffer = MakeBuffer(PropIndex);
+						GuidReference.NumBufferBits = sizeof(int32) * 8;
+					}
+					LegacyBuildAllocations = Counter.GetAllocationNum();
+				}
+				{
+					FScopedAllocationCounter Counter;
+					for (auto It = GuidReferencesMap.CreateIterator(); It; ++It)
+					{
+						FLegacyGuidReference& GuidReference = It.Value();
+						bool bMappedSomeGUIDs = false;
+						for (auto UnmappedIt = GuidReference.UnmappedGUIDs.CreateIterator(); UnmappedIt; ++UnmappedIt)
+						{
+							const FNetworkGUID GUID = *UnmappedIt;
+							if (!Map->IsGUIDBroken(GUID, false) && Map->GetObjectFromNetGUID(GUID, false))
+							{
+								if (GUID.IsDynamic())
+								{
+									GuidReference.MappedDynamicGUIDs.Add(GUID);
+								}
+								UnmappedIt.RemoveCurrent();
+								bMappedSomeGUIDs = true;
+							}
+						}
+						LegacyMappedNum += bMappedSomeGUIDs ? 1 : 0;
+						if (GuidReference.UnmappedGUIDs.Num() == 0 && GuidReference.MappedDynamicGUIDs.Num() == 0)
+						{
+							It.RemoveCurrent();
+						}
+					}
+					LegacyResolveAllocations = Counter.GetAllocationNum();
+				}
+			}
+
+			// 修改后：有序的扁平数组
+			int32 FlatBuildAllocations = 0;
+			int32 FlatResolveAllocations = 0;
+			int32 FlatMappedNum = 0;
+			{
+				FAttributeNetGuidReferences References;
+				const TSet<FNetworkGUID> EmptyGUIDs;
+				{
+					FScopedAllocationCounter Counter;
+					for (int32 PropIndex = 0; PropIndex < AttributeNum; ++PropIndex)
+					{
+						References.Set((uint16)PropIndex, INDEX_NONE, TrackedGUIDs[PropIndex], EmptyGUIDs, MakeBuffer(PropIndex), sizeof(int32) * 8);
+					}
+					FlatBuildAllocations = Counter.GetAllocationNum();
+				}
+				{
+					FScopedAllocationCounter Counter;
+					References.UpdateUnmapped(Map, [&FlatMappedNum](const FAttributeNetGuidBuffer&) { ++FlatMappedNum; });
+					FlatResolveAllocations = Counter.GetAllocationNum();
+				}
+			}
+
+			TEST_EQUAL(FlatMappedNum, LegacyMappedNum);
+			TEST_TRUE(FlatBuildAllocations < LegacyBuildAllocations);
+			TEST_TRUE(FlatResolveAllocations <= LegacyResolveAllocations);
+
+			AddInfo(FString::Printf(TEXT("%d object-ref attributes (%d mapped): build %d allocations (map of sets) vs %d (flat), resolve %d vs %d"),
+				AttributeNum, FlatMappedNum, LegacyBuildAllocations, FlatBuildAllocations, LegacyResolveAllocations, FlatResolveAllocations));
+		});
+	});
+}
@@ -0,0 +1,233 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+
+#include "Component/Mover/MoveLibrary/CFrameFloorCache.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	constexpr float FloorSweepDistance = 40.0f;
+	constexpr float MaxWalkSlopeCosine = 0.71f;
+	constexpr float CapsuleRadius = 34.0f;
+	constexpr float CapsuleHalfHeight = 88.0f;
+
+	/**
+	 * 一块地面加一组站在上面的胶囊体
+	 */
+	struct FFloorTestWorld
+	{
+		UWorld* World = nullptr;
+		UBoxComponent* Floor = nullptr;
+		TArray<UCapsuleComponent*> Capsules;
+
+		FFloorTestWorld(int32 CapsuleNum, EComponentMobility::Type FloorMobility)
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CFrameFloorCacheSpec"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+
+			AActor* FloorActor = World->SpawnActor<AActor>();
+			Floor = NewObject<UBoxComponent>(FloorActor);
+			Floor->SetBoxExtent(FVector(10000.0, 10000.0, 50.0));
+			Floor->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+			Floor->SetMobility(FloorMobility);
+			Floor->SetWorldLocation(FVector(0.0, 0.0, -50.0));
+			FloorActor->SetRootComponent(Floor);
+			Floor->RegisterComponent();
+
+			const int32 RowNum = FMath::CeilToInt32(FMath::Sqrt((float)CapsuleNum));
+			for (int32 Index = 0; Index < CapsuleNum; ++Index)
+			{
+				AActor* MoverActor = World->SpawnActor<AActor>();
+				UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(MoverActor);
+				Capsule->InitCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+				Capsule->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
+				Capsule->SetWorldLocation(FVector((Index % RowNum) * 200.0, (Index / RowNum) * 200.0, CapsuleHalfHeight + 2.0));
+				MoverActor->SetRootComponent(Capsule);
+				Capsule->RegisterComponent();
+				Capsules.Add(Capsule);
+			}
+
+			// 让物理场景的查询结构包含刚创建的碰撞体
+			World->Tick(LEVELTICK_All, 1.0f / 30.0f);
+		}
+
+		~FFloorTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		void FindFloor(int32 Index, FFloorCheckResult& OutFloorResult) const
+		{
+			UFloorQueryUtils::FindFloor(Capsules[Index], Capsules[Index], FloorSweepDistance, MaxWalkSlopeCosine, Capsules[Index]->GetComponentLocation(), OutFloorResult);
+		}
+
+		void FindFloor(int32 Index, FCFrameFloorCache& FloorCache, FFloorCheckResult& OutFloorResult) const
+		{
+			FloorCache.FindFloor(Capsules[Index], Capsules[Index], FloorSweepDistance, MaxWalkSlopeCosine, Capsules[Index]->GetComponentLocation(), OutFloorResult);
+		}
+	};
+}
+
+BEGIN_DEFINE_SPEC(FCFrameFloorCacheSpec, "StateAbilityFramework.Mover.FloorCache", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameFloorCacheSpec)
+
+void FCFrameFloorCacheSpec::Define()
+{
+	Describe("Invalidate", [this]()
+	{
+		It("Should query again when the base or the mover moves", [this]()
+		{
+			FFloorTestWorld TestWorld(1, EComponentMobility::Movable);
+			FCFrameFloorCache FloorCache;
+			FFloorCheckResult FloorResult;
+
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_TRUE(FloorResult.IsWalkableFloor());
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 1u);
+			TEST_EQUAL(FloorCache.GetHitNum(), 1u);
+
+			// 地面移动
+			TestWorld.Floor->SetWorldLocation(FVector(0.0, 0.0, -51.0));
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 2u);
+
+			// Mover移动超过阈值
+			TestWorld.Capsules[0]->AddWorldOffset(FVector(1.0, 0.0, 0.0));
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 3u);
+
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetHitNum(), 2u);
+
+			FloorCache.Invalidate();
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 4u);
+		});
+
+		It("Should query again when the collision between the base and the mover changes", [this]()
+		{
+			FFloorTestWorld TestWorld(1, EComponentMobility::Static);
+			FCFrameFloorCache FloorCache;
+			FFloorCheckResult FloorResult;
+
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 1u);
+			TEST_EQUAL(FloorCache.GetHitNum(), 1u);
+
+			// 地面不再阻挡Pawn
+			TestWorld.Floor->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 2u);
+			TEST_FALSE(FloorResult.IsWalkableFloor());
+
+			TestWorld.Floor->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block);
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 3u);
+			TEST_TRUE(FloorResult.IsWalkableFloor());
+
+			// Mover不再阻挡地面的通道
+			TestWorld.Capsules[0]->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Ignore);
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 4u);
+
+			TestWorld.Capsules[0]->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 5u);
+
+			// 地面关闭碰撞
+			TestWorld.Floor->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			TestWorld.FindFloor(0, FloorCache, FloorResult);
+			TEST_EQUAL(FloorCache.GetMissNum(), 6u);
+			TEST_FALSE(FloorResult.IsWalkableFloor());
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report uncached and cached time for 256 idle movers on a static floor", [this]()
+		{
+			const int32 MoverNum = 256;
+			const int32 FrameNum = 300;
+
+			FFloorTestWorld TestWorld(MoverNum, EComponentMobility::Static);
+
+			TArray<FFloorCheckResult> Uncached;
+			Uncached.SetNum(MoverNum);
+
+			double UncachedSeconds = 0.0;
+			for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < MoverNum; ++Index)
+				{
+					TestWorld.FindFloor(Index, Uncached[Index]);
+				}
+				UncachedSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			TArray<FFloorCheckResult> Cached;
+			Cached.SetNum(MoverNum);
+			TArray<FCFrameFloorCache> FloorCaches;
+			FloorCaches.SetNum(MoverNum);
+
+			double CachedSeconds = 0.0;
+			for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < MoverNum; ++Index)
+				{
+					TestWorld.FindFloor(Index, FloorCaches[Index], Cached[Index]);
+				}
+				CachedSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			int32 WalkableNum = 0;
+			int32 MismatchNum = 0;
+			uint32 HitNum = 0;
+			uint32 MissNum = 0;
+			for (int32 Index = 0; Index < MoverNum; ++Index)
+			{
+				WalkableNum += Uncached[Index].IsWalkableFloor() ? 1 : 0;
+				if (Cached[Index].bWalkableFloor != Uncached[Index].bWalkableFloor || Cached[Index].FloorDist != Uncached[Index].FloorDist)
+				{
+					++MismatchNum;
+				}
+				HitNum += FloorCaches[Index].GetHitNum();
+				MissNum += FloorCaches[Index].GetMissNum();
+			}
+
+			TEST_EQUAL(WalkableNum, MoverNum);
+			TEST_EQUAL(MismatchNum, 0);
+			// 每个Mover只在第一帧查询
+			TEST_EQUAL(MissNum, (uint32)MoverNum);
+
+			AddInfo(FString::Printf(TEXT("Movers[%d] Uncached %.4f ms/frame, Cached %.4f ms/frame, HitRate %.2f%%"),
+				MoverNum,
+				UncachedSeconds * 1000.0 / FrameNum,
+				CachedSeconds * 1000.0 / FrameNum,
+				HitNum + MissNum > 0 ? HitNum * 100.0 / (HitNum + MissNum) : 0.0));
+		});
+	});
+}
@@ -0,0 +1,187 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "CFrameMoveModeTransitionTest.h"
+#include "Component/Mover/CFrameMoveModeTransitionTable.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	FName MakeModeName(int32 ModeId)
+	{
+		return FName(TEXT("TestMode"), ModeId + 1);
+	}
+
+	TArray<TObjectPtr<UCFrameMovementMode>> MakeModes(int32 ModeNum)
+	{
+		TArray<TObjectPtr<UCFrameMovementMode>> Modes;
+		for (int32 ModeId = 0; ModeId < ModeNum; ++ModeId)
+		{
+			UCFrameMovementMode_Test* Mode = NewObject<UCFrameMovementMode_Test>(GetTransientPackage());
+			Mode->OnRegistered(MakeModeName(ModeId));
+			Modes.Add(Mode);
+		}
+		return Modes;
+	}
+
+	FCFrameModeTransitionLink MakeLink(TSubclassOf<UCFrameMoveModeTransition> TransitionClass, int32 FromModeId, int32 ToModeId, int32 Priority)
+	{
+		FCFrameModeTransitionLink Link;
+		Link.ModeTransition = TransitionClass;
+		Link.FromMode = MakeModeName(FromModeId);
+		Link.ToMode = MakeModeName(ToModeId);
+		Link.Priority = Priority;
+		return Link;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameMoveModeTransitionSpec, "StateAbilityFramework.Mover.Transition", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameMoveModeTransitionSpec)
+
+void FCFrameMoveModeTransitionSpec::Define()
+{
+	Describe("Compile", [this]()
+	{
+		It("Should order each mode's transitions by priority and drop unknown modes", [this]()
+		{
+			TArray<TObjectPtr<UCFrameMovementMode>> Modes = MakeModes(3);
+
+			TArray<FCFrameModeTransitionLink> Links;
+			Links.Add(MakeLink(UCFrameMoveModeTransition_TestDeltaTime::StaticClass(), 0, 1, 1));
+			Links.Add(MakeLink(UCFrameMoveModeTransition_TestFlag::StaticClass(), 0, 2, 5));
+			Links.Add(MakeLink(UCFrameMoveModeTransition_TestFlag::StaticClass(), 2, 0, 0));
+			Links.Add(MakeLink(UCFrameMoveModeTransition_TestFlag::StaticClass(), 1, 7, 0));
+
+			FCFrameMoveModeTransitionTable Table;
+			Table.Compile(Modes, Links);
+
+			TEST_EQUAL(Table.Num(), 3);
+			TEST_EQUAL(Table.GetTransitions(0).Num(), 2);
+			TEST_EQUAL(Table.GetTransitions(1).Num(), 0);
+			TEST_EQUAL(Table.GetTransitions(2).Num(), 1);
+			TEST_EQUAL(Table.GetTransitions(0)[0].ToModeId, (uint8)2);
+			TEST_EQUAL(Table.GetTransitions(0)[1].ToModeId, (uint8)1);
+		});
+	});
+
+	Describe("Evaluate", [this]()
+	{
+		It("Should pick the first transition that passes its precheck and OnEvaluate", [this]()
+		{
+			TArray<TObjectPtr<UCFrameMovementMode>> Modes = MakeModes(3);
+			UCFrameMovementMode_Test* FromMode = CastChecked<UCFrameMovementMode_Test>(Modes[0]);
+
+			TArray<FCFrameModeTransitionLink> Links;
+			Links.Add(MakeLink(UCFrameMoveModeTransition_TestFlag::StaticClass(), 0, 2, 5));
+			Links.Add(MakeLink(UCFrameMoveModeTransition_TestDeltaTime::StaticClass(), 0, 1, 1));
+
+			FCFrameMoveModeTransitionTable Table;
+			Table.Compile(Modes, Links);
+
+			FCFrameMovementContext Context;
+			Context.CurrentMode = FromMode;
+			Context.DeltaTime = 1.0f / 30.0f;
+
+			TEST_EQUAL(Table.Evaluate(0, FromMode->GetModeFlags(), Context), CFrameMoveMode::InvalidId);
+
+			Context.DeltaTime = 2.0f;
+			TEST_EQUAL(Table.Evaluate(0, FromMode->GetModeFlags(), Context), (uint8)1);
+
+			FromMode->ModeFlags = ECFrameMoveModeFlags::OnWalkableFloor;
+			TEST_EQUAL(Table.Evaluate(0, FromMode->GetModeFlags(), Context), (uint8)2);
+
+			TEST_EQUAL(Table.Evaluate(1, ECFrameMoveModeFlags::None, Context), CFrameMoveMode::InvalidId);
+			TEST_EQUAL(Table.Evaluate(CFrameMoveMode::InvalidId, ECFrameMoveModeFlags::None, Context), CFrameMoveMode::InvalidId);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report name map and compiled table cost for 8 modes and 20 transitions", [this]()
+		{
+			const int32 ModeNum = 8;
+			const int32 TransitionNum = 20;
+			const int32 EvaluateNum = 1000 * 300;
+
+			TArray<TObjectPtr<UCFrameMovementMode>> Modes = MakeModes(ModeNum);
+
+			TArray<FCFrameModeTransitionLink> Links;
+			for (int32 Index = 0; Index < TransitionNum; ++Index)
+			{
+				TSubclassOf<UCFrameMoveModeTransition> TransitionClass = Index % 2 ? UCFrameMoveModeTransition_TestDeltaTime::StaticClass() : UCFrameMoveModeTransition_TestFlag::StaticClass();
+				Links.Add(MakeLink(TransitionClass, Index % ModeNum, (Index + 1) % ModeNum, Index));
+			}
+
+			// 原先的做法：按模式名查找，逐个调用 CDO 的 OnEvaluate
+			TMap<FName, TArray<FCFrameModeTransitionLink>> LinkMap;
+			{
+				TArray<FCFrameModeTransitionLink> SortedLinks = Links;
+				SortedLinks.Sort([](const FCFrameModeTransitionLink& A, const FCFrameModeTransitionLink& B) { return A.Priority > B.Priority; });
+				for (const FCFrameModeTransitionLink& Link : SortedLinks)
+				{
+					LinkMap.FindOrAdd(Link.FromMode).Add(Link);
+				}
+			}
+
+			FCFrameMoveModeTransitionTable Table;
+			Table.Compile(Modes, Links);
+			TEST_EQUAL(Table.Num(), TransitionNum);
+
+			// 稳定状态：没有转换成立
+			FCFrameMovementContext Context;
+			Context.DeltaTime = 1.0f / 30.0f;
+
+			int32 MapTransitionNum = 0;
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < EvaluateNum; ++Index)
+			{
+				const int32 ModeId = Index % ModeNum;
+				Context.CurrentMode = Modes[ModeId];
+
+				if (const TArray<FCFrameModeTransitionLink>* ModeLinks = LinkMap.Find(Modes[ModeId]->GetModeName()))
+				{
+					for (const FCFrameModeTransitionLink& Link : *ModeLinks)
+					{
+						if (Link.ModeTransition->GetDefaultObject<UCFrameMoveModeTransition>()->OnEvaluate(Context))
+						{
+							++MapTransitionNum;
+							break;
+						}
+					}
+				}
+			}
+			const double MapSeconds = FPlatformTime::Seconds() - StartTime;
+
+			int32 TableTransitionNum = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < EvaluateNum; ++Index)
+			{
+				const uint8 ModeId = (uint8)(Index % ModeNum);
+				Context.CurrentMode = Modes[ModeId];
+
+				if (Table.Evaluate(ModeId, Modes[ModeId]->GetModeFlags(), Context) != CFrameMoveMode::InvalidId)
+				{
+					++TableTransitionNum;
+				}
+			}
+			const double TableSeconds = FPlatformTime::Seconds() - StartTime;
+
+			TEST_EQUAL(MapTransitionNum, 0);
+			TEST_EQUAL(TableTransitionNum, 0);
+
+			AddInfo(FString::Printf(TEXT("Modes[%d] Transitions[%d] Evaluations[%d] NameMap %.2f ns/eval, CompiledTable %.2f ns/eval"),
+				ModeNum, TransitionNum, EvaluateNum, MapSeconds * 1.0e9 / EvaluateNum, TableSeconds * 1.0e9 / EvaluateNum));
+		});
+	});
+}
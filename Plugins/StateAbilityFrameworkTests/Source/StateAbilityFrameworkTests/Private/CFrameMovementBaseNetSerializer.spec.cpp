@@ -0,0 +1,165 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/SkeletalMesh.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Net/NetBitWriter.h"
+#include "Net/NetBitReader.h"
+
+#include "Component/Mover/MoveLibrary/CFrameMovementBaseNetSerializer.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const TCHAR* SkeletalBasePath = TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube");
+
+	USkeletalMeshComponent* MakeSkeletalBase()
+	{
+		USkeletalMesh* SkeletalMesh = LoadObject<USkeletalMesh>(nullptr, SkeletalBasePath);
+		if (!SkeletalMesh)
+		{
+			return nullptr;
+		}
+
+		USkeletalMeshComponent* SkeletalBase = NewObject<USkeletalMeshComponent>(GetTransientPackage());
+		SkeletalBase->SetSkeletalMeshAsset(SkeletalMesh);
+		return SkeletalBase;
+	}
+
+	// 原先的做法：直接传递 FName
+	int64 MeasureNameBits(FName BoneName)
+	{
+		FNetBitWriter Writer(nullptr, 0);
+		Writer.SetAllowResize(true);
+		Writer << BoneName;
+		return Writer.GetNumBits();
+	}
+
+	// 服务器以 ServerBase 写入，客户端以 ClientBase 读取
+	bool TransferBoneName(const UPrimitiveComponent* ServerBase, const UPrimitiveComponent* ClientBase, FName BoneName, FName& OutBoneName, int64& OutBits)
+	{
+		FNetBitWriter Writer(nullptr, 0);
+		Writer.SetAllowResize(true);
+		FCFrameMovementBaseNetSerializer::SerializeBoneName(Writer, ServerBase, BoneName);
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		const bool bMapped = FCFrameMovementBaseNetSerializer::SerializeBoneName(Reader, ClientBase, OutBoneName);
+
+		OutBits = Writer.GetNumBits();
+		return bMapped;
+	}
+
+	int64 MeasureBoneBits(const UPrimitiveComponent* MovementBase, FName BoneName, FName& OutBoneName)
+	{
+		int64 Bits = 0;
+		TransferBoneName(MovementBase, MovementBase, BoneName, OutBoneName, Bits);
+		return Bits;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameMovementBaseNetSerializerSpec, "StateAbilityFramework.Mover.BaseNetSerializer", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameMovementBaseNetSerializerSpec)
+
+void FCFrameMovementBaseNetSerializerSpec::Define()
+{
+	Describe("BoneName", [this]()
+	{
+		It("Should spend one bit when there is no bone", [this]()
+		{
+			FName OutBoneName = TEXT("Dummy");
+			TEST_EQUAL(MeasureBoneBits(nullptr, NAME_None, OutBoneName), (int64)1);
+			TEST_EQUAL(OutBoneName, FName(NAME_None));
+		});
+
+		It("Should fall back to the name when the base has no such bone", [this]()
+		{
+			const FName SocketName(TEXT("CFrameTestSocket"));
+
+			FName OutBoneName;
+			const int64 Bits = MeasureBoneBits(nullptr, SocketName, OutBoneName);
+
+			TEST_EQUAL(OutBoneName, SocketName);
+			TEST_EQUAL(Bits, MeasureNameBits(SocketName) + 2);
+		});
+
+		It("Should report the bone as unmapped instead of guessing when the client base differs", [this]()
+		{
+			USkeletalMeshComponent* SkeletalBase = MakeSkeletalBase();
+			if (!SkeletalBase)
+			{
+				AddWarning(FString::Printf(TEXT("%s not found, skipped."), SkeletalBasePath));
+				return;
+			}
+
+			const FName BoneName = SkeletalBase->GetBoneName(SkeletalBase->GetNumBones() - 1);
+			FName OutBoneName;
+			int64 Bits = 0;
+
+			TEST_TRUE(TransferBoneName(SkeletalBase, SkeletalBase, BoneName, OutBoneName, Bits));
+			TEST_EQUAL(OutBoneName, BoneName);
+
+			// 客户端尚未映射 MovementBase
+			OutBoneName = TEXT("Dummy");
+			TEST_FALSE(TransferBoneName(SkeletalBase, nullptr, BoneName, OutBoneName, Bits));
+			TEST_EQUAL(OutBoneName, FName(NAME_None));
+
+			// 客户端的 MovementBase 使用了不同的资源
+			USkeletalMeshComponent* OtherBase = NewObject<USkeletalMeshComponent>(GetTransientPackage());
+			OutBoneName = TEXT("Dummy");
+			TEST_FALSE(TransferBoneName(SkeletalBase, OtherBase, BoneName, OutBoneName, Bits));
+			TEST_EQUAL(OutBoneName, FName(NAME_None));
+		});
+	});
+
+	Describe("PacketSize", [this]()
+	{
+		It("Should send bone indices for movers standing on skeletal bases", [this]()
+		{
+			USkeletalMeshComponent* SkeletalBase = MakeSkeletalBase();
+			if (!SkeletalBase)
+			{
+				AddWarning(FString::Printf(TEXT("%s not found, skipped."), SkeletalBasePath));
+				return;
+			}
+
+			const int32 BoneNum = SkeletalBase->GetNumBones();
+			TEST_TRUE(BoneNum > 0);
+
+			const int32 MoverNum = 64;
+			int64 NameBits = 0;
+			int64 BoneBits = 0;
+			int32 MismatchNum = 0;
+			for (int32 Index = 0; Index < MoverNum; ++Index)
+			{
+				const FName BoneName = SkeletalBase->GetBoneName(Index % BoneNum);
+
+				FName OutBoneName;
+				BoneBits += MeasureBoneBits(SkeletalBase, BoneName, OutBoneName);
+				NameBits += MeasureNameBits(BoneName);
+
+				MismatchNum += OutBoneName == BoneName ? 0 : 1;
+			}
+
+			TEST_EQUAL(MismatchNum, 0);
+			// 骨骼数小于128时，IntPacked索引只占一个字节，另有16bit的资源校验值
+			if (BoneNum < 128)
+			{
+				TEST_TRUE(BoneBits <= MoverNum * (2 + 8 + 16));
+			}
+			TEST_TRUE(BoneBits < NameBits);
+
+			AddInfo(FString::Printf(TEXT("Movers[%d] Bones[%d] FName %.1f bits/mover, BoneIndex %.1f bits/mover"),
+				MoverNum, BoneNum, (double)NameBits / MoverNum, (double)BoneBits / MoverNum));
+		});
+	});
+}
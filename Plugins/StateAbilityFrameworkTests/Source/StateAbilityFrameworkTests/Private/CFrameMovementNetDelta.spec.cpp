@@ -0,0 +1,257 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+#include "Component/Mover/MoveLibrary/CFrameMovementNetState.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	struct FSimulatedMover
+	{
+		FCFrameMovementNetState State;
+		FCFrameMovementNetHistory ServerHistory;
+		FCFrameMovementNetHistory ClientHistory;
+		bool bIdle = false;
+	};
+
+	struct FNetDeltaReport
+	{
+		double FullBitsPerMover = 0.0;
+		double DeltaBitsPerMover = 0.0;
+		double MaxPositionError = 0.0;
+		int32 FailedNum = 0;
+	};
+
+	/**
+	 * 模拟 MoverNum 个移动组件同步 FrameNum 帧，客户端的确认落后 AckLag 帧。
+	 * 移动中的组件匀速前进并缓慢转向，静止的组件状态不变。
+	 */
+	FNetDeltaReport SimulateNetDelta(int32 MoverNum, int32 FrameNum, uint32 AckLag, float IdleRatio)
+	{
+		FRandomStream Random(0x0DE17A);
+		const FCFrameMovementQuantization Quantization;
+
+		TArray<FSimulatedMover> Movers;
+		Movers.SetNum(MoverNum);
+		for (FSimulatedMover& Mover : Movers)
+		{
+			Mover.bIdle = Random.FRand() < IdleRatio;
+			Mover.State.Location = FVector(Random.FRandRange(-100000.0, 100000.0), Random.FRandRange(-100000.0, 100000.0), 100.0);
+			Mover.State.Velocity = Mover.bIdle ? FVector::ZeroVector : FVector(Random.FRandRange(-600.0, 600.0), Random.FRandRange(-600.0, 600.0), 0.0);
+			Mover.State.Orientation = FRotator(0.0, Random.FRandRange(-180.0, 180.0), 0.0);
+		}
+
+		FNetDeltaReport Report;
+		int64 FullBits = 0;
+		int64 DeltaBits = 0;
+
+		for (uint32 Frame = 1; Frame <= (uint32)FrameNum; ++Frame)
+		{
+			const uint32 AckFrame = Frame > AckLag ? Frame - AckLag : 0;
+
+			for (FSimulatedMover& Mover : Movers)
+			{
+				Mover.State.Frame = Frame;
+				if (!Mover.bIdle)
+				{
+					Mover.State.Location += Mover.State.Velocity / 30.0;
+					Mover.State.Orientation.Yaw = FRotator::NormalizeAxis(Mover.State.Orientation.Yaw + 1.0);
+				}
+
+				FBitWriter FullWriter(0, true);
+				FCFrameMovementNetState FullState = Mover.State;
+				FCFrameMovementNetSerializer::NetSerialize(FullWriter, Quantization, FullState, Mover.ServerHistory, 0);
+				FullBits += FullWriter.GetNumBits();
+
+				FBitWriter Writer(0, true);
+				FCFrameMovementNetState ServerState = Mover.State;
+				FCFrameMovementNetSerializer::NetSerialize(Writer, Quantization, ServerState, Mover.ServerHistory, AckFrame);
+				Mover.ServerHistory.Record(ServerState);
+				DeltaBits += Writer.GetNumBits();
+
+				FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+				FCFrameMovementNetState ClientState;
+				ClientState.Frame = Frame;
+				if (!FCFrameMovementNetSerializer::NetSerialize(Reader, Quantization, ClientState, Mover.ClientHistory, 0))
+				{
+					++Report.FailedNum;
+					continue;
+				}
+				Mover.ClientHistory.Record(ClientState);
+
+				Report.MaxPositionError = FMath::Max(Report.MaxPositionError, (ClientState.Location - Mover.State.Location).GetAbsMax());
+			}
+		}
+
+		const double SampleNum = (double)MoverNum * FrameNum;
+		Report.FullBitsPerMover = FullBits / SampleNum;
+		Report.DeltaBitsPerMover = DeltaBits / SampleNum;
+		return Report;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameMovementNetDeltaSpec, "StateAbilityFramework.Mover.NetDelta", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameMovementNetDeltaSpec)
+
+void FCFrameMovementNetDeltaSpec::Define()
+{
+	Describe("History", [this]()
+	{
+		It("Should only find frames that are still in the ring", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameMovementNetHistory History;
+
+			FCFrameMovementNetState State;
+			State.Frame = 10;
+			History.Record(State);
+			TEST_TRUE(History.Find(10) != nullptr);
+			TEST_TRUE(History.Find(10 + FCFrameMovementNetHistory::Capacity) == nullptr);
+
+			State.Frame = 10 + FCFrameMovementNetHistory::Capacity;
+			History.Record(State);
+			TEST_TRUE(History.Find(10) == nullptr);
+
+			History.Reset();
+			TEST_TRUE(History.Find(10 + FCFrameMovementNetHistory::Capacity) == nullptr);
+		});
+	});
+
+	Describe("Serialize", [this]()
+	{
+		It("Should send a single bit set for an unchanged mover", EAsyncExecution::ThreadPool, [this]()
+		{
+			const FCFrameMovementQuantization Quantization;
+			FCFrameMovementNetHistory ServerHistory;
+			FCFrameMovementNetHistory ClientHistory;
+
+			FCFrameMovementNetState State;
+			State.Frame = 1;
+			State.Location = FVector(100.0, 200.0, 300.0);
+			State.Orientation = FRotator(0.0, 90.0, 0.0);
+
+			FBitWriter FullWriter(0, true);
+			FCFrameMovementNetSerializer::NetSerialize(FullWriter, Quantization, State, ServerHistory, 0);
+			ServerHistory.Record(State);
+
+			FBitReader FullReader(FullWriter.GetData(), FullWriter.GetNumBits());
+			FCFrameMovementNetState ClientState;
+			ClientState.Frame = 1;
+			TEST_TRUE(FCFrameMovementNetSerializer::NetSerialize(FullReader, Quantization, ClientState, ClientHistory, 0));
+			ClientHistory.Record(ClientState);
+
+			State.Frame = 2;
+			FBitWriter DeltaWriter(0, true);
+			FCFrameMovementNetSerializer::NetSerialize(DeltaWriter, Quantization, State, ServerHistory, 1);
+
+			// bDelta + FrameGap(8bit) + bUnchanged
+			TEST_EQUAL(DeltaWriter.GetNumBits(), (int64)10);
+
+			FBitReader DeltaReader(DeltaWriter.GetData(), DeltaWriter.GetNumBits());
+			FCFrameMovementNetState DeltaState;
+			DeltaState.Frame = 2;
+			TEST_TRUE(FCFrameMovementNetSerializer::NetSerialize(DeltaReader, Quantization, DeltaState, ClientHistory, 0));
+			TEST_EQUAL(DeltaState.Location, ClientState.Location);
+			TEST_EQUAL(DeltaState.Orientation, ClientState.Orientation);
+		});
+
+		It("Should fail to read a delta whose base frame the client does not have", EAsyncExecution::ThreadPool, [this]()
+		{
+			const FCFrameMovementQuantization Quantization;
+			FCFrameMovementNetHistory ServerHistory;
+			FCFrameMovementNetHistory ClientHistory;
+
+			FCFrameMovementNetState State;
+			State.Frame = 1;
+			ServerHistory.Record(State);
+
+			State.Frame = 2;
+			State.Velocity = FVector(10.0, 0.0, 0.0);
+			FBitWriter Writer(0, true);
+			FCFrameMovementNetSerializer::NetSerialize(Writer, Quantization, State, ServerHistory, 1);
+
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			FCFrameMovementNetState ClientState;
+			ClientState.Frame = 2;
+			TEST_FALSE(FCFrameMovementNetSerializer::NetSerialize(Reader, Quantization, ClientState, ClientHistory, 0));
+		});
+
+		It("Should send a full state on keyframes", EAsyncExecution::ThreadPool, [this]()
+		{
+			const FCFrameMovementQuantization Quantization;
+			FCFrameMovementNetHistory ServerHistory;
+
+			FCFrameMovementNetState State;
+			State.Frame = FCFrameMovementNetHistory::Capacity - 1;
+			ServerHistory.Record(State);
+
+			State.Frame = FCFrameMovementNetHistory::Capacity;
+			FBitWriter Writer(0, true);
+			FCFrameMovementNetSerializer::NetSerialize(Writer, Quantization, State, ServerHistory, State.Frame - 1);
+
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			bool bDelta = true;
+			Reader.SerializeBits(&bDelta, 1);
+			TEST_FALSE(bDelta);
+		});
+
+		It("Should stagger keyframes by the mover offset", EAsyncExecution::ThreadPool, [this]()
+		{
+			const FCFrameMovementQuantization Quantization;
+			const uint32 KeyframeOffset = 5;
+
+			// 每个帧号对应的是否为完整同步
+			auto IsFullState = [&Quantization, KeyframeOffset](uint32 Frame)
+			{
+				FCFrameMovementNetHistory ServerHistory;
+				FCFrameMovementNetState State;
+				State.Frame = Frame - 1;
+				ServerHistory.Record(State);
+
+				State.Frame = Frame;
+				FBitWriter Writer(0, true);
+				FCFrameMovementNetSerializer::NetSerialize(Writer, Quantization, State, ServerHistory, Frame - 1, KeyframeOffset);
+
+				FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+				bool bDelta = true;
+				Reader.SerializeBits(&bDelta, 1);
+				return !bDelta;
+			};
+
+			TEST_FALSE(IsFullState(FCFrameMovementNetHistory::Capacity));
+			TEST_TRUE(IsFullState(FCFrameMovementNetHistory::Capacity - KeyframeOffset));
+			TEST_TRUE(IsFullState(2 * FCFrameMovementNetHistory::Capacity - KeyframeOffset));
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report bits per mover for full and delta snapshots", EAsyncExecution::ThreadPool, [this]()
+		{
+			const int32 MoverNum = 1000;
+			const int32 FrameNum = 300;
+			const uint32 AckLag = 4;
+
+			const FNetDeltaReport Report = SimulateNetDelta(MoverNum, FrameNum, AckLag, 0.7f);
+
+			TEST_EQUAL(Report.FailedNum, 0);
+			TEST_TRUE(Report.MaxPositionError <= 0.01);
+			TEST_TRUE(Report.DeltaBitsPerMover < Report.FullBitsPerMover);
+
+			AddInfo(FString::Printf(TEXT("%d movers (70%% idle) x %d frames, ack lag %u: full %.1f bits/mover/frame, delta %.1f bits/mover/frame (%.1f%%)"),
+				MoverNum, FrameNum, AckLag, Report.FullBitsPerMover, Report.DeltaBitsPerMover, 100.0 * Report.DeltaBitsPerMover / Report.FullBitsPerMover));
+		});
+	});
+}
@@ -0,0 +1,81 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Component/Mover/CFrameMovementPersistentData.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+static_assert(FCFrameMovementPersistentSlots::IndexOf<FFloorCheckResult>() == 0, "Slot index must be known at compile time.");
+static_assert(FCFrameMovementPersistentSlots::IndexOf<FCFrameRelativeBaseInfo>() == 1, "Slot index must be known at compile time.");
+static_assert(FCFrameMovementPersistentSlots::OffsetOf<FFloorCheckResult>() % alignof(FFloorCheckResult) == 0, "Slot must be aligned.");
+static_assert(FCFrameMovementPersistentSlots::OffsetOf<FCFrameRelativeBaseInfo>() % alignof(FCFrameRelativeBaseInfo) == 0, "Slot must be aligned.");
+
+BEGIN_DEFINE_SPEC(FCFrameMovementPersistentDataSpec, "StateAbilityFramework.Mover.PersistentData", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameMovementPersistentDataSpec)
+
+void FCFrameMovementPersistentDataSpec::Define()
+{
+	Describe("Slot", [this]()
+	{
+		It("Should keep each slot invalid until it is set", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameMovementPersistentData PersistentData;
+			TEST_FALSE(PersistentData.IsValid<FFloorCheckResult>());
+			TEST_TRUE(PersistentData.Find<FCFrameRelativeBaseInfo>() == nullptr);
+
+			FCFrameRelativeBaseInfo BaseInfo;
+			BaseInfo.Location = FVector(1.0, 2.0, 3.0);
+			PersistentData.Set(BaseInfo);
+
+			TEST_TRUE(PersistentData.IsValid<FCFrameRelativeBaseInfo>());
+			TEST_FALSE(PersistentData.IsValid<FFloorCheckResult>());
+			TEST_TRUE(PersistentData.Find<FCFrameRelativeBaseInfo>() == &PersistentData.Get<FCFrameRelativeBaseInfo>());
+			TEST_EQUAL(PersistentData.Get<FCFrameRelativeBaseInfo>().Location, BaseInfo.Location);
+
+			PersistentData.Invalid<FCFrameRelativeBaseInfo>();
+			TEST_FALSE(PersistentData.IsValid<FCFrameRelativeBaseInfo>());
+		});
+	});
+
+	Describe("Rollback", [this]()
+	{
+		It("Should restore every slot and flag from a memcpy snapshot", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameMovementPersistentData PersistentData;
+
+			FFloorCheckResult FloorResult;
+			FloorResult.bBlockingHit = true;
+			FloorResult.bWalkableFloor = true;
+			FloorResult.FloorDist = 2.15f;
+			PersistentData.Set(FloorResult);
+
+			const FCFrameMovementPersistentData Snapshot = PersistentData;
+
+			FCFrameRelativeBaseInfo BaseInfo;
+			BaseInfo.Location = FVector(100.0);
+			PersistentData.Set(BaseInfo);
+			PersistentData.Get<FFloorCheckResult>().FloorDist = 10.0f;
+			PersistentData.Invalid<FFloorCheckResult>();
+
+			PersistentData = Snapshot;
+
+			TEST_TRUE(PersistentData.IsValid<FFloorCheckResult>());
+			TEST_FALSE(PersistentData.IsValid<FCFrameRelativeBaseInfo>());
+			TEST_EQUAL(PersistentData.Get<FFloorCheckResult>().FloorDist, 2.15f);
+			TEST_TRUE(PersistentData.Get<FFloorCheckResult>().IsWalkableFloor());
+
+			PersistentData.Reset();
+			TEST_FALSE(PersistentData.IsValid<FFloorCheckResult>());
+		});
+	});
+}
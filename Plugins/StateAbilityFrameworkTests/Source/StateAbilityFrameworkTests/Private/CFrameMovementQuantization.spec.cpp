@@ -0,0 +1,159 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+#include "Component/Mover/MoveLibrary/CFrameMovementQuantization.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	struct FQuantizationReport
+	{
+		double MaxPositionError = 0.0;
+		double MaxVelocityError = 0.0;
+		double MaxRotationError = 0.0;
+		int32 MaxBits = 0;
+		double AverageBits = 0.0;
+	};
+
+	/**
+	 * 在 Compact 的范围内（±8km，±300m/s）随机生成移动状态，写入再读出，统计最大误差和位数
+	 */
+	FQuantizationReport MeasureQuantization(const FCFrameMovementQuantization& Quantization, int32 SampleNum)
+	{
+		FRandomStream Random(0x51C0FFEE);
+
+		TArray<FVector> Locations;
+		TArray<FVector> Velocities;
+		TArray<FRotator> Orientations;
+		for (int32 Index = 0; Index < SampleNum; ++Index)
+		{
+			Locations.Add(FVector(Random.FRandRange(-800000.0, 800000.0), Random.FRandRange(-800000.0, 800000.0), Random.FRandRange(-20000.0, 20000.0)));
+			Velocities.Add(FVector(Random.FRandRange(-30000.0, 30000.0), Random.FRandRange(-30000.0, 30000.0), Random.FRandRange(-4000.0, 4000.0)));
+			Orientations.Add(FRotator(Random.FRandRange(-89.0, 89.0), Random.FRandRange(-180.0, 180.0), Random.FRandRange(-180.0, 180.0)));
+		}
+
+		FQuantizationReport Report;
+
+		FBitWriter Writer(0, true);
+		for (int32 Index = 0; Index < SampleNum; ++Index)
+		{
+			const int64 StartBits = Writer.GetNumBits();
+
+			FVector Location = Locations[Index];
+			FVector Velocity = Velocities[Index];
+			FRotator Orientation = Orientations[Index];
+			FCFrameMovementQuantizer::Serialize(Writer, Quantization, Location, Velocity, Orientation);
+
+			Report.MaxBits = FMath::Max(Report.MaxBits, (int32)(Writer.GetNumBits() - StartBits));
+		}
+		Report.AverageBits = (double)Writer.GetNumBits() / SampleNum;
+
+		const bool bYawOnly = Quantization.Profile == ECFrameMovementQuantizationProfile::Compact
+			|| (Quantization.Profile == ECFrameMovementQuantizationProfile::Custom && Quantization.bYawOnly);
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		for (int32 Index = 0; Index < SampleNum; ++Index)
+		{
+			FVector Location;
+			FVector Velocity;
+			FRotator Orientation;
+			FCFrameMovementQuantizer::Serialize(Reader, Quantization, Location, Velocity, Orientation);
+
+			Report.MaxPositionError = FMath::Max(Report.MaxPositionError, (Location - Locations[Index]).GetAbsMax());
+			Report.MaxVelocityError = FMath::Max(Report.MaxVelocityError, (Velocity - Velocities[Index]).GetAbsMax());
+
+			const FRotator RotationDelta = (Orientation - Orientations[Index]).GetNormalized();
+			const double RotationError = bYawOnly ? FMath::Abs(RotationDelta.Yaw) : FMath::Max3(FMath::Abs(RotationDelta.Pitch), FMath::Abs(RotationDelta.Yaw), FMath::Abs(RotationDelta.Roll));
+			Report.MaxRotationError = FMath::Max(Report.MaxRotationError, RotationError);
+		}
+
+		return Report;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameMovementQuantizationSpec, "StateAbilityFramework.Mover.Quantization", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameMovementQuantizationSpec)
+
+void FCFrameMovementQuantizationSpec::Define()
+{
+	Describe("Profile", [this]()
+	{
+		It("Should stay within half a quantization step for fixed profiles", EAsyncExecution::ThreadPool, [this]()
+		{
+			static_assert(FCFrameMovementQuantizer_Compact::NumBits == 3 * 24 + 3 * 16 + 12, "Compact profile layout changed.");
+
+			FCFrameMovementQuantization Quantization;
+
+			Quantization.Profile = ECFrameMovementQuantizationProfile::HighPrecision;
+			FQuantizationReport Report = MeasureQuantization(Quantization, 1000);
+			TEST_TRUE(Report.MaxPositionError <= 0.005 + UE_KINDA_SMALL_NUMBER);
+			TEST_TRUE(Report.MaxVelocityError <= 0.05 + UE_KINDA_SMALL_NUMBER);
+			TEST_EQUAL(Report.MaxBits, FCFrameMovementQuantizer_HighPrecision::NumBits);
+
+			Quantization.Profile = ECFrameMovementQuantizationProfile::Compact;
+			Report = MeasureQuantization(Quantization, 1000);
+			TEST_TRUE(Report.MaxPositionError <= 0.05 + UE_KINDA_SMALL_NUMBER);
+			TEST_TRUE(Report.MaxVelocityError <= 0.5 + UE_KINDA_SMALL_NUMBER);
+			TEST_TRUE(Report.MaxRotationError <= 360.0 / (1 << 12));
+			TEST_EQUAL(Report.MaxBits, FCFrameMovementQuantizer_Compact::NumBits);
+		});
+
+		It("Should clamp values outside the custom range instead of wrapping", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameMovementQuantization Quantization;
+			Quantization.Profile = ECFrameMovementQuantizationProfile::Custom;
+			Quantization.PositionScale = 1;
+			Quantization.PositionBits = 8;
+
+			FVector Location(1000.0, -1000.0, 12.0);
+			FVector Velocity = FVector::ZeroVector;
+			FRotator Orientation = FRotator::ZeroRotator;
+
+			FBitWriter Writer(0, true);
+			FCFrameMovementQuantizer::Serialize(Writer, Quantization, Location, Velocity, Orientation);
+
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			FCFrameMovementQuantizer::Serialize(Reader, Quantization, Location, Velocity, Orientation);
+
+			TEST_EQUAL(Location, FVector(127.0, -127.0, 12.0));
+		});
+	});
+
+	Describe("Report", [this]()
+	{
+		It("Should report worst case error and bits per snapshot for each profile", EAsyncExecution::ThreadPool, [this]()
+		{
+			const int32 SampleNum = 10000;
+
+			const UEnum* ProfileEnum = StaticEnum<ECFrameMovementQuantizationProfile>();
+			for (int32 ProfileIndex = 0; ProfileIndex <= (int32)ECFrameMovementQuantizationProfile::Custom; ++ProfileIndex)
+			{
+				FCFrameMovementQuantization Quantization;
+				Quantization.Profile = (ECFrameMovementQuantizationProfile)ProfileIndex;
+
+				const FQuantizationReport Report = MeasureQuantization(Quantization, SampleNum);
+
+				AddInfo(FString::Printf(TEXT("%s: Position %.4f cm, Velocity %.4f cm/s, Rotation %.4f deg, Bits avg %.1f max %d"),
+					*ProfileEnum->GetNameStringByValue(ProfileIndex),
+					Report.MaxPositionError,
+					Report.MaxVelocityError,
+					Report.MaxRotationError,
+					Report.AverageBits,
+					Report.MaxBits));
+			}
+		});
+	});
+}
@@ -0,0 +1,165 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+#include "Component/Mover/CFrameMovementTrace.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	FCFrameMovementTraceEvent MakeTraceEvent(uint32 Frame, uint32 EntityIndex, uint8 ModeId)
+	{
+		FCFrameMovementTraceEvent Event;
+		Event.Frame = Frame;
+		Event.EntityIndex = EntityIndex;
+		Event.ModeId = ModeId;
+		Event.Position = FVector(Frame, EntityIndex, 88.0);
+		Event.Velocity = FVector(600.0, 0.0, 0.0);
+		return Event;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameMovementTraceSpec, "StateAbilityFramework.Mover.Trace", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameMovementTraceSpec)
+
+void FCFrameMovementTraceSpec::Define()
+{
+	Describe("RingBuffer", [this]()
+	{
+		It("Should keep the newest events in order after wrapping", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameMovementTrace Trace(6);
+			TEST_EQUAL(Trace.GetCapacity(), 8);
+
+			for (uint32 Frame = 0; Frame < 11; ++Frame)
+			{
+				Trace.Record(MakeTraceEvent(Frame, 0, 0));
+			}
+
+			TArray<FCFrameMovementTraceEvent> Events;
+			Trace.CopyEvents(Events);
+
+			TEST_EQUAL(Events.Num(), 8);
+			TEST_EQUAL(Events[0].Frame, 3u);
+			TEST_EQUAL(Events.Last().Frame, 10u);
+
+			Trace.Reset();
+			TEST_EQUAL(Trace.Num(), 0);
+		});
+
+		It("Should map mode names to stable ids", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameMovementTrace Trace(8);
+			const uint8 WalkingId = Trace.GetModeId(TEXT("Walking"));
+			const uint8 FallingId = Trace.GetModeId(TEXT("Falling"));
+
+			TEST_TRUE(WalkingId != FallingId);
+			TEST_EQUAL(Trace.GetModeId(TEXT("Walking")), WalkingId);
+			TEST_EQUAL(Trace.GetModeName(FallingId), FName(TEXT("Falling")));
+		});
+	});
+
+	Describe("File", [this]()
+	{
+		It("Should load the same events and mode names it saved", [this]()
+		{
+			FCFrameMovementTrace Trace(16);
+			const uint8 WalkingId = Trace.GetModeId(TEXT("Walking"));
+			const uint8 FallingId = Trace.GetModeId(TEXT("Falling"));
+
+			for (uint32 Frame = 0; Frame < 4; ++Frame)
+			{
+				Trace.Record(MakeTraceEvent(Frame, 7, Frame % 2 ? FallingId : WalkingId));
+			}
+
+			const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("CFrameMovementTraceSpec.cfmtrace"));
+			TEST_TRUE(Trace.SaveToFile(FilePath));
+
+			TArray<FCFrameMovementTraceEvent> Events;
+			TArray<FName> ModeNames;
+			TEST_TRUE(FCFrameMovementTrace::LoadFromFile(FilePath, Events, ModeNames));
+
+			TEST_EQUAL(Events.Num(), 4);
+			TEST_EQUAL(ModeNames.Num(), 2);
+			if (Events.Num() == 4 && ModeNames.Num() == 2)
+			{
+				TEST_EQUAL(Events[3].Frame, 3u);
+				TEST_EQUAL(Events[3].EntityIndex, 7u);
+				TEST_EQUAL(Events[3].Position, FVector(3.0, 7.0, 88.0));
+				TEST_EQUAL(ModeNames[Events[3].ModeId], FName(TEXT("Falling")));
+			}
+
+			IFileManager::Get().Delete(*FilePath);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report per mover overhead of trace off, trace on and formatted logging", [this]()
+		{
+			const int32 MoverNum = 1000;
+			const int32 FrameNum = 300;
+
+			FCFrameMovementTrace Trace(MoverNum * FrameNum);
+			const uint8 ModeId = Trace.GetModeId(TEXT("Walking"));
+			volatile bool bTraceEnabled = false;
+
+			auto Run = [&](auto&& Body)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+				{
+					for (int32 Index = 0; Index < MoverNum; ++Index)
+					{
+						Body(Frame, Index);
+					}
+				}
+				return (FPlatformTime::Seconds() - StartTime) * 1.0e9 / (MoverNum * FrameNum);
+			};
+
+			// 关闭时只剩一次分支判断
+			const double OffNs = Run([&](int32 Frame, int32 Index)
+			{
+				if (bTraceEnabled)
+				{
+					Trace.Record(MakeTraceEvent(Frame, Index, ModeId));
+				}
+			});
+
+			bTraceEnabled = true;
+			const double OnNs = Run([&](int32 Frame, int32 Index)
+			{
+				if (bTraceEnabled)
+				{
+					Trace.Record(MakeTraceEvent(Frame, Index, ModeId));
+				}
+			});
+
+			// 原先每帧 UE_LOG 的格式化开销，不含输出设备
+			int32 FormattedLength = 0;
+			const double FormatNs = Run([&](int32 Frame, int32 Index)
+			{
+				const FCFrameMovementTraceEvent Event = MakeTraceEvent(Frame, Index, ModeId);
+				FormattedLength += FString::Printf(TEXT("[Server] RCF[%d] Location[%s]"), Event.Frame, *(Event.Position.ToCompactString())).Len();
+			});
+
+			TEST_EQUAL(Trace.Num(), MoverNum * FrameNum);
+			TEST_TRUE(FormattedLength > 0);
+
+			AddInfo(FString::Printf(TEXT("Movers[%d] Frames[%d] TraceOff %.2f ns/move, TraceOn %.2f ns/move, FormattedLog %.2f ns/move"),
+				MoverNum, FrameNum, OffNs, OnNs, FormatNs));
+		});
+	});
+}
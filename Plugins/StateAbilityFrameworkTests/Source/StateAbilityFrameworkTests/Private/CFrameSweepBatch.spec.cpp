@@ -0,0 +1,247 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Component/Mover/MoveLibrary/CFrameSweepBatch.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	enum class ESweepQueryMode : uint8
+	{
+		None,			// 不预查询，全部串行扫掠
+		SingleThread,
+		Parallel,
+	};
+
+	/**
+	 * 只有球体的解析世界，代替物理场景：Mover 按注册顺序移动，被阻挡时停在接触点并反弹
+	 */
+	struct FSphereWorld
+	{
+		static constexpr double MoverRadius = 40.0;
+		static constexpr double ObstacleRadius = 100.0;
+		static constexpr double DeltaTime = 1.0 / 30.0;
+
+		TArray<FVector> Obstacles;
+		TArray<FVector> Movers;
+		TArray<FVector> Velocities;
+
+		int32 ClearNum = 0;
+		int32 FallbackNum = 0;
+
+		explicit FSphereWorld(int32 Seed)
+		{
+			FRandomStream RandomStream(Seed);
+			for (int32 Index = 0; Index < 64; ++Index)
+			{
+				Obstacles.Add(FVector(RandomStream.FRandRange(-2000.0, 2000.0), RandomStream.FRandRange(-2000.0, 2000.0), 0.0));
+			}
+			for (int32 Index = 0; Index < 256; ++Index)
+			{
+				Movers.Add(FVector(RandomStream.FRandRange(-2000.0, 2000.0), RandomStream.FRandRange(-2000.0, 2000.0), 0.0));
+				Velocities.Add(FVector(RandomStream.FRandRange(-600.0, 600.0), RandomStream.FRandRange(-600.0, 600.0), 0.0));
+			}
+		}
+
+		// 移动球与静止球的首次接触时间，起始重叠为 0，无接触为 1
+		static double SweepSphere(const FVector& Start, const FVector& Delta, const FVector& Center, double Radius)
+		{
+			const FVector Offset = Start - Center;
+			const double A = Delta | Delta;
+			const double B = 2.0 * (Offset | Delta);
+			const double C = (Offset | Offset) - FMath::Square(MoverRadius + Radius);
+
+			if (C <= 0.0)
+			{
+				return 0.0;
+			}
+
+			const double Discriminant = B * B - 4.0 * A * C;
+			if (A <= 0.0 || Discriminant < 0.0)
+			{
+				return 1.0;
+			}
+
+			const double Time = (-B - FMath::Sqrt(Discriminant)) / (2.0 * A);
+			return (Time >= 0.0 && Time < 1.0) ? Time : 1.0;
+		}
+
+		double Sweep(int32 MoverIndex, const FVector& Start, const FVector& Delta) const
+		{
+			double Time = 1.0;
+			for (const FVector& Obstacle : Obstacles)
+			{
+				Time = FMath::Min(Time, SweepSphere(Start, Delta, Obstacle, ObstacleRadius));
+			}
+			for (int32 Index = 0; Index < Movers.Num(); ++Index)
+			{
+				if (Index != MoverIndex)
+				{
+					Time = FMath::Min(Time, SweepSphere(Start, Delta, Movers[Index], MoverRadius));
+				}
+			}
+			return Time;
+		}
+
+		void Tick(FCFrameSweepBatch& SweepBatch, ESweepQueryMode QueryMode, int32 MinBatchSize)
+		{
+			SweepBatch.Reset();
+			for (int32 Index = 0; Index < Movers.Num(); ++Index)
+			{
+				FCFrameSweepRequest Request;
+				Request.Start = Movers[Index];
+				Request.Delta = Velocities[Index] * DeltaTime;
+				Request.Shape = FCollisionShape::MakeSphere(MoverRadius);
+				SweepBatch.Add(Request);
+			}
+
+			//////////////////////////////////////////////////////////////////////////
+			// Query：只读帧开始时的位置
+			if (QueryMode != ESweepQueryMode::None)
+			{
+				const FCFrameSweepRequest* FirstRequest = &SweepBatch.GetRequest(0);
+				SweepBatch.Query([this, FirstRequest](const FCFrameSweepRequest& Request)
+				{
+					const int32 MoverIndex = UE_PTRDIFF_TO_INT32(&Request - FirstRequest);
+					return Sweep(MoverIndex, Request.Start, Request.Delta) >= 1.0;
+				}, MinBatchSize, QueryMode == ESweepQueryMode::SingleThread);
+			}
+
+			//////////////////////////////////////////////////////////////////////////
+			// Commit：按注册顺序
+			for (int32 Index = 0; Index < Movers.Num(); ++Index)
+			{
+				const FVector Start = Movers[Index];
+				const FVector Delta = Velocities[Index] * DeltaTime;
+
+				if (QueryMode != ESweepQueryMode::None && SweepBatch.IsClearSweep(Index, Start, Delta))
+				{
+					Movers[Index] = Start + Delta;
+					++ClearNum;
+				}
+				else
+				{
+					const double Time = Sweep(Index, Start, Delta);
+					Movers[Index] = Start + Delta * Time;
+					if (Time < 1.0)
+					{
+						Velocities[Index] = -Velocities[Index];
+					}
+					++FallbackNum;
+				}
+
+				if (Movers[Index] != Start)
+				{
+					SweepBatch.NotifyCommitted(FBox(Movers[Index] - FVector(MoverRadius), Movers[Index] + FVector(MoverRadius)));
+				}
+			}
+		}
+	};
+
+	TArray<FVector> Simulate(ESweepQueryMode QueryMode, int32 MinBatchSize, int32& OutClearNum, int32& OutFallbackNum)
+	{
+		FSphereWorld World(2024);
+		FCFrameSweepBatch SweepBatch;
+
+		for (int32 Frame = 0; Frame < 90; ++Frame)
+		{
+			World.Tick(SweepBatch, QueryMode, MinBatchSize);
+		}
+
+		OutClearNum = World.ClearNum;
+		OutFallbackNum = World.FallbackNum;
+
+		TArray<FVector> Result = World.Movers;
+		Result.Append(World.Velocities);
+		return Result;
+	}
+
+	bool IsBitwiseEqual(const TArray<FVector>& A, const TArray<FVector>& B)
+	{
+		return A.Num() == B.Num() && FMemory::Memcmp(A.GetData(), B.GetData(), A.Num() * sizeof(FVector)) == 0;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameSweepBatchSpec, "StateAbilityFramework.Mover.SweepBatch", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameSweepBatchSpec)
+
+void FCFrameSweepBatchSpec::Define()
+{
+	Describe("Commit", [this]()
+	{
+		It("Should invalidate a clear query overlapped by an earlier commit", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCFrameSweepBatch SweepBatch;
+
+			FCFrameSweepRequest Request;
+			Request.Start = FVector(0.0, 0.0, 0.0);
+			Request.Delta = FVector(100.0, 0.0, 0.0);
+			Request.Shape = FCollisionShape::MakeSphere(40.0);
+			SweepBatch.Add(Request);
+
+			SweepBatch.Query([](const FCFrameSweepRequest&) { return true; }, 1, true);
+			TEST_EQUAL(SweepBatch.GetClearNum(), 1);
+
+			TEST_TRUE(SweepBatch.IsClearSweep(0, Request.Start, Request.Delta));
+			TEST_FALSE(SweepBatch.IsClearSweep(0, Request.Start + FVector(1.0, 0.0, 0.0), Request.Delta));
+			TEST_FALSE(SweepBatch.IsClearSweep(0, Request.Start, Request.Delta * 0.5));
+
+			// 远处的提交不影响
+			SweepBatch.NotifyCommitted(FBox(FVector(1000.0), FVector(1080.0)));
+			TEST_TRUE(SweepBatch.IsClearSweep(0, Request.Start, Request.Delta));
+
+			// 落在路径上的提交使预查询失效
+			SweepBatch.NotifyCommitted(FBox(FVector(60.0, -40.0, -40.0), FVector(140.0, 40.0, 40.0)));
+			TEST_FALSE(SweepBatch.IsClearSweep(0, Request.Start, Request.Delta));
+
+			SweepBatch.Reset();
+			TEST_EQUAL(SweepBatch.Num(), 0);
+			TEST_FALSE(SweepBatch.IsClearSweep(0, Request.Start, Request.Delta));
+		});
+	});
+
+	Describe("Determinism", [this]()
+	{
+		It("Should produce the same bits regardless of thread count", EAsyncExecution::ThreadPool, [this]()
+		{
+			int32 SerialClearNum = 0, SerialFallbackNum = 0;
+			const TArray<FVector> Serial = Simulate(ESweepQueryMode::None, 1, SerialClearNum, SerialFallbackNum);
+
+			int32 SingleClearNum = 0, SingleFallbackNum = 0;
+			const TArray<FVector> SingleThread = Simulate(ESweepQueryMode::SingleThread, 1, SingleClearNum, SingleFallbackNum);
+
+			int32 FineClearNum = 0, FineFallbackNum = 0;
+			const TArray<FVector> ParallelFine = Simulate(ESweepQueryMode::Parallel, 1, FineClearNum, FineFallbackNum);
+
+			int32 CoarseClearNum = 0, CoarseFallbackNum = 0;
+			const TArray<FVector> ParallelCoarse = Simulate(ESweepQueryMode::Parallel, 64, CoarseClearNum, CoarseFallbackNum);
+
+			// 两条路径都要覆盖到，否则比较没有意义
+			TEST_TRUE(SingleClearNum > 0);
+			TEST_TRUE(SingleFallbackNum > 0);
+
+			TEST_TRUE(IsBitwiseEqual(Serial, SingleThread));
+			TEST_TRUE(IsBitwiseEqual(SingleThread, ParallelFine));
+			TEST_TRUE(IsBitwiseEqual(SingleThread, ParallelCoarse));
+
+			// 走快速路径的数量也与线程数无关
+			TEST_EQUAL(FineClearNum, SingleClearNum);
+			TEST_EQUAL(CoarseClearNum, SingleClearNum);
+			TEST_EQUAL(FineFallbackNum, SingleFallbackNum);
+			TEST_EQUAL(CoarseFallbackNum, SingleFallbackNum);
+
+			AddInfo(FString::Printf(TEXT("Frames[90] Movers[256] Clear[%d] Fallback[%d]"), SingleClearNum, SingleFallbackNum));
+		});
+	});
+}
@@ -0,0 +1,191 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Component/Mover/MoveLibrary/CFrameVelocityBatch.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	/**
+	 * 覆盖 ComputeVelocity 的各个分支：无输入制动、超速、输入超过1、静止等
+	 */
+	FCFrameComputeVelocityParams MakeRandomParams(FRandomStream& RandomStream)
+	{
+		FCFrameComputeVelocityParams Params;
+		Params.DeltaSeconds = RandomStream.FRand() < 0.9f ? 1.0f / 30.0f : RandomStream.FRandRange(0.0f, 0.1f);
+		Params.MaxSpeed = RandomStream.FRandRange(0.0f, 1200.0f);
+		Params.TurningBoost = RandomStream.FRandRange(0.0f, 16.0f);
+		Params.Friction = RandomStream.FRandRange(0.0f, 16.0f);
+		Params.Deceleration = RandomStream.FRandRange(0.0f, 8000.0f);
+		Params.Acceleration = RandomStream.FRandRange(-4000.0f, 4000.0f);
+
+		const float InputCase = RandomStream.FRand();
+		if (InputCase < 0.2f)
+		{
+			Params.MoveDirectionIntent = FVector::ZeroVector;
+		}
+		else if (InputCase < 0.4f)
+		{
+			Params.MoveDirectionIntent = RandomStream.VRand() * RandomStream.FRandRange(1.0f, 3.0f);
+		}
+		else
+		{
+			Params.MoveDirectionIntent = RandomStream.VRand() * RandomStream.FRand();
+		}
+
+		const float VelocityCase = RandomStream.FRand();
+		if (VelocityCase < 0.1f)
+		{
+			Params.InitialVelocity = FVector::ZeroVector;
+		}
+		else if (VelocityCase < 0.3f)
+		{
+			Params.InitialVelocity = RandomStream.VRand() * Params.MaxSpeed * RandomStream.FRandRange(1.0f, 2.0f);
+		}
+		else
+		{
+			Params.InitialVelocity = RandomStream.VRand() * RandomStream.FRandRange(0.0f, Params.MaxSpeed);
+		}
+
+		return Params;
+	}
+
+	bool IsBitwiseEqual(const FVector& A, const FVector& B)
+	{
+		return FMemory::Memcmp(&A, &B, sizeof(FVector)) == 0;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCFrameVelocityBatchSpec, "StateAbilityFramework.Mover.VelocityBatch", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCFrameVelocityBatchSpec)
+
+void FCFrameVelocityBatchSpec::Define()
+{
+	Describe("Compute", [this]()
+	{
+		It("Should match FCFrameMovementUtils::ComputeVelocity bit for bit", EAsyncExecution::ThreadPool, [this]()
+		{
+			// 故意不对齐 LaneNum，覆盖尾部填充
+			const int32 MoverNum = 4099;
+
+			FRandomStream RandomStream(4096);
+			TArray<FCFrameComputeVelocityParams> Params;
+			FCFrameVelocityBatch VelocityBatch;
+
+			for (int32 Index = 0; Index < MoverNum; ++Index)
+			{
+				Params.Add(MakeRandomParams(RandomStream));
+				TEST_EQUAL(VelocityBatch.Add(Params.Last()), Index);
+			}
+
+			VelocityBatch.Compute();
+
+			int32 MismatchNum = 0;
+			for (int32 Index = 0; Index < MoverNum; ++Index)
+			{
+				const FVector Expected = FCFrameMovementUtils::ComputeVelocity(Params[Index]);
+				const FVector Actual = VelocityBatch.GetVelocity(Index);
+				if (!IsBitwiseEqual(Expected, Actual))
+				{
+					if (MismatchNum == 0)
+					{
+						AddError(FString::Printf(TEXT("Mover[%d] Expected[%s] Actual[%s]"), Index, *Expected.ToString(), *Actual.ToString()));
+					}
+					++MismatchNum;
+				}
+			}
+
+			TEST_EQUAL(MismatchNum, 0);
+		});
+
+		It("Should reuse the batch after Reset", EAsyncExecution::ThreadPool, [this]()
+		{
+			FRandomStream RandomStream(8192);
+			FCFrameVelocityBatch VelocityBatch;
+
+			for (int32 Round = 0; Round < 3; ++Round)
+			{
+				VelocityBatch.Reset();
+				TEST_EQUAL(VelocityBatch.Num(), 0);
+
+				const FCFrameComputeVelocityParams Params = MakeRandomParams(RandomStream);
+				TEST_EQUAL(VelocityBatch.Add(Params), 0);
+
+				VelocityBatch.Compute();
+				TEST_TRUE(IsBitwiseEqual(VelocityBatch.GetVelocity(0), FCFrameMovementUtils::ComputeVelocity(Params)));
+			}
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report scalar and batched time for 1k movers", EAsyncExecution::ThreadPool, [this]()
+		{
+			const int32 MoverNum = 1000;
+			const int32 FrameNum = 300;
+
+			FRandomStream RandomStream(1024);
+			TArray<FCFrameComputeVelocityParams> Params;
+			for (int32 Index = 0; Index < MoverNum; ++Index)
+			{
+				Params.Add(MakeRandomParams(RandomStream));
+			}
+
+			// 标量：与各Mover逐个调用 ComputeVelocity 相同
+			TArray<FVector> ScalarVelocities;
+			ScalarVelocities.SetNumUninitialized(MoverNum);
+
+			double ScalarSeconds = 0.0;
+			for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < MoverNum; ++Index)
+				{
+					ScalarVelocities[Index] = FCFrameMovementUtils::ComputeVelocity(Params[Index]);
+				}
+				ScalarSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			// 批量：包含收集和写回的开销
+			TArray<FVector> BatchedVelocities;
+			BatchedVelocities.SetNumUninitialized(MoverNum);
+			FCFrameVelocityBatch VelocityBatch;
+
+			double BatchedSeconds = 0.0;
+			for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				VelocityBatch.Reset();
+				for (int32 Index = 0; Index < MoverNum; ++Index)
+				{
+					VelocityBatch.Add(Params[Index]);
+				}
+				VelocityBatch.Compute();
+				for (int32 Index = 0; Index < MoverNum; ++Index)
+				{
+					BatchedVelocities[Index] = VelocityBatch.GetVelocity(Index);
+				}
+				BatchedSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			TEST_TRUE(FMemory::Memcmp(ScalarVelocities.GetData(), BatchedVelocities.GetData(), MoverNum * sizeof(FVector)) == 0);
+
+			AddInfo(FString::Printf(TEXT("Movers[%d] Scalar %.4f ms/frame, Batched %.4f ms/frame, Speedup %.2fx"),
+				MoverNum,
+				ScalarSeconds * 1000.0 / FrameNum,
+				BatchedSeconds * 1000.0 / FrameNum,
+				BatchedSeconds > 0.0 ? ScalarSeconds / BatchedSeconds : 0.0));
+		});
+	});
+}
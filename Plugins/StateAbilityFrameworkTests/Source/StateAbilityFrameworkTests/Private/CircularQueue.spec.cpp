@@ -0,0 +1,168 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Buffer/CircularQueueCore.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	struct FCircularQueueTestFrame
+	{
+		uint32 CommandFrame = 0;
+		TArray<int32> Items;
+
+		void AddItem(const int32& Key, const int32& ItemData)
+		{
+			Items.Add(ItemData);
+		}
+		uint8* AllocateItem(const int32& Key, uint32 DataSize)
+		{
+			return (uint8*)(Items.GetData() + Items.AddUninitialized(DataSize));
+		}
+		void Reset(uint32 InCommandFrame)
+		{
+			CommandFrame = InCommandFrame;
+			Items.Reset();
+		}
+		bool Verify(uint32 InCommandFrame)
+		{
+			if (CommandFrame != InCommandFrame)
+			{
+				Reset(InCommandFrame);
+				return false;
+			}
+			return true;
+		}
+	};
+
+	using FCircularQueueTest = TJOwnerShipCircularQueue<FCircularQueueTestFrame, int32, int32>;
+}
+
+BEGIN_DEFINE_SPEC(FCircularQueueSpec, "StateAbilityFramework.Buffer.CircularQueue", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCircularQueueSpec)
+
+void FCircularQueueSpec::Define()
+{
+	Describe("OwnerShip", [this]()
+	{
+		It("Should count every owner of the same frame", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCircularQueueTest Queue(32);
+
+			for (uint32 Frame = 1; Frame <= 4; ++Frame)
+			{
+				for (int32 Owner = 0; Owner < 70; ++Owner)
+				{
+					TEST_TRUE(Queue.RecordItemData(Owner, Owner, Frame));
+				}
+			}
+
+			TEST_FALSE(Queue.RecordItemData(3, 3, 4));
+			TEST_EQUAL(Queue.Count(0), 4u);
+			TEST_EQUAL(Queue.Count(69), 4u);
+			TEST_EQUAL(Queue.Count(70), 0u);
+		});
+
+		It("Should only release the owners of acked frames", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCircularQueueTest Queue(32);
+
+			for (uint32 Frame = 1; Frame <= 8; ++Frame)
+			{
+				Queue.RecordItemData(0, 0, Frame);
+				if (Frame & 1)
+				{
+					Queue.RecordItemData(1, 1, Frame);
+				}
+			}
+
+			Queue.AckData(4);
+			TEST_EQUAL(Queue.Count(0), 4u);
+			TEST_EQUAL(Queue.Count(1), 2u);
+
+			Queue.AckNextData();
+			TEST_EQUAL(Queue.Count(0), 3u);
+			TEST_EQUAL(Queue.Count(1), 1u);
+
+			Queue.AckData(8);
+			TEST_TRUE(Queue.IsEmpty(0));
+			TEST_TRUE(Queue.IsEmpty(1));
+		});
+
+		It("Should drop the owners of overwritten frames", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCircularQueueTest Queue(32);
+
+			Queue.RecordItemData(0, 0, 1);
+			Queue.RecordItemData(1, 1, 1);
+			Queue.RecordItemData(0, 0, 100);
+
+			TEST_EQUAL(Queue.Count(0), 1u);
+			TEST_EQUAL(Queue.Count(1), 0u);
+		});
+
+		It("Should release the slot of an owner once its last frame is overwritten", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCircularQueueTest Queue(32);
+
+			// 每个Owner只写入一帧，环形缓冲绕过之后旧Owner不再占用槽位
+			for (uint32 Frame = 1; Frame <= 1000; ++Frame)
+			{
+				TEST_TRUE(Queue.RecordItemData((int32)Frame, (int32)Frame, Frame));
+			}
+
+			TEST_TRUE(Queue.GetOwnerNum() <= 64);
+			TEST_EQUAL(Queue.Count(1), 0u);
+			TEST_EQUAL(Queue.Count(1000), 1u);
+
+			// 复用的槽位不继承旧Owner的掩码
+			TEST_TRUE(Queue.RecordItemData(1, 1, 1001));
+			TEST_EQUAL(Queue.Count(1), 1u);
+			TEST_EQUAL(Queue.Count(999), 1u);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report AckData cost for 1/16/64/256 owners", EAsyncExecution::ThreadPool, [this]()
+		{
+			const int32 OwnerNums[] = { 1, 16, 64, 256 };
+			const uint32 FrameNum = 20000;
+
+			for (const int32 OwnerNum : OwnerNums)
+			{
+				FCircularQueueTest Queue(32);
+				double AckSeconds = 0.0;
+
+				for (uint32 Frame = 1; Frame <= FrameNum; ++Frame)
+				{
+					for (int32 Owner = 0; Owner < OwnerNum; ++Owner)
+					{
+						Queue.RecordItemData(Owner, Owner, Frame);
+					}
+
+					if (Frame > 16)
+					{
+						const double StartTime = FPlatformTime::Seconds();
+						Queue.AckData(Frame - 16);
+						AckSeconds += FPlatformTime::Seconds() - StartTime;
+					}
+				}
+
+				TEST_EQUAL(Queue.Count(OwnerNum - 1), 16u);
+				AddInfo(FString::Printf(TEXT("Owners[%d] Ring[32] AckData %.1f ns/op"), OwnerNum, AckSeconds * 1e9 / (FrameNum - 16)));
+			}
+		});
+	});
+}
@@ -0,0 +1,177 @@
+#include "CommandFrameChecksumTest.h"
+
+#include "Misc/AutomationTest.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "Buffer/BufferTypes.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const float ChecksumDeltaTime = 1.0f / 30.0f;
+
+	// 确定性的固定帧模拟：重力、跳跃、摩擦
+	void StepState(FCommandFrameChecksumTestState& State, uint32 Frame)
+	{
+		if (!State.bIsFalling && Frame % 45 == 0)
+		{
+			State.Velocity.Z = 600.0f;
+			State.bIsFalling = true;
+			++State.JumpCount;
+		}
+
+		const FVector Input(FMath::Cos(Frame * 0.05f), FMath::Sin(Frame * 0.05f), 0.0f);
+		State.Velocity += Input * 2000.0f * ChecksumDeltaTime;
+		State.Velocity.X *= 0.9f;
+		State.Velocity.Y *= 0.9f;
+
+		if (State.bIsFalling)
+		{
+			State.Velocity.Z -= 980.0f * ChecksumDeltaTime;
+		}
+
+		State.Location += State.Velocity * ChecksumDeltaTime;
+		if (State.Location.Z <= 0.0f)
+		{
+			State.Location.Z = 0.0f;
+			State.Velocity.Z = 0.0f;
+			State.bIsFalling = false;
+		}
+
+		State.Orientation = State.Velocity.Rotation();
+		State.Stamina = FMath::Clamp(State.Stamina - (State.bIsFalling ? 0.5f : -0.25f), 0.0f, 100.0f);
+	}
+
+	uint64 CalcStateChecksum(const FCommandFrameChecksumTestState& State, uint32 EntityIndex, uint32 Frame)
+	{
+		FCommandFrameAttributeSnapshot Snapshot;
+		Snapshot.Reset(Frame);
+
+		const FCommandFrameSnapshotKey Key(FCommandFrameChecksumTestState::StaticStruct(), EntityIndex);
+		Snapshot.AddItem(Key, (const uint8*)&State);
+
+		return Snapshot.CalcChecksum(MakeArrayView(&Key, 1));
+	}
+
+	// 相邻的下一个可表示的浮点数
+	double NextULP(double Value)
+	{
+		return FMath::IsNegativeOrNegativeZero(Value) ? std::nextafter(Value, -DBL_MAX) : std::nextafter(Value, DBL_MAX);
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCommandFrameChecksumSpec, "StateAbilityFramework.Net.SnapshotChecksum", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCommandFrameChecksumSpec)
+
+void FCommandFrameChecksumSpec::Define()
+{
+	Describe("Checksum", [this]()
+	{
+		It("Should only depend on comparable values", [this]()
+		{
+			FCommandFrameChecksumTestState State;
+			State.Location = FVector(100.0f, 0.0f, 0.0f);
+			State.MovementBaseBoneName = TEXT("Root");
+
+			const uint64 Checksum = CalcStateChecksum(State, 0, 1);
+
+			// EntityIndex 与帧号只在本地有意义
+			TEST_EQUAL(CalcStateChecksum(State, 7, 2), Checksum);
+
+			FCommandFrameChecksumTestState Other = State;
+			Other.Location.Y = -0.0f;
+			Other.MovementBase = GetTransientPackage();
+			Other.MovementBaseBoneName = TEXT("root");
+			TEST_EQUAL(CalcStateChecksum(Other, 0, 1), Checksum);
+
+			Other.bIsFalling = true;
+			TEST_FALSE(CalcStateChecksum(Other, 0, 1) == Checksum);
+		});
+
+		It("Should hash names by their case-insensitive text and number", [this]()
+		{
+			FCommandFrameChecksumTestState State;
+			State.MovementBaseBoneName = FName(TEXT("Spine"), 2);
+
+			const uint64 Checksum = CalcStateChecksum(State, 0, 1);
+
+			FCommandFrameChecksumTestState Other = State;
+			Other.MovementBaseBoneName = FName(TEXT("SPINE"), 2);
+			TEST_EQUAL(CalcStateChecksum(Other, 0, 1), Checksum);
+
+			Other.MovementBaseBoneName = FName(TEXT("Spine"), 3);
+			TEST_FALSE(CalcStateChecksum(Other, 0, 1) == Checksum);
+
+			Other.MovementBaseBoneName = FName(TEXT("Spine_1"));
+			TEST_FALSE(CalcStateChecksum(Other, 0, 1) == Checksum);
+		});
+
+		It("Should change when an entity is missing", [this]()
+		{
+			FCommandFrameChecksumTestState State;
+
+			FCommandFrameAttributeSnapshot Snapshot;
+			Snapshot.Reset(1);
+
+			const FCommandFrameSnapshotKey Keys[] = {
+				FCommandFrameSnapshotKey(FCommandFrameChecksumTestState::StaticStruct(), 0),
+				FCommandFrameSnapshotKey(FCommandFrameChecksumTestState::StaticStruct(), 1),
+			};
+			Snapshot.AddItem(Keys[0], (const uint8*)&State);
+
+			TEST_FALSE(Snapshot.CalcChecksum(Keys) == Snapshot.CalcChecksum(MakeArrayView(Keys, 1)));
+		});
+	});
+
+	Describe("Desync", [this]()
+	{
+		It("Should detect a one-ULP float perturbation on the frame it happens", [this]()
+		{
+			const uint32 FrameNum = 600;
+			const uint32 PerturbFrame = 250;
+
+			FCommandFrameChecksumTestState ServerState;
+			FCommandFrameChecksumTestState ClientState;
+
+			uint32 FirstDesyncFrame = 0;
+			uint32 DesyncNum = 0;
+
+			for (uint32 Frame = 1; Frame <= FrameNum; ++Frame)
+			{
+				StepState(ServerState, Frame);
+				StepState(ClientState, Frame);
+
+				if (Frame == PerturbFrame)
+				{
+					ClientState.Velocity.X = NextULP(ClientState.Velocity.X);
+				}
+
+				// 服务器与客户端的实体索引不同
+				const uint64 ServerChecksum = CalcStateChecksum(ServerState, 3, Frame);
+				const uint64 ClientChecksum = CalcStateChecksum(ClientState, 0, Frame);
+				if (ServerChecksum != ClientChecksum)
+				{
+					FirstDesyncFrame = FirstDesyncFrame ? FirstDesyncFrame : Frame;
+					++DesyncNum;
+				}
+			}
+
+			TEST_EQUAL(FirstDesyncFrame, PerturbFrame);
+			TEST_TRUE(DesyncNum > 0);
+			AddInfo(FString::Printf(TEXT("Perturbed at CF[%u], first desync CF[%u], desync frames %u/%u"), PerturbFrame, FirstDesyncFrame, DesyncNum, FrameNum - PerturbFrame + 1));
+		});
+	});
+}
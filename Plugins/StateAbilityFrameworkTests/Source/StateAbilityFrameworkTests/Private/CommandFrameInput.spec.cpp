@@ -0,0 +1,381 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/OnlineReplStructs.h"
+
+#include "InputAction.h"
+#include "Buffer/BufferTypes.h"
+#include "Buffer/CircularQueueCore.h"
+#include "Net/Packet/CommandFrameInput.h"
+#include "Net/Packet/CommandFramePacket.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const int32 InputTableActionNum = 24;
+	const int32 InputAtomNum = 2048;
+
+	const ETriggerEvent TriggerEvents[] = { ETriggerEvent::Started, ETriggerEvent::Ongoing, ETriggerEvent::Triggered, ETriggerEvent::Completed, ETriggerEvent::Canceled };
+	const EInputActionValueType ValueTypes[] = { EInputActionValueType::Boolean, EInputActionValueType::Axis1D, EInputActionValueType::Axis2D, EInputActionValueType::Axis3D };
+
+	FCommandFrameInputAtom MakeRandomAtom(FRandomStream& RandomStream, const FCommandFrameInputActionTable& ActionTable, float ValueRange)
+	{
+		const EInputActionValueType ValueType = ValueTypes[RandomStream.RandHelper(UE_ARRAY_COUNT(ValueTypes))];
+		const FVector Value(RandomStream.FRandRange(-ValueRange, ValueRange), RandomStream.FRandRange(-ValueRange, ValueRange), RandomStream.FRandRange(-ValueRange, ValueRange));
+
+		return FCommandFrameInputAtom(
+			RandomStream.FRandRange(0.0f, 600.0f),
+			RandomStream.FRandRange(0.0f, 5.0f),
+			RandomStream.FRandRange(0.0f, 5.0f),
+			ActionTable.GetActions()[RandomStream.RandHelper(ActionTable.Num())].Get(),
+			TriggerEvents[RandomStream.RandHelper(UE_ARRAY_COUNT(TriggerEvents))],
+			FInputActionValue(ValueType, Value));
+	}
+
+	using FCommandBufferTest = TJOwnerShipCircularQueue<FCommandFrameInputFrame, FUniqueNetIdRepl, TArray<FCommandFrameInputAtom>>;
+
+	const uint32 TraceFrameNum = 1200;
+	const uint32 RedundantNum = 16;
+
+	/**
+	 * 模拟一段录制的输入：移动轴长时间保持并缓慢变向，视角轴偶尔变化，开火按住一段时间，跳跃偶尔按下。
+	 * Action[0] Move, Action[1] Look, Action[2] Fire, Action[3] Jump
+	 */
+	TArray<FCommandFrameInputAtom> MakeTraceFrame(const FCommandFrameInputActionTable& ActionTable, uint32 Frame)
+	{
+		const float DeltaTime = 1.0f / 30.0f;
+		TArray<FCommandFrameInputAtom> InputAtoms;
+
+		const uint32 MovePhase = Frame % 90;
+		if (MovePhase < 70)
+		{
+			const float Angle = (Frame / 90) * 0.7f;
+			const float HeldTime = MovePhase * DeltaTime;
+			InputAtoms.Emplace(0.0f, HeldTime, HeldTime, ActionTable.GetActions()[0].Get(), MovePhase ? ETriggerEvent::Triggered : ETriggerEvent::Started, FInputActionValue(FVector2D(FMath::Cos(Angle), FMath::Sin(Angle))));
+		}
+
+		if ((Frame / 8) % 3 == 0)
+		{
+			const float Yaw = FMath::Sin(Frame * 0.05f) * 0.3f;
+			InputAtoms.Emplace(0.0f, 0.0f, 0.0f, ActionTable.GetActions()[1].Get(), ETriggerEvent::Triggered, FInputActionValue(FVector2D(Yaw, 0.0f)));
+		}
+
+		const uint32 FirePhase = Frame % 150;
+		if (FirePhase >= 100 && FirePhase < 130)
+		{
+			const float HeldTime = (FirePhase - 100) * DeltaTime;
+			InputAtoms.Emplace(0.0f, HeldTime, HeldTime, ActionTable.GetActions()[2].Get(), ETriggerEvent::Triggered, FInputActionValue(true));
+		}
+
+		if (Frame % 200 == 0)
+		{
+			InputAtoms.Emplace(0.0f, 0.0f, 0.0f, ActionTable.GetActions()[3].Get(), ETriggerEvent::Started, FInputActionValue(true));
+		}
+
+		return InputAtoms;
+	}
+
+	// 离线回放输入轨迹，返回平均每个包的bit数
+	double ReplayTrace(FAutomationTestBase& Test, const FCommandFrameInputActionTable& ActionTable)
+	{
+		FCommandBufferTest ClientBuffer(32);
+		const FUniqueNetIdRepl NetId;
+
+		uint64 TotalBits = 0;
+		for (uint32 Frame = 1; Frame <= TraceFrameNum; ++Frame)
+		{
+			ClientBuffer.RecordItemData(NetId, MakeTraceFrame(ActionTable, Frame), Frame);
+
+			TCircularQueueView<FCommandFrameInputFrame> RangeView = ClientBuffer.ReadRangeData_Shrink(Frame, RedundantNum);
+			FCommandFrameInputNetPacket InputNetPacket;
+			InputNetPacket.WriteRedundantData(nullptr, &ActionTable, RangeView);
+			TotalBits += InputNetPacket.RawData.Num();
+
+			TMap<uint32, TArray<FCommandFrameInputAtom>> Received;
+			InputNetPacket.ReadRedundantData(nullptr, &ActionTable, [&Received](uint32 CommandFrame, int32 DataCount) -> uint8* {
+				TArray<FCommandFrameInputAtom>& InputAtoms = Received.FindOrAdd(CommandFrame);
+				InputAtoms.SetNumUninitialized(DataCount);
+				return (uint8*)InputAtoms.GetData();
+			});
+
+			Test.TestEqual(TEXT("Received frame num"), (uint32)Received.Num(), RangeView.Num());
+
+			for (const TPair<uint32, TArray<FCommandFrameInputAtom>>& Pair : Received)
+			{
+				const TArray<FCommandFrameInputAtom> Expected = MakeTraceFrame(ActionTable, Pair.Key);
+				bool bSame = Expected.Num() == Pair.Value.Num();
+				for (int32 Index = 0; bSame && Index < Expected.Num(); ++Index)
+				{
+					bSame = Pair.Value[Index].IsSameInput(Expected[Index]);
+				}
+
+				if (!bSame)
+				{
+					Test.AddError(FString::Printf(TEXT("Frame[%u] in packet[%u] was not reconstructed exactly"), Pair.Key, Frame));
+					return 0.0;
+				}
+			}
+
+			// 模拟服务器的Ack，保持冗余窗口
+			if (Frame > RedundantNum)
+			{
+				ClientBuffer.AckData(Frame - RedundantNum);
+			}
+		}
+
+		return (double)TotalBits / TraceFrameNum;
+	}
+
+	// 与旧版 NetSerialize 相同的布局，但不包含 InputAction 的对象引用
+	void SerializeLegacyAtom(FArchive& Ar, FCommandFrameInputAtom& InputAtom)
+	{
+		Ar << InputAtom.TriggerEvent;
+		Ar << InputAtom.LastTriggeredWorldTime;
+		Ar << InputAtom.ElapsedProcessedTime;
+		Ar << InputAtom.ElapsedTriggeredTime;
+		Ar << InputAtom.ValueType;
+		Ar << InputAtom.Value;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCommandFrameInputSpec, "StateAbilityFramework.Net.InputAtom", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+	FCommandFrameInputActionTable ActionTable;
+	TArray<FCommandFrameInputAtom> InputAtoms;
+END_DEFINE_SPEC(FCommandFrameInputSpec)
+
+void FCommandFrameInputSpec::Define()
+{
+	BeforeEach([this]()
+	{
+		TArray<TObjectPtr<UInputAction>> InputActions;
+		for (int32 Index = 0; Index < InputTableActionNum; ++Index)
+		{
+			InputActions.Add(NewObject<UInputAction>(GetTransientPackage()));
+		}
+		ActionTable.Init(InputActions);
+
+		FRandomStream RandomStream(1024);
+		InputAtoms.Reset();
+		for (int32 Index = 0; Index < InputAtomNum; ++Index)
+		{
+			InputAtoms.Add(MakeRandomAtom(RandomStream, ActionTable, 1.0f));
+		}
+	});
+
+	AfterEach([this]()
+	{
+		ActionTable.Reset();
+		InputAtoms.Reset();
+	});
+
+	Describe("ActionTable", [this]()
+	{
+		It("Should assign dense indices starting from 1", [this]()
+		{
+			TEST_EQUAL(ActionTable.Num(), InputTableActionNum);
+			TEST_EQUAL(ActionTable.GetIndexBits(), 8u);
+			TEST_EQUAL(ActionTable.FindIndex(nullptr), (uint16)0);
+
+			for (int32 Index = 0; Index < InputTableActionNum; ++Index)
+			{
+				const UInputAction* InputAction = ActionTable.GetActions()[Index];
+				TEST_EQUAL(ActionTable.FindIndex(InputAction), (uint16)(Index + 1));
+				TEST_TRUE(ActionTable.GetAction(Index + 1) == InputAction);
+			}
+
+			TEST_TRUE(ActionTable.GetAction(0) == nullptr);
+			TEST_TRUE(ActionTable.GetAction(InputTableActionNum + 1) == nullptr);
+		});
+	});
+
+	Describe("NetSerialize", [this]()
+	{
+		It("Should round-trip the atom stream through the action table", [this]()
+		{
+			FBitWriter Writer(0, true);
+			bool bOutSuccess = false;
+			for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+			{
+				InputAtom.NetSerialize(Writer, nullptr, bOutSuccess, &ActionTable);
+				TEST_TRUE(bOutSuccess);
+			}
+
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			for (const FCommandFrameInputAtom& Expected : InputAtoms)
+			{
+				FCommandFrameInputAtom InputAtom;
+				InputAtom.NetSerialize(Reader, nullptr, bOutSuccess, &ActionTable);
+				TEST_TRUE(bOutSuccess);
+
+				TEST_TRUE(InputAtom.InputAction == Expected.InputAction);
+				TEST_TRUE(InputAtom.TriggerEvent == Expected.TriggerEvent);
+				TEST_TRUE(InputAtom.ValueType == Expected.ValueType);
+				TEST_EQUAL(InputAtom.Value, Expected.Value);
+				TEST_EQUAL(InputAtom.ElapsedProcessedTime, Expected.ElapsedProcessedTime);
+				TEST_EQUAL(InputAtom.ElapsedTriggeredTime, Expected.ElapsedTriggeredTime);
+			}
+
+			TEST_TRUE(Reader.AtEnd());
+			TEST_FALSE(Reader.IsError());
+		});
+
+		It("Should report bit count against the legacy layout", [this]()
+		{
+			FBitWriter LegacyWriter(0, true);
+			FBitWriter Writer(0, true);
+			bool bOutSuccess = false;
+			for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+			{
+				SerializeLegacyAtom(LegacyWriter, InputAtom);
+				InputAtom.NetSerialize(Writer, nullptr, bOutSuccess, &ActionTable);
+			}
+
+			TEST_TRUE(Writer.GetNumBits() < LegacyWriter.GetNumBits());
+
+			// 旧版还需要额外传递 InputAction 的对象引用（至少一个打包的 FNetworkGUID）
+			AddInfo(FString::Printf(TEXT("Atoms[%d] Legacy %.1f bits/atom (+ object reference) Indexed %.1f bits/atom"),
+				InputAtomNum, (double)LegacyWriter.GetNumBits() / InputAtomNum, (double)Writer.GetNumBits() / InputAtomNum));
+		});
+	});
+
+	Describe("BulkNetSerialize", [this]()
+	{
+		It("Should round-trip random frames without loss", [this]()
+		{
+			FRandomStream RandomStream(2048);
+			for (int32 Round = 0; Round < 500; ++Round)
+			{
+				// 随机的帧大小与数值量级，覆盖不同的列宽
+				const int32 AtomNum = RandomStream.RandHelper(65);
+				const float ValueRange = FMath::Pow(10.0f, (float)RandomStream.RandHelper(6));
+
+				TArray<FCommandFrameInputAtom> Source;
+				for (int32 Index = 0; Index < AtomNum; ++Index)
+				{
+					Source.Add(MakeRandomAtom(RandomStream, ActionTable, ValueRange));
+				}
+
+				FBitWriter Writer(0, true);
+				TEST_TRUE(FCommandFrameInputAtom::BulkNetSerialize(Writer, nullptr, Source, &ActionTable));
+
+				TArray<FCommandFrameInputAtom> Result;
+				Result.SetNum(AtomNum);
+
+				FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+				TEST_TRUE(FCommandFrameInputAtom::BulkNetSerialize(Reader, nullptr, Result, &ActionTable));
+				TEST_TRUE(Reader.AtEnd());
+
+				for (int32 Index = 0; Index < AtomNum; ++Index)
+				{
+					const FCommandFrameInputAtom& Expected = Source[Index];
+					const FCommandFrameInputAtom& InputAtom = Result[Index];
+
+					if (InputAtom.InputAction != Expected.InputAction
+						|| InputAtom.TriggerEvent != Expected.TriggerEvent
+						|| InputAtom.ValueType != Expected.ValueType
+						|| InputAtom.Value != Expected.Value
+						|| InputAtom.ElapsedProcessedTime != Expected.ElapsedProcessedTime
+						|| InputAtom.ElapsedTriggeredTime != Expected.ElapsedTriggeredTime)
+					{
+						AddError(FString::Printf(TEXT("Round[%d] Atom[%d] mismatch, Value[%s] Expected[%s]"), Round, Index, *InputAtom.Value.ToString(), *Expected.Value.ToString()));
+						return;
+					}
+				}
+			}
+		});
+
+		It("Should reject a stream written with a different action table", [this]()
+		{
+			FBitWriter Writer(0, true);
+			TEST_TRUE(FCommandFrameInputAtom::BulkNetSerialize(Writer, nullptr, InputAtoms, &ActionTable));
+
+			FCommandFrameInputActionTable EmptyTable;
+			TArray<FCommandFrameInputAtom> Result;
+			Result.SetNum(InputAtoms.Num());
+
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			TEST_FALSE(FCommandFrameInputAtom::BulkNetSerialize(Reader, nullptr, Result, &EmptyTable));
+		});
+
+		It("Should report throughput in atoms per microsecond", [this]()
+		{
+			const int32 RoundNum = 200;
+			TArray<FCommandFrameInputAtom> Result;
+			Result.SetNum(InputAtomNum);
+
+			FBitWriter Writer(0, true);
+			double EncodeSeconds = 0.0;
+			double DecodeSeconds = 0.0;
+			for (int32 Round = 0; Round < RoundNum; ++Round)
+			{
+				Writer.Reset();
+
+				double StartTime = FPlatformTime::Seconds();
+				FCommandFrameInputAtom::BulkNetSerialize(Writer, nullptr, InputAtoms, &ActionTable);
+				EncodeSeconds += FPlatformTime::Seconds() - StartTime;
+
+				FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+				StartTime = FPlatformTime::Seconds();
+				FCommandFrameInputAtom::BulkNetSerialize(Reader, nullptr, Result, &ActionTable);
+				DecodeSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			FBitWriter AtomWriter(0, true);
+			bool bOutSuccess = false;
+			double AtomSeconds = FPlatformTime::Seconds();
+			for (int32 Round = 0; Round < RoundNum; ++Round)
+			{
+				AtomWriter.Reset();
+				for (FCommandFrameInputAtom& InputAtom : InputAtoms)
+				{
+					InputAtom.NetSerialize(AtomWriter, nullptr, bOutSuccess, &ActionTable);
+				}
+			}
+			AtomSeconds = FPlatformTime::Seconds() - AtomSeconds;
+
+			const double AtomTotal = (double)InputAtomNum * RoundNum;
+			AddInfo(FString::Printf(TEXT("Atoms[%d] Bulk Encode %.1f atoms/us Decode %.1f atoms/us %.1f bits/atom, PerAtom Encode %.1f atoms/us %.1f bits/atom"),
+				InputAtomNum, AtomTotal / (EncodeSeconds * 1e6), AtomTotal / (DecodeSeconds * 1e6), (double)Writer.GetNumBits() / InputAtomNum,
+				AtomTotal / (AtomSeconds * 1e6), (double)AtomWriter.GetNumBits() / InputAtomNum));
+		});
+	});
+
+	Describe("RedundantInput", [this]()
+	{
+		It("Should reconstruct delta-coded frames exactly and report packet size", [this]()
+		{
+			IConsoleVariable* CVarDeltaRedundantInput = IConsoleManager::Get().FindConsoleVariable(TEXT("CFrame.Net.DeltaRedundantInput"));
+			if (!TestNotNull(TEXT("CFrame.Net.DeltaRedundantInput"), CVarDeltaRedundantInput))
+			{
+				return;
+			}
+
+			const bool bPrevEnabled = CVarDeltaRedundantInput->GetBool();
+
+			CVarDeltaRedundantInput->Set(false, ECVF_SetByCode);
+			const double FullBits = ReplayTrace(*this, ActionTable);
+
+			CVarDeltaRedundantInput->Set(true, ECVF_SetByCode);
+			const double DeltaBits = ReplayTrace(*this, ActionTable);
+
+			CVarDeltaRedundantInput->Set(bPrevEnabled, ECVF_SetByCode);
+
+			TEST_TRUE(DeltaBits < FullBits);
+			AddInfo(FString::Printf(TEXT("Frames[%u] Redundant[%u] Full %.1f bytes/packet Delta %.1f bytes/packet"), TraceFrameNum, RedundantNum, FullBits / 8.0, DeltaBits / 8.0));
+		});
+	});
+}
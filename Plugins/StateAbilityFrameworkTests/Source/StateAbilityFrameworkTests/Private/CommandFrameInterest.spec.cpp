@@ -0,0 +1,218 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/NetSerialization.h"
+
+#include "Net/CommandFrameInterest.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const float InterestRadius = 5000.0f;
+
+	/**
+	 * 合成地图上的客户端，每帧随机游走，用于模拟 ServerSendDeltaNetPacket 的发送开销
+	 */
+	struct FInterestTestClient
+	{
+		uint32 EntityId = 0;
+		FVector Location = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+	};
+
+	void StepClients(FRandomStream& RandomStream, TArray<FInterestTestClient>& Clients, float MapExtent, float DeltaTime)
+	{
+		for (FInterestTestClient& Client : Clients)
+		{
+			if (RandomStream.FRand() < 0.05f)
+			{
+				Client.Velocity = FVector(RandomStream.FRandRange(-600.0f, 600.0f), RandomStream.FRandRange(-600.0f, 600.0f), 0.0f);
+			}
+
+			Client.Location += Client.Velocity * DeltaTime;
+			Client.Location.X = FMath::Clamp(Client.Location.X, -MapExtent, MapExtent);
+			Client.Location.Y = FMath::Clamp(Client.Location.Y, -MapExtent, MapExtent);
+		}
+	}
+
+	// 与 UCFrameMoverComponent::OnServerNetSync 写入的内容保持一致
+	void SerializeMovementProcedure(FBitWriter& Writer, const FInterestTestClient& Client)
+	{
+		FVector Location = Client.Location;
+		FVector Velocity = Client.Velocity;
+		FRotator Orientation = Client.Velocity.Rotation();
+		bool bIsUsingMovementBase = false;
+
+		SerializePackedVector<100, 30>(Location, Writer);
+		SerializePackedVector<10, 16>(Velocity, Writer);
+		Orientation.SerializeCompressedShort(Writer);
+		Writer.SerializeBits(&bIsUsingMovementBase, 1);
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCommandFrameInterestSpec, "StateAbilityFramework.Net.Interest", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCommandFrameInterestSpec)
+
+void FCommandFrameInterestSpec::Define()
+{
+	Describe("Relevancy", [this]()
+	{
+		It("Should treat everything as relevant when disabled or untracked", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCommandFrameInterestManager InterestManager;
+			InterestManager.Init(0.0f, 0.1f);
+			TEST_FALSE(InterestManager.IsEnabled());
+			TEST_TRUE(InterestManager.IsRelevant(1, 2));
+
+			InterestManager.Init(InterestRadius, 0.1f);
+			InterestManager.BeginUpdate();
+			InterestManager.AddEntity(1, FVector::ZeroVector);
+			InterestManager.AddEntity(2, FVector(InterestRadius * 10.0f, 0.0f, 0.0f));
+			InterestManager.EndUpdate();
+
+			TEST_TRUE(InterestManager.IsRelevant(1, 1));
+			TEST_FALSE(InterestManager.IsRelevant(1, 2));
+			TEST_TRUE(InterestManager.IsRelevant(1, 3));
+			TEST_TRUE(InterestManager.IsRelevant(3, 2));
+		});
+
+		It("Should keep relevancy inside the hysteresis band", EAsyncExecution::ThreadPool, [this]()
+		{
+			FCommandFrameInterestManager InterestManager;
+			InterestManager.Init(InterestRadius, 0.1f);
+
+			auto Step = [&InterestManager](float Distance) {
+				InterestManager.BeginUpdate();
+				InterestManager.AddEntity(1, FVector::ZeroVector);
+				InterestManager.AddEntity(2, FVector(Distance, 0.0f, 0.0f));
+				InterestManager.EndUpdate();
+				return InterestManager.IsRelevant(1, 2);
+			};
+
+			TEST_FALSE(Step(InterestRadius * 1.05f));
+			TEST_TRUE(Step(InterestRadius * 0.9f));
+			TEST_TRUE(Step(InterestRadius * 1.05f));
+			TEST_FALSE(Step(InterestRadius * 1.2f));
+			TEST_FALSE(Step(InterestRadius * 1.05f));
+		});
+
+		It("Should match a brute force search without hysteresis", EAsyncExecution::ThreadPool, [this]()
+		{
+			const int32 EntityNum = 300;
+			const float MapExtent = 20000.0f;
+
+			FRandomStream RandomStream(1024);
+			FCommandFrameInterestManager InterestManager;
+			InterestManager.Init(InterestRadius, 0.0f);
+
+			TArray<FVector> Locations;
+			InterestManager.BeginUpdate();
+			for (int32 Index = 0; Index < EntityNum; ++Index)
+			{
+				Locations.Add(FVector(RandomStream.FRandRange(-MapExtent, MapExtent), RandomStream.FRandRange(-MapExtent, MapExtent), RandomStream.FRandRange(-500.0f, 500.0f)));
+				InterestManager.AddEntity(Index, Locations.Last());
+			}
+			InterestManager.EndUpdate();
+
+			int32 MismatchNum = 0;
+			for (int32 Viewer = 0; Viewer < EntityNum; ++Viewer)
+			{
+				for (int32 Target = 0; Target < EntityNum; ++Target)
+				{
+					const bool bExpected = Viewer == Target || FVector::DistSquared2D(Locations[Viewer], Locations[Target]) <= FMath::Square((double)InterestRadius);
+					if (InterestManager.IsRelevant(Viewer, Target) != bExpected)
+					{
+						++MismatchNum;
+					}
+				}
+			}
+
+			TEST_EQUAL(MismatchNum, 0);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report bytes and CPU time per frame for 200 clients", EAsyncExecution::ThreadPool, [this]()
+		{
+			const int32 ClientNum = 200;
+			const int32 FrameNum = 300;
+			const float MapExtent = 40000.0f;
+			const float DeltaTime = 1.0f / 30.0f;
+
+			for (const bool bEnableInterest : { false, true })
+			{
+				FRandomStream RandomStream(2048);
+				FCommandFrameInterestManager InterestManager;
+				InterestManager.Init(bEnableInterest ? InterestRadius : 0.0f, 0.1f);
+
+				TArray<FInterestTestClient> Clients;
+				for (int32 Index = 0; Index < ClientNum; ++Index)
+				{
+					FInterestTestClient& Client = Clients.AddDefaulted_GetRef();
+					Client.EntityId = Index + 1;
+					Client.Location = FVector(RandomStream.FRandRange(-MapExtent, MapExtent), RandomStream.FRandRange(-MapExtent, MapExtent), 0.0f);
+				}
+
+				FBitWriter Writer(0, true);
+				int64 TotalBits = 0;
+				int64 RelevantNum = 0;
+				double TotalSeconds = 0.0;
+
+				for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+				{
+					StepClients(RandomStream, Clients, MapExtent, DeltaTime);
+
+					const double StartTime = FPlatformTime::Seconds();
+
+					InterestManager.BeginUpdate();
+					for (const FInterestTestClient& Client : Clients)
+					{
+						InterestManager.AddEntity(Client.EntityId, Client.Location);
+					}
+					InterestManager.EndUpdate();
+
+					// 每个连接都会收到所有NetChannel的包，只有相关的包才携带Movement内容
+					for (const FInterestTestClient& Viewer : Clients)
+					{
+						for (const FInterestTestClient& Target : Clients)
+						{
+							Writer.Reset();
+
+							uint32 ServerCommandFrame = Frame;
+							Writer.SerializeIntPacked(ServerCommandFrame);
+
+							if (InterestManager.IsRelevant(Viewer.EntityId, Target.EntityId))
+							{
+								SerializeMovementProcedure(Writer, Target);
+								++RelevantNum;
+							}
+
+							TotalBits += Writer.GetNumBits();
+						}
+					}
+
+					TotalSeconds += FPlatformTime::Seconds() - StartTime;
+				}
+
+				AddInfo(FString::Printf(TEXT("Interest[%s] Clients[%d] Radius[%.0f] Relevant %.1f/client, %.1f KB/frame, %.3f ms/frame"),
+					bEnableInterest ? TEXT("On") : TEXT("Off"),
+					ClientNum,
+					bEnableInterest ? InterestRadius : 0.0f,
+					(double)RelevantNum / (ClientNum * FrameNum),
+					(double)TotalBits / 8.0 / 1024.0 / FrameNum,
+					TotalSeconds * 1000.0 / FrameNum));
+			}
+		});
+	});
+}
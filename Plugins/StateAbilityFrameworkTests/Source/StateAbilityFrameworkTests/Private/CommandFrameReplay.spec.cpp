@@ -0,0 +1,173 @@
+#include "CommandFrameReplayTest.h"
+
+#include "Misc/AutomationTest.h"
+#include "UObject/StrongObjectPtr.h"
+
+#include "CommandFrameManager.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const int32 ReplayMoverNum = 100;
+	const float FixedDeltaTime = 1.0f / 30.0f;
+
+	/**
+	 * 与 UCommandFrameManager::ReplayFrames 相同的流程：从 RewindedFrame + 1 重新模拟到当前帧
+	 */
+	void ReplayFrames(FOnFixedUpdate& OnBeginFrame, FOnFixedUpdate& OnEndFrame, uint32 RewindedFrame, uint32 RealCommandFrame, const TSet<const UObject*>* ReplayObjects)
+	{
+		auto Filter = [ReplayObjects](const UObject* Object) {
+			return ReplayObjects->Contains(Object);
+		};
+
+		for (uint32 InternalCommandFrame = RewindedFrame + 1; InternalCommandFrame <= RealCommandFrame; ++InternalCommandFrame)
+		{
+			if (ReplayObjects)
+			{
+				OnBeginFrame.BroadcastFiltered(FixedDeltaTime, RealCommandFrame, InternalCommandFrame, Filter);
+				OnEndFrame.BroadcastFiltered(FixedDeltaTime, RealCommandFrame, InternalCommandFrame, Filter);
+			}
+			else
+			{
+				OnBeginFrame.Broadcast(FixedDeltaTime, RealCommandFrame, InternalCommandFrame);
+				OnEndFrame.Broadcast(FixedDeltaTime, RealCommandFrame, InternalCommandFrame);
+			}
+		}
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCommandFrameReplaySpec, "StateAbilityFramework.Rewind.SelectiveReplay", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+TArray<TStrongObjectPtr<UCommandFrameReplayTestMover>> Movers;
+END_DEFINE_SPEC(FCommandFrameReplaySpec)
+
+void FCommandFrameReplaySpec::Define()
+{
+	BeforeEach([this]() {
+		Movers.Reset();
+		for (int32 Index = 0; Index < ReplayMoverNum; ++Index)
+		{
+			Movers.Emplace(NewObject<UCommandFrameReplayTestMover>(GetTransientPackage()));
+		}
+	});
+
+	AfterEach([this]() {
+		Movers.Reset();
+	});
+
+	Describe("FixedUpdate", [this]()
+	{
+		It("Should only notify the bindings accepted by the filter", [this]()
+		{
+			FOnFixedUpdate OnEndFrame;
+			for (const TStrongObjectPtr<UCommandFrameReplayTestMover>& Mover : Movers)
+			{
+				OnEndFrame.AddUObject(Mover.Get(), &UCommandFrameReplayTestMover::FixedTick);
+			}
+
+			const TSet<const UObject*> ReplayObjects = { Movers[3].Get(), Movers[42].Get() };
+			OnEndFrame.BroadcastFiltered(FixedDeltaTime, 1, 1, [&ReplayObjects](const UObject* Object) {
+				return ReplayObjects.Contains(Object);
+			});
+
+			int32 TickedNum = 0;
+			for (const TStrongObjectPtr<UCommandFrameReplayTestMover>& Mover : Movers)
+			{
+				TickedNum += Mover->TickNum;
+			}
+
+			TEST_EQUAL(TickedNum, 2);
+			TEST_EQUAL(Movers[3]->TickNum, 1);
+			TEST_EQUAL(Movers[42]->TickNum, 1);
+
+			OnEndFrame.Broadcast(FixedDeltaTime, 2, 2);
+			TEST_EQUAL(Movers[0]->TickNum, 1);
+			TEST_EQUAL(Movers[3]->TickNum, 2);
+		});
+
+		It("Should tolerate removing bindings during broadcast", [this]()
+		{
+			FOnFixedUpdate OnEndFrame;
+			UCommandFrameReplayTestMover* Remover = Movers[0].Get();
+			UCommandFrameReplayTestMover* Removed = Movers[1].Get();
+
+			OnEndFrame.AddWeakLambda(Remover, [&OnEndFrame, Removed](float DeltaTime, uint32 RCF, uint32 ICF) {
+				OnEndFrame.RemoveAll(Removed);
+			});
+			OnEndFrame.AddUObject(Removed, &UCommandFrameReplayTestMover::FixedTick);
+			OnEndFrame.AddUObject(Movers[2].Get(), &UCommandFrameReplayTestMover::FixedTick);
+
+			OnEndFrame.Broadcast(FixedDeltaTime, 1, 1);
+			TEST_EQUAL(Removed->TickNum, 0);
+			TEST_EQUAL(Movers[2]->TickNum, 1);
+
+			TEST_EQUAL(OnEndFrame.RemoveAll(Movers[2].Get()), 1);
+			TEST_EQUAL(OnEndFrame.RemoveAll(Remover), 1);
+			TEST_FALSE(OnEndFrame.IsBound());
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report replay cost at a 10% mispredict rate with 100 movers", [this]()
+		{
+			const int32 ReplayNum = 200;
+			const uint32 RewindFrameNum = 8;
+			const int32 MispredictNum = ReplayMoverNum / 10;
+
+			FOnFixedUpdate OnBeginFrame;
+			FOnFixedUpdate OnEndFrame;
+			for (const TStrongObjectPtr<UCommandFrameReplayTestMover>& Mover : Movers)
+			{
+				OnBeginFrame.AddUObject(Mover.Get(), &UCommandFrameReplayTestMover::FixedTick);
+				OnEndFrame.AddUObject(Mover.Get(), &UCommandFrameReplayTestMover::FixedTick);
+			}
+
+			FRandomStream RandomStream(512);
+			TSet<const UObject*> ReplayObjects;
+			double FullSeconds = 0.0;
+			double SelectiveSeconds = 0.0;
+			int64 FullTickNum = 0;
+			int64 SelectiveTickNum = 0;
+
+			for (int32 Replay = 0; Replay < ReplayNum; ++Replay)
+			{
+				const uint32 RealCommandFrame = (Replay + 1) * RewindFrameNum;
+
+				ReplayObjects.Reset();
+				while (ReplayObjects.Num() < MispredictNum)
+				{
+					ReplayObjects.Add(Movers[RandomStream.RandHelper(ReplayMoverNum)].Get());
+				}
+
+				int32 TickNumBefore = Movers[0]->TickNum;
+				double StartTime = FPlatformTime::Seconds();
+				ReplayFrames(OnBeginFrame, OnEndFrame, RealCommandFrame - RewindFrameNum, RealCommandFrame, nullptr);
+				FullSeconds += FPlatformTime::Seconds() - StartTime;
+				FullTickNum += (int64)(Movers[0]->TickNum - TickNumBefore) * ReplayMoverNum;
+
+				StartTime = FPlatformTime::Seconds();
+				ReplayFrames(OnBeginFrame, OnEndFrame, RealCommandFrame - RewindFrameNum, RealCommandFrame, &ReplayObjects);
+				SelectiveSeconds += FPlatformTime::Seconds() - StartTime;
+				SelectiveTickNum += (int64)RewindFrameNum * 2 * MispredictNum;
+			}
+
+			TEST_TRUE(SelectiveTickNum * 10 == FullTickNum);
+
+			AddInfo(FString::Printf(TEXT("Movers[%d] Mispredict[%d] RewindFrames[%u] Full %.2f us/replay (%lld ticks), Selective %.2f us/replay (%lld ticks)"),
+				ReplayMoverNum, MispredictNum, RewindFrameNum,
+				FullSeconds * 1e6 / ReplayNum, FullTickNum,
+				SelectiveSeconds * 1e6 / ReplayNum, SelectiveTickNum));
+		});
+	});
+}
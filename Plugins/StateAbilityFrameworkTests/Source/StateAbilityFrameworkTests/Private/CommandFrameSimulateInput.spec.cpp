@@ -0,0 +1,184 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/StrongObjectPtr.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Online/CoreOnline.h"
+#include "GameFramework/OnlineReplStructs.h"
+
+#include "InputAction.h"
+#include "Buffer/BufferTypes.h"
+#include "Net/CommandEnhancedInput.h"
+#include "Net/Packet/CommandFrameInput.h"
+
+#include "CommandFrameInputTest.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	const int32 InputActionNum = 8;
+	const int32 SimulateFrameNum = 300;
+
+	/**
+	 * 每个玩家一个 UCommandEnhancedInputComponent，为每个 InputAction 绑定 Started/Triggered 两个事件
+	 */
+	struct FSimulateInputTestWorld
+	{
+		UWorld* World = nullptr;
+		TStrongObjectPtr<UCommandFrameInputTestReceiver> Receiver;
+		TArray<TStrongObjectPtr<UInputAction>> Actions;
+
+		TArray<FUniqueNetIdRepl> NetIds;
+		TArray<TArray<UInputComponent*>> InputStacks;
+
+		FCommandFrameInputFrame InputFrame;
+
+		FSimulateInputTestWorld(int32 PlayerNum)
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CommandFrameSimulateInputSpec"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+
+			Receiver.Reset(NewObject<UCommandFrameInputTestReceiver>());
+			for (int32 Index = 0; Index < InputActionNum; ++Index)
+			{
+				UInputAction* Action = NewObject<UInputAction>();
+				Action->ValueType = EInputActionValueType::Axis2D;
+				Actions.Emplace(Action);
+			}
+
+			for (int32 PlayerIndex = 0; PlayerIndex < PlayerNum; ++PlayerIndex)
+			{
+				AActor* PlayerActor = World->SpawnActor<AActor>();
+				UCommandEnhancedInputComponent* InputComp = NewObject<UCommandEnhancedInputComponent>(PlayerActor);
+				InputComp->RegisterComponent();
+
+				TArray<FCommandFrameInputAtom> InputAtoms;
+				for (const TStrongObjectPtr<UInputAction>& Action : Actions)
+				{
+					InputComp->BindCommandInput(Action.Get(), ETriggerEvent::Started, Receiver.Get(), &UCommandFrameInputTestReceiver::OnInput);
+					InputComp->BindCommandInput(Action.Get(), ETriggerEvent::Triggered, Receiver.Get(), &UCommandFrameInputTestReceiver::OnInput);
+
+					InputAtoms.Emplace(0.0f, 0.1f, 0.1f, Action.Get(), ETriggerEvent::Triggered, FInputActionValue(FVector2D(0.5, -0.5)));
+				}
+
+				const FUniqueNetIdRepl& NetId = NetIds.Emplace_GetRef(FUniqueNetIdString::Create(FString::Printf(TEXT("SimulateInputPlayer_%d"), PlayerIndex), FName(TEXT("CommandFrameTest"))));
+				InputStacks.Add({ InputComp });
+				InputFrame.AddItem(NetId, InputAtoms);
+			}
+		}
+
+		~FSimulateInputTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		void BuildInputEventMaps(TMap<const FUniqueNetIdRepl, FCommandFrameInputProcedureCache>& ProcedureCaches) const
+		{
+			for (int32 PlayerIndex = 0; PlayerIndex < NetIds.Num(); ++PlayerIndex)
+			{
+				FCommandFrameInputProcedureCache& ProcedureCache = ProcedureCaches.FindOrAdd(NetIds[PlayerIndex]);
+				ProcedureCache.InputEventMap.Reset();
+				FCommandFrameInputProcedure::BuildInputEventMap(InputStacks[PlayerIndex], ProcedureCache.InputEventMap);
+			}
+		}
+
+		void ClearRecordedInput() const
+		{
+			if (UCommandEnhancedInputSubsystem* InputSystem = World->GetSubsystem<UCommandEnhancedInputSubsystem>())
+			{
+				InputSystem->ClearInput();
+			}
+		}
+	};
+
+	struct FSimulateInputReport
+	{
+		int32 InputNum = 0;
+		double Seconds = 0.0;
+	};
+
+	// bCached 为 false 时与缓存前的 SimulateInput 一致，每帧为每个玩家重建输入事件表
+	FSimulateInputReport SimulateInput(FSimulateInputTestWorld& TestWorld, bool bCached)
+	{
+		FSimulateInputReport Report;
+		TMap<const FUniqueNetIdRepl, FCommandFrameInputProcedureCache> ProcedureCaches;
+
+		TestWorld.Receiver->InputNum = 0;
+
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < SimulateFrameNum; ++Frame)
+		{
+			if (!bCached || Frame == 0)
+			{
+				TestWorld.BuildInputEventMaps(ProcedureCaches);
+			}
+
+			FCommandFrameInputProcedure::Dispatch(TestWorld.InputFrame, ProcedureCaches);
+			TestWorld.ClearRecordedInput();
+		}
+		Report.Seconds = FPlatformTime::Seconds() - Start;
+		Report.InputNum = TestWorld.Receiver->InputNum;
+
+		return Report;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCommandFrameSimulateInputSpec, "StateAbilityFramework.CommandFrame.SimulateInput", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCommandFrameSimulateInputSpec)
+
+void FCommandFrameSimulateInputSpec::Define()
+{
+	Describe("Dispatch", [this]()
+	{
+		It("Should only dispatch the inputs of the player that owns the event map", [this]()
+		{
+			FSimulateInputTestWorld TestWorld(4);
+
+			TMap<const FUniqueNetIdRepl, FCommandFrameInputProcedureCache> ProcedureCaches;
+			TestWorld.BuildInputEventMaps(ProcedureCaches);
+			ProcedureCaches.Remove(TestWorld.NetIds[1]);
+			ProcedureCaches.Remove(TestWorld.NetIds[2]);
+
+			FCommandFrameInputProcedure::Dispatch(TestWorld.InputFrame, ProcedureCaches);
+			TestWorld.ClearRecordedInput();
+
+			// 只有 Triggered 的绑定会响应
+			TEST_EQUAL(TestWorld.Receiver->InputNum, 2 * InputActionNum);
+		});
+	});
+
+	Describe("Benchmark", [this]()
+	{
+		It("Should report the cost of SimulateInput with cached and rebuilt input event maps", [this]()
+		{
+			for (const int32 PlayerNum : { 1, 8, 32, 128 })
+			{
+				FSimulateInputTestWorld TestWorld(PlayerNum);
+
+				const FSimulateInputReport Uncached = SimulateInput(TestWorld, false);
+				const FSimulateInputReport Cached = SimulateInput(TestWorld, true);
+
+				TEST_EQUAL(Uncached.InputNum, PlayerNum * InputActionNum * SimulateFrameNum);
+				TEST_EQUAL(Cached.InputNum, Uncached.InputNum);
+
+				AddInfo(FString::Printf(TEXT("%d players x %d actions x %d frames: rebuilt %.3f ms/frame, cached %.3f ms/frame"),
+					PlayerNum, InputActionNum, SimulateFrameNum, Uncached.Seconds * 1000.0 / SimulateFrameNum, Cached.Seconds * 1000.0 / SimulateFrameNum));
+			}
+		});
+	});
+}
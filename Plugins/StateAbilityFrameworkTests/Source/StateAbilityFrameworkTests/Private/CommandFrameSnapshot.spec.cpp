@@ -0,0 +1,340 @@
+#include "CommandFrameSnapshotTest.h"
+#include "Misc/AutomationTest.h"
+
+#include "Buffer/BufferTypes.h"
+#include "Buffer/CircularQueueCore.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	using FSnapshotBufferBase = TJOwnerShipCircularQueue<FCommandFrameAttributeSnapshot, FCommandFrameSnapshotKey, uint8*>;
+
+	struct FSnapshotBufferTest : public FSnapshotBufferBase
+	{
+		using FSnapshotBufferBase::FSnapshotBufferBase;
+
+		// 只统计本队列所有槽位（包括有效范围之外的）的分配器，不受其他快照缓冲的影响
+		uint32 GetHeapAllocationNum() const
+		{
+			uint32 Num = 0;
+			for (const FCommandFrameAttributeSnapshot& Snapshot : Buffer)
+			{
+				Num += Snapshot.Arena.GetHeapAllocationNum();
+			}
+			return Num;
+		}
+	};
+
+	const uint32 MoverNum = 100;
+
+	// 每个Mover的轨迹都不相同，且速度随帧数发散
+	FCommandFrameSnapshotTestData SimulateMover(uint32 EntityIndex, uint32 Frame)
+	{
+		FCommandFrameSnapshotTestData Data;
+		Data.Velocity = FVector(EntityIndex + 1, (double)Frame * EntityIndex, -(double)EntityIndex);
+		Data.Location = FVector(EntityIndex * 100.0, 0.0, 0.0) + Data.Velocity * Frame;
+		return Data;
+	}
+
+	// 逐帧推进的模拟，回滚后的重新模拟必须从快照中的状态继续
+	void StepMover(FCommandFrameSnapshotTestData& Data, uint32 EntityIndex)
+	{
+		Data.Velocity += FVector(1.0, -(double)(EntityIndex % 7), 0.5 * EntityIndex);
+		Data.Location += Data.Velocity;
+	}
+
+	// 服务器在 CorrectionFrame 给奇数 Mover 施加了客户端没有预测到的冲量
+	const uint32 CorrectionFrame = 20;
+
+	bool IsCorrectedMover(uint32 EntityIndex)
+	{
+		return (EntityIndex & 1) != 0;
+	}
+
+	void ApplyCorrection(FCommandFrameSnapshotTestData& Data, uint32 EntityIndex)
+	{
+		Data.Velocity += FVector(0.0, 0.0, 100.0 + EntityIndex);
+	}
+
+	// 从头模拟到 Frame，作为回滚结果的参照
+	FCommandFrameSnapshotTestData SimulateAuthority(uint32 EntityIndex, uint32 Frame, bool bWithCorrection)
+	{
+		FCommandFrameSnapshotTestData Data;
+		Data.Location = FVector(EntityIndex * 100.0, 0.0, 0.0);
+		for (uint32 StepFrame = 1; StepFrame <= Frame; ++StepFrame)
+		{
+			StepMover(Data, EntityIndex);
+			if (bWithCorrection && StepFrame == CorrectionFrame && IsCorrectedMover(EntityIndex))
+			{
+				ApplyCorrection(Data, EntityIndex);
+			}
+		}
+		return Data;
+	}
+
+	bool IsSameState(const FCommandFrameSnapshotTestData* Data, const FCommandFrameSnapshotTestData& Expected)
+	{
+		return Data && Data->Location.Equals(Expected.Location, 0.0) && Data->Velocity.Equals(Expected.Velocity, 0.0);
+	}
+}
+
+BEGIN_DEFINE_SPEC(FCommandFrameSnapshotSpec, "StateAbilityFramework.Buffer.AttributeSnapshot", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FCommandFrameSnapshotSpec)
+
+void FCommandFrameSnapshotSpec::Define()
+{
+	Describe("Rollback", [this]()
+	{
+		It("Should roll back every mover to its own snapshot and resimulate from it", EAsyncExecution::ThreadPool, [this]()
+		{
+			const UScriptStruct* Struct = FCommandFrameSnapshotTestData::StaticStruct();
+			const uint32 LastFrame = 40;
+			FSnapshotBufferTest SnapshotBuffer(32);
+
+			// 客户端预测：没有冲量
+			TArray<FCommandFrameSnapshotTestData> LiveStates;
+			for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+			{
+				LiveStates.Add_GetRef(FCommandFrameSnapshotTestData()).Location = FVector(EntityIndex * 100.0, 0.0, 0.0);
+			}
+			for (uint32 Frame = 1; Frame <= LastFrame; ++Frame)
+			{
+				for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+				{
+					StepMover(LiveStates[EntityIndex], EntityIndex);
+					TEST_TRUE(SnapshotBuffer.RecordItemData(FCommandFrameSnapshotKey(Struct, EntityIndex), (uint8*)&LiveStates[EntityIndex], Frame));
+				}
+			}
+
+			// 回滚：每个 Mover 从自己在 CorrectionFrame 的快照恢复，被修正的 Mover 应用服务器状态
+			int32 RestoreMismatchNum = 0;
+			FCommandFrameAttributeSnapshot* CorrectionSnapshot = SnapshotBuffer.ReadData(CorrectionFrame);
+			TEST_TRUE(CorrectionSnapshot != nullptr);
+			if (!CorrectionSnapshot)
+			{
+				return;
+			}
+			for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+			{
+				FCommandFrameSnapshotTestData* Data = (FCommandFrameSnapshotTestData*)CorrectionSnapshot->ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex));
+				if (!IsSameState(Data, SimulateAuthority(EntityIndex, CorrectionFrame, false)))
+				{
+					++RestoreMismatchNum;
+					continue;
+				}
+
+				if (IsCorrectedMover(EntityIndex))
+				{
+					ApplyCorrection(*Data, EntityIndex);
+				}
+				LiveStates[EntityIndex] = *Data;
+			}
+			TEST_EQUAL(RestoreMismatchNum, 0);
+
+			// 重新模拟到最新帧，历史记录无法被直接覆盖，需要取出后进行修改
+			for (uint32 Frame = CorrectionFrame + 1; Frame <= LastFrame; ++Frame)
+			{
+				FCommandFrameAttributeSnapshot* Snapshot = SnapshotBuffer.ReadData(Frame);
+				for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+				{
+					StepMover(LiveStates[EntityIndex], EntityIndex);
+					if (FCommandFrameSnapshotTestData* Data = Snapshot ? (FCommandFrameSnapshotTestData*)Snapshot->ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex)) : nullptr)
+					{
+						*Data = LiveStates[EntityIndex];
+					}
+				}
+			}
+
+			// 每个 Mover 的结果与带冲量从头模拟的结果一致，未被修正的 Mover 不受影响
+			int32 ResimulateMismatchNum = 0;
+			int32 DivergedNum = 0;
+			for (const uint32 Frame : { CorrectionFrame, (CorrectionFrame + LastFrame) / 2, LastFrame })
+			{
+				FCommandFrameAttributeSnapshot* Snapshot = SnapshotBuffer.ReadData(Frame);
+				for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+				{
+					const FCommandFrameSnapshotTestData* Data = Snapshot ? (const FCommandFrameSnapshotTestData*)Snapshot->ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex)) : nullptr;
+					const FCommandFrameSnapshotTestData Expected = SimulateAuthority(EntityIndex, Frame, true);
+					if (!IsSameState(Data, Expected))
+					{
+						++ResimulateMismatchNum;
+					}
+					if (Frame == LastFrame && !IsSameState(&Expected, SimulateAuthority(EntityIndex, Frame, false)))
+					{
+						++DivergedNum;
+					}
+				}
+				TEST_TRUE(Snapshot != nullptr);
+			}
+			TEST_EQUAL(ResimulateMismatchNum, 0);
+			TEST_EQUAL(DivergedNum, (int32)MoverNum / 2);
+
+			for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+			{
+				if (!IsSameState(&LiveStates[EntityIndex], SimulateAuthority(EntityIndex, LastFrame, true)))
+				{
+					++ResimulateMismatchNum;
+				}
+			}
+			TEST_EQUAL(ResimulateMismatchNum, 0);
+		});
+
+		It("Should keep a separate snapshot for every mover across the ring", EAsyncExecution::ThreadPool, [this]()
+		{
+			const UScriptStruct* Struct = FCommandFrameSnapshotTestData::StaticStruct();
+			FSnapshotBufferTest SnapshotBuffer(32);
+
+			for (uint32 Frame = 1; Frame <= 40; ++Frame)
+			{
+				for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+				{
+					FCommandFrameSnapshotTestData Data = SimulateMover(EntityIndex, Frame);
+					TEST_TRUE(SnapshotBuffer.RecordItemData(FCommandFrameSnapshotKey(Struct, EntityIndex), (uint8*)&Data, Frame));
+				}
+			}
+
+			// 同一帧内不能重复写入同一个实体
+			FCommandFrameSnapshotTestData Duplicate;
+			TEST_FALSE(SnapshotBuffer.RecordItemData(FCommandFrameSnapshotKey(Struct, 0), (uint8*)&Duplicate, 40));
+
+			// 读回第20帧之后的快照，并在原位修改
+			const uint32 RewindFrame = 20;
+			int32 MismatchNum = 0;
+			for (uint32 Frame = RewindFrame; Frame <= 40; ++Frame)
+			{
+				FCommandFrameAttributeSnapshot* Snapshot = SnapshotBuffer.ReadData(Frame);
+				TEST_TRUE(Snapshot != nullptr);
+				if (!Snapshot)
+				{
+					continue;
+				}
+
+				for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+				{
+					FCommandFrameSnapshotTestData* Data = (FCommandFrameSnapshotTestData*)Snapshot->ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex));
+					const FCommandFrameSnapshotTestData Expected = SimulateMover(EntityIndex, Frame);
+
+					if (!Data || !Data->Location.Equals(Expected.Location, 0.0) || !Data->Velocity.Equals(Expected.Velocity, 0.0))
+					{
+						++MismatchNum;
+						continue;
+					}
+
+					// 历史记录无法被直接覆盖，需要取出后进行修改
+					Data->Location += FVector(0.0, 0.0, EntityIndex);
+				}
+			}
+			TEST_EQUAL(MismatchNum, 0);
+
+			for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+			{
+				FCommandFrameAttributeSnapshot* Snapshot = SnapshotBuffer.ReadData(40);
+				const FCommandFrameSnapshotTestData* Data = (const FCommandFrameSnapshotTestData*)Snapshot->ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex));
+				const FVector Expected = SimulateMover(EntityIndex, 40).Location + FVector(0.0, 0.0, EntityIndex);
+				if (!Data || !Data->Location.Equals(Expected, 0.0))
+				{
+					++MismatchNum;
+				}
+			}
+			TEST_EQUAL(MismatchNum, 0);
+		});
+
+		It("Should not allocate from heap once the ring is warmed up", EAsyncExecution::ThreadPool, [this]()
+		{
+			const UScriptStruct* Struct = FCommandFrameSnapshotTestData::StaticStruct();
+			FSnapshotBufferTest SnapshotBuffer(32);
+
+			auto TickFrames = [&SnapshotBuffer, Struct](uint32 BeginFrame, uint32 EndFrame)
+			{
+				for (uint32 Frame = BeginFrame; Frame < EndFrame; ++Frame)
+				{
+					for (uint32 EntityIndex = 0; EntityIndex < MoverNum; ++EntityIndex)
+					{
+						FCommandFrameSnapshotTestData Data = SimulateMover(EntityIndex, Frame);
+						SnapshotBuffer.RecordItemData(FCommandFrameSnapshotKey(Struct, EntityIndex), (uint8*)&Data, Frame);
+					}
+				}
+			};
+
+			// 每个槽位第一次使用时走溢出块，第二次回收时按峰值扩容
+			TickFrames(1, 200);
+
+			const uint32 AllocationNum = SnapshotBuffer.GetHeapAllocationNum();
+			TEST_TRUE(AllocationNum > 0u);
+			TickFrames(200, 1000);
+
+			TEST_EQUAL(SnapshotBuffer.GetHeapAllocationNum() - AllocationNum, 0u);
+		});
+
+		It("Should copy non-POD columns through the struct even without a destructor", EAsyncExecution::ThreadPool, [this]()
+		{
+			const UScriptStruct* Struct = FCommandFrameSnapshotCopyTestData::StaticStruct();
+			TEST_TRUE((Struct->StructFlags & STRUCT_NoDestructor) != 0);
+			TEST_FALSE((Struct->StructFlags & STRUCT_IsPlainOldData) != 0);
+
+			FCommandFrameAttributeSnapshot Source;
+			FCommandFrameAttributeSnapshot Target;
+
+			FCommandFrameSnapshotCopyTestData Data;
+			Data.Value = 7;
+			Source.AddItem(FCommandFrameSnapshotKey(Struct, 0), (uint8*)&Data);
+
+			// 超出容量的实体触发列的重新分配，已有的实体需要通过拷贝搬移
+			Data.Value = 9;
+			Source.AddItem(FCommandFrameSnapshotKey(Struct, 100), (uint8*)&Data);
+
+			const FCommandFrameSnapshotCopyTestData* Moved = (const FCommandFrameSnapshotCopyTestData*)Source.ReadItemData(FCommandFrameSnapshotKey(Struct, 0));
+			TEST_TRUE(Moved != nullptr && Moved->Value == 7 && Moved->CopyCount == 2);
+
+			Target.CopyColumn(Source, Struct);
+
+			for (const uint32 EntityIndex : { 0u, 100u })
+			{
+				const FCommandFrameSnapshotCopyTestData* SourceItem = (const FCommandFrameSnapshotCopyTestData*)Source.ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex));
+				const FCommandFrameSnapshotCopyTestData* Item = (const FCommandFrameSnapshotCopyTestData*)Target.ReadItemData(FCommandFrameSnapshotKey(Struct, EntityIndex));
+				TEST_TRUE(SourceItem != nullptr && Item != nullptr);
+				if (SourceItem && Item)
+				{
+					TEST_EQUAL(Item->Value, EntityIndex == 0 ? 7 : 9);
+					TEST_EQUAL(Item->CopyCount, SourceItem->CopyCount + 1);
+				}
+			}
+		});
+
+		It("Should copy a whole column between frames", EAsyncExecution::ThreadPool, [this]()
+		{
+			const UScriptStruct* Struct = FCommandFrameSnapshotTestData::StaticStruct();
+			FCommandFrameAttributeSnapshot Source;
+			FCommandFrameAttributeSnapshot Target;
+
+			for (uint32 EntityIndex = 0; EntityIndex < MoverNum; EntityIndex += 2)
+			{
+				FCommandFrameSnapshotTestData Data = SimulateMover(EntityIndex, 1);
+				Source.AddItem(FCommandFrameSnapshotKey(Struct, EntityIndex), (uint8*)&Data);
+			}
+
+			Target.CopyColumn(Source, Struct);
+
+			int32 EntityNum = 0;
+			const FCommandFrameSnapshotTestData* Column = (const FCommandFrameSnapshotTestData*)Target.ReadColumnData(Struct, EntityNum);
+			TEST_TRUE(Column != nullptr && EntityNum >= (int32)MoverNum);
+			TEST_TRUE(Target.ReadItemData(FCommandFrameSnapshotKey(Struct, 98)) != nullptr);
+			TEST_TRUE(Target.ReadItemData(FCommandFrameSnapshotKey(Struct, 99)) == nullptr);
+			if (Column)
+			{
+				TEST_TRUE(Column[98].Location.Equals(SimulateMover(98, 1).Location, 0.0));
+			}
+		});
+	});
+}
@@ -0,0 +1,156 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Buffer/ReorderWindow.h"
+
+#define TEST_TRUE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, true)
+
+#define TEST_FALSE(expression) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, false)
+
+#define TEST_EQUAL(expression, expected) \
+	TEST_BOOLEAN_(TEXT(#expression), expression, expected)
+
+#define TEST_BOOLEAN_(text, expression, expected) \
+	TestEqual(text, expression, expected);
+
+namespace
+{
+	struct FReorderWindowTestPacket
+	{
+		uint32 ServerCommandFrame = 0;
+		uint32 PrevServerCommandFrame = 0;
+	};
+
+	/**
+	 * 与 ADefaultCommandFrameNetChannel 相同的处理流程：
+	 * 以 PrevServerCommandFrame 为Key缓存，只按序取出与 LastServerCommandFrame 相接的包
+	 */
+	struct FReorderWindowTestChannel
+	{
+		FReorderWindowTestChannel(uint32 Capacity)
+			: UnorderedPackets(Capacity)
+		{}
+
+		void Receive(const FReorderWindowTestPacket& Packet)
+		{
+			if (LastServerCommandFrame <= Packet.PrevServerCommandFrame || LastServerCommandFrame == 0)
+			{
+				if (FReorderWindowTestPacket* Slot = UnorderedPackets.Insert(Packet.PrevServerCommandFrame))
+				{
+					*Slot = Packet;
+				}
+			}
+
+			while (FReorderWindowTestPacket* Slot = UnorderedPackets.Find(LastServerCommandFrame))
+			{
+				Delivered.Add(Slot->ServerCommandFrame);
+				LastServerCommandFrame = Slot->ServerCommandFrame;
+				UnorderedPackets.Remove(Slot->PrevServerCommandFrame);
+			}
+
+			UnorderedPackets.Expire(LastServerCommandFrame);
+		}
+
+		TReorderWindow<FReorderWindowTestPacket> UnorderedPackets;
+		uint32 LastServerCommandFrame = 0;
+		TArray<uint32> Delivered;
+	};
+
+	FReorderWindowTestPacket MakePacket(uint32 ServerCommandFrame)
+	{
+		FReorderWindowTestPacket Packet;
+		Packet.ServerCommandFrame = ServerCommandFrame;
+		Packet.PrevServerCommandFrame = ServerCommandFrame - 1;
+		return Packet;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FReorderWindowSpec, "StateAbilityFramework.Buffer.ReorderWindow", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FReorderWindowSpec)
+
+void FReorderWindowSpec::Define()
+{
+	Describe("Window", [this]()
+	{
+		It("Should reject duplicated and expired keys", EAsyncExecution::ThreadPool, [this]()
+		{
+			TReorderWindow<int32> Window(8);
+			TEST_EQUAL(Window.GetCapacity(), 8u);
+
+			TEST_TRUE(Window.Insert(3) != nullptr);
+			TEST_TRUE(Window.Insert(3) == nullptr);
+			TEST_EQUAL(Window.Num(), 1);
+
+			// 与 3 落在同一个槽位，保留更早的Key
+			TEST_TRUE(Window.Insert(11) == nullptr);
+			TEST_TRUE(Window.Find(3) != nullptr);
+
+			Window.Expire(4);
+			TEST_TRUE(Window.Find(3) == nullptr);
+			TEST_TRUE(Window.Insert(3) == nullptr);
+			TEST_EQUAL(Window.Num(), 0);
+
+			TEST_TRUE(Window.Insert(11) != nullptr);
+			Window.Remove(11);
+			TEST_TRUE(Window.Find(11) == nullptr);
+			TEST_EQUAL(Window.Num(), 0);
+		});
+	});
+
+	Describe("Delivery", [this]()
+	{
+		It("Should deliver shuffled and duplicated packets in order exactly once", EAsyncExecution::ThreadPool, [this]()
+		{
+			const uint32 PacketNum = 2000;
+			const uint32 ReorderDistance = 8;
+
+			FRandomStream RandomStream(4096);
+
+			// 以 ReorderDistance 为块打乱顺序，并随机插入重复包
+			TArray<FReorderWindowTestPacket> Arrivals;
+			for (uint32 BlockBegin = 1; BlockBegin <= PacketNum; BlockBegin += ReorderDistance)
+			{
+				TArray<FReorderWindowTestPacket> Block;
+				for (uint32 Frame = BlockBegin; Frame < BlockBegin + ReorderDistance && Frame <= PacketNum; ++Frame)
+				{
+					Block.Add(MakePacket(Frame));
+					if (RandomStream.FRand() < 0.2f)
+					{
+						Block.Add(MakePacket(Frame));
+					}
+				}
+
+				for (int32 Index = Block.Num() - 1; Index > 0; --Index)
+				{
+					Block.Swap(Index, RandomStream.RandHelper(Index + 1));
+				}
+
+				Arrivals.Append(Block);
+			}
+
+			// 已经处理过的包再次到达
+			Arrivals.Add(MakePacket(PacketNum / 2));
+
+			FReorderWindowTestChannel Channel(32);
+			for (const FReorderWindowTestPacket& Packet : Arrivals)
+			{
+				Channel.Receive(Packet);
+			}
+
+			TEST_EQUAL(Channel.Delivered.Num(), (int32)PacketNum);
+			for (int32 Index = 0; Index < Channel.Delivered.Num(); ++Index)
+			{
+				if (Channel.Delivered[Index] != (uint32)Index + 1)
+				{
+					AddError(FString::Printf(TEXT("Delivered[%d] = %u, expected %d"), Index, Channel.Delivered[Index], Index + 1));
+					break;
+				}
+			}
+
+			TEST_EQUAL(Channel.LastServerCommandFrame, PacketNum);
+			TEST_EQUAL(Channel.UnorderedPackets.Num(), 0);
+		});
+	});
+}
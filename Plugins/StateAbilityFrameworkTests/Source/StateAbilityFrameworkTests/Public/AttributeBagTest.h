@@ -1,5 +1,6 @@
 #pragma once
 #include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
 
 #include "Attribute/AttributeBag/AttributeBagUtils.h"
 #include "Attribute/Reactive/AttributeReactive.h"
@@ -37,6 +38,45 @@ struct FAttributeReactiveBagTestData : public FAttributeReactiveBagTestDataBase
 	REACTIVE_ATTRIBUTE(TArray<int32>, ArrayValue);
 };
 
+// 暴露脏标记，用于检查按名字标记的结果
+USTRUCT()
+struct FAttributeDynamicBag_Test : public FAttributeDynamicBag
+{
+	GENERATED_BODY()
+
+	void ResetDirtyMark() { RawDirtyMark = FNetBitArray(GetPropertyNum()); }
+	bool IsDirty(int32 Index) const { return RawDirtyMark.IsDirty(Index); }
+};
+
+// TArray 属性的逐元素同步
+USTRUCT()
+struct FAttributeArrayReplicationTestData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FVector> Positions;
+};
+
+// 只记录哪些 NetGUID 已加载或已损坏，已加载的 NetGUID 都映射到 TransientPackage
+UCLASS()
+class UAttributeNetGuidTestPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+public:
+	virtual UObject* GetObjectFromNetGUID(const FNetworkGUID& NetGUID, const bool bIgnoreMustBeMapped) override
+	{
+		return LoadedGUIDs.Contains(NetGUID) ? GetTransientPackage() : nullptr;
+	}
+
+	virtual bool IsGUIDBroken(const FNetworkGUID& NetGUID, const bool bMustBeRegistered) const override
+	{
+		return BrokenGUIDs.Contains(NetGUID);
+	}
+
+	TSet<FNetworkGUID> LoadedGUIDs;
+	TSet<FNetworkGUID> BrokenGUIDs;
+};
 
 UCLASS()
 class UAttributeBagTestObject : public UObject
@@ -62,6 +62,32 @@ public:
 	REACTIVE_ATTRIBUTE(UObject*, ObjectValue);
 };
 
+// Stage1..Stage5 derived from Stage0 by a chain of bindings
+USTRUCT()
+struct STATEABILITYFRAMEWORKTESTS_API FAttributeModelTest_Chain : public FAttributeModelTestBase, public TReactiveModel<FAttributeModelTest_Chain>
+{
+	GENERATED_BODY()
+
+public:
+	FAttributeModelTest_Chain()
+		: Stage0Field(0)
+		, Stage1Field(0)
+		, Stage2Field(0)
+		, Stage3Field(0)
+		, Stage4Field(0)
+		, Stage5Field(0)
+	{
+	}
+
+	REACTIVE_BODY(FAttributeModelTest_Chain);
+	REACTIVE_ATTRIBUTE(int32, Stage0);
+	REACTIVE_ATTRIBUTE(int32, Stage1);
+	REACTIVE_ATTRIBUTE(int32, Stage2);
+	REACTIVE_ATTRIBUTE(int32, Stage3);
+	REACTIVE_ATTRIBUTE(int32, Stage4);
+	REACTIVE_ATTRIBUTE(int32, Stage5);
+};
+
 //////////////////////////////////////////////////////////////////////////
 
 UCLASS()
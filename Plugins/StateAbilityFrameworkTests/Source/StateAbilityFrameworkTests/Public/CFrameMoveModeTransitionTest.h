@@ -0,0 +1,61 @@
+#pragma once
+#include "CoreMinimal.h"
+
+#include "Component/Mover/CFrameMovementMode.h"
+#include "Component/Mover/CFrameMovementTransition.h"
+#include "Component/Mover/CFrameMovementContext.h"
+
+#include "CFrameMoveModeTransitionTest.generated.h"
+
+/**
+ * 只公开状态位的模式
+ */
+UCLASS()
+class UCFrameMovementMode_Test : public UCFrameMovementMode
+{
+	GENERATED_BODY()
+public:
+	UCFrameMovementMode_Test(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get())
+		: Super(ObjectInitializer)
+	{
+	}
+
+	virtual ECFrameMoveModeFlags GetModeFlags() const override { return ModeFlags; }
+
+	ECFrameMoveModeFlags ModeFlags = ECFrameMoveModeFlags::None;
+};
+
+/**
+ * 只依赖状态位的转换，编译后不再调用 OnEvaluate
+ */
+UCLASS()
+class UCFrameMoveModeTransition_TestFlag : public UCFrameMoveModeTransition
+{
+	GENERATED_BODY()
+public:
+	UCFrameMoveModeTransition_TestFlag()
+	{
+		PrecheckMask = ECFrameMoveModeFlags::OnWalkableFloor;
+		PrecheckValue = ECFrameMoveModeFlags::OnWalkableFloor;
+		bPrecheckOnly = true;
+	}
+
+	virtual bool OnEvaluate(FCFrameMovementContext& Context) const override
+	{
+		return EnumHasAnyFlags(Context.CurrentMode->GetModeFlags(), ECFrameMoveModeFlags::OnWalkableFloor);
+	}
+};
+
+/**
+ * 没有预检查，每次都需要调用 OnEvaluate
+ */
+UCLASS()
+class UCFrameMoveModeTransition_TestDeltaTime : public UCFrameMoveModeTransition
+{
+	GENERATED_BODY()
+public:
+	virtual bool OnEvaluate(FCFrameMovementContext& Context) const override
+	{
+		return Context.DeltaTime > 1.0f;
+	}
+};
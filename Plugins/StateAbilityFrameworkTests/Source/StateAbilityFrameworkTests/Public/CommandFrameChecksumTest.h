@@ -0,0 +1,32 @@
+#pragma once
+#include "CoreMinimal.h"
+
+#include "CommandFrameChecksumTest.generated.h"
+
+/**
+ * 与 FCFrameMovementSnapshot 结构相近的快照数据，用于确定性校验
+ */
+USTRUCT()
+struct FCommandFrameChecksumTestState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+	UPROPERTY()
+	FVector Velocity = FVector::ZeroVector;
+	UPROPERTY()
+	FRotator Orientation = FRotator::ZeroRotator;
+
+	UPROPERTY()
+	float Stamina = 100.0f;
+	UPROPERTY()
+	int32 JumpCount = 0;
+	UPROPERTY()
+	bool bIsFalling = false;
+
+	UPROPERTY()
+	TWeakObjectPtr<UObject> MovementBase;
+	UPROPERTY()
+	FName MovementBaseBoneName;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "CoreMinimal.h"
+
+#include "CommandFrameInputTest.generated.h"
+
+struct FInputActionInstance;
+
+/**
+ * 帧同步输入的接收者，只记录被触发的次数
+ */
+UCLASS()
+class UCommandFrameInputTestReceiver : public UObject
+{
+	GENERATED_BODY()
+public:
+	void OnInput(const FInputActionInstance& ActionData)
+	{
+		++InputNum;
+	}
+
+	int32 InputNum = 0;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "CoreMinimal.h"
+
+#include "CommandFrameReplayTest.generated.h"
+
+/**
+ * 模拟绑定在 OnBeginFrame/OnEndFrame 上的移动组件，FixedTick 的计算量接近一次简单的移动更新
+ */
+UCLASS()
+class UCommandFrameReplayTestMover : public UObject
+{
+	GENERATED_BODY()
+public:
+	void FixedTick(float DeltaTime, uint32 RCF, uint32 ICF)
+	{
+		++TickNum;
+
+		const int32 SubStepNum = 16;
+		const float SubDeltaTime = DeltaTime / SubStepNum;
+		for (int32 Step = 0; Step < SubStepNum; ++Step)
+		{
+			Velocity += FVector(0.0f, 0.0f, -980.0f) * SubDeltaTime;
+			Velocity *= 0.99f;
+			Location += Velocity * SubDeltaTime;
+
+			if (Location.Z < 0.0f)
+			{
+				Location.Z = 0.0f;
+				Velocity.Z = FMath::Abs(Velocity.Z) * 0.5f;
+			}
+		}
+	}
+
+	int32 TickNum = 0;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+};
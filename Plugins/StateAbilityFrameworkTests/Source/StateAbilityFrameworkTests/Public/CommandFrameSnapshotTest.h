@@ -0,0 +1,51 @@
+#pragma once
+#include "CoreMinimal.h"
+
+#include "CommandFrameSnapshotTest.generated.h"
+
+USTRUCT()
+struct FCommandFrameSnapshotTestData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+	UPROPERTY()
+	FVector Velocity = FVector::ZeroVector;
+};
+
+// 没有析构但有自定义拷贝的类型，快照不能按内存拷贝它
+USTRUCT()
+struct FCommandFrameSnapshotCopyTestData
+{
+	GENERATED_BODY()
+
+	FCommandFrameSnapshotCopyTestData() {}
+	FCommandFrameSnapshotCopyTestData(const FCommandFrameSnapshotCopyTestData& Other)
+		: Value(Other.Value)
+		, CopyCount(Other.CopyCount + 1)
+	{
+	}
+	FCommandFrameSnapshotCopyTestData& operator=(const FCommandFrameSnapshotCopyTestData& Other)
+	{
+		Value = Other.Value;
+		CopyCount = Other.CopyCount + 1;
+		return *this;
+	}
+
+	UPROPERTY()
+	int32 Value = 0;
+
+	// 每经过一次自定义拷贝加1，按内存拷贝时不变
+	int32 CopyCount = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCommandFrameSnapshotCopyTestData> : public TStructOpsTypeTraitsBase2<FCommandFrameSnapshotCopyTestData>
+{
+	enum
+	{
+		WithNoDestructor = true,
+		WithCopy = true,
+	};
+};
@@ -40,6 +40,9 @@ public class StateAbilityFrameworkTests : ModuleRules
 				"SlateCore",
                 "StateAbilityScriptRuntime",
                 "MassEntity",
+                "EnhancedInput",
+                "Mover",
+                "CoreOnline",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);